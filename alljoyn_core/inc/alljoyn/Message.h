@@ -972,6 +972,44 @@ class _Message {
      *      - An error status otherwise
      */
     QStatus DeliverNonBlocking(RemoteEndpoint& endpoint);
+
+    /**
+     * @internal
+     * Start delivery of a marshaled message that the caller writes together with other messages.
+     * This makes the same checks DeliverNonBlocking() makes before writing the first byte. Messages
+     * that must be encrypted or that carry handles cannot be written this way.
+     *
+     * @param[out] buf   Returns the bytes to write.
+     * @param[out] len   Returns the number of bytes to write, 0 if the message has expired.
+     * @return
+     *      - #ER_OK if the caller can write the message
+     *      - #ER_FAIL if the message must be delivered with DeliverNonBlocking()
+     */
+    QStatus BeginBatchedDelivery(const uint8_t*& buf, size_t& len);
+
+    /**
+     * @internal
+     * Get the bytes BeginBatchedDelivery() would return without changing the write state, so a
+     * message that is shared with other endpoints can be written together with other messages.
+     *
+     * @param[out] buf   Returns the bytes to write.
+     * @param[out] len   Returns the number of bytes to write, 0 if the message has expired.
+     * @return
+     *      - #ER_OK if the caller can write the message
+     *      - #ER_FAIL if the message must be delivered with DeliverNonBlocking()
+     */
+    QStatus GetBatchedDeliveryBuffer(const uint8_t*& buf, size_t& len) const;
+
+    /**
+     * @internal
+     * Record how much of a message started with BeginBatchedDelivery() was written. Any bytes
+     * not yet written are written by DeliverNonBlocking(). A message that was not started is
+     * started here if any of it was written, whether or not it has expired since.
+     *
+     * @param numBytes   Number of bytes written.
+     */
+    void BatchedBytesWritten(size_t numBytes);
+
     /**
      * @internal
      * Marshal the message again with the new sender name if one was provided.
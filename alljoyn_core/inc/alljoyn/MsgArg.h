@@ -705,6 +705,12 @@ class MsgArg {
      */
     uint8_t flags;
 
+    /**
+     * Flag value set together with #OwnsData on scalar arrays that were copied out of a message
+     * while unmarshaling. These arrays come from the message buffer pool rather than new[].
+     */
+    static const uint8_t PooledData = 0x80;
+
     /**
      * Recursively sets the ownership flags on the entire MsgArg tree.
      * @see SetOwnershipFlags
@@ -27,13 +27,17 @@
 
 
 #include <map>
+#include <vector>
 
 #include <qcc/Log.h>
+#include <qcc/Metrics.h>
 #include <qcc/String.h>
 
 #include "AllJoynDebugObj.h"
 #include "Bus.h"
 #include "BusController.h"
+#include "DaemonRouter.h"
+#include "RemoteEndpoint.h"
 
 using namespace ajn;
 using namespace debug;
@@ -44,6 +48,15 @@ using namespace debug;
  */
 AllJoynDebugObj* AllJoynDebugObj::self = NULL;
 
+/* Router statistics interface, implemented on the debug object */
+static const char* StatsInterfaceName = "org.alljoyn.Debug.Stats";
+
+static const AllJoynDebugObj::Properties::Info statsPropInfo[] = {
+    { "Endpoints",  "a(ssuuttuuu)", PROP_ACCESS_READ },   /* name, transport, rx msgs, tx msgs, rx bytes, tx bytes, tx queue depth, rx dropped, tx dropped */
+    { "Counters",   "a{su}",        PROP_ACCESS_READ },   /* qcc::Metrics counters */
+    { "Histograms", "a{s(tuuu)}",   PROP_ACCESS_READ }    /* qcc::Metrics histograms: count, 50th, 90th and 99th percentile */
+};
+
 
 AllJoynDebugObj* AllJoynDebugObj::GetAllJoynDebugObj()
 {
@@ -63,6 +76,9 @@ QStatus AllJoynDebugObj::Init()
     }
 
     status = AddInterface(*alljoynDbgIntf);
+    if (status == ER_OK) {
+        status = AddStatsInterface();
+    }
     if (status == ER_OK) {
         /* Hook up the methods to their handlers */
         const MethodEntry methodEntries[] = {
@@ -80,6 +96,30 @@ QStatus AllJoynDebugObj::Init()
 }
 
 
+QStatus AllJoynDebugObj::AddStatsInterface()
+{
+    const InterfaceDescription* statsIntf = busController->GetBus().GetInterface(StatsInterfaceName);
+    if (!statsIntf) {
+        InterfaceDescription* ifc;
+        QStatus status = busController->GetBus().CreateInterface(StatsInterfaceName, ifc);
+        if (status != ER_OK) {
+            return status;
+        }
+        for (size_t i = 0; i < ArraySize(statsPropInfo); ++i) {
+            ifc->AddProperty(statsPropInfo[i].name, statsPropInfo[i].signature, statsPropInfo[i].access);
+        }
+        ifc->Activate();
+        statsIntf = ifc;
+    }
+
+    QStatus status = AddInterface(*statsIntf);
+    if (status == ER_OK) {
+        properties.insert(std::pair<std::string, Properties*>(StatsInterfaceName, &statsProperties));
+    }
+    return status;
+}
+
+
 QStatus AllJoynDebugObj::AddDebugInterface(AllJoynDebugObjAddon* addon,
                                            const char* ifaceName,
                                            const MethodInfo* methodInfo,
@@ -163,18 +203,34 @@ QStatus AllJoynDebugObj::Set(const char* ifcName, const char* propName, MsgArg&
 
 void AllJoynDebugObj::GetProp(const InterfaceDescription::Member* member, Message& msg)
 {
-    const qcc::String guid(busController->GetBus().GetInternal().GetGlobalGUID().ToShortString());
-    qcc::String sender(msg->GetSender());
     // Only allow local connections to get properties
-    if (sender.substr(1, guid.size()) == guid) {
+    if (IsLocalSender(msg)) {
         BusObject::GetProp(member, msg);
     } // else someone off-device is trying to set our debug output, punish them by not responding.
 }
 
 
+void AllJoynDebugObj::GetAllProps(const InterfaceDescription::Member* member, Message& msg)
+{
+    // Only allow local connections to get properties
+    if (IsLocalSender(msg)) {
+        BusObject::GetAllProps(member, msg);
+    } // else someone off-device is trying to read our statistics, punish them by not responding.
+}
+
+
+bool AllJoynDebugObj::IsLocalSender(Message& msg)
+{
+    const qcc::String guid(busController->GetBus().GetInternal().GetGlobalGUID().ToShortString());
+    qcc::String sender(msg->GetSender());
+    return sender.substr(1, guid.size()) == guid;
+}
+
+
 AllJoynDebugObj::AllJoynDebugObj(BusController* busController) :
     BusObject(org::alljoyn::Daemon::Debug::ObjectPath),
-    busController(busController)
+    busController(busController),
+    statsProperties(busController)
 {
     self = this;
 }
@@ -240,4 +296,96 @@ void AllJoynDebugObj::GenericMethodHandler(const InterfaceDescription::Member* m
     }
 }
 
+
+QStatus AllJoynDebugObj::StatsProperties::Get(const char* propName, MsgArg& val) const
+{
+    if (strcmp(propName, "Endpoints") == 0) {
+        return GetEndpoints(val);
+    } else if (strcmp(propName, "Counters") == 0) {
+        return GetCounters(val);
+    } else if (strcmp(propName, "Histograms") == 0) {
+        return GetHistograms(val);
+    }
+    return ER_BUS_NO_SUCH_PROPERTY;
+}
+
+
+void AllJoynDebugObj::StatsProperties::GetProperyInfo(const Info*& info, size_t& infoSize)
+{
+    info = statsPropInfo;
+    infoSize = ArraySize(statsPropInfo);
+}
+
+
+QStatus AllJoynDebugObj::StatsProperties::GetEndpoints(MsgArg& val) const
+{
+    DaemonRouter& router = reinterpret_cast<DaemonRouter&>(busController->GetBus().GetInternal().GetRouter());
+    std::vector<RemoteEndpoint> eps;
+    router.GetRemoteEndpoints(eps);
+
+    std::vector<qcc::String> transports(eps.size());
+    std::vector<MsgArg> entries(eps.size());
+    for (size_t i = 0; i < eps.size(); ++i) {
+        _RemoteEndpoint::Stats stats;
+        eps[i]->GetStats(stats);
+        const qcc::String& connectSpec = eps[i]->GetConnectSpec();
+        transports[i] = connectSpec.substr(0, connectSpec.find_first_of(':'));
+        QStatus status = entries[i].Set("(ssuuttuuu)", eps[i]->GetUniqueName().c_str(), transports[i].c_str(),
+                                        stats.rxMessages, stats.txMessages, stats.rxBytes, stats.txBytes,
+                                        stats.txQueueDepth, stats.rxDropped, stats.txDropped);
+        if (status != ER_OK) {
+            return status;
+        }
+    }
+    QStatus status = val.Set("a(ssuuttuuu)", entries.size(), entries.empty() ? NULL : &entries.front());
+    if (status == ER_OK) {
+        val.Stabilize();
+    }
+    return status;
+}
+
+
+QStatus AllJoynDebugObj::StatsProperties::GetCounters(MsgArg& val) const
+{
+    qcc::MetricsSnapshot snapshot;
+    qcc::Metrics::GetSnapshot(snapshot);
+
+    std::vector<MsgArg> entries(snapshot.counters.size());
+    size_t i = 0;
+    for (std::map<qcc::String, uint32_t>::const_iterator it = snapshot.counters.begin(); it != snapshot.counters.end(); ++it, ++i) {
+        QStatus status = entries[i].Set("{su}", it->first.c_str(), it->second);
+        if (status != ER_OK) {
+            return status;
+        }
+    }
+    QStatus status = val.Set("a{su}", entries.size(), entries.empty() ? NULL : &entries.front());
+    if (status == ER_OK) {
+        val.Stabilize();
+    }
+    return status;
+}
+
+
+QStatus AllJoynDebugObj::StatsProperties::GetHistograms(MsgArg& val) const
+{
+    qcc::MetricsSnapshot snapshot;
+    qcc::Metrics::GetSnapshot(snapshot);
+
+    std::vector<MsgArg> entries(snapshot.histograms.size());
+    size_t i = 0;
+    for (std::map<qcc::String, qcc::MetricHistogramSnapshot>::const_iterator it = snapshot.histograms.begin(); it != snapshot.histograms.end(); ++it, ++i) {
+        const qcc::MetricHistogramSnapshot& histogram = it->second;
+        QStatus status = entries[i].Set("{s(tuuu)}", it->first.c_str(), histogram.GetCount(),
+                                        histogram.GetPercentile(50), histogram.GetPercentile(90), histogram.GetPercentile(99));
+        if (status != ER_OK) {
+            return status;
+        }
+    }
+    QStatus status = val.Set("a{s(tuuu)}", entries.size(), entries.empty() ? NULL : &entries.front());
+    if (status == ER_OK) {
+        val.Stabilize();
+    }
+    return status;
+}
+
 #endif //NDEBUG
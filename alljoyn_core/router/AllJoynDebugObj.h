@@ -29,6 +29,7 @@
 
 
 #include <map>
+#include <vector>
 
 #include <qcc/String.h>
 
@@ -141,8 +142,29 @@ class AllJoynDebugObj : public BusObject {
 
     void GetProp(const InterfaceDescription::Member* member, Message& msg);
 
+    void GetAllProps(const InterfaceDescription::Member* member, Message& msg);
+
   private:
 
+    /**
+     * Properties of the org.alljoyn.Debug.Stats interface: the traffic
+     * statistics of every remote endpoint and the value of every qcc metric.
+     * A monitoring client reads them all with a single GetAll call.
+     */
+    class StatsProperties : public Properties {
+      public:
+        StatsProperties(BusController* busController) : busController(busController) { }
+        QStatus Get(const char* propName, MsgArg& val) const;
+        void GetProperyInfo(const Info*& info, size_t& infoSize);
+
+      private:
+        QStatus GetEndpoints(MsgArg& val) const;
+        QStatus GetCounters(MsgArg& val) const;
+        QStatus GetHistograms(MsgArg& val) const;
+
+        BusController* busController;
+    };
+
     /**
      * Constructor
      */
@@ -153,6 +175,13 @@ class AllJoynDebugObj : public BusObject {
      */
     ~AllJoynDebugObj();
 
+    /**
+     * Add the org.alljoyn.Debug.Stats interface to this object.
+     *
+     * @return ER_OK if successful.
+     */
+    QStatus AddStatsInterface();
+
     /**
      * Need to let the bus contoller know when the registration is complete
      */
@@ -168,10 +197,20 @@ class AllJoynDebugObj : public BusObject {
 
     void GenericMethodHandler(const InterfaceDescription::Member* member, Message& msg);
 
+    /**
+     * Check that a message was sent by a connection to this router.
+     *
+     * @param msg   The message.
+     * @return true if the sender is local.
+     */
+    bool IsLocalSender(Message& msg);
+
     BusController* busController;
 
     PropertyStore properties;
 
+    StatsProperties statsProperties;
+
     AddonMethodHandlerMap methodHandlerMap;
 
     static AllJoynDebugObj* self;
@@ -69,7 +69,13 @@ using namespace qcc;
 namespace ajn {
 
 void* AllJoynObj::NameMapEntry::truthiness = reinterpret_cast<void*>(true);
-volatile int32_t AllJoynObj::JoinSessionThread::jstCount = 0;
+
+/* Maximum number of JoinSession requests from local clients handled at the same time */
+static const uint32_t MAX_CONCURRENT_JOINS = 16;
+
+/* Maximum number of AttachSession requests from other routers handled at the same time */
+static const uint32_t MAX_CONCURRENT_ATTACHES = 16;
+
 struct AllJoynObj::PingAlarmContext {
     enum Type {
         TRANSPORT_CONTEXT,
@@ -109,8 +115,8 @@ AllJoynObj::AllJoynObj(Bus& bus, BusController* busController, DaemonRouter& rou
     daemonGuid(bus.GetInternal().GetGlobalGUID()),
     detachSessionSignal(NULL),
     timer("NameReaper"),
-    joinSessionThreadsLock(LOCK_LEVEL_ALLJOYNOBJ_JOINSESSIONTHREADSLOCK),
-    isStopping(false),
+    joinExecutor("join", MAX_CONCURRENT_JOINS),
+    attachExecutor("attach", MAX_CONCURRENT_ATTACHES),
     busController(busController)
 {
 }
@@ -271,14 +277,8 @@ QStatus AllJoynObj::Init()
 QStatus AllJoynObj::Stop()
 {
     /* Stop any outstanding JoinSessionThreads */
-    joinSessionThreadsLock.Lock(MUTEX_CONTEXT);
-    isStopping = true;
-    vector<JoinSessionThread*>::iterator it = joinSessionThreads.begin();
-    while (it != joinSessionThreads.end()) {
-        (*it)->Stop();
-        ++it;
-    }
-    joinSessionThreadsLock.Unlock(MUTEX_CONTEXT);
+    joinExecutor.Stop();
+    attachExecutor.Stop();
 
     timer.Stop();
     return ER_OK;
@@ -287,13 +287,8 @@ QStatus AllJoynObj::Stop()
 QStatus AllJoynObj::Join()
 {
     /* Wait for any outstanding JoinSessionThreads */
-    joinSessionThreadsLock.Lock(MUTEX_CONTEXT);
-    while (!joinSessionThreads.empty()) {
-        joinSessionThreadsLock.Unlock(MUTEX_CONTEXT);
-        qcc::Sleep(50);
-        joinSessionThreadsLock.Lock(MUTEX_CONTEXT);
-    }
-    joinSessionThreadsLock.Unlock(MUTEX_CONTEXT);
+    joinExecutor.Join();
+    attachExecutor.Join();
 
     timer.Join();
     return ER_OK;
@@ -517,17 +512,161 @@ void AllJoynObj::UnbindSessionPort(const InterfaceDescription::Member* member, M
     }
 }
 
-ThreadReturn STDCALL AllJoynObj::JoinSessionThread::Run(void* arg)
+void AllJoynObj::JoinSessionThread::Run(void)
 {
-    QCC_UNUSED(arg);
-
     if (isJoin) {
         QCC_DbgTrace(("JoinSessionThread::RunJoin()"));
-        return RunJoin();
+        RunJoin();
     } else {
         QCC_DbgTrace(("JoinSessionThread::RunAttach()"));
-        return RunAttach();
+        RunAttach();
+    }
+}
+
+AllJoynObj::JoinSessionExecutor::JoinSessionExecutor(const char* name, uint32_t concurrency) :
+    concurrency(concurrency),
+    lock(LOCK_LEVEL_ALLJOYNOBJ_JOINSESSIONTHREADSLOCK),
+    active(0),
+    stopping(false),
+    activeRequests(Metrics::GetCounter(String("session.") + name + ".active")),
+    queuedRequests(Metrics::GetCounter(String("session.") + name + ".queued")),
+    waitUsec(Metrics::GetHistogram(String("session.") + name + ".wait.usec")),
+    pool(name, concurrency)
+{
+}
+
+QStatus AllJoynObj::JoinSessionExecutor::Submit(const String& key, Ptr<JoinSessionThread> request)
+{
+    lock.Lock(MUTEX_CONTEXT);
+    if (stopping) {
+        lock.Unlock(MUTEX_CONTEXT);
+        return ER_THREADPOOL_STOPPING;
+    }
+    /*
+     * A key is scheduled from the time its first request is queued until its
+     * queue is empty, so at most one thread ever runs the requests for a key.
+     */
+    bool dispatch = false;
+    std::map<String, std::deque<QueuedRequest> >::iterator it = lanes.find(key);
+    if (it == lanes.end()) {
+        it = lanes.insert(std::pair<String, std::deque<QueuedRequest> >(key, std::deque<QueuedRequest>())).first;
+        if (active < concurrency) {
+            ++active;
+            dispatch = true;
+        } else {
+            ready.push_back(key);
+        }
+    }
+    it->second.push_back(QueuedRequest(request, GetTimestampMicros()));
+    queuedRequests->Increment();
+    lock.Unlock(MUTEX_CONTEXT);
+
+    if (dispatch) {
+        Dispatch(key);
+    }
+    return ER_OK;
+}
+
+void AllJoynObj::JoinSessionExecutor::Dispatch(const String& key)
+{
+    String next = key;
+    for (;;) {
+        QStatus status = pool.Execute(Ptr<Runnable>(new Runner(*this, next)));
+        while (status == ER_THREADPOOL_EXHAUSTED) {
+            /* A runner that has just finished may not have handed its thread back to the pool yet */
+            status = pool.WaitForAvailableThread();
+            if (status == ER_OK) {
+                status = pool.Execute(Ptr<Runnable>(new Runner(*this, next)));
+            }
+        }
+        if (status == ER_OK) {
+            return;
+        }
+
+        lock.Lock(MUTEX_CONTEXT);
+        if (!stopping) {
+            /*
+             * Nothing will ever run this key's requests, so drop them as a JoinSessionThread
+             * that fails to start would be, and give the thread slot to the next waiting key.
+             * Once stopping, Stop() has already dropped everything that was queued.
+             */
+            QCC_LogError(status, ("JoinSessionExecutor: Dropping requests that could not be run"));
+            std::map<String, std::deque<QueuedRequest> >::iterator it = lanes.find(next);
+            if (it != lanes.end()) {
+                for (size_t i = 0; i < it->second.size(); ++i) {
+                    queuedRequests->Decrement();
+                }
+                lanes.erase(it);
+            }
+            if (!ready.empty()) {
+                next = ready.front();
+                ready.pop_front();
+                lock.Unlock(MUTEX_CONTEXT);
+                continue;
+            }
+        }
+        --active;
+        lock.Unlock(MUTEX_CONTEXT);
+        return;
+    }
+}
+
+void AllJoynObj::JoinSessionExecutor::RunRequests(String key)
+{
+    lock.Lock(MUTEX_CONTEXT);
+    while (!stopping) {
+        std::map<String, std::deque<QueuedRequest> >::iterator it = lanes.find(key);
+        QCC_ASSERT((it != lanes.end()) && !it->second.empty());
+        QueuedRequest next = it->second.front();
+        it->second.pop_front();
+        queuedRequests->Decrement();
+        activeRequests->Increment();
+        lock.Unlock(MUTEX_CONTEXT);
+
+        uint64_t waited = GetTimestampMicros() - next.submitTime;
+        waitUsec->Record((waited > 0xFFFFFFFF) ? 0xFFFFFFFF : static_cast<uint32_t>(waited));
+        next.request->Run();
+        activeRequests->Decrement();
+
+        lock.Lock(MUTEX_CONTEXT);
+        if (stopping) {
+            break;
+        }
+        /* Let the keys that have been waiting for a thread go before this key's next request */
+        it = lanes.find(key);
+        if (it->second.empty()) {
+            lanes.erase(it);
+        } else {
+            ready.push_back(key);
+        }
+        if (ready.empty()) {
+            break;
+        }
+        key = ready.front();
+        ready.pop_front();
+    }
+    --active;
+    lock.Unlock(MUTEX_CONTEXT);
+}
+
+void AllJoynObj::JoinSessionExecutor::Stop()
+{
+    lock.Lock(MUTEX_CONTEXT);
+    stopping = true;
+    for (std::map<String, std::deque<QueuedRequest> >::iterator it = lanes.begin(); it != lanes.end(); ++it) {
+        for (size_t i = 0; i < it->second.size(); ++i) {
+            queuedRequests->Decrement();
+        }
     }
+    lanes.clear();
+    ready.clear();
+    lock.Unlock(MUTEX_CONTEXT);
+    pool.Stop();
+}
+
+void AllJoynObj::JoinSessionExecutor::Join()
+{
+    pool.Join();
 }
 
 bool AllJoynObj::IsSelfJoinSupported(BusEndpoint& joinerEp) const {
@@ -1330,62 +1469,54 @@ RemoteEndpoint AllJoynObj::JoinSessionThread::ConnectBusToBusEndpoint(const qcc:
     return b2bEp;
 }
 
-void AllJoynObj::JoinSessionThread::ThreadExit(Thread* thread)
+/* Requests from the same joiner for the same session are handled in the order they arrive */
+static String JoinSessionKey(const char* joiner, const char* sessionHost, SessionPort sessionPort)
 {
-    ajObj.joinSessionThreadsLock.Lock(MUTEX_CONTEXT);
-    vector<JoinSessionThread*>::iterator it = ajObj.joinSessionThreads.begin();
-    JoinSessionThread* deleteMe = NULL;
-    while (it != ajObj.joinSessionThreads.end()) {
-        if (*it == thread) {
-            deleteMe = *it;
-            ajObj.joinSessionThreads.erase(it);
-            break;
-        }
-        ++it;
-    }
-    ajObj.joinSessionThreadsLock.Unlock(MUTEX_CONTEXT);
-    if (deleteMe) {
-        deleteMe->Join();
-        delete deleteMe;
-    } else {
-        QCC_LogError(ER_FAIL, ("Internal error: JoinSessionThread not found on list"));
-    }
+    return String(joiner) + " " + sessionHost + ":" + U32ToString(sessionPort);
 }
 
 void AllJoynObj::JoinSession(const InterfaceDescription::Member* member, Message& msg)
 {
     QCC_UNUSED(member);
-    /* Handle JoinSession on another thread since JoinThread can block waiting for NameOwnerChanged */
-    joinSessionThreadsLock.Lock(MUTEX_CONTEXT);
-    if (!isStopping) {
-        JoinSessionThread* jst = new JoinSessionThread(*this, msg, true);
-        QStatus status = jst->Start(NULL, jst);
-        if (status == ER_OK) {
-            joinSessionThreads.push_back(jst);
-        } else {
-            QCC_LogError(status, ("Join: Failed to start JoinSessionThread"));
-            delete jst;
-        }
+    /* Handle JoinSession on the join pool since JoinThread can block waiting for NameOwnerChanged */
+    size_t numArgs;
+    const MsgArg* args;
+    const char* sessionHost = "";
+    SessionPort sessionPort = 0;
+    msg->GetArgs(numArgs, args);
+    if ((numArgs < 2) || (MsgArg::Get(args, 2, "sq", &sessionHost, &sessionPort) != ER_OK)) {
+        /* RunJoin() rejects the bad arguments */
+        sessionHost = "";
+        sessionPort = 0;
+    }
+    QStatus status = joinExecutor.Submit(JoinSessionKey(msg->GetSender(), sessionHost, sessionPort),
+                                         Ptr<JoinSessionThread>(new JoinSessionThread(*this, msg, true)));
+    if (status != ER_OK) {
+        QCC_DbgPrintf(("Join: Not handling JoinSession (%s)", QCC_StatusText(status)));
     }
-    joinSessionThreadsLock.Unlock(MUTEX_CONTEXT);
 }
 
 void AllJoynObj::AttachSession(const InterfaceDescription::Member* member, Message& msg)
 {
     QCC_UNUSED(member);
-    /* Handle AttachSession on another thread since AttachSession can block when connecting through an intermediate node */
-    joinSessionThreadsLock.Lock(MUTEX_CONTEXT);
-    if (!isStopping) {
-        JoinSessionThread* jst = new JoinSessionThread(*this, msg, false);
-        QStatus status = jst->Start(NULL, jst);
-        if (status == ER_OK) {
-            joinSessionThreads.push_back(jst);
-        } else {
-            QCC_LogError(status, ("Attach: Failed to start JoinSessionThread"));
-            delete jst;
-        }
+    /* Handle AttachSession on the attach pool since AttachSession can block when connecting through an intermediate node */
+    size_t numArgs;
+    const MsgArg* args;
+    SessionPort sessionPort = 0;
+    const char* src = "";
+    const char* sessionHost = "";
+    msg->GetArgs(numArgs, args);
+    if ((numArgs < 3) || (MsgArg::Get(args, 3, "qss", &sessionPort, &src, &sessionHost) != ER_OK)) {
+        /* RunAttach() rejects the bad arguments */
+        sessionPort = 0;
+        src = "";
+        sessionHost = "";
+    }
+    QStatus status = attachExecutor.Submit(JoinSessionKey(src, sessionHost, sessionPort),
+                                           Ptr<JoinSessionThread>(new JoinSessionThread(*this, msg, false)));
+    if (status != ER_OK) {
+        QCC_DbgPrintf(("Attach: Not handling AttachSession (%s)", QCC_StatusText(status)));
     }
-    joinSessionThreadsLock.Unlock(MUTEX_CONTEXT);
 }
 
 void AllJoynObj::LeaveHostedSession(const InterfaceDescription::Member* member, Message& msg)
@@ -24,8 +24,12 @@
 
 #include <qcc/platform.h>
 #include <vector>
+#include <deque>
 #include <map>
 
+#include <qcc/Metrics.h>
+#include <qcc/Mutex.h>
+#include <qcc/Ptr.h>
 #include <qcc/String.h>
 #include <qcc/StringUtil.h>
 #include <qcc/Thread.h>
@@ -33,6 +37,7 @@
 #include <qcc/SocketTypes.h>
 #include <qcc/Timer.h>
 #include <qcc/GUID.h>
+#include <qcc/ThreadPool.h>
 
 #include <alljoyn/AllJoynStd.h>
 #include <alljoyn/BusObject.h>
@@ -648,24 +653,22 @@ class AllJoynObj : public BusObject, public NameListener, public TransportListen
      */
     /// @cond ALLJOYN_DEV
 
-    /** JoinSessionThread handles a JoinSession request from a local client on a separate thread */
-    class JoinSessionThread : public qcc::Thread, public qcc::ThreadListener {
+    /**
+     * JoinSessionThread handles a JoinSession request from a local client, or an AttachSession
+     * request from another router, on one of the threads of a JoinSessionExecutor.
+     */
+    class JoinSessionThread : public qcc::Runnable {
       public:
         JoinSessionThread(AllJoynObj& ajObj, const Message& msg, bool isJoin) :
-            qcc::Thread(qcc::String("JoinS-") + qcc::U32ToString(qcc::IncrementAndFetch(&jstCount))),
             ajObj(ajObj),
             msg(msg),
             isJoin(isJoin) { }
 
         qcc::ThreadReturn STDCALL RunJoin();
         virtual QStatus Reply(uint32_t replyCode, SessionId id, SessionOpts optsOut);
-        void ThreadExit(Thread* thread);
-
-      protected:
-        qcc::ThreadReturn STDCALL Run(void* arg);
+        virtual void Run(void);
 
       private:
-        static volatile int32_t jstCount;
         qcc::ThreadReturn STDCALL RunAttach();
         /*
          * This must be called with the locks as it looks through the various advertisement maps.
@@ -685,6 +688,91 @@ class AllJoynObj : public BusObject, public NameListener, public TransportListen
         bool isJoin;
     };
 
+    /**
+     * Runs JoinSessionThreads on a fixed pool of threads instead of starting a thread per
+     * request.  Requests submitted with the same key run one at a time in the order they were
+     * submitted; requests that find every thread busy wait in a queue.
+     */
+    class JoinSessionExecutor {
+      public:
+        /**
+         * Constructor
+         *
+         * @param name         Name of the executor, used for the pool threads and the metrics.
+         * @param concurrency  Maximum number of requests run at the same time.
+         */
+        JoinSessionExecutor(const char* name, uint32_t concurrency);
+
+        /**
+         * Queue a request.
+         *
+         * @param key      Requests with the same key are run in order, one at a time.
+         * @param request  The request.
+         *
+         * @return ER_OK, or ER_THREADPOOL_STOPPING if Stop() has been called.
+         */
+        QStatus Submit(const qcc::String& key, qcc::Ptr<JoinSessionThread> request);
+
+        /**
+         * Stop the pool threads.  Queued requests that have not started are dropped.
+         */
+        void Stop();
+
+        /**
+         * Wait for the pool threads to exit.
+         */
+        void Join();
+
+      private:
+        /** A pool closure that runs queued requests until there are none left to run */
+        class Runner : public qcc::Runnable {
+          public:
+            Runner(JoinSessionExecutor& executor, const qcc::String& key) : executor(executor), key(key) { }
+            virtual void Run(void) { executor.RunRequests(key); }
+          private:
+            JoinSessionExecutor& executor;
+            qcc::String key;
+        };
+
+        /** A queued request and the time it was submitted */
+        struct QueuedRequest {
+            qcc::Ptr<JoinSessionThread> request;
+            uint64_t submitTime;
+            QueuedRequest(const qcc::Ptr<JoinSessionThread>& request, uint64_t submitTime) : request(request), submitTime(submitTime) { }
+        };
+
+        /* Private copy constructor and assignment operator to prevent copies */
+        JoinSessionExecutor(const JoinSessionExecutor& other);
+        JoinSessionExecutor& operator=(const JoinSessionExecutor& other);
+
+        /**
+         * Run the requests for a key, then for any other key that is waiting for a thread.
+         *
+         * @param key  The key to start with.
+         */
+        void RunRequests(qcc::String key);
+
+        /**
+         * Hand a key whose requests can run to a pool thread.  If the pool refuses it for any
+         * reason other than being momentarily full, the key's requests are dropped and its
+         * thread slot goes to the next key waiting for one.
+         *
+         * @param key  The key.
+         */
+        void Dispatch(const qcc::String& key);
+
+        const uint32_t concurrency;                                  /**< Maximum number of running requests */
+        qcc::Mutex lock;                                             /**< Protects the members below */
+        std::map<qcc::String, std::deque<QueuedRequest> > lanes;     /**< Requests by key, the front one is running or ready */
+        std::deque<qcc::String> ready;                               /**< Keys waiting for a pool thread */
+        uint32_t active;                                             /**< Number of keys handed to pool threads */
+        bool stopping;                                               /**< True once Stop() has been called */
+        qcc::MetricCounter* activeRequests;                          /**< Number of requests running */
+        qcc::MetricCounter* queuedRequests;                          /**< Number of requests waiting to run */
+        qcc::MetricHistogram* waitUsec;                              /**< Time requests spend queued */
+        qcc::ThreadPool pool;                                        /**< Threads that run the requests */
+    };
+
     typedef enum {
         JOINER, /* AttachSession from new session joiner to Host */
         HOST,   /* AttachSession response from session host to new joiner */
@@ -987,9 +1075,8 @@ class AllJoynObj : public BusObject, public NameListener, public TransportListen
      */
     void AlarmTriggered(const qcc::Alarm& alarm, QStatus reason);
 
-    std::vector<JoinSessionThread*> joinSessionThreads;  /**< List of outstanding join session requests */
-    qcc::Mutex joinSessionThreadsLock;                   /**< Lock that protects joinSessionThreads */
-    bool isStopping;                                     /**< True while waiting for threads to exit */
+    JoinSessionExecutor joinExecutor;                    /**< Runs JoinSession requests from local clients */
+    JoinSessionExecutor attachExecutor;                  /**< Runs AttachSession requests from other routers */
     BusController* busController;                        /**< BusController that created this BusObject */
 
     /**
@@ -21,7 +21,12 @@
 
 
 #include <qcc/platform.h>
+
+#include <unordered_map>
+#include <unordered_set>
+
 #include <qcc/IPAddress.h>
+#include <qcc/Metrics.h>
 #include <qcc/Socket.h>
 #include <qcc/SocketTypes.h>
 #include <qcc/time.h>
@@ -33,6 +38,8 @@
 #include "ArdpProtocol.h"
 
 #define QCC_MODULE "ARDP_PROTOCOL"
+#undef QCC_MODULE_DBG_MASK
+#define QCC_MODULE_DBG_MASK QCC_DBG_HOT_PATH_MASK
 
 namespace ajn {
 
@@ -63,12 +70,27 @@ namespace ajn {
 /* Minimum Delayed ACK Timeout */
 #define ARDP_MIN_DELAYED_ACK_TIMEOUT 10
 
+/* Ephemeral local ports are allocated from 1 to ARDP_MAX_LOCAL_PORT */
+#define ARDP_MAX_LOCAL_PORT 65534
+
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 #define ABS(a) ((a) >= 0 ? (a) : -(a))
 
 #define UDP_HEADER_SIZE 8
 
+/* Size of a receive buffer; UDP packet can be up to 64K long */
+#define ARDP_RECV_BUFFER_SIZE 65536
+
+/* Maximum number of datagrams read from the socket in one system call */
+#define ARDP_RECV_BATCH 8
+
+/* Maximum number of data segments handed to the socket in one system call */
+#define ARDP_SEND_BATCH 32
+
+/* Maximum number of buffers in one data segment: the header, the EACK mask and the data */
+#define ARDP_SEND_BATCH_IOV 3
+
 /* Marshal/Unmarshal ARDP header offsets */
 #define FLAGS_OFFSET   0
 #define HLEN_OFFSET    1
@@ -266,6 +288,17 @@ struct ARDP_CONN_RECORD {
     qcc::SendMsgFlags sndFlags; /* SendMsgFlags to underlying sockets call */
 };
 
+/*
+ * Hash indexes over the connections on ARDP_HANDLE::conns.  The list itself is
+ * kept since its order matters to CheckTimers() and moveAhead(); the indexes
+ * let ARDP_Run() demultiplex a datagram and the API functions validate a
+ * connection without walking every connection of the handle.
+ */
+struct ArdpConnIndex {
+    std::unordered_set<ArdpConnRecord*> conns;                 /* Every connection on the conns list */
+    std::unordered_multimap<uint16_t, ArdpConnRecord*> local;  /* The same connections keyed by ARDP local port */
+};
+
 struct ARDP_HANDLE {
     ArdpGlobalConfig config; /* The configurable items that affect this instance of ARDP as a whole */
     ArdpCallbacks cb;        /* The callbacks to allow the protocol to talk back to the client */
@@ -277,11 +310,19 @@ struct ARDP_HANDLE {
 #endif
     bool accepting;          /* If true the ArdpProtocol is accepting inbound connections */
     ListNode conns;          /* List of currently active connections */
+    ArdpConnIndex* connIndex; /* Hash indexes over the conns list */
+    uint16_t portPartition;  /* Local ports allocated by this handle are congruent to portPartition ... */
+    uint16_t numPortPartitions; /* ... modulo numPortPartitions (zero if the ports are not partitioned) */
+    qcc::RecvFromEntry* rcvBatch; /* ARDP_RECV_BATCH receive buffers, allocated on first read */
     qcc::Timespec<qcc::MonotonicTime> tbase; /* Baseline time */
     ListNode dataTimers;     /* List of currently scheduled retransmit timers */
     uint32_t msnext;         /* To inform upper layer when to call into the protocol next time */
     bool trafficJam;         /* "Socket Write Block" indicator */
     void* context;           /* A client-defined context pointer */
+    qcc::MetricCounter* sendBackpressure; /* ARDP_Send() calls refused because the send window was full */
+    qcc::MetricCounter* retransmits;      /* Data segments retransmitted */
+    qcc::MetricCounter* segmentsReceived; /* Segments handed to Receive() */
+    qcc::MetricHistogram* rttMsec;        /* Round trip time of acknowledged messages in milliseconds */
 };
 
 /*
@@ -418,34 +459,42 @@ static bool IsConnValid(ArdpHandle* handle, ArdpConnRecord* conn)
         return false;
     }
 
-    if (IsEmpty(&handle->conns)) {
-        return false;
-    }
-
-    for (ListNode* ln = &handle->conns; (ln = ln->fwd) != &handle->conns;) {
-        if (conn == (ArdpConnRecord*)ln) {
-            return true;
-        }
-    }
-    return false;
+    /* Only the pointer value is looked up; conn may already have been freed */
+    return handle->connIndex->conns.find(conn) != handle->connIndex->conns.end();
 }
 
 static bool IsConnValid(ArdpHandle* handle, ArdpConnRecord* conn, uint32_t connId)
 {
-    if (conn == NULL) {
-        return false;
-    }
+    return IsConnValid(handle, conn) && (conn->id == connId);
+}
 
-    if (IsEmpty(&handle->conns)) {
-        return false;
-    }
+/*
+ * Put a connection on the list of active connections of the handle and index it.
+ */
+static void AddConn(ArdpHandle* handle, ArdpConnRecord* conn)
+{
+    EnList(handle->conns.bwd, (ListNode*)conn);
+    handle->connIndex->conns.insert(conn);
+    handle->connIndex->local.insert(std::make_pair(conn->local, conn));
+}
 
-    for (ListNode* ln = &handle->conns; (ln = ln->fwd) != &handle->conns;) {
-        if (conn == (ArdpConnRecord*)ln && (conn->id == connId)) {
-            return true;
+/*
+ * Remove a connection from the indexes of the handle.  A connection that never
+ * made it onto the list is silently ignored.
+ */
+static void RemoveConn(ArdpHandle* handle, ArdpConnRecord* conn)
+{
+    if (handle->connIndex->conns.erase(conn) == 0) {
+        return;
+    }
+    typedef std::unordered_multimap<uint16_t, ArdpConnRecord*>::iterator LocalIterator;
+    std::pair<LocalIterator, LocalIterator> range = handle->connIndex->local.equal_range(conn->local);
+    for (LocalIterator i = range.first; i != range.second; ++i) {
+        if (i->second == conn) {
+            handle->connIndex->local.erase(i);
+            break;
         }
     }
-    return false;
 }
 
 static void moveAhead(ArdpHandle* handle, ArdpConnRecord* conn)
@@ -644,7 +693,6 @@ static uint32_t CheckTimers(ArdpHandle* handle)
 
 static void DelConnRecord(ArdpHandle* handle, ArdpConnRecord* conn, bool forced)
 {
-    QCC_UNUSED(handle);
     QCC_DbgTrace(("DelConnRecord(handle=%p conn=%p forced=%s state=%s)",
                   handle, conn, forced ? "true" : "false", State2Text(conn->state)));
 
@@ -670,6 +718,7 @@ static void DelConnRecord(ArdpHandle* handle, ArdpConnRecord* conn, bool forced)
         free(conn->rcv.buf);
     }
 
+    RemoveConn(handle, conn);
     DeList((ListNode*)conn);
 
     if (conn->synData.buf != NULL) {
@@ -1014,20 +1063,21 @@ static void ExpireMessageSnd(ArdpHandle* handle, ArdpConnRecord* conn, ArdpSndBu
     }
 }
 
-static QStatus SendMsgData(ArdpHandle* handle, ArdpConnRecord* conn, ArdpSndBuf* sBuf, uint32_t ttl)
+/*
+ * Fill in the header of a data segment and describe the segment (header,
+ * EACK mask and payload) in msgSG.  The header is marshaled into hdrBuf, which
+ * must remain valid until the segment has been handed to the socket.
+ */
+static void PrepareMsgData(ArdpHandle* handle, ArdpConnRecord* conn, ArdpSndBuf* sBuf, uint32_t ttl,
+                           uint32_t* hdrBuf, qcc::ScatterGatherList& msgSG)
 {
-
     ArdpHeader* h = (ArdpHeader*) sBuf->hdr;
-    qcc::ScatterGatherList msgSG;
-    uint32_t buf32[ARDP_FIXED_HEADER_LEN >> 2];
     uint32_t len;
-    size_t sent;
-    QStatus status;
 
-    QCC_DbgTrace(("SendMsgData(): handle=%p, conn=%p, hdr=%p, data=%p, datalen=%d, ttl=%u, tStart=%u",
+    QCC_DbgTrace(("PrepareMsgData(): handle=%p, conn=%p, hdr=%p, data=%p, datalen=%d, ttl=%u, tStart=%u",
                   handle, conn, sBuf->hdr, sBuf->data, sBuf->datalen, sBuf->ttl, sBuf->tStart));
 
-    msgSG.AddBuffer(&buf32[0], ARDP_FIXED_HEADER_LEN);
+    msgSG.AddBuffer(hdrBuf, ARDP_FIXED_HEADER_LEN);
 
     h->ack = htonl(conn->rcv.CUR);
     h->lcs = htonl(conn->rcv.LCS);
@@ -1035,12 +1085,12 @@ static QStatus SendMsgData(ArdpHandle* handle, ArdpConnRecord* conn, ArdpSndBuf*
     h->flags = ARDP_FLAG_ACK | ARDP_FLAG_VER;
     h->ttl = htonl(ttl);
 
-    QCC_DbgPrintf(("SendMsgData(): seq = %u, ack=%u, lcs = %u, acknxt = %u, ttl=%u", ntohl(h->seq), conn->rcv.CUR, conn->rcv.LCS, conn->snd.UNA, ttl));
+    QCC_DbgPrintf(("PrepareMsgData(): seq = %u, ack=%u, lcs = %u, acknxt = %u, ttl=%u", ntohl(h->seq), conn->rcv.CUR, conn->rcv.LCS, conn->snd.UNA, ttl));
 
     if (conn->rcv.eack.sz == 0 || conn->modeSimple) {
         len = ARDP_FIXED_HEADER_LEN;
     } else {
-        QCC_DbgPrintf(("SendMsgData(): have EACKs"));
+        QCC_DbgPrintf(("PrepareMsgData(): have EACKs"));
         h->flags |= ARDP_FLAG_EACK;
         len = ARDP_FIXED_HEADER_LEN + conn->rcv.eack.fixedSz;
         msgSG.AddBuffer(conn->rcv.eack.htnMask, conn->rcv.eack.fixedSz);
@@ -1050,7 +1100,7 @@ static QStatus SendMsgData(ArdpHandle* handle, ArdpConnRecord* conn, ArdpSndBuf*
     h->hlen = (uint8_t)(len >> 1);
 
     /* Marshal the header structure into a byte buffer */
-    MarshalHeader(buf32, h);
+    MarshalHeader(hdrBuf, h);
 
     /* Add data payload buffer */
     msgSG.AddBuffer(sBuf->data, sBuf->datalen);
@@ -1064,9 +1114,11 @@ static QStatus SendMsgData(ArdpHandle* handle, ArdpConnRecord* conn, ArdpSndBuf*
         handle->th.SendToSG(handle, conn, SEND_MSG_DATA, msgSG);
     }
 #endif
+}
 
-    status = qcc::SendToSG(conn->sock, conn->ipAddr, conn->ipPort, msgSG, sent, conn->sndFlags);
-
+/* Account for the result of handing one or more data segments to the socket */
+static void MsgDataSent(ArdpHandle* handle, ArdpConnRecord* conn, QStatus status)
+{
     if (status == ER_OK) {
         /* Piggyback ACKs with data. Cancel ACK timer. */
         conn->ackTimer.retry = 0;
@@ -1076,6 +1128,79 @@ static QStatus SendMsgData(ArdpHandle* handle, ArdpConnRecord* conn, ArdpSndBuf*
         handle->trafficJam = true;
     }
     conn->sndFlags = qcc::QCC_MSG_NONE;
+}
+
+static QStatus SendMsgData(ArdpHandle* handle, ArdpConnRecord* conn, ArdpSndBuf* sBuf, uint32_t ttl)
+{
+    qcc::ScatterGatherList msgSG;
+    uint32_t buf32[ARDP_FIXED_HEADER_LEN >> 2];
+    size_t sent;
+
+    PrepareMsgData(handle, conn, sBuf, ttl, buf32, msgSG);
+    QStatus status = qcc::SendToSG(conn->sock, conn->ipAddr, conn->ipPort, msgSG, sent, conn->sndFlags);
+    MsgDataSent(handle, conn, status);
+
+    return status;
+}
+
+/* Data segments of a single connection waiting to be handed to the socket together */
+typedef struct {
+    uint32_t hdr[ARDP_SEND_BATCH][ARDP_FIXED_HEADER_LEN >> 2];
+    qcc::IOVec iov[ARDP_SEND_BATCH][ARDP_SEND_BATCH_IOV];
+    qcc::SendToEntry entries[ARDP_SEND_BATCH];
+    ArdpSndBuf* sBuf[ARDP_SEND_BATCH];
+    size_t count;
+} ArdpSendBatch;
+
+static void AddToSendBatch(ArdpHandle* handle, ArdpConnRecord* conn, ArdpSendBatch* batch, ArdpSndBuf* sBuf, uint32_t ttl)
+{
+    qcc::ScatterGatherList msgSG;
+    size_t i = batch->count++;
+    QCC_ASSERT(i < ARDP_SEND_BATCH);
+    PrepareMsgData(handle, conn, sBuf, ttl, batch->hdr[i], msgSG);
+    QCC_ASSERT(msgSG.Size() <= ARDP_SEND_BATCH_IOV);
+    size_t numIov = 0;
+    for (qcc::ScatterGatherList::const_iterator iter = msgSG.Begin(); iter != msgSG.End(); ++iter) {
+        batch->iov[i][numIov].buf = iter->buf;
+        batch->iov[i][numIov].len = iter->len;
+        ++numIov;
+    }
+    batch->entries[i].remoteAddr = &conn->ipAddr;
+    batch->entries[i].remotePort = conn->ipPort;
+    batch->entries[i].iov = batch->iov[i];
+    batch->entries[i].numIov = numIov;
+    batch->sBuf[i] = sBuf;
+}
+
+/*
+ * Hand the batched segments to the socket.  The segments have already been
+ * queued for retransmission as if they were sent; any the socket did not take
+ * are rescheduled to go out as soon as it becomes writable again, just as if
+ * the socket had been blocked when they were queued.
+ */
+static QStatus FlushSendBatch(ArdpHandle* handle, ArdpConnRecord* conn, ArdpSendBatch* batch)
+{
+    size_t numSent = 0;
+
+    if (batch->count == 0) {
+        return ER_OK;
+    }
+
+    QStatus status = qcc::SendToBatch(conn->sock, batch->entries, batch->count, numSent, conn->sndFlags);
+    QCC_DbgPrintf(("FlushSendBatch(): sent %u of %u segments, status=%s", numSent, batch->count, QCC_StatusText(status)));
+    if (numSent > 0) {
+        MsgDataSent(handle, conn, ER_OK);
+    }
+    if (status != ER_OK) {
+        MsgDataSent(handle, conn, status);
+    }
+    if (status == ER_WOULDBLOCK) {
+        for (size_t i = numSent; i < batch->count; ++i) {
+            UpdateTimer(handle, conn, &batch->sBuf[i]->timer, 0, 1);
+        }
+        status = ER_OK;
+    }
+    batch->count = 0;
 
     return status;
 }
@@ -1152,6 +1277,8 @@ static void AdjustRTT(ArdpHandle* handle, ArdpConnRecord* conn, ArdpSndBuf* sBuf
     uint32_t rttUnit = rtt / units;
     int32_t err;
 
+    handle->rttMsec->Record(rtt);
+
     if (!conn->rttInit) {
         conn->rttMean = rtt;
         conn->rttMeanVar = rtt >> 1;
@@ -1212,6 +1339,7 @@ static void RetransmitTimerHandler(ArdpHandle* handle, ArdpConnRecord* conn, voi
     QCC_ASSERT(sBuf->inUse && "RetransmitTimerHandler: trying to resend flushed buffer");
 
     sBuf->retransmits++;
+    handle->retransmits->Increment();
 
     if ((msElapsed >= timeout) && (timer->retry > handle->config.minDataRetries)) {
         QCC_DbgHLPrintf(("RetransmitTimerHandler seq=%u hit the time limit %u, retries %u",
@@ -1367,10 +1495,15 @@ ArdpHandle* ARDP_AllocHandle(ArdpGlobalConfig* config)
     ArdpHandle* handle = new ArdpHandle;
     memset(handle, 0, sizeof(ArdpHandle));
     SetEmpty(&handle->conns);
+    handle->connIndex = new ArdpConnIndex();
     SetEmpty(&handle->dataTimers);
     GetTimeNow(&handle->tbase);
     handle->msnext = ARDP_NO_TIMEOUT;
     memcpy(&handle->config, config, sizeof(ArdpGlobalConfig));
+    handle->sendBackpressure = qcc::Metrics::GetCounter("ardp.send.backpressure");
+    handle->retransmits = qcc::Metrics::GetCounter("ardp.retransmits");
+    handle->segmentsReceived = qcc::Metrics::GetCounter("ardp.rx.segments");
+    handle->rttMsec = qcc::Metrics::GetHistogram("ardp.rtt.msec");
     return handle;
 }
 
@@ -1385,6 +1518,11 @@ void ARDP_FreeHandle(ArdpHandle* handle)
             DelConnRecord(handle, (ArdpConnRecord*)tmp, false);
         }
     }
+    delete handle->connIndex;
+    if (handle->rcvBatch) {
+        delete[] static_cast<uint8_t*>(handle->rcvBatch[0].buf);
+        delete[] handle->rcvBatch;
+    }
     delete handle;
 }
 
@@ -1406,6 +1544,14 @@ void ARDP_SetDisconnectCb(ArdpHandle* handle, ARDP_DISCONNECT_CB DisconnectCb)
     handle->cb.DisconnectCb = DisconnectCb;
 }
 
+void ARDP_SetLocalPortPartition(ArdpHandle* handle, uint16_t partition, uint16_t numPartitions)
+{
+    QCC_DbgTrace(("ARDP_SetLocalPortPartition(handle=%p, partition=%d, numPartitions=%d)", handle, partition, numPartitions));
+    QCC_ASSERT(partition < numPartitions && "ARDP_SetLocalPortPartition(): partition out of range");
+    handle->portPartition = partition;
+    handle->numPortPartitions = numPartitions;
+}
+
 void ARDP_SetRecvCb(ArdpHandle* handle, ARDP_RECV_CB RecvCb)
 {
     QCC_DbgTrace(("ARDP_SetRecvCb(handle=%p, RecvCb=%p)", handle, RecvCb));
@@ -1619,21 +1765,41 @@ static void PostInitRcv(ArdpConnRecord* conn)
     }
 }
 
+/*
+ * Return the first local port after port that belongs to the partition of the
+ * local port space owned by this handle, wrapping around at the end of the
+ * range local ports are allocated from.
+ */
+static uint16_t NextLocalPort(ArdpHandle* handle, uint32_t port)
+{
+    uint32_t n = handle->numPortPartitions ? handle->numPortPartitions : 1;
+    uint32_t next = port + 1;
+    next += (handle->portPartition + n - (next % n)) % n;
+    if (next > ARDP_MAX_LOCAL_PORT) {
+        next = handle->portPartition;
+    }
+    if (next == 0) {
+        next = n;
+    }
+    return static_cast<uint16_t>(next);
+}
+
 static QStatus InitConnRecord(ArdpHandle* handle, ArdpConnRecord* conn, qcc::SocketFd sock, qcc::IPAddress ipAddr, uint16_t ipPort, uint16_t foreign)
 {
     QCC_DbgTrace(("InitConnRecord(handle=%p, conn=%p, sock=%d, ipAddr=\"%s\", ipPort=%d, foreign=%d)",
                   handle, conn, sock, ipAddr.ToString().c_str(), ipPort, foreign));
     uint16_t local;
     uint32_t count = 0;
+    uint32_t numPorts = ARDP_MAX_LOCAL_PORT / (handle->numPortPartitions ? handle->numPortPartitions : 1);
 
     conn->state = CLOSED;                 /* Starting state is always CLOSED */
-    local = (qcc::Rand32() % 65534) + 1;  /* Allocate an "ephemeral" source port */
+    local = NextLocalPort(handle, qcc::Rand32() % ARDP_MAX_LOCAL_PORT);  /* Allocate an "ephemeral" source port */
 
     /* Make sure this is a unique combiation of foreign/local */
     while (FindConn(handle, local, foreign) != NULL) {
-        local++;
+        local = NextLocalPort(handle, local);
         count++;
-        if (count == 65535) {
+        if (count == numPorts) {
             /* Really? We exhausted all the connections?! */
             QCC_LogError(ER_FAIL, ("InitConnRecord: Cannot get a new connection record. Too many connections?"));
             return ER_FAIL;
@@ -1679,10 +1845,12 @@ static ArdpConnRecord* FindConn(ArdpHandle* handle, uint16_t local, uint16_t for
 {
     QCC_DbgTrace(("FindConn(handle=%p, local=%d, foreign=%d)", handle, local, foreign));
 
-    for (ListNode* ln = &handle->conns; (ln = ln->fwd) != &handle->conns;) {
-        ArdpConnRecord* conn = (ArdpConnRecord*)ln;
+    typedef std::unordered_multimap<uint16_t, ArdpConnRecord*>::const_iterator LocalIterator;
+    std::pair<LocalIterator, LocalIterator> range = handle->connIndex->local.equal_range(local);
+    for (LocalIterator i = range.first; i != range.second; ++i) {
+        ArdpConnRecord* conn = i->second;
         QCC_DbgPrintf(("FindConn(): conn %p local = %d, foreign = %d", conn, conn->local, conn->foreign));
-        if (conn->local == local && conn->foreign == foreign) {
+        if (conn->foreign == foreign) {
             QCC_DbgPrintf(("FindConn(): Found conn %p", conn));
             return conn;
         }
@@ -1703,10 +1871,13 @@ static QStatus SendData(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf,
     uint32_t now = TimeNow(handle->tbase);
     uint32_t ttlSend = ttl;
     bool sendReady = true;
+    ArdpSendBatch batch;
 
     QCC_DbgTrace(("SendData(handle=%p, conn=%p, buf=%p, len=%u, ttl=%u)", handle, conn, buf, len, ttl));
     QCC_DbgPrintf(("SendData(): Sending %u bytes of data from src=0x%x to dst=0x%x", len, conn->local, conn->foreign));
 
+    batch.count = 0;
+
     /* Check if message needs to be fragmented */
     if (len <= conn->snd.maxDlen) {
         /* Data fits into one segment */
@@ -1762,8 +1933,6 @@ static QStatus SendData(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf,
         ArdpHeader* h = (ArdpHeader*) sBuf->hdr;
         uint16_t segLen = (i == (fcnt - 1)) ? lastLen : conn->snd.maxDlen;
 
-        status = ER_OK;
-
         QCC_DbgPrintf(("SendData: Segment %d, snd.NXT=%u, snd.UNA=%u", i, conn->snd.NXT, conn->snd.UNA));
         QCC_ASSERT((conn->snd.NXT - conn->snd.UNA) < conn->snd.SEGMAX);
 
@@ -1793,8 +1962,11 @@ static QStatus SendData(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf,
         }
 
         if (!handle->trafficJam && sendReady) {
-
-            status = SendMsgData(handle, conn, sBuf, ttlSend);
+            /*
+             * The fragments are handed to the socket in batches rather than
+             * one system call each; see FlushSendBatch().
+             */
+            AddToSendBatch(handle, conn, &batch, sBuf, ttlSend);
             if (conn->rttInit) {
                 timeout = GetRTO(handle, conn);
             } else {
@@ -1808,44 +1980,53 @@ static QStatus SendData(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf,
          */
         if (handle->trafficJam || !sendReady) {
             timeout = 0;
-            status = ER_OK;
         }
 
         /*
-         * We update our accounting only if the message has been sent successfully
-         * or has been put on the retransmit queue.
+         * Batched segments are accounted for as sent; FlushSendBatch() puts
+         * back any the socket does not take.
          */
-        if (status == ER_OK) {
-            sBuf->inUse = true;
-            UpdateTimer(handle, conn, &sBuf->timer, timeout, 1);
+        sBuf->inUse = true;
+        UpdateTimer(handle, conn, &sBuf->timer, timeout, 1);
 
-            if (sendReady) {
-                /* Since we scheduled a valid retransmit timer, cancel active persist timer */
-                QCC_DbgHLPrintf(("Cancel persist timer: handle=%p, conn=%p, id=%u (%d)",
-                                 handle, conn, conn->id, conn->id));
+        if (sendReady) {
+            /* Since we scheduled a valid retransmit timer, cancel active persist timer */
+            QCC_DbgHLPrintf(("Cancel persist timer: handle=%p, conn=%p, id=%u (%d)",
+                             handle, conn, conn->id, conn->id));
 
-                conn->persistTimer.retry = 0;
+            conn->persistTimer.retry = 0;
 
-                /* Advance NXT counter for in simple mode */
-                if (conn->modeSimple) {
-                    conn->snd.thinNXT++;
-                }
+            /* Advance NXT counter for in simple mode */
+            if (conn->modeSimple) {
+                conn->snd.thinNXT++;
             }
+        }
 
-            EnList(handle->dataTimers.bwd, (ListNode*) &sBuf->timer);
-            conn->snd.pending++;
-            QCC_ASSERT(((conn->snd.pending) <= conn->snd.SEGMAX) && "Number of pending segments in send queue exceeds MAX!");
-            conn->snd.NXT++;
-        } else {
-            /* Something irrevocably bad happened on the socket. Disconnect. */
-            Disconnect(handle, conn, status);
-            break;
+        EnList(handle->dataTimers.bwd, (ListNode*) &sBuf->timer);
+        conn->snd.pending++;
+        QCC_ASSERT(((conn->snd.pending) <= conn->snd.SEGMAX) && "Number of pending segments in send queue exceeds MAX!");
+        conn->snd.NXT++;
+
+        if (batch.count == ARDP_SEND_BATCH) {
+            status = FlushSendBatch(handle, conn, &batch);
+            if (status != ER_OK) {
+                break;
+            }
         }
 
         segData += segLen;
         sBuf = sBuf->next;
     }
 
+    if (status == ER_OK) {
+        status = FlushSendBatch(handle, conn, &batch);
+    }
+
+    if (status != ER_OK) {
+        /* Something irrevocably bad happened on the socket. Disconnect. */
+        Disconnect(handle, conn, status);
+    }
+
     return status;
 }
 
@@ -3105,7 +3286,7 @@ QStatus ARDP_Connect(ArdpHandle* handle, qcc::SocketFd sock, qcc::IPAddress ipAd
     if (status == ER_OK) {
         conn->context = context;
         conn->passive = false;
-        EnList(handle->conns.bwd, (ListNode*)conn);
+        AddConn(handle, conn);
         status = SendSyn(handle, conn, buf, len);
     }
 
@@ -3231,6 +3412,7 @@ QStatus ARDP_Send(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf, uint32
     QCC_DbgPrintf(("NXT=%u, UNA=%u", conn->snd.NXT, conn->snd.UNA));
     if ((conn->window == 0)  || (conn->snd.NXT - conn->snd.UNA) >= conn->snd.SEGMAX) {
         QCC_DbgPrintf(("NXT - UNA=%u, window=%u", conn->snd.NXT - conn->snd.UNA, conn->window));
+        handle->sendBackpressure->Increment();
         return ER_ARDP_BACKPRESSURE;
     } else {
         return SendData(handle, conn, buf, len, ttl);
@@ -3243,6 +3425,8 @@ static QStatus Receive(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* rxbuf,
     ArdpSeg seg;
     uint8_t hdrSz;
 
+    handle->segmentsReceived->Increment();
+
     seg.FLG = rxbuf[FLAGS_OFFSET];        /* The flags of the current segment */
     seg.HLEN = rxbuf[HLEN_OFFSET];      /* The header len */
 
@@ -3358,14 +3542,89 @@ static bool IsDuplicateConnRequest(ArdpHandle* handle, uint16_t foreign, qcc::IP
     return false;
 }
 
+void ARDP_Demux(uint8_t* buf, uint16_t len, uint16_t* local, uint16_t* foreign)
+{
+    ProtocolDemux(buf, len, local, foreign);
+}
+
+QStatus ARDP_Deliver(ArdpHandle* handle, qcc::SocketFd sock, qcc::IPAddress address, uint16_t port, uint8_t* buf, uint16_t len)
+{
+    QStatus status = ER_OK;
+
+#if ARDP_TESTHOOKS
+    /*
+     * Call the inbound testhook in case the test team needs to munge the
+     * inbound data.
+     */
+    if (handle->th.RecvFrom) {
+        handle->th.RecvFrom(handle, NULL, ARDP_RUN, buf, len);
+    }
+#endif
+
+    uint16_t local, foreign;
+    ProtocolDemux(buf, len, &local, &foreign);
+    if (local == 0) {
+        if (handle->accepting && handle->cb.AcceptCb) {
+            if (!IsDuplicateConnRequest(handle, foreign, address)) {
+                ArdpConnRecord* conn = NewConnRecord();
+                status = InitConnRecord(handle, conn, sock, address, port, foreign);
+                if (status == ER_OK) {
+                    AddConn(handle, conn);
+                    status = Accept(handle, conn, buf, len);
+                }
+                if (status != ER_OK) {
+                    SetState(conn, CLOSED);
+                    DelConnRecord(handle, conn, false);
+                }
+            } /*
+               * Else the remote most likely timed out waiting for our SYN_ACK.
+               * We should rely on local connection retry mechanism to kick in
+               * and eventually establish the connection.
+               */
+
+        } else {
+            status = ER_ARDP_INVALID_STATE;
+        }
+        if (status != ER_OK) {
+            QCC_LogError(status, ("Failed to accept incoming connection request from %s (ARDP port %u)", address.ToString().c_str(), foreign));
+            SendRst(handle, sock, address, port, local, foreign);
+        }
+    } else {
+        /* Is there an open connection? */
+        ArdpConnRecord* conn = FindConn(handle, local, foreign);
+        if (!conn) {
+            /* Is there a half open connection? */
+            conn = FindConn(handle, local, 0);
+        }
+
+        if (conn) {
+            if ((conn->state != CLOSED) && (conn->state != CLOSE_WAIT)) {
+                QCC_DbgHLPrintf(("ARDP_Run conn state %s", State2Text(conn->state)));
+                conn->lastSeen = TimeNow(handle->tbase);
+                conn->probeTimer.retry = handle->config.keepaliveRetries;
+                status = Receive(handle, conn, buf, len);
+                if (status == ER_ARDP_INVALID_RESPONSE) {
+                    Disconnect(handle, conn, status);
+                }
+            } else {
+                uint8_t flags = *reinterpret_cast<uint8_t*>(buf + FLAGS_OFFSET);
+                /* Only send repeat RST if this is a NUL segment.
+                 * This is done to alleviate a situation when original RST has not reached
+                 * the remote. This can potentially cause the remote to keep the link
+                 * alive (sending pings and retransmit data) until it hits probe timeout
+                 */
+                if (flags & ARDP_FLAG_NUL) {
+                    SendRst(handle, sock, address, port, local, foreign);
+                }
+            }
+        }
+    }
+    return status;
+}
+
 QStatus ARDP_Run(ArdpHandle* handle, qcc::SocketFd sock, bool sockRead, bool sockWrite, uint32_t* ms)
 {
-    const size_t bufferSize = 65536;      /* UDP packet can be up to 64K long */
-    uint32_t buf32[bufferSize >> 2];
-    uint8_t* buf = reinterpret_cast<uint8_t*>(buf32);
-    qcc::IPAddress address;               /* The IP address of the foreign side */
-    uint16_t port;                        /* Will be the UDP port of the foreign side */
-    size_t nbytes;                        /* The number of bytes actually received */
+    size_t count;                         /* The number of datagrams actually received */
     QStatus status = ER_OK;
 
     //QCC_DbgTrace(("ARDP_Run(handle=%p, sock=%d., socketRead=%d., socketWrite=%d., ms=%p)", handle, sock, sockRead, sockWrite, ms));
@@ -3374,78 +3633,29 @@ QStatus ARDP_Run(ArdpHandle* handle, qcc::SocketFd sock, bool sockRead, bool soc
     }
 
     if (sockRead) {
-        while ((status = qcc::RecvFrom(sock, address, port, buf, bufferSize, nbytes)) == ER_OK) {
-#if ARDP_TESTHOOKS
-            /*
-             * Call the inbound testhook in case the test team needs to munge the
-             * inbound data.
-             */
-            if (handle->th.RecvFrom) {
-                handle->th.RecvFrom(handle, NULL, ARDP_RUN, buf, nbytes);
+        if (handle->rcvBatch == NULL) {
+            uint8_t* buffers = new uint8_t[ARDP_RECV_BATCH * ARDP_RECV_BUFFER_SIZE];
+            handle->rcvBatch = new qcc::RecvFromEntry[ARDP_RECV_BATCH];
+            for (size_t i = 0; i < ARDP_RECV_BATCH; ++i) {
+                handle->rcvBatch[i].buf = buffers + i * ARDP_RECV_BUFFER_SIZE;
+                handle->rcvBatch[i].len = ARDP_RECV_BUFFER_SIZE;
             }
-#endif
-
-            if (nbytes > 0 && nbytes < 65536) {
-                uint16_t local, foreign;
-                ProtocolDemux(buf, nbytes, &local, &foreign);
-                if (local == 0) {
-                    if (handle->accepting && handle->cb.AcceptCb) {
-                        if (!IsDuplicateConnRequest(handle, foreign, address)) {
-                            ArdpConnRecord* conn = NewConnRecord();
-                            status = InitConnRecord(handle, conn, sock, address, port, foreign);
-                            if (status == ER_OK) {
-                                EnList(handle->conns.bwd, (ListNode*)conn);
-                                status = Accept(handle, conn, buf, nbytes);
-                            }
-                            if (status != ER_OK) {
-                                SetState(conn, CLOSED);
-                                DelConnRecord(handle, conn, false);
-                            }
-                        } /*
-                           * Else the remote most likely timed out waiting for our SYN_ACK.
-                           * We should rely on local connection retry mechanism to kick in
-                           * and eventually establish the connection.
-                           */
+        }
 
-                    } else {
-                        status = ER_ARDP_INVALID_STATE;
-                    }
-                    if (status != ER_OK) {
-                        QCC_LogError(status, ("Failed to accept incoming connection request from %s (ARDP port %u)", address.ToString().c_str(), foreign));
-                        SendRst(handle, sock, address, port, local, foreign);
-                    }
+        /*
+         * Read datagrams a batch at a time.  A short batch means the socket
+         * has been drained, so there is no need to ask again.
+         */
+        while ((status = qcc::RecvFromBatch(sock, handle->rcvBatch, ARDP_RECV_BATCH, count)) == ER_OK) {
+            for (size_t i = 0; i < count; ++i) {
+                qcc::RecvFromEntry& entry = handle->rcvBatch[i];
+                if (entry.received > 0 && entry.received < ARDP_RECV_BUFFER_SIZE) {
+                    ARDP_Deliver(handle, sock, entry.remoteAddr, entry.remotePort, static_cast<uint8_t*>(entry.buf), entry.received);
                 } else {
-                    /* Is there an open connection? */
-                    ArdpConnRecord* conn = FindConn(handle, local, foreign);
-                    if (!conn) {
-                        /* Is there a half open connection? */
-                        conn = FindConn(handle, local, 0);
-                    }
-
-                    if (conn) {
-                        if ((conn->state != CLOSED) && (conn->state != CLOSE_WAIT)) {
-                            QCC_DbgHLPrintf(("ARDP_Run conn state %s", State2Text(conn->state)));
-                            conn->lastSeen = TimeNow(handle->tbase);
-                            conn->probeTimer.retry = handle->config.keepaliveRetries;
-                            status = Receive(handle, conn, buf, nbytes);
-                            if (status == ER_ARDP_INVALID_RESPONSE) {
-                                Disconnect(handle, conn, status);
-                            }
-                        } else {
-                            uint8_t flags = *reinterpret_cast<uint8_t*>(buf + FLAGS_OFFSET);
-                            /* Only send repeat RST if this is a NUL segment.
-                             * This is done to alleviate a situation when original RST has not reached
-                             * the remote. This can potentially cause the remote to keep the link
-                             * alive (sending pings and retransmit data) until it hits probe timeout
-                             */
-                            if (flags & ARDP_FLAG_NUL) {
-                                SendRst(handle, sock, address, port, local, foreign);
-                            }
-                        }
-                    }
+                    QCC_DbgHLPrintf(("ARDP_Run(): Socket read failed (nbytes = %d)", entry.received));
                 }
-            } else {
-                QCC_DbgHLPrintf(("ARDP_Run(): Socket read failed (nbytes = %d)", nbytes));
+            }
+            if (count < ARDP_RECV_BATCH) {
                 break;
             }
         }
@@ -198,6 +198,13 @@ typedef struct {
  *       acknowledging the underlying segment that was received (allowing the
  *       other side to send more data).
  *
+ *     - Deliver hands a single datagram that the client has read from the
+ *       socket to the protocol.  A client that spreads its connections over
+ *       several handles partitions the local ports with SetLocalPortPartition,
+ *       reads the socket itself, uses Demux to find the handle that owns each
+ *       datagram and then calls Run on each handle without asking it to read.
+ *       Each handle may then be protected by its own lock.
+ *
  * Call-in functions are expected to be set by the ARDP protocol and call-out functions are
  * expected to be set by the client.  Since this code is expected to run on embedded
  * systems, we don't protect the API using class mechanisms, we just trust that since
@@ -216,6 +223,9 @@ uint32_t ARDP_GetConnPending(ArdpHandle* handle, ArdpConnRecord* conn);
 QStatus ARDP_GetRemoteIPEndpointFromConn(ArdpHandle* handle, ArdpConnRecord* conn, qcc::IPEndpoint& endpoint);
 QStatus ARDP_GetLocalIPEndpointFromConn(ArdpHandle* handle, ArdpConnRecord* conn, qcc::IPEndpoint& endpoint);
 QStatus ARDP_Run(ArdpHandle* handle, qcc::SocketFd sock, bool readReady, bool writeReady, uint32_t* ms);
+QStatus ARDP_Deliver(ArdpHandle* handle, qcc::SocketFd sock, qcc::IPAddress address, uint16_t port, uint8_t* buf, uint16_t len);
+void ARDP_Demux(uint8_t* buf, uint16_t len, uint16_t* local, uint16_t* foreign);
+void ARDP_SetLocalPortPartition(ArdpHandle* handle, uint16_t partition, uint16_t numPartitions);
 QStatus ARDP_StartPassive(ArdpHandle* handle);
 QStatus ARDP_Accept(ArdpHandle* handle, ArdpConnRecord* conn, uint16_t segmax, uint16_t segbmax, uint8_t* buf, uint16_t len);
 QStatus ARDP_Acknowledge(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf, uint16_t len);
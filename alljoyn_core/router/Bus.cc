@@ -24,6 +24,7 @@
 #include <qcc/String.h>
 
 #include "Bus.h"
+#include "ConfigDB.h"
 #include "DaemonRouter.h"
 #include "TransportList.h"
 
@@ -39,8 +40,15 @@ using namespace std;
  */
 const uint32_t EP_CONCURRENCY = 4;
 
+/*
+ * Number of independent IODispatch loops that remote endpoint streams are
+ * spread over.  May be overridden with the "iodispatch_shards" config limit.
+ */
+const uint32_t IODISPATCH_SHARDS_DEFAULT = 1;
+
 Bus::Bus(const char* applicationName, TransportFactoryContainer& factories, const char* listenSpecs) :
-    BusAttachment(new Internal(applicationName, *this, factories, new DaemonRouter, true, listenSpecs, EP_CONCURRENCY), EP_CONCURRENCY),
+    BusAttachment(new Internal(applicationName, *this, factories, new DaemonRouter, true, listenSpecs, EP_CONCURRENCY,
+                               ConfigDB::GetConfigDB()->GetLimit("iodispatch_shards", IODISPATCH_SHARDS_DEFAULT)), EP_CONCURRENCY),
     listenersLock(LOCK_LEVEL_BUS_LISTENERSLOCK)
 {
     GetInternal().GetRouter().SetGlobalGUID(GetInternal().GetGlobalGUID());
@@ -22,9 +22,11 @@
 
 #include <qcc/platform.h>
 
+#include <algorithm>
 
 #include <qcc/Debug.h>
 #include <qcc/Logger.h>
+#include <qcc/Metrics.h>
 #include <qcc/String.h>
 #include <qcc/Util.h>
 #include <qcc/atomic.h>
@@ -44,6 +46,8 @@
 #endif
 
 #define QCC_MODULE "ROUTER"
+#undef QCC_MODULE_DBG_MASK
+#define QCC_MODULE_DBG_MASK QCC_DBG_HOT_PATH_MASK
 
 using namespace std;
 using namespace qcc;
@@ -52,7 +56,10 @@ namespace ajn {
 
 DaemonRouter::DaemonRouter()
     : ruleTable(), nameTable(), busController(NULL), alljoynObj(NULL), sessionlessObj(NULL),
-    m_Lock(LOCK_LEVEL_DAEMONROUTER_MLOCK)
+    m_Lock(LOCK_LEVEL_DAEMONROUTER_MLOCK),
+    pushMessages(Metrics::GetCounter("router.push.messages")),
+    pushUsec(Metrics::GetHistogram("router.push.usec")),
+    pushFanOut(Metrics::GetHistogram("router.push.destinations"))
 {
 #ifdef ENABLE_POLICYDB
     AddBusNameListener(ConfigDB::GetConfigDB());
@@ -79,6 +86,11 @@ static inline QStatus SendThroughEndpoint(Message& msg, BusEndpoint& ep, Session
     return status;
 }
 
+static bool IsBus2BusEndpoint(const BusEndpoint& ep)
+{
+    return ep->GetEndpointType() == ENDPOINT_TYPE_BUS2BUS;
+}
+
 #ifdef ENABLE_OLD_PUSHMESSAGE_COMPATIBILITY
 
 /*
@@ -216,6 +228,9 @@ QStatus DaemonRouter::PushMessage(Message& msg, BusEndpoint& src)
         return ER_BUS_NO_ROUTE;
     }
 
+    ScopedMetricTimer pushTimer(pushUsec);
+    pushMessages->Increment();
+
     /*
      * Make a local reference to localEndpoint since it could be altered under
      * us by another thread.
@@ -345,6 +360,36 @@ QStatus DaemonRouter::PushMessage(Message& msg, BusEndpoint& src)
         if (ep->IsValid()) {
             allEps.push_back(ep);
         }
+    } else if (isBroadcast) {
+        /*
+         * A broadcast message is only delivered to non-Bus-to-bus endpoints
+         * that have a match rule for it (see the OkToSend() check below), so
+         * let the rule table's index narrow the list down to the endpoints
+         * with at least one rule that could match rather than checking every
+         * endpoint in the Name Table.  Bus-to-bus endpoints are added below.
+         */
+        ruleTable.GetCandidateEndpoints(msg, allEps);
+        allEps.erase(remove_if(allEps.begin(), allEps.end(), IsBus2BusEndpoint), allEps.end());
+#ifdef ENABLE_POLICYDB
+        /*
+         * The endpoints left out never receive the message, but a policy rule
+         * rejecting the message for any of them still counts as a policy
+         * rejection: it keeps a sessionless signal from SessionlessObj and
+         * turns ER_BUS_NO_ROUTE into ER_BUS_POLICY_VIOLATION.  Evaluate the
+         * policy for them just like the loop below does for the candidates.
+         */
+        vector<BusEndpoint> otherEps;
+        vector<BusEndpoint> candidates(allEps);
+        sort(candidates.begin(), candidates.end());
+        nameTable.GetAllBusEndpoints(otherEps);
+        for (vector<BusEndpoint>::iterator it = otherEps.begin(); !policyRejected && (it != otherEps.end()); ++it) {
+            if (binary_search(candidates.begin(), candidates.end(), *it)) {
+                continue;
+            }
+            policyRejected = ((src != lep) && !policyDB->OKToSend(nmh, *it)) ||
+                             ((*it != lep) && !policyDB->OKToReceive(nmh, *it));
+        }
+#endif
     } else {
         /*
          * Here we get a list of all the known non-Bus-to-bus endpoints in the
@@ -381,8 +426,10 @@ QStatus DaemonRouter::PushMessage(Message& msg, BusEndpoint& src)
 
     /*
      * Here is where we iterate over all the known endpoints to determine which
-     * ones will receive the message.
+     * ones will receive the message.  The message arguments needed by argN
+     * rules are parsed once for all of them.
      */
+    MatchArgs matchArgs;
     for (vector<BusEndpoint>::const_iterator it = allEps.begin(); it != allEps.end(); ++it) {
         BusEndpoint dest = *it;
         const bool destIsDirect =     (isUnicast && nameTable.IsAlias(dest->GetUniqueName(), destination));
@@ -471,11 +518,11 @@ QStatus DaemonRouter::PushMessage(Message& msg, BusEndpoint& src)
          *               Can we deprecate the GlobalBroadcast flag?
          */
         add = add && (!isBroadcast || ((msgIsGlobalBroadcast && destIsB2b && (src != dest)) ||
-                                       ruleTable.OkToSend(msg, dest)));
+                                       ruleTable.OkToSend(msg, dest, &matchArgs)));
         if (isBroadcast) {
             QCC_DbgPrintf(("    broadcast src = %s   dest = %s   global bcast = %d   dest epType = %d   ruleTable.OkToSend() => %d   add = %d",
                            src->GetUniqueName().c_str(), dest->GetUniqueName().c_str(),
-                           msgIsGlobalBroadcast, dest->GetEndpointType(), ruleTable.OkToSend(msg, dest), add));
+                           msgIsGlobalBroadcast, dest->GetEndpointType(), ruleTable.OkToSend(msg, dest, &matchArgs), add));
         }
 
         add = add && (!isSessioncast || IsSessionDeliverable(sessionId, src, dest));
@@ -503,6 +550,8 @@ QStatus DaemonRouter::PushMessage(Message& msg, BusEndpoint& src)
         }
     }
 
+    pushFanOut->Record(static_cast<uint32_t>(destEps.size()));
+
     /*
      * At this point destEps now contains all the endpoints that will receive
      * this message normally.  That is, the message is either directed to a
@@ -610,6 +659,21 @@ void DaemonRouter::GetBusNames(vector<qcc::String>& names) const
     nameTable.GetBusNames(names);
 }
 
+void DaemonRouter::GetRemoteEndpoints(vector<RemoteEndpoint>& eps) const
+{
+    vector<BusEndpoint> allEps;
+    nameTable.GetAllBusEndpoints(allEps);
+    eps.clear();
+    for (vector<BusEndpoint>::iterator it = allEps.begin(); it != allEps.end(); ++it) {
+        if ((*it)->GetEndpointType() == ENDPOINT_TYPE_REMOTE) {
+            eps.push_back(RemoteEndpoint::cast(*it));
+        }
+    }
+    m_Lock.Lock(MUTEX_CONTEXT);
+    eps.insert(eps.end(), m_b2bEndpoints.begin(), m_b2bEndpoints.end());
+    m_Lock.Unlock(MUTEX_CONTEXT);
+}
+
 BusEndpoint DaemonRouter::FindEndpoint(const qcc::String& busName)
 {
     BusEndpoint ep = nameTable.FindEndpoint(busName);
@@ -26,6 +26,7 @@
 
 #include <vector>
 
+#include <qcc/Metrics.h>
 #include <qcc/Thread.h>
 
 #include "Transport.h"
@@ -175,6 +176,13 @@ class DaemonRouter : public Router {
      */
     void GetBusNames(std::vector<qcc::String>& names) const;
 
+    /**
+     * Get the remote and bus-to-bus endpoints connected to this router.
+     *
+     * @param[out] eps   The endpoints.
+     */
+    void GetRemoteEndpoints(std::vector<RemoteEndpoint>& eps) const;
+
     /**
      * Find the endpoint that owns the given unique or well-known name.
      *
@@ -395,6 +403,10 @@ class DaemonRouter : public Router {
     std::set<std::pair<qcc::String, SessionId> > selfJoinEps;  /**< set of EPs that "self joined" */
     mutable qcc::Mutex m_Lock;           /**< Lock that protects internals of the DaemonRouter */
 
+    qcc::MetricCounter* pushMessages;     /**< Number of messages routed by PushMessage() */
+    qcc::MetricHistogram* pushUsec;       /**< Time spent in PushMessage() in microseconds */
+    qcc::MetricHistogram* pushFanOut;     /**< Number of endpoints each message was routed to */
+
     /**
      * Helper function to determine if a message can be delivered over a given
      * session from the source to the destination.
@@ -76,7 +76,7 @@ class _DaemonSLAPEndpoint : public _RemoteEndpoint {
         m_timer("SLAPEp", true, 1, false, 10),
         m_rawStream(fd),
         m_stream(&m_rawStream, m_timer, packetSize, 4, baudrate),
-        m_uartController(&m_rawStream, bus.GetInternal().GetIODispatch(), &m_stream)
+        m_uartController(&m_rawStream, bus.GetInternal().GetIODispatch().ShardFor(&m_rawStream), &m_stream)
     {
     }
 
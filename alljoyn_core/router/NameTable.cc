@@ -93,7 +93,9 @@ void NameTable::AddUniqueName(BusEndpoint& endpoint)
     const qcc::String& uniqueName = endpoint->GetUniqueName();
     lock.Lock(MUTEX_CONTEXT);
     UniqueNameEntry entry = { endpoint, nameTransfer };
+    tableLock.WRLock();
     uniqueNames[uniqueName] = entry;
+    tableLock.Unlock();
     lock.Unlock(MUTEX_CONTEXT);
 
     /* Notify listeners */
@@ -142,7 +144,9 @@ void NameTable::RemoveUniqueName(const qcc::String& uniqueName)
                             break;
                         }
                     } else {
+                        tableLock.WRLock();
                         ait->second.erase(lit);
+                        tableLock.Unlock();
                         break;
                     }
                 } else {
@@ -155,7 +159,9 @@ void NameTable::RemoveUniqueName(const qcc::String& uniqueName)
         }
 
         if (it != uniqueNames.end()) {
+            tableLock.WRLock();
             uniqueNames.erase(it);
+            tableLock.Unlock();
             QCC_DbgPrintf(("Removed ep=%s from name table", uniqueName.c_str()));
         }
 
@@ -201,7 +207,9 @@ QStatus NameTable::AddAlias(const qcc::String& aliasName,
                 disposition = DBUS_REQUEST_NAME_REPLY_ALREADY_OWNER;
             } else if ((primary.flags & DBUS_NAME_FLAG_ALLOW_REPLACEMENT) && (flags & DBUS_NAME_FLAG_REPLACE_EXISTING)) {
                 /* Make endpoint the current owner */
+                tableLock.WRLock();
                 wasIt->second.push_front(entry);
+                tableLock.Unlock();
                 disposition = DBUS_REQUEST_NAME_REPLY_PRIMARY_OWNER;
                 origOwner = primary.endpointName;
                 newOwner = &uniqueName;
@@ -211,13 +219,17 @@ QStatus NameTable::AddAlias(const qcc::String& aliasName,
                     disposition = DBUS_REQUEST_NAME_REPLY_EXISTS;
                 } else {
                     /* Add this new potential owner to the end of the list */
+                    tableLock.WRLock();
                     wasIt->second.push_back(entry);
+                    tableLock.Unlock();
                     disposition = DBUS_REQUEST_NAME_REPLY_IN_QUEUE;
                 }
             }
         } else {
             /* No pre-existing queue for this name */
+            tableLock.WRLock();
             aliasNames[aliasName] = deque<NameQueueEntry>(1, entry);
+            tableLock.Unlock();
             disposition = DBUS_REQUEST_NAME_REPLY_PRIMARY_OWNER;
             newOwner = &uniqueName;
 
@@ -270,8 +282,10 @@ void NameTable::RemoveAlias(const qcc::String& aliasName,
         if (queue[0].endpointName == ownerName) {
             /* Remove primary */
             if (queue.size() > 1) {
+                tableLock.WRLock();
                 queue.pop_front();
-                BusEndpoint ep = FindEndpoint(queue[0].endpointName);
+                tableLock.Unlock();
+                BusEndpoint ep = FindEndpointLocked(queue[0].endpointName);
                 if (ep->IsValid()) {
                     newOwner = queue[0].endpointName;
                 }
@@ -283,7 +297,9 @@ void NameTable::RemoveAlias(const qcc::String& aliasName,
                     newOwner = vit->second.endpoint->GetUniqueName();
                     newOwnerNameTransfer = vit->second.nameTransfer;
                 }
+                tableLock.WRLock();
                 aliasNames.erase(it);
+                tableLock.Unlock();
             }
             oldOwner = ownerName;
             disposition = DBUS_RELEASE_NAME_REPLY_RELEASED;
@@ -330,10 +346,17 @@ bool NameTable::IsValidLocalUniqueName(const qcc::String& uniqueName) const
 }
 
 BusEndpoint NameTable::FindEndpoint(const qcc::String& busName) const
+{
+    tableLock.RDLock();
+    BusEndpoint ep = FindEndpointLocked(busName);
+    tableLock.Unlock();
+    return ep;
+}
+
+BusEndpoint NameTable::FindEndpointLocked(const qcc::String& busName) const
 {
     BusEndpoint ep;
 
-    lock.Lock(MUTEX_CONTEXT);
     if (busName[0] == ':') {
         UniqueNameMap::const_iterator it = uniqueNames.find(busName);
         if (it != uniqueNames.end()) {
@@ -343,7 +366,7 @@ BusEndpoint NameTable::FindEndpoint(const qcc::String& busName) const
         unordered_map<string, deque<NameQueueEntry> >::const_iterator it = aliasNames.find(busName);
         if (it != aliasNames.end()) {
             QCC_ASSERT(!it->second.empty());
-            ep = FindEndpoint(it->second[0].endpointName);
+            ep = FindEndpointLocked(it->second[0].endpointName);
         }
         /* Fallback to virtual (remote) aliases if a suitable local one cannot be found */
         if (!ep->IsValid()) {
@@ -354,13 +377,12 @@ BusEndpoint NameTable::FindEndpoint(const qcc::String& busName) const
             }
         }
     }
-    lock.Unlock(MUTEX_CONTEXT);
     return ep;
 }
 
 void NameTable::GetBusNames(vector<qcc::String>& names) const
 {
-    lock.Lock(MUTEX_CONTEXT);
+    tableLock.RDLock();
 
     AliasMap::const_iterator it = aliasNames.begin();
     while (it != aliasNames.end()) {
@@ -372,7 +394,7 @@ void NameTable::GetBusNames(vector<qcc::String>& names) const
         names.push_back(uit->first);
         ++uit;
     }
-    lock.Unlock(MUTEX_CONTEXT);
+    tableLock.Unlock();
 }
 
 void NameTable::GetUniqueNamesAndAliases(vector<pair<qcc::String, vector<qcc::String> > >& names) const
@@ -380,7 +402,7 @@ void NameTable::GetUniqueNamesAndAliases(vector<pair<qcc::String, vector<qcc::St
 
     /* Create a intermediate map to avoid N^2 perf */
     multimap<BusEndpoint, qcc::String> epMap;
-    lock.Lock(MUTEX_CONTEXT);
+    tableLock.RDLock();
     UniqueNameMap::const_iterator uit = uniqueNames.begin();
     while (uit != uniqueNames.end()) {
         epMap.insert(pair<const BusEndpoint, qcc::String>(uit->second.endpoint, uit->first));
@@ -389,7 +411,7 @@ void NameTable::GetUniqueNamesAndAliases(vector<pair<qcc::String, vector<qcc::St
     AliasMap::const_iterator ait = aliasNames.begin();
     while (ait != aliasNames.end()) {
         if (!ait->second.empty()) {
-            BusEndpoint ep = FindEndpoint(ait->second.front().endpointName);
+            BusEndpoint ep = FindEndpointLocked(ait->second.front().endpointName);
             if (ep->IsValid()) {
                 epMap.insert(pair<BusEndpoint, qcc::String>(ep, ait->first));
             }
@@ -402,14 +424,15 @@ void NameTable::GetUniqueNamesAndAliases(vector<pair<qcc::String, vector<qcc::St
         epMap.insert(pair<BusEndpoint, qcc::String>(BusEndpoint::cast(vep), vit->first.c_str()));
         ++vit;
     }
-    lock.Unlock(MUTEX_CONTEXT);
+    size_t numUniqueNames = uniqueNames.size();
+    tableLock.Unlock();
 
     /* Fill in the caller's vector */
     qcc::String uniqueName;
     vector<qcc::String> aliasVec;
     BusEndpoint lastEp;
     multimap<BusEndpoint, qcc::String>::iterator it = epMap.begin();
-    names.reserve(uniqueNames.size());  // prevent dynamic resizing in loop
+    names.reserve(numUniqueNames);  // prevent dynamic resizing in loop
     for (;;) {
         if ((it == epMap.end()) || (lastEp != it->first)) {
             if (!uniqueName.empty()) {
@@ -434,7 +457,7 @@ void NameTable::GetUniqueNamesAndAliases(vector<pair<qcc::String, vector<qcc::St
 
 void NameTable::GetAllBusEndpoints(vector<BusEndpoint>& eps) const
 {
-    lock.Lock(MUTEX_CONTEXT);
+    tableLock.RDLock();
     eps.clear();
     eps.reserve(uniqueNames.size());
     UniqueNameMap::const_iterator it = uniqueNames.begin();
@@ -443,13 +466,13 @@ void NameTable::GetAllBusEndpoints(vector<BusEndpoint>& eps) const
         eps.push_back(entry.endpoint);
         ++it;
     }
-    lock.Unlock(MUTEX_CONTEXT);
+    tableLock.Unlock();
 }
 
 String NameTable::GetNameOwner(const String& name) const
 {
     String un;
-    lock.Lock(MUTEX_CONTEXT);
+    tableLock.RDLock();
     AliasMap::const_iterator aliasit = aliasNames.find(name);
     if (aliasit != aliasNames.end()) {
         if (aliasit->second.begin() != aliasit->second.end()) {
@@ -463,7 +486,7 @@ String NameTable::GetNameOwner(const String& name) const
             un = valiasit->second.endpoint->GetUniqueName();
         }
     }
-    lock.Unlock(MUTEX_CONTEXT);
+    tableLock.Unlock();
     return un;
 }
 
@@ -502,6 +525,7 @@ bool NameTable::IsAlias(const String name1, const String name2) const
 
 void NameTable::GetQueuedNames(const qcc::String& busName, std::vector<qcc::String>& names)
 {
+    tableLock.RDLock();
     AliasMap::iterator ait = aliasNames.find(busName.c_str());
     if (ait != aliasNames.end()) {
 
@@ -512,12 +536,13 @@ void NameTable::GetQueuedNames(const qcc::String& busName, std::vector<qcc::Stri
     } else {
         names.clear();
     }
+    tableLock.Unlock();
 }
 
 void NameTable::UpdateVirtualAliases(const qcc::String& epName)
 {
     lock.Lock(MUTEX_CONTEXT);
-    BusEndpoint tempEp = FindEndpoint(epName);
+    BusEndpoint tempEp = FindEndpointLocked(epName);
     VirtualEndpoint ep = VirtualEndpoint::cast(tempEp);
 
     QCC_DbgTrace(("NameTable::UpdateVirtualAliases(%s)", ep->IsValid() ? ep->GetUniqueName().c_str() : "<none>"));
@@ -530,7 +555,9 @@ void NameTable::UpdateVirtualAliases(const qcc::String& epName)
             SessionOpts::NameTransferType newNameTransfer = GetNameTransfer(it->second.endpoint);
 
             madeChange = (oldNameTransfer != newNameTransfer);
+            tableLock.WRLock();
             it->second.nameTransfer = newNameTransfer;
+            tableLock.Unlock();
             if (madeChange) {
                 lock.Unlock(MUTEX_CONTEXT);
                 CallListeners(epName,
@@ -548,7 +575,9 @@ void NameTable::UpdateVirtualAliases(const qcc::String& epName)
                 oldNameTransfer = vit->second.nameTransfer;
                 newNameTransfer = GetNameTransfer(vit->second.endpoint);
                 madeChange = (oldNameTransfer != newNameTransfer);
+                tableLock.WRLock();
                 vit->second.nameTransfer = newNameTransfer;
+                tableLock.Unlock();
             }
             String alias = vit->first.c_str();
             if (madeChange && (aliasNames.find(alias) == aliasNames.end())) {
@@ -569,7 +598,7 @@ void NameTable::UpdateVirtualAliases(const qcc::String& epName)
 void NameTable::RemoveVirtualAliases(const qcc::String& epName)
 {
     lock.Lock(MUTEX_CONTEXT);
-    BusEndpoint tempEp = FindEndpoint(epName);
+    BusEndpoint tempEp = FindEndpointLocked(epName);
     VirtualEndpoint ep = VirtualEndpoint::cast(tempEp);
 
     QCC_DbgTrace(("NameTable::RemoveVirtualAliases(%s)", ep->IsValid() ? ep->GetUniqueName().c_str() : "<none>"));
@@ -580,7 +609,9 @@ void NameTable::RemoveVirtualAliases(const qcc::String& epName)
             if (vit->second.endpoint == ep) {
                 String alias = vit->first.c_str();
                 SessionOpts::NameTransferType nameTransfer = vit->second.nameTransfer;
+                tableLock.WRLock();
                 virtualAliasNames.erase(vit++);
+                tableLock.Unlock();
                 if (aliasNames.find(alias) == aliasNames.end()) {
                     lock.Unlock(MUTEX_CONTEXT);
                     CallListeners(alias,
@@ -641,10 +672,14 @@ bool NameTable::SetVirtualAlias(const qcc::String& alias,
     if (newOwner && (*newOwner)->IsValid()) {
         newOwnerNameTransfer = GetNameTransfer(*newOwner);
         VirtualAliasEntry entry = { *newOwner, newOwnerNameTransfer };
+        tableLock.WRLock();
         virtualAliasNames[alias] = entry;
+        tableLock.Unlock();
         madeChange = !newOwner->iden(oldOwner) || (oldOwnerNameTransfer != newOwnerNameTransfer);
     } else {
+        tableLock.WRLock();
         virtualAliasNames.erase(std::string(alias));
+        tableLock.Unlock();
         madeChange = true;
     }
     if (newOwner && (*newOwner)->IsValid()) {
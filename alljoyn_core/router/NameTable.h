@@ -29,6 +29,7 @@
 #include <set>
 
 #include <qcc/Mutex.h>
+#include <qcc/RWLock.h>
 #include <qcc/Environ.h>
 #include <qcc/String.h>
 #include <qcc/LockLevel.h>
@@ -233,12 +234,12 @@ class NameTable {
     void GetQueuedNames(const qcc::String& busName, std::vector<qcc::String>& names);
 
     /**
-     * Lock table.
+     * Lock table against changes. Lookups such as FindEndpoint() do not wait for this lock.
      */
     void Lock() { lock.Lock(MUTEX_CONTEXT); }
 
     /**
-     * Lock table.
+     * Unlock table.
      */
     void Unlock() { lock.Unlock(MUTEX_CONTEXT); }
 
@@ -261,7 +262,14 @@ class NameTable {
     typedef std::unordered_map<std::string, std::deque<NameQueueEntry> > AliasMap;
     typedef std::unordered_map<std::string, UniqueNameEntry> UniqueNameMap;
 
-    mutable qcc::Mutex lock;                                             /**< Lock protecting name tables */
+    /*
+     * Changes to uniqueNames, aliasNames and virtualAliasNames are made holding both lock and
+     * tableLock for writing, so holding either one is enough to read them. Changes are serialized
+     * and may call out with lock held, while lookups on the message routing path only take
+     * tableLock for reading and so never wait behind a name owner change that is calling out.
+     */
+    mutable qcc::Mutex lock;                                             /**< Lock serializing changes to the name tables and listeners */
+    mutable qcc::RWLock tableLock;                                       /**< Lock protecting the name tables from concurrent lookups */
     UniqueNameMap uniqueNames;   /**< Unique name table */
     AliasMap aliasNames;  /**< Alias name table */
     uint32_t uniqueId;
@@ -301,6 +309,14 @@ class NameTable {
                        const qcc::String* newOwner, SessionOpts::NameTransferType newOwnerNameTransfer);
 
     qcc::String GetNameOwner(const qcc::String& name) const;
+
+    /**
+     * Find an endpoint for a given unique or alias bus name. Called with lock or tableLock held.
+     *
+     * @param busName   Name of bus.
+     * @return  Returns the endpoint if it was found or an invalid endpoint if not found
+     */
+    BusEndpoint FindEndpointLocked(const qcc::String& busName) const;
 };
 
 /**
@@ -40,7 +40,15 @@ QStatus RuleTable::AddRule(BusEndpoint& endpoint, const Rule& rule)
 {
     QCC_DbgPrintf(("AddRule for endpoint %s\n  %s", endpoint->GetUniqueName().c_str(), rule.ToString().c_str()));
     lock.Lock(MUTEX_CONTEXT);
-    rules.insert(std::pair<BusEndpoint, Rule>(endpoint, rule));
+    std::map<BusEndpoint, RuleSetRef>::iterator it = ruleSets.find(endpoint);
+    RuleSetRef ruleSet = (it != ruleSets.end()) ? RuleSetRef(*it->second) : RuleSetRef();
+    ruleSet->push_back(rule);
+    /* The replaced rule set is released after the write lock is dropped */
+    RuleSetRef replaced;
+    rulesLock.WRLock();
+    replaced = PublishRules(endpoint, ruleSet);
+    IndexRule(endpoint, rule);
+    rulesLock.Unlock();
     lock.Unlock(MUTEX_CONTEXT);
     return ER_OK;
 }
@@ -49,16 +57,22 @@ QStatus RuleTable::RemoveRule(BusEndpoint& endpoint, Rule& rule)
 {
     QStatus status = ER_BUS_MATCH_RULE_NOT_FOUND;
     lock.Lock(MUTEX_CONTEXT);
-    std::pair<RuleIterator, RuleIterator> range = rules.equal_range(endpoint);
-    while (range.first != range.second) {
-        if (range.first->second == rule) {
-            const RuleIterator begin = range.first;
-            const RuleIterator end = ++range.first;
-            rules.erase(begin, end);
-            status = ER_OK;
-            break;
+    std::map<BusEndpoint, RuleSetRef>::iterator it = ruleSets.find(endpoint);
+    if (it != ruleSets.end()) {
+        const RuleSet& current = *it->second;
+        for (size_t i = 0; i < current.size(); ++i) {
+            if (current[i] == rule) {
+                RuleSetRef ruleSet(current);
+                ruleSet->erase(ruleSet->begin() + i);
+                RuleSetRef replaced;
+                rulesLock.WRLock();
+                UnindexRule(endpoint, rule);
+                replaced = PublishRules(endpoint, ruleSet);
+                rulesLock.Unlock();
+                status = ER_OK;
+                break;
+            }
         }
-        ++range.first;
     }
     lock.Unlock(MUTEX_CONTEXT);
     return status;
@@ -67,21 +81,59 @@ QStatus RuleTable::RemoveRule(BusEndpoint& endpoint, Rule& rule)
 QStatus RuleTable::RemoveAllRules(BusEndpoint& endpoint)
 {
     lock.Lock(MUTEX_CONTEXT);
-    std::pair<RuleIterator, RuleIterator> range = rules.equal_range(endpoint);
-    if (range.first != rules.end()) {
-        rules.erase(range.first, range.second);
+    std::map<BusEndpoint, RuleSetRef>::iterator it = ruleSets.find(endpoint);
+    if (it != ruleSets.end()) {
+        /* Detach the whole rule set, readers that already hold it keep it alive */
+        RuleSetRef ruleSet = it->second;
+        rulesLock.WRLock();
+        ruleSets.erase(it);
+        for (RuleSet::const_iterator rit = ruleSet->begin(); rit != ruleSet->end(); ++rit) {
+            UnindexRule(endpoint, *rit);
+        }
+        rulesLock.Unlock();
     }
     lock.Unlock(MUTEX_CONTEXT);
     return ER_OK;
 }
 
-bool RuleTable::OkToSend(const Message& msg, BusEndpoint& endpoint) const
+RuleSetRef RuleTable::PublishRules(const BusEndpoint& endpoint, RuleSetRef& ruleSet)
+{
+    RuleSetRef replaced;
+    std::map<BusEndpoint, RuleSetRef>::iterator it = ruleSets.find(endpoint);
+    if (it == ruleSets.end()) {
+        if (!ruleSet->empty()) {
+            ruleSets.insert(std::pair<BusEndpoint, RuleSetRef>(endpoint, ruleSet));
+        }
+    } else {
+        replaced = it->second;
+        if (ruleSet->empty()) {
+            ruleSets.erase(it);
+        } else {
+            it->second = ruleSet;
+        }
+    }
+    return replaced;
+}
+
+RuleSetRef RuleTable::GetRules(const BusEndpoint& endpoint) const
+{
+    RuleSetRef ruleSet = emptyRules;
+    rulesLock.RDLock();
+    std::map<BusEndpoint, RuleSetRef>::const_iterator it = ruleSets.find(endpoint);
+    if (it != ruleSets.end()) {
+        ruleSet = it->second;
+    }
+    rulesLock.Unlock();
+    return ruleSet;
+}
+
+bool RuleTable::OkToSend(const Message& msg, BusEndpoint& endpoint, MatchArgs* cachedArgs) const
 {
     bool match = false;
-    lock.Lock(MUTEX_CONTEXT);
-    pair<RuleConstIterator, RuleConstIterator> range = rules.equal_range(endpoint);
-    for (RuleConstIterator it = range.first; !match && (it != range.second); ++it) {
-        match = it->second.IsMatch(msg);
+    /* Only the lookup is done under the read lock, the rules are matched on the snapshot */
+    RuleSetRef ruleSet = GetRules(endpoint);
+    for (RuleSet::const_iterator it = ruleSet->begin(); !match && (it != ruleSet->end()); ++it) {
+        match = it->IsMatch(msg, nullptr, cachedArgs);
 
         /*
          * This little hack is to make DaemonRouter::PushMessage() work with the
@@ -97,14 +149,99 @@ bool RuleTable::OkToSend(const Message& msg, BusEndpoint& endpoint) const
          * in the future.  This will likely require that the interaction between
          * SessionlessObj and DaemonRouter change.
          */
-        if (match && (it->second.sessionless == Rule::SESSIONLESS_TRUE)) {
+        if (match && (it->sessionless == Rule::SESSIONLESS_TRUE)) {
             match = false;
             break;
         }
     }
-    lock.Unlock(MUTEX_CONTEXT);
     return match;
 }
 
+RuleTable::IndexField RuleTable::GetIndexField(const Rule& rule, const String*& key)
+{
+    /* Prefer the field that is likely to be the most selective */
+    if (!rule.sender.empty()) {
+        key = &rule.sender;
+        return INDEX_SENDER;
+    } else if (!rule.member.empty()) {
+        key = &rule.member;
+        return INDEX_MEMBER;
+    } else if (!rule.path.empty()) {
+        key = &rule.path;
+        return INDEX_PATH;
+    } else if (!rule.iface.empty()) {
+        key = &rule.iface;
+        return INDEX_IFACE;
+    }
+    key = NULL;
+    return INDEX_NUM_FIELDS;
+}
+
+void RuleTable::IndexRule(BusEndpoint& endpoint, const Rule& rule)
+{
+    const String* key;
+    IndexField field = GetIndexField(rule, key);
+    if (field == INDEX_NUM_FIELDS) {
+        ++wildcardRules[endpoint];
+    } else {
+        ++index[field][*key][endpoint];
+    }
+}
+
+void RuleTable::UnindexRule(BusEndpoint& endpoint, const Rule& rule)
+{
+    const String* key;
+    IndexField field = GetIndexField(rule, key);
+    if (field == INDEX_NUM_FIELDS) {
+        EndpointRuleCount::iterator it = wildcardRules.find(endpoint);
+        if ((it != wildcardRules.end()) && (--it->second == 0)) {
+            wildcardRules.erase(it);
+        }
+        return;
+    }
+    FieldIndex::iterator bit = index[field].find(*key);
+    if (bit != index[field].end()) {
+        EndpointRuleCount& bucket = bit->second;
+        EndpointRuleCount::iterator it = bucket.find(endpoint);
+        if ((it != bucket.end()) && (--it->second == 0)) {
+            bucket.erase(it);
+        }
+        if (bucket.empty()) {
+            index[field].erase(bit);
+        }
+    }
+}
+
+void RuleTable::GetCandidateEndpoints(const Message& msg, vector<BusEndpoint>& eps) const
+{
+    const char* fields[INDEX_NUM_FIELDS];
+    fields[INDEX_SENDER] = msg->GetSender();
+    fields[INDEX_MEMBER] = msg->GetMemberName();
+    fields[INDEX_PATH] = msg->GetObjectPath();
+    fields[INDEX_IFACE] = msg->GetInterface();
+
+    eps.clear();
+    rulesLock.RDLock();
+    for (EndpointRuleCount::const_iterator it = wildcardRules.begin(); it != wildcardRules.end(); ++it) {
+        eps.push_back(it->first);
+    }
+    for (size_t i = 0; i < INDEX_NUM_FIELDS; ++i) {
+        if (!fields[i] || !*fields[i] || index[i].empty()) {
+            continue;
+        }
+        FieldIndex::const_iterator bit = index[i].find(String(fields[i]));
+        if (bit != index[i].end()) {
+            for (EndpointRuleCount::const_iterator it = bit->second.begin(); it != bit->second.end(); ++it) {
+                eps.push_back(it->first);
+            }
+        }
+    }
+    rulesLock.Unlock();
+
+    /* An endpoint may have rules in several buckets */
+    sort(eps.begin(), eps.end());
+    eps.erase(unique(eps.begin(), eps.end()), eps.end());
+}
+
 
 }
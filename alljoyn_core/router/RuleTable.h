@@ -25,8 +25,16 @@
 #define _ALLJOYN_RULETABLE_H
 
 #include <qcc/platform.h>
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include <qcc/ManagedObj.h>
 #include <qcc/Mutex.h>
 #include <qcc/LockLevel.h>
+#include <qcc/RWLock.h>
+#include <qcc/String.h>
 
 #include "BusEndpoint.h"
 #include "Rule.h"
@@ -34,13 +42,26 @@
 
 namespace ajn {
 
-/** Rule iterator */
-typedef std::multimap<BusEndpoint, Rule>::iterator RuleIterator;
-typedef std::multimap<BusEndpoint, Rule>::const_iterator RuleConstIterator;
+/** The rules of one endpoint */
+typedef std::vector<Rule> RuleSet;
+
+/**
+ * Reference to a published rule set.  A rule set is never modified once it
+ * has been published so holders can read it without a lock.
+ */
+typedef qcc::ManagedObj<RuleSet> RuleSetRef;
 
 /**
  * RuleTable is a thread-safe store used for storing
  * and retrieving message bus routing rules.
+ *
+ * Each endpoint owns an immutable rule set.  AddRule() and RemoveRule() copy
+ * the endpoint's rule set, change the copy and swap it in, so OkToSend() only
+ * holds a read lock long enough to take a reference to the current set and
+ * matches the message against it without any lock held.  The field index is
+ * updated under the same write lock as the rule sets, so
+ * GetCandidateEndpoints() only takes the read lock and does not wait for a
+ * writer that is copying a rule set.
  */
 class RuleTable {
   public:
@@ -77,70 +98,95 @@ class RuleTable {
     QStatus RemoveAllRules(BusEndpoint& endpoint);
 
     /**
-     * Obtain exclusive access to rule table.
-     * This method only needs to be called before using methods that return or use
-     * AllJoynRuleIterators. Atomic rule table operations will obtain the lock internally.
+     * Get the rules for an endpoint.  The returned rule set is a snapshot
+     * that is not affected by later changes to the rule table.
      *
-     * @return ER_OK if successful.
+     * @param endpoint  Endpoint whose rules are needed.
+     * @return  The endpoint's rules, empty if it has none.
      */
-    QStatus Lock() { return lock.Lock(MUTEX_CONTEXT); }
+    RuleSetRef GetRules(const BusEndpoint& endpoint) const;
 
     /**
-     * Release exclusive access to rule table.
+     * Check if message matches a rule for the given endpoint.
+     *
+     * @param   msg         Message that may be delivered.
+     * @param   endpoint    Endpoint message may be delivered to.
+     * @param   cachedArgs  Optional string arguments of msg shared by the
+     *                      calls for each endpoint the message may go to.
      *
-     * @return ER_OK if successful.
+     * @return  true if endpoint has a match rule that matches the message, false otherwise.
      */
-    QStatus Unlock() { return lock.Unlock(MUTEX_CONTEXT); }
+    bool OkToSend(const Message& msg, BusEndpoint& endpoint, MatchArgs* cachedArgs = nullptr) const;
 
     /**
-     * Return an iterator to the start of the rules.
-     * Caller should obtain lock before calling this method.
-     * @return Iterator to first rule.
+     * Get the endpoints that have at least one rule that could match the
+     * message.  Endpoints that are not returned cannot pass OkToSend() for
+     * this message, so callers only need to check the returned endpoints.
+     *
+     * @param      msg   Message that may be delivered.
+     * @param[out] eps   Candidate endpoints (no duplicates).
      */
-    RuleIterator Begin() { return rules.begin(); }
+    void GetCandidateEndpoints(const Message& msg, std::vector<BusEndpoint>& eps) const;
 
-    /**
-     * Return an iterator to the end of the rules.
-     * @return Iterator to end of rules.
-     */
-    RuleIterator End() { return rules.end(); }
+  private:
 
     /**
-     * Find all rules for a given endpoint.
-     * Caller should obtain lock before calling this method.
-     *
-     * @param endpoint  Endpoint whose rules are needed.
-     * @return  Iterator to first rule for given endpoint.
+     * Rules are indexed on a single field so that a message only has to look
+     * at the rules whose indexed field equals the corresponding message field.
+     * Rules that specify none of these fields are kept in the wildcard bucket.
      */
-    RuleIterator FindRulesForEndpoint(BusEndpoint& endpoint) {
-        return rules.find(endpoint);
-    }
+    enum IndexField {
+        INDEX_SENDER,
+        INDEX_MEMBER,
+        INDEX_PATH,
+        INDEX_IFACE,
+        INDEX_NUM_FIELDS
+    };
+
+    /** Hash functor for index keys */
+    struct Hash {
+        size_t operator()(const qcc::String& s) const {
+            size_t hash = 37;
+            for (const char* p = s.c_str(); *p; ++p) {
+                hash = *p + hash * 31;
+            }
+            return hash;
+        }
+    };
+
+    /** Number of rules each endpoint has in an index bucket */
+    typedef std::map<BusEndpoint, uint32_t> EndpointRuleCount;
+    typedef std::unordered_map<qcc::String, EndpointRuleCount, Hash> FieldIndex;
 
     /**
-     * Advance iterator to next endpoint.
-     *
-     * @param endpoint   Endpoint before advance.
-     * @return   Iterator to next endpoint in ruleTable or end.
+     * Get the field a rule is indexed on.
      *
+     * @param      rule   The rule.
+     * @param[out] key    The value of that field in the rule or NULL.
+     * @return The indexed field or INDEX_NUM_FIELDS if the rule is a wildcard.
      */
-    RuleIterator AdvanceToNextEndpoint(BusEndpoint endpoint) {
-        std::multimap<BusEndpoint, Rule>::iterator ret = rules.upper_bound(endpoint);
-        return ret;
-    }
+    static IndexField GetIndexField(const Rule& rule, const qcc::String*& key);
+
+    /** Add a rule to the index.  Caller must hold the lock and the write lock on rulesLock. */
+    void IndexRule(BusEndpoint& endpoint, const Rule& rule);
+
+    /** Remove a rule from the index.  Caller must hold the lock and the write lock on rulesLock. */
+    void UnindexRule(BusEndpoint& endpoint, const Rule& rule);
 
     /**
-     * Check if message matches a rule for the given endpoint.
-     *
-     * @param   msg         Message that may be delivered.
-     * @param   endpoint    Endpoint message may be delivered to.
+     * Publish a new rule set for an endpoint.  Caller must hold the lock and
+     * the write lock on rulesLock.
      *
-     * @return  true if endpoint has a match rule that matches the message, false otherwise.
+     * @return The replaced rule set, to be released after rulesLock is dropped.
      */
-    bool OkToSend(const Message& msg, BusEndpoint& endpoint) const;
-
-  private:
-    mutable qcc::Mutex lock;                   /**< Lock protecting rule table */
-    std::multimap<BusEndpoint, Rule> rules;    /**< Rule table */
+    RuleSetRef PublishRules(const BusEndpoint& endpoint, RuleSetRef& ruleSet);
+
+    mutable qcc::Mutex lock;                      /**< Lock serializing changes to the rule table */
+    mutable qcc::RWLock rulesLock;                /**< Lock protecting ruleSets and the index from concurrent lookups */
+    std::map<BusEndpoint, RuleSetRef> ruleSets;   /**< Rule set of each endpoint that has rules */
+    RuleSetRef emptyRules;                        /**< Shared rule set returned for endpoints without rules */
+    FieldIndex index[INDEX_NUM_FIELDS];           /**< Inverted index from field value to endpoints */
+    EndpointRuleCount wildcardRules;              /**< Endpoints with rules that have no indexed field */
 };
 
 }
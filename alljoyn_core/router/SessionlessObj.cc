@@ -537,7 +537,7 @@ void SessionlessObj::SendMatchingThroughEndpoint(SessionId sid, SessionlessMessa
         RuleIterator end = rules.upper_bound(dstEpName);
         for (; rit != end; ++rit) {
             if (IN_WINDOW(uint32_t, fromRulesId, rulesRangeLen, rit->second.id) && dstEpCanReceive) {
-                if (rit->second.IsMatch(msg, slm->cachedWhoImplements)) {
+                if (rit->second.IsMatch(msg, slm->cachedWhoImplements, &slm->cachedArgs)) {
                     isExplicitMatch = true;
                     if (isAnnounce && !rit->second.implements.empty()) {
                         /*
@@ -556,13 +556,10 @@ void SessionlessObj::SendMatchingThroughEndpoint(SessionId sid, SessionlessMessa
                      * sessionless signals will route through the daemon router's
                      * rule table.
                      */
-                    router.GetRuleTable().Lock();
-                    for (ajn::RuleIterator drit = router.GetRuleTable().FindRulesForEndpoint(dstEp);
-                         !isExplicitMatch && (drit != router.GetRuleTable().End()) && (drit->first == dstEp);
-                         ++drit) {
-                        isExplicitMatch = drit->second.IsMatch(msg, slm->cachedWhoImplements);
+                    RuleSetRef dstRules = router.GetRuleTable().GetRules(dstEp);
+                    for (RuleSet::const_iterator drit = dstRules->begin(); !isExplicitMatch && (drit != dstRules->end()); ++drit) {
+                        isExplicitMatch = drit->IsMatch(msg, slm->cachedWhoImplements, &slm->cachedArgs);
                     }
-                    router.GetRuleTable().Unlock();
                 }
             }
         }
@@ -900,7 +897,7 @@ void SessionlessObj::HandleRangeRequest(const char* sender, SessionId sid,
                 bool isMatch = remoteRules.empty();
                 for (vector<String>::iterator rit = remoteRules.begin(); !isMatch && (rit != remoteRules.end()); ++rit) {
                     Rule rule(rit->c_str());
-                    isMatch = rule.IsMatch(slm->msg) || (rule == legacyRule);
+                    isMatch = rule.IsMatch(slm->msg, nullptr, &slm->cachedArgs) || (rule == legacyRule);
                 }
                 if (isMatch) {
                     BusEndpoint ep = router.FindEndpoint(sender);
@@ -1600,7 +1597,7 @@ bool SessionlessObj::SendResponseIfMatch(TransportMask transport, const qcc::IPE
     lock.Lock();
     for (LocalCache::iterator mit = localCache.begin(); mit != localCache.end(); ++mit) {
         Message& msg = mit->second->msg;
-        if (rule.IsMatch(msg, mit->second->cachedWhoImplements)) {
+        if (rule.IsMatch(msg, mit->second->cachedWhoImplements, &mit->second->cachedArgs)) {
             name = AdvertisedName(msg->GetInterface(), lastAdvertisements[msg->GetInterface()]);
             sendResponse = true;
             break;
@@ -1859,12 +1856,12 @@ bool SessionlessObj::IsOnlyImplicitMatch(const qcc::String& epName, SessionlessM
      * purely implicit, and the implicit match rule should be removed for this epName.
      */
     for (ImplicitRuleIterator irit = implicitRules.begin(); irit != implicitRules.end(); ++irit) {
-        if (irit->IsMatch(msg, slm->cachedWhoImplements)) {
+        if (irit->IsMatch(msg, slm->cachedWhoImplements, &slm->cachedArgs)) {
             bool hasExplicitMatch = false;
             std::pair<RuleIterator, RuleIterator> range = rules.equal_range(epName);
             bool hasExplicitRules = (range.first != range.second);
             for (; range.first != range.second; range.first++) {
-                if (range.first->second.IsMatch(msg, slm->cachedWhoImplements)) {
+                if (range.first->second.IsMatch(msg, slm->cachedWhoImplements, &slm->cachedArgs)) {
                     hasExplicitMatch = true;
                     break;
                 }
@@ -386,6 +386,7 @@ class SessionlessObj : public BusObject, public NameListener, public SessionList
         uint32_t changeId;
         Message msg;
         std::set<qcc::String>* cachedWhoImplements; /**< For About signals, this field caches 'implements' interfaces (to avoid future cost of re-parsing) */
+        MatchArgs cachedArgs;                       /**< Caches the string arguments for argN rules (to avoid future cost of re-parsing) */
     };
 
     typedef qcc::ManagedObj<_SessionlessMessage> SessionlessMessage;
@@ -432,6 +432,8 @@
  */
 
 #define QCC_MODULE "UDP"
+#undef QCC_MODULE_DBG_MASK
+#define QCC_MODULE_DBG_MASK QCC_DBG_HOT_PATH_MASK
 
 #define SENT_SANITY 0   /**< If non-zero make sure ARDP is returning buffers correctly (expensive) */
 #define BYTEDUMPS 0     /**< If non-zero do byte-by-byte debug dumps of sent and received buffers (super-expensive) */
@@ -469,6 +471,10 @@ const uint32_t UDP_TIMEWAIT = 1000;  /**< How long do we stay in TIMWAIT state b
 const uint32_t UDP_SEGBMAX = 4440;  /**< Maximum size of an ARDP segment (quantum of reliable transmission) */
 const uint32_t UDP_SEGMAX = 93;  /**< Maximum number of ARDP segment in-flight (bandwidth-delay product sizing) */
 
+const uint32_t UDP_ARDP_SHARDS = 1;  /**< Number of independently locked ARDP instances connections are spread over */
+const uint32_t UDP_ARDP_SHARDS_MAX = 256;  /**< Upper limit on udp_ardp_shards */
+const size_t UDP_ARDP_RECV_BATCH = 8;  /**< Maximum number of datagrams read in one system call when there are several ARDP instances */
+
 namespace ajn {
 
 /**
@@ -1101,8 +1107,9 @@ class _UDPEndpoint : public _RemoteEndpoint {
          * hold the endpoint lock, we should find the endpoint on the list.
          */
         uint32_t found = 0;
-        for (set<UDPEndpoint>::iterator i = m_transport->m_endpointList.begin(); i != m_transport->m_endpointList.end(); ++i) {
-            UDPEndpoint ep = *i;
+        UDPTransport::EndpointConnIdRange range = m_transport->m_endpointConnIdMap.equal_range(GetConnId());
+        for (UDPTransport::EndpointConnIdMap::iterator i = range.first; i != range.second; ++i) {
+            UDPEndpoint ep = i->second;
             if (GetConnId() == ep->GetConnId()) {
                 QCC_DbgPrintf(("_UDPEndpoint::PushMessage(): found endpoint with conn ID == %d. on m_endpointList", GetConnId()));
                 ++found;
@@ -1214,8 +1221,9 @@ class _UDPEndpoint : public _RemoteEndpoint {
          * remove the endpoint with threads wandering around in it.
          */
         uint32_t found = 0;
-        for (set<UDPEndpoint>::iterator i = m_transport->m_endpointList.begin(); i != m_transport->m_endpointList.end(); ++i) {
-            UDPEndpoint ep = *i;
+        UDPTransport::EndpointConnIdRange range = m_transport->m_endpointConnIdMap.equal_range(GetConnId());
+        for (UDPTransport::EndpointConnIdMap::iterator i = range.first; i != range.second; ++i) {
+            UDPEndpoint ep = i->second;
             if (GetConnId() == ep->GetConnId()) {
                 QCC_ASSERT(connId == GetConnId() && "_UDPEndpoint::RecvCb(): Inconsistent connId");
                 QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): found endpoint with conn ID == %d. on m_endpointList", GetConnId()));
@@ -1233,7 +1241,7 @@ class _UDPEndpoint : public _RemoteEndpoint {
             QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): Not accepting inbound messages"));
 
             QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): ARDP_RecvReady()"));
-            m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+            m_transport->ArdpLock(handle).Lock(MUTEX_CONTEXT);
 
             /*
              * We got a receive callback that includes data destined for an
@@ -1266,7 +1274,7 @@ class _UDPEndpoint : public _RemoteEndpoint {
                 QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): ARDP_RecvReady() returns status==\"%s\"", QCC_StatusText(status)));
             }
 #endif
-            m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+            m_transport->ArdpLock(handle).Unlock(MUTEX_CONTEXT);
 
             m_transport->m_endpointListLock.Unlock(MUTEX_CONTEXT);
             DecrementAndFetch(&m_refCount);
@@ -1283,14 +1291,14 @@ class _UDPEndpoint : public _RemoteEndpoint {
             QCC_LogError(ER_UDP_INVALID, ("_UDPEndpoint::RecvCb(): Unexpected rcv->fcnt==%d.", rcv->fcnt));
 
             QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): ARDP_RecvReady()"));
-            m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+            m_transport->ArdpLock(handle).Lock(MUTEX_CONTEXT);
             /*
              * We got a bogus fragment count and so we will assert this is a
              * bogus condition below.  Don't bother printing an error if ARDP
              * also doesn't take the bogus buffers back.
              */
             ARDP_RecvReady(handle, conn, rcv);
-            m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+            m_transport->ArdpLock(handle).Unlock(MUTEX_CONTEXT);
             m_transport->m_endpointListLock.Unlock(MUTEX_CONTEXT);
 
             DecrementAndFetch(&m_refCount);
@@ -1320,14 +1328,14 @@ class _UDPEndpoint : public _RemoteEndpoint {
                     m_transport->m_endpointListLock.Unlock(MUTEX_CONTEXT);
 
                     QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): ARDP_RecvReady()"));
-                    m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+                    m_transport->ArdpLock(handle).Lock(MUTEX_CONTEXT);
                     /*
                      * We got a bogus fragment count and so we will assert this
                      * is a bogus condition below.  Don't bother printing an
                      * error if ARDP also doesn't take the bogus buffers back.
                      */
                     ARDP_RecvReady(handle, conn, rcv);
-                    m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+                    m_transport->ArdpLock(handle).Unlock(MUTEX_CONTEXT);
 
                     DecrementAndFetch(&m_refCount);
                     QCC_ASSERT(false && "_UDPEndpoint::RecvCb(): unexpected rcv->fcnt");
@@ -1401,7 +1409,7 @@ class _UDPEndpoint : public _RemoteEndpoint {
              * If there's some kind of problem, we have to give the buffer
              * back to the protocol now.
              */
-            m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+            m_transport->ArdpLock(handle).Lock(MUTEX_CONTEXT);
 
 #ifndef NDEBUG
             QStatus alternateStatus =
@@ -1412,7 +1420,7 @@ class _UDPEndpoint : public _RemoteEndpoint {
                 QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): ARDP_RecvReady() returns status==\"%s\"", QCC_StatusText(alternateStatus)));
             }
 #endif
-            m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+            m_transport->ArdpLock(handle).Unlock(MUTEX_CONTEXT);
 
             /*
              * If we allocated a reassembly buffer, free it too.
@@ -1460,7 +1468,7 @@ class _UDPEndpoint : public _RemoteEndpoint {
              * If there's some kind of problem, we have to give the buffer
              * back to the protocol now.
              */
-            m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+            m_transport->ArdpLock(handle).Lock(MUTEX_CONTEXT);
 
 #ifndef NDEBUG
             QStatus alternateStatus =
@@ -1472,7 +1480,7 @@ class _UDPEndpoint : public _RemoteEndpoint {
             }
 #endif
 
-            m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+            m_transport->ArdpLock(handle).Unlock(MUTEX_CONTEXT);
 
             /*
              * If we do something that is going to bug the ARDP protocol, we
@@ -1495,7 +1503,7 @@ class _UDPEndpoint : public _RemoteEndpoint {
          * it know that it can reuse the buffer (and open its receive window).
          */
         QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): ARDP_RecvReady()"));
-        m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+        m_transport->ArdpLock(handle).Lock(MUTEX_CONTEXT);
 
 #ifndef NDEBUG
         QStatus alternateStatus =
@@ -1506,7 +1514,7 @@ class _UDPEndpoint : public _RemoteEndpoint {
             QCC_DbgPrintf(("_UDPEndpoint::RecvCb(): ARDP_RecvReady() returns status==\"%s\"", QCC_StatusText(alternateStatus)));
         }
 #endif
-        m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+        m_transport->ArdpLock(handle).Unlock(MUTEX_CONTEXT);
 
         /*
          * If we do something that is going to bug the ARDP protocol, we need to
@@ -1571,7 +1579,7 @@ class _UDPEndpoint : public _RemoteEndpoint {
     {
         QCC_DbgTrace(("_UDPEndpoint::SetConn(conn=%p)", conn));
         m_conn = conn;
-        m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+        m_transport->ArdpLock(m_handle).Lock(MUTEX_CONTEXT);
         uint32_t cid = ARDP_GetConnId(m_handle, conn);
 
 #ifndef NDEBUG
@@ -1581,7 +1589,7 @@ class _UDPEndpoint : public _RemoteEndpoint {
 #endif
 
         SetConnId(cid);
-        m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+        m_transport->ArdpLock(m_handle).Unlock(MUTEX_CONTEXT);
     }
 
     /**
@@ -1659,7 +1667,7 @@ class _UDPEndpoint : public _RemoteEndpoint {
             return ER_UDP_ENDPOINT_NOT_STARTED;
         }
 
-        m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+        m_transport->ArdpLock(GetHandle()).Lock(MUTEX_CONTEXT);
 
         IPEndpoint endpoint;
         QStatus status = ARDP_GetLocalIPEndpointFromConn(GetHandle(), GetConn(), endpoint);
@@ -1667,7 +1675,7 @@ class _UDPEndpoint : public _RemoteEndpoint {
             ipAddrStr = endpoint.addr.ToString();
         }
 
-        m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+        m_transport->ArdpLock(GetHandle()).Unlock(MUTEX_CONTEXT);
         return status;
     };
 
@@ -2460,9 +2468,9 @@ class ArdpStream : public qcc::Stream {
         uint32_t timeout;
         Timespec<MonotonicTime> tStart;
 
-        m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+        m_transport->ArdpLock(m_handle).Lock(MUTEX_CONTEXT);
         timeout = 2 * ARDP_GetDataTimeout(m_handle, m_conn);
-        m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+        m_transport->ArdpLock(m_handle).Unlock(MUTEX_CONTEXT);
 
         GetTimeNow(&tStart);
         QCC_DbgPrintf(("ArdpStream::PushBytes(): Start time is %" PRIu64 ".%03d.", tStart.seconds, tStart.mseconds));
@@ -2579,9 +2587,9 @@ class ArdpStream : public qcc::Stream {
                      * We think everything is up and ready in ARDP-land, so we
                      * can go ahead and start a send.
                      */
-                    m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+                    m_transport->ArdpLock(m_handle).Lock(MUTEX_CONTEXT);
                     status = ARDP_Send(m_handle, m_conn, buffer, numBytes, ttl);
-                    m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+                    m_transport->ArdpLock(m_handle).Unlock(MUTEX_CONTEXT);
                 }
             } else {
                 /*
@@ -2873,10 +2881,10 @@ class ArdpStream : public qcc::Stream {
                      */
                     QCC_ASSERT(status == ER_UDP_LOCAL_DISCONNECT && "ArdpStream::Disconnect(): Unexpected status");
 
-                    m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+                    m_transport->ArdpLock(m_handle).Lock(MUTEX_CONTEXT);
                     QCC_DbgPrintf(("ArdpStream::Disconnect(): ARDP_Disconnect()"));
                     status = ARDP_Disconnect(m_handle, m_conn, m_connId);
-                    m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+                    m_transport->ArdpLock(m_handle).Unlock(MUTEX_CONTEXT);
                     if (status == ER_OK) {
                         m_discSent = true;
                         m_discStatus = ER_UDP_LOCAL_DISCONNECT;
@@ -3176,9 +3184,9 @@ class MessagePump {
         while (m_queue.empty() == false) {
             QueueEntry entry = m_queue.front();
             m_queue.pop();
-            m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+            m_transport->ArdpLock(entry.m_handle).Lock(MUTEX_CONTEXT);
             ARDP_RecvReady(entry.m_handle, entry.m_conn, entry.m_rcv);
-            m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+            m_transport->ArdpLock(entry.m_handle).Unlock(MUTEX_CONTEXT);
         }
 
         QCC_ASSERT(m_queue.empty() && "MessagePump::~MessagePump(): Message queue must be empty here");
@@ -3604,8 +3612,9 @@ QStatus _UDPEndpoint::Start()
             ++found;
         }
     }
-    for (set<UDPEndpoint>::iterator i = m_transport->m_endpointList.begin(); i != m_transport->m_endpointList.end(); ++i) {
-        UDPEndpoint ep = *i;
+    UDPTransport::EndpointConnIdRange range = m_transport->m_endpointConnIdMap.equal_range(GetConnId());
+    for (UDPTransport::EndpointConnIdMap::iterator i = range.first; i != range.second; ++i) {
+        UDPEndpoint ep = i->second;
         if (GetConnId() == ep->GetConnId()) {
             QCC_DbgPrintf(("_UDPEndpoint::Start(): found endpoint with conn ID == %d. on m_endpointList", GetConnId()));
             ++found;
@@ -3745,8 +3754,9 @@ QStatus _UDPEndpoint::Stop()
             ++found;
         }
     }
-    for (set<UDPEndpoint>::iterator i = m_transport->m_endpointList.begin(); i != m_transport->m_endpointList.end(); ++i) {
-        UDPEndpoint ep = *i;
+    UDPTransport::EndpointConnIdRange range = m_transport->m_endpointConnIdMap.equal_range(GetConnId());
+    for (UDPTransport::EndpointConnIdMap::iterator i = range.first; i != range.second; ++i) {
+        UDPEndpoint ep = i->second;
         if (GetConnId() == ep->GetConnId()) {
             QCC_DbgPrintf(("_UDPEndpoint::Stop(): found endpoint with conn ID == %d. on m_endpointList", GetConnId()));
             ++found;
@@ -3965,7 +3975,7 @@ void _UDPEndpoint::CreateStream(ArdpHandle* handle, ArdpConnRecord* conn, uint32
     IncrementAndFetch(&m_refCount);
     QCC_DbgHLPrintf(("_UDPEndpoint::CreateStream(handle=%p, conn=%p)", handle, conn));
 
-    m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+    m_transport->ArdpLock(handle).Lock(MUTEX_CONTEXT);
     QCC_ASSERT(m_stream == NULL && "_UDPEndpoint::CreateStream(): stream already exists");
 
     /*
@@ -3986,7 +3996,7 @@ void _UDPEndpoint::CreateStream(ArdpHandle* handle, ArdpConnRecord* conn, uint32
      * PushMessage() back into the ArdpStream PushBytes().
      */
     SetStream(m_stream);
-    m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+    m_transport->ArdpLock(handle).Unlock(MUTEX_CONTEXT);
     DecrementAndFetch(&m_refCount);
 }
 
@@ -4034,8 +4044,9 @@ void _UDPEndpoint::DisconnectCb(ArdpHandle* handle, ArdpConnRecord* conn, uint32
      * remove the endpoint with threads wandering around in it.
      */
     uint32_t found = 0;
-    for (set<UDPEndpoint>::iterator i = m_transport->m_endpointList.begin(); i != m_transport->m_endpointList.end(); ++i) {
-        UDPEndpoint ep = *i;
+    UDPTransport::EndpointConnIdRange range = m_transport->m_endpointConnIdMap.equal_range(GetConnId());
+    for (UDPTransport::EndpointConnIdMap::iterator i = range.first; i != range.second; ++i) {
+        UDPEndpoint ep = i->second;
         if (GetConnId() == ep->GetConnId()) {
             QCC_ASSERT(connId == GetConnId() && "_UDPEndpoint::DisconnectCb(): Inconsistent connId");
             QCC_DbgPrintf(("_UDPEndpoint::DisconnectCb(): found endpoint with conn ID == %d. on m_endpointList", GetConnId()));
@@ -4172,8 +4183,9 @@ void _UDPEndpoint::SendCb(ArdpHandle* handle, ArdpConnRecord* conn, uint32_t con
      * remove the endpoint with threads wandering around in it.
      */
     uint32_t found = 0;
-    for (set<UDPEndpoint>::iterator i = m_transport->m_endpointList.begin(); i != m_transport->m_endpointList.end(); ++i) {
-        UDPEndpoint ep = *i;
+    UDPTransport::EndpointConnIdRange range = m_transport->m_endpointConnIdMap.equal_range(GetConnId());
+    for (UDPTransport::EndpointConnIdMap::iterator i = range.first; i != range.second; ++i) {
+        UDPEndpoint ep = i->second;
         if (GetConnId() == ep->GetConnId()) {
             QCC_ASSERT(connId == GetConnId() && "_UDPEndpoint::SendCb(): Inconsistent connId");
             QCC_DbgPrintf(("_UDPEndpoint::SendCb(): found endpoint with conn ID == %d. on m_endpointList", GetConnId()));
@@ -4292,8 +4304,9 @@ ThreadReturn STDCALL MessagePump::PumpThread::Run(void* arg)
              */
             bool handled = false;
             m_pump->m_transport->m_endpointListLock.Lock(MUTEX_CONTEXT);
-            for (set<UDPEndpoint>::iterator i = m_pump->m_transport->m_endpointList.begin(); i != m_pump->m_transport->m_endpointList.end(); ++i) {
-                UDPEndpoint ep = *i;
+            UDPTransport::EndpointConnIdRange range = m_pump->m_transport->m_endpointConnIdMap.equal_range(entry.m_connId);
+            for (UDPTransport::EndpointConnIdMap::iterator i = range.first; i != range.second; ++i) {
+                UDPEndpoint ep = i->second;
                 if (entry.m_connId == ep->GetConnId()) {
                     QCC_DbgPrintf(("MessagePump::PumpThread::Run(): found endpoint with conn ID == %d. on m_endpointList", entry.m_connId));
                     /*
@@ -4341,9 +4354,9 @@ ThreadReturn STDCALL MessagePump::PumpThread::Run(void* arg)
 #if RETURN_ORPHAN_BUFS
 
                 QCC_DbgPrintf(("MessagePump::PumpThread::Run(): Unable to find endpoint with conn ID == %d. on m_endpointList", entry.m_connId));
-                m_pump->m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+                m_pump->m_transport->ArdpLock(entry.m_handle).Lock(MUTEX_CONTEXT);
                 ARDP_RecvReady(entry.m_handle, entry.m_conn, entry.m_rcv);
-                m_pump->m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+                m_pump->m_transport->ArdpLock(entry.m_handle).Unlock(MUTEX_CONTEXT);
 
 #else // not RETURN_ORPHAN_BUFS
 
@@ -4424,10 +4437,9 @@ UDPTransport::UDPTransport(BusAttachment& bus) :
     m_authTimeout(0), m_sessionSetupTimeout(0),
     m_maxAuth(0), m_maxConn(0), m_currAuth(0), m_currConn(0),
     m_connLock(LOCK_LEVEL_UDPTRANSPORT_CONNLOCK), m_dynamicScoreUpdater(*this),
-    /* Workaround for known deadlock prediction break ASACORE-2678 */
-    m_ardpLock(LOCK_LEVEL_CHECKING_DISABLED),
+    m_ardpConnectShard(0),
     m_cbLock(LOCK_LEVEL_UDPTRANSPORT_CBLOCK),
-    m_handle(NULL), m_dispatcher(NULL), m_exitDispatcher(NULL),
+    m_dispatcher(NULL), m_exitDispatcher(NULL),
     m_workerCommandQueue(), m_workerCommandQueueLock(LOCK_LEVEL_UDPTRANSPORT_WORKERCOMMANDQUEUELOCK),
     m_exitWorkerCommandQueue(), m_exitWorkerCommandQueueLock(LOCK_LEVEL_UDPTRANSPORT_EXITWORKERCOMMANDQUEUELOCK)
 #if WORKAROUND_1298
@@ -4491,44 +4503,58 @@ UDPTransport::UDPTransport(BusAttachment& bus) :
 
     /*
      * Initialize the hooks to and from the ARDP protocol.  Note that
-     * ARDP_AllocHandle is expected to "never fail."
-     */
-    m_ardpLock.Lock(MUTEX_CONTEXT);
-    m_handle = ARDP_AllocHandle(&ardpConfig);
-    ARDP_SetHandleContext(m_handle, this);
-    ARDP_SetAcceptCb(m_handle, ArdpAcceptCb);
-    ARDP_SetConnectCb(m_handle, ArdpConnectCb);
-    ARDP_SetDisconnectCb(m_handle, ArdpDisconnectCb);
-    ARDP_SetRecvCb(m_handle, ArdpRecvCb);
-    ARDP_SetSendCb(m_handle, ArdpSendCb);
-    ARDP_SetSendWindowCb(m_handle, ArdpSendWindowCb);
+     * ARDP_AllocHandle is expected to "never fail."  Each ARDP instance owns
+     * its own partition of the ARDP local ports so that the main thread can
+     * route inbound datagrams to it.  Local ports are 16 bits, so there is no
+     * point in more instances than there are ports to go round.
+     */
+    uint32_t numShards = config->GetLimit("udp_ardp_shards", UDP_ARDP_SHARDS);
+    if (numShards == 0 || numShards > UDP_ARDP_SHARDS_MAX) {
+        QCC_LogError(ER_INVALID_CONFIG, ("UDPTransport::UDPTransport(): udp_ardp_shards (%d) out of range ignored", numShards));
+        numShards = UDP_ARDP_SHARDS;
+    }
+
+    for (uint32_t i = 0; i < numShards; ++i) {
+        ArdpShard* shard = new ArdpShard(this);
+        shard->m_lock.Lock(MUTEX_CONTEXT);
+        shard->m_handle = ARDP_AllocHandle(&ardpConfig);
+        ARDP_SetHandleContext(shard->m_handle, shard);
+        ARDP_SetLocalPortPartition(shard->m_handle, i, numShards);
+        ARDP_SetAcceptCb(shard->m_handle, ArdpAcceptCb);
+        ARDP_SetConnectCb(shard->m_handle, ArdpConnectCb);
+        ARDP_SetDisconnectCb(shard->m_handle, ArdpDisconnectCb);
+        ARDP_SetRecvCb(shard->m_handle, ArdpRecvCb);
+        ARDP_SetSendCb(shard->m_handle, ArdpSendCb);
+        ARDP_SetSendWindowCb(shard->m_handle, ArdpSendWindowCb);
 
 #if ARDP_TESTHOOKS
-    /*
-     * Initialize some testhooks as an example of how to do this.
-     */
-    ARDP_HookSendToSG(m_handle, ArdpSendToSGHook);
-    ARDP_HookSendTo(m_handle, ArdpSendToHook);
-    ARDP_HookRecvFrom(m_handle, ArdpRecvFromHook);
+        /*
+         * Initialize some testhooks as an example of how to do this.
+         */
+        ARDP_HookSendToSG(shard->m_handle, ArdpSendToSGHook);
+        ARDP_HookSendTo(shard->m_handle, ArdpSendToHook);
+        ARDP_HookRecvFrom(shard->m_handle, ArdpRecvFromHook);
 #endif
 
-    /*
-     * Call into ARDP and ask it to start accepting connections passively.
-     * Since we are running in a constructor, there's not much we can do if it
-     * fails.
-     */
+        /*
+         * Call into ARDP and ask it to start accepting connections passively.
+         * Since we are running in a constructor, there's not much we can do if
+         * it fails.
+         */
 #ifndef NDEBUG
-    QStatus status =
+        QStatus status =
 #endif
-    ARDP_StartPassive(m_handle);
+        ARDP_StartPassive(shard->m_handle);
 
 #ifndef NDEBUG
-    if (status != ER_OK) {
-        QCC_DbgPrintf(("UDPTransport::UDPTransport(): ARDP_StartPassive() returns status==\"%s\"", QCC_StatusText(status)));
-    }
+        if (status != ER_OK) {
+            QCC_DbgPrintf(("UDPTransport::UDPTransport(): ARDP_StartPassive() returns status==\"%s\"", QCC_StatusText(status)));
+        }
 #endif
 
-    m_ardpLock.Unlock(MUTEX_CONTEXT);
+        shard->m_lock.Unlock(MUTEX_CONTEXT);
+        m_ardpShards.push_back(shard);
+    }
 }
 
 /**
@@ -4547,8 +4573,11 @@ UDPTransport::~UDPTransport()
         m_messagePumps[i] = NULL;
     }
 
-    ARDP_FreeHandle(m_handle);
-    m_handle = NULL;
+    for (vector<ArdpShard*>::iterator i = m_ardpShards.begin(); i != m_ardpShards.end(); ++i) {
+        ARDP_FreeHandle((*i)->m_handle);
+        delete *i;
+    }
+    m_ardpShards.clear();
 
     QCC_DbgPrintf(("UDPTransport::~UDPTransport(): m_mAuthList.size() == %d", m_authList.size()));
     QCC_DbgPrintf(("UDPTransport::~UDPTransport(): m_mEndpointList.size() == %d", m_endpointList.size()));
@@ -4676,8 +4705,9 @@ ThreadReturn STDCALL UDPTransport::DispatcherThread::Run(void* arg)
                 } else {
                     bool haveLock = true;
                     m_transport->m_endpointListLock.Lock(MUTEX_CONTEXT);
-                    for (set<UDPEndpoint>::iterator i = m_transport->m_endpointList.begin(); i != m_transport->m_endpointList.end(); ++i) {
-                        UDPEndpoint ep = *i;
+                    EndpointConnIdRange range = m_transport->m_endpointConnIdMap.equal_range(entry.m_connId);
+                    for (EndpointConnIdMap::iterator i = range.first; i != range.second; ++i) {
+                        UDPEndpoint ep = i->second;
                         if (entry.m_connId == ep->GetConnId()) {
                             /*
                              * We can't call out to some possibly windy code path
@@ -4844,7 +4874,7 @@ ThreadReturn STDCALL UDPTransport::DispatcherThread::Run(void* arg)
                                  * if that happens.
                                  */
                                 QCC_DbgPrintf(("UDPTransport::DispatcherThread::Run(): Orphaned RECV_CB: ARDP_RecvReady()"));
-                                m_transport->m_ardpLock.Lock(MUTEX_CONTEXT);
+                                m_transport->ArdpLock(entry.m_handle).Lock(MUTEX_CONTEXT);
 
 #ifndef NDEBUG
                                 QStatus alternateStatus =
@@ -4855,7 +4885,7 @@ ThreadReturn STDCALL UDPTransport::DispatcherThread::Run(void* arg)
                                     QCC_DbgPrintf(("UDPTransport::DispatcherThread::Run(): ARDP_RecvReady() returns status==\"%s\"", QCC_StatusText(alternateStatus)));
                                 }
 #endif
-                                m_transport->m_ardpLock.Unlock(MUTEX_CONTEXT);
+                                m_transport->ArdpLock(entry.m_handle).Unlock(MUTEX_CONTEXT);
 #else // not RETURN_ORPHAN_BUFS
                                 /*
                                  * If we get here, we have a receive callback
@@ -4974,8 +5004,9 @@ ThreadReturn STDCALL UDPTransport::ExitDispatcherThread::Run(void* arg)
                 } else {
                     bool haveLock = true;
                     m_transport->m_endpointListLock.Lock(MUTEX_CONTEXT);
-                    for (set<UDPEndpoint>::iterator i = m_transport->m_endpointList.begin(); i != m_transport->m_endpointList.end(); ++i) {
-                        UDPEndpoint ep = *i;
+                    EndpointConnIdRange range = m_transport->m_endpointConnIdMap.equal_range(entry.m_connId);
+                    for (EndpointConnIdMap::iterator i = range.first; i != range.second; ++i) {
+                        UDPEndpoint ep = i->second;
                         if (entry.m_connId == ep->GetConnId()) {
                             /*
                              * We can't call out to some possibly windy code path
@@ -5366,7 +5397,7 @@ QStatus UDPTransport::Join(void)
          * Stop()ped.
          */
         if (entry.m_command == WorkerCommandQueueEntry::RECV_CB) {
-            m_ardpLock.Lock(MUTEX_CONTEXT);
+            ArdpLock(entry.m_handle).Lock(MUTEX_CONTEXT);
 
 #ifndef NDEBUG
             QStatus alternateStatus =
@@ -5377,7 +5408,7 @@ QStatus UDPTransport::Join(void)
                 QCC_DbgPrintf(("UDPTransport::Join(): ARDP_RecvReady() returns status==\"%s\"", QCC_StatusText(alternateStatus)));
             }
 #endif
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            ArdpLock(entry.m_handle).Unlock(MUTEX_CONTEXT);
         }
 
         /*
@@ -5534,7 +5565,7 @@ QStatus UDPTransport::Join(void)
          * the total connection count.  Update that count.
          */
         m_connLock.Lock(MUTEX_CONTEXT);
-        m_endpointList.erase(i);
+        EndpointListErase(i);
         --m_currConn;
         m_connLock.Unlock(MUTEX_CONTEXT);
     }
@@ -6030,7 +6061,7 @@ void UDPTransport::ManageEndpoints(uint32_t authTimeout, uint32_t sessionSetupTi
             ep->SetEpWaitEnable(false);
             ep->Stop();
             QCC_DbgPrintf(("UDPTransport::ManageEndpoints(): Moving endpoint with connId == %d. from m_authList to m_endpointList", ep->GetConnId()));
-            m_endpointList.insert(ep);
+            EndpointListInsert(ep);
             m_authList.erase(i);
             i = m_authList.begin();
         }
@@ -6119,7 +6150,7 @@ void UDPTransport::ManageEndpoints(uint32_t authTimeout, uint32_t sessionSetupTi
                 ep->SetEpWaitEnable(false);
                 ep->Stop();
                 QCC_DbgPrintf(("UDPTransport::ManageEndpoints(): Moving endpoint with connId == %d. from m_authList to m_endpointList", ep->GetConnId()));
-                m_endpointList.insert(ep);
+                EndpointListInsert(ep);
                 --m_currAuth;
                 m_connLock.Unlock(MUTEX_CONTEXT);
                 ep->StateUnlock(MUTEX_CONTEXT);
@@ -6526,7 +6557,7 @@ void UDPTransport::ManageEndpoints(uint32_t authTimeout, uint32_t sessionSetupTi
                      * count.
                      */
                     m_connLock.Lock(MUTEX_CONTEXT);
-                    m_endpointList.erase(i);
+                    EndpointListErase(i);
                     --m_currConn;
                     m_connLock.Unlock(MUTEX_CONTEXT);
 
@@ -6612,7 +6643,7 @@ bool UDPTransport::ArdpAcceptCb(ArdpHandle* ardpHandle, qcc::IPAddress ipAddr, u
 {
     QCC_DbgTrace(("UDPTransport::ArdpAcceptCb(handle=%p, ipAddr=\"%s\", port=%d., conn=%p, buf =%p, len = %d)",
                   ardpHandle, ipAddr.ToString().c_str(), ipPort, conn, buf, len));
-    UDPTransport* const transport = static_cast<UDPTransport* const>(ARDP_GetHandleContext(ardpHandle));
+    UDPTransport* const transport = static_cast<ArdpShard*>(ARDP_GetHandleContext(ardpHandle))->m_transport;
     return transport->AcceptCb(ardpHandle, ipAddr, ipPort, conn, buf, len, status);
 }
 
@@ -6630,7 +6661,7 @@ void UDPTransport::ArdpConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, b
 {
     QCC_DbgTrace(("UDPTransport::ArdpConnectCb(handle=%p, conn=%p, passive=%s, buf = %p, len = %d, status=%s)",
                   ardpHandle, conn, passive ? "true" : "false", buf, len, QCC_StatusText(status)));
-    UDPTransport* const transport = static_cast<UDPTransport* const>(ARDP_GetHandleContext(ardpHandle));
+    UDPTransport* const transport = static_cast<ArdpShard*>(ARDP_GetHandleContext(ardpHandle))->m_transport;
     transport->ConnectCb(ardpHandle, conn, passive, buf, len, status);
 }
 
@@ -6647,7 +6678,7 @@ void UDPTransport::ArdpConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, b
 void UDPTransport::ArdpDisconnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, QStatus status)
 {
     QCC_DbgTrace(("UDPTransport::ArdpDisconnectCb(handle=%p, conn=%p, status=\"%s\")", ardpHandle, conn, QCC_StatusText(status)));
-    UDPTransport* const transport = static_cast<UDPTransport* const>(ARDP_GetHandleContext(ardpHandle));
+    UDPTransport* const transport = static_cast<ArdpShard*>(ARDP_GetHandleContext(ardpHandle))->m_transport;
     transport->DisconnectCb(ardpHandle, conn, status);
 }
 
@@ -6665,7 +6696,7 @@ void UDPTransport::ArdpRecvCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, Ardp
 {
     QCC_DbgTrace(("UDPTransport::ArdpRecvCb(handle=%p, conn=%p, buf=%p, status=%s)",
                   ardpHandle, conn, rcv, QCC_StatusText(status)));
-    UDPTransport* const transport = static_cast<UDPTransport* const>(ARDP_GetHandleContext(ardpHandle));
+    UDPTransport* const transport = static_cast<ArdpShard*>(ARDP_GetHandleContext(ardpHandle))->m_transport;
     transport->RecvCb(ardpHandle, conn, rcv, status);
 }
 
@@ -6682,7 +6713,7 @@ void UDPTransport::ArdpRecvCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, Ardp
 void UDPTransport::ArdpSendCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uint8_t* buf, uint32_t len, QStatus status)
 {
     QCC_DbgTrace(("UDPTransport::ArdpSendCb(handle=%p, conn=%p, buf=%p, len=%d.)", ardpHandle, conn, buf, len));
-    UDPTransport* const transport = static_cast<UDPTransport* const>(ARDP_GetHandleContext(ardpHandle));
+    UDPTransport* const transport = static_cast<ArdpShard*>(ARDP_GetHandleContext(ardpHandle))->m_transport;
     transport->SendCb(ardpHandle, conn, buf, len, status);
 }
 
@@ -6699,7 +6730,7 @@ void UDPTransport::ArdpSendCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uint
 void UDPTransport::ArdpSendWindowCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uint16_t window, QStatus status)
 {
     QCC_DbgTrace(("UDPTransport::ArdpSendWindowCb(handle=%p, conn=%p, window=%d.)", ardpHandle, conn, window));
-    UDPTransport* const transport = static_cast<UDPTransport* const>(ARDP_GetHandleContext(ardpHandle));
+    UDPTransport* const transport = static_cast<ArdpShard*>(ARDP_GetHandleContext(ardpHandle))->m_transport;
     transport->SendWindowCb(ardpHandle, conn, window, status);
 }
 
@@ -7231,6 +7262,113 @@ bool UDPTransport::AcceptCb(ArdpHandle* ardpHandle, qcc::IPAddress ipAddr, uint1
     return true;
 }
 
+void UDPTransport::EndpointListInsert(UDPEndpoint ep)
+{
+    QCC_DbgTrace(("UDPTransport::EndpointListInsert(): conn ID == %d.", ep->GetConnId()));
+    m_endpointList.insert(ep);
+    std::pair<EndpointConnIdMap::iterator, bool> ins = m_endpointConnIdMap.insert(EndpointConnIdMap::value_type(ep->GetConnId(), ep));
+    if (!ins.second) {
+        ins.first->second = ep;
+    }
+}
+
+void UDPTransport::EndpointListErase(set<UDPEndpoint>::iterator i)
+{
+    UDPEndpoint ep = *i;
+    QCC_DbgTrace(("UDPTransport::EndpointListErase(): conn ID == %d.", ep->GetConnId()));
+
+    /*
+     * Only drop the index entry if it refers to this endpoint; a stale endpoint
+     * must not take the entry of a newer endpoint with the same connection ID.
+     */
+    EndpointConnIdMap::iterator j = m_endpointConnIdMap.find(ep->GetConnId());
+    if (j != m_endpointConnIdMap.end() && j->second.iden(ep)) {
+        m_endpointConnIdMap.erase(j);
+    }
+    m_endpointList.erase(i);
+}
+
+qcc::Mutex& UDPTransport::ArdpLock(ArdpHandle* handle)
+{
+    QCC_ASSERT(handle != NULL);
+    ArdpShard* shard = static_cast<ArdpShard*>(ARDP_GetHandleContext(handle));
+    QCC_ASSERT(shard != NULL && shard->m_transport == this && shard->m_handle == handle);
+    return shard->m_lock;
+}
+
+uint32_t UDPTransport::ArdpShardIndex(uint8_t* buf, uint16_t len, uint16_t remotePort, uint32_t numShards)
+{
+    uint16_t local, foreign;
+    ARDP_Demux(buf, len, &local, &foreign);
+    return local ? (local % numShards) : ((foreign ^ remotePort) % numShards);
+}
+
+QStatus UDPTransport::ArdpRun(qcc::SocketFd sock, bool readReady, bool writeReady, uint32_t* ms)
+{
+    /*
+     * With a single ARDP instance let it read the socket itself, exactly as
+     * if it were the only user of the socket.
+     */
+    uint32_t numShards = m_ardpShards.size();
+    if (numShards == 1) {
+        ArdpShard* shard = m_ardpShards[0];
+        shard->m_lock.Lock(MUTEX_CONTEXT);
+        QStatus status = ARDP_Run(shard->m_handle, sock, readReady, writeReady, ms);
+        shard->m_lock.Unlock(MUTEX_CONTEXT);
+        return status;
+    }
+
+    /*
+     * Otherwise we read the datagrams and deliver each of them to the instance
+     * that owns it, see ArdpShardIndex(), holding only that instance's lock.
+     */
+    if (readReady) {
+        const size_t bufferSize = 65536;  /* UDP packet can be up to 64K long */
+        if (m_ardpRecvBatch.empty()) {
+            m_ardpRecvBatch.resize(UDP_ARDP_RECV_BATCH);
+            m_ardpRecvBuffers.resize(UDP_ARDP_RECV_BATCH * bufferSize);
+            for (size_t i = 0; i < m_ardpRecvBatch.size(); ++i) {
+                m_ardpRecvBatch[i].buf = &m_ardpRecvBuffers[i * bufferSize];
+                m_ardpRecvBatch[i].len = bufferSize;
+            }
+        }
+
+        size_t count;
+        while (qcc::RecvFromBatch(sock, &m_ardpRecvBatch[0], m_ardpRecvBatch.size(), count) == ER_OK) {
+            for (size_t i = 0; i < count; ++i) {
+                qcc::RecvFromEntry& entry = m_ardpRecvBatch[i];
+                if (entry.received == 0 || entry.received >= bufferSize) {
+                    QCC_DbgHLPrintf(("UDPTransport::ArdpRun(): Socket read failed (nbytes = %d)", entry.received));
+                    continue;
+                }
+
+                uint8_t* buf = static_cast<uint8_t*>(entry.buf);
+                ArdpShard* shard = m_ardpShards[ArdpShardIndex(buf, entry.received, entry.remotePort, numShards)];
+                shard->m_lock.Lock(MUTEX_CONTEXT);
+                ARDP_Deliver(shard->m_handle, sock, entry.remoteAddr, entry.remotePort, buf, entry.received);
+                shard->m_lock.Unlock(MUTEX_CONTEXT);
+            }
+            if (count < m_ardpRecvBatch.size()) {
+                break;
+            }
+        }
+    }
+
+    QStatus status = ER_OK;
+    *ms = ARDP_NO_TIMEOUT;
+    for (vector<ArdpShard*>::iterator i = m_ardpShards.begin(); i != m_ardpShards.end(); ++i) {
+        uint32_t shardMs;
+        (*i)->m_lock.Lock(MUTEX_CONTEXT);
+        QStatus shardStatus = ARDP_Run((*i)->m_handle, sock, false, writeReady, &shardMs);
+        (*i)->m_lock.Unlock(MUTEX_CONTEXT);
+        if (shardStatus == ER_ARDP_WRITE_BLOCKED) {
+            status = shardStatus;
+        }
+        *ms = std::min(*ms, shardMs);
+    }
+    return status;
+}
+
 #ifndef NDEBUG
 void UDPTransport::DebugAuthListCheck(UDPEndpoint uep)
 {
@@ -7250,8 +7388,9 @@ void UDPTransport::DebugEndpointListCheck(UDPEndpoint uep)
 {
     QCC_DbgTrace(("UDPTransport::DebugEndpointListCheck()"));
     m_endpointListLock.Lock(MUTEX_CONTEXT);
-    for (set<UDPEndpoint>::iterator i = m_endpointList.begin(); i != m_endpointList.end(); ++i) {
-        UDPEndpoint ep = *i;
+    EndpointConnIdRange range = m_endpointConnIdMap.equal_range(uep->GetConnId());
+    for (EndpointConnIdMap::iterator i = range.first; i != range.second; ++i) {
+        UDPEndpoint ep = i->second;
         if (uep->GetConnId() == ep->GetConnId()) {
             QCC_DbgPrintf(("UDPTransport::DebugEndpointListCheck(): Endpoint with conn ID == %d. already on m_endpointList", uep->GetConnId()));
             QCC_ASSERT(0 && "UDPTransport::DebugAuthListCheck(): Endpoint already on m_endpointList");
@@ -7413,9 +7552,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
          * return since it is pointless to continue to bring up something that
          * will be unusable.
          */
-        m_ardpLock.Lock(MUTEX_CONTEXT);
-        uint32_t cidFromConn = ARDP_GetConnId(m_handle, conn);
-        m_ardpLock.Unlock(MUTEX_CONTEXT);
+        ArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
+        uint32_t cidFromConn = ARDP_GetConnId(ardpHandle, conn);
+        ArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
         if (cidFromConn == ARDP_CONN_ID_INVALID) {
             DecrementAndFetch(&m_refCount);
             return;
@@ -7431,9 +7570,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
              * this endpoint.  Ignore it.  If it was the one referred to by the
              * now defunct conn, it will time out on its own.
              */
-            m_ardpLock.Lock(MUTEX_CONTEXT);
-            uint32_t cidFromEp = ARDP_GetConnId(m_handle, ep->GetConn());
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            ArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
+            uint32_t cidFromEp = ARDP_GetConnId(ardpHandle, ep->GetConn());
+            ArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
             if (cidFromEp == ARDP_CONN_ID_INVALID) {
                 continue;
             }
@@ -7457,7 +7596,7 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
                 DebugEndpointListCheck(ep);
 #endif
                 QCC_DbgPrintf(("UDPTransport::DoConnectCb(): Adding endpoint with connId == %d. to m_endpointList", ep->GetConnId()));
-                m_endpointList.insert(ep);
+                EndpointListInsert(ep);
                 m_connLock.Unlock(MUTEX_CONTEXT);
 
                 QCC_DbgPrintf(("UDPTransport::DoConnectCb(): Start()ing endpoint with conn ID == %d.", connId));
@@ -7510,9 +7649,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
                     m_endpointListLock.Unlock(MUTEX_CONTEXT);
                     haveLock = false;
 
-                    m_ardpLock.Lock(MUTEX_CONTEXT);
+                    ArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
                     ARDP_ReleaseConnection(ardpHandle, conn);
-                    m_ardpLock.Unlock(MUTEX_CONTEXT);
+                    ArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
                     m_manage = UDPTransport::STATE_MANAGE;
                     Alert();
                 }
@@ -7551,10 +7690,10 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
          * be valid.
          */
         QCC_DbgPrintf(("UDPTransport::DoConnectCb(): active connection callback with conn ID == %d.", connId));
-        m_ardpLock.Lock(MUTEX_CONTEXT);
-        bool connValid = ARDP_IsConnValid(m_handle, conn, connId);
-        qcc::Event* event = static_cast<qcc::Event*>(ARDP_GetConnContext(m_handle, conn));
-        m_ardpLock.Unlock(MUTEX_CONTEXT);
+        ArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
+        bool connValid = ARDP_IsConnValid(ardpHandle, conn, connId);
+        qcc::Event* event = static_cast<qcc::Event*>(ARDP_GetConnContext(ardpHandle, conn));
+        ArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
         /*
          * We need to remember in the following code that we have a contract
@@ -7626,9 +7765,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
         if (eventValid == false) {
             QCC_LogError(status, ("UDPTransport::DoConnectCb(): No thread waiting for Connect() to complete"));
             m_endpointListLock.Unlock(MUTEX_CONTEXT);
-            m_ardpLock.Lock(MUTEX_CONTEXT);
+            ArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
             ARDP_ReleaseConnection(ardpHandle, conn);
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            ArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
             m_connLock.Lock(MUTEX_CONTEXT);
             --m_currAuth;
@@ -7648,9 +7787,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
             QCC_LogError(status, ("UDPTransport::DoConnectCb(): Connect error"));
             event->SetEvent();
             m_endpointListLock.Unlock(MUTEX_CONTEXT);
-            m_ardpLock.Lock(MUTEX_CONTEXT);
+            ArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
             ARDP_ReleaseConnection(ardpHandle, conn);
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            ArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
             m_connLock.Lock(MUTEX_CONTEXT);
             --m_currAuth;
@@ -7670,9 +7809,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
             QCC_LogError(ER_UDP_INVALID, ("UDPTransport::DoConnectCb(): No BusHello reply with SYN + ACK"));
             event->SetEvent();
             m_endpointListLock.Unlock(MUTEX_CONTEXT);
-            m_ardpLock.Lock(MUTEX_CONTEXT);
+            ArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
             ARDP_ReleaseConnection(ardpHandle, conn);
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            ArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
             m_connLock.Lock(MUTEX_CONTEXT);
             --m_currAuth;
@@ -7693,9 +7832,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
             QCC_LogError(status, ("UDPTransport::DoConnectCb(): Can't Unmarhsal() BusHello Reply Message"));
             event->SetEvent();
             m_endpointListLock.Unlock(MUTEX_CONTEXT);
-            m_ardpLock.Lock(MUTEX_CONTEXT);
+            ArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
             ARDP_ReleaseConnection(ardpHandle, conn);
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            ArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
             m_connLock.Lock(MUTEX_CONTEXT);
             --m_currAuth;
@@ -7721,9 +7860,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
             QCC_LogError(status, ("UDPTransport::DoConnectCb(): Can't Unmarhsal() BusHello Message"));
             event->SetEvent();
             m_endpointListLock.Unlock(MUTEX_CONTEXT);
-            m_ardpLock.Lock(MUTEX_CONTEXT);
+            ArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
             ARDP_ReleaseConnection(ardpHandle, conn);
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            ArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
             m_connLock.Lock(MUTEX_CONTEXT);
             --m_currAuth;
@@ -7743,9 +7882,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
             QCC_LogError(status, ("UDPTransport::DoConnectCb(): Response was not a reply Message"));
             event->SetEvent();
             m_endpointListLock.Unlock(MUTEX_CONTEXT);
-            m_ardpLock.Lock(MUTEX_CONTEXT);
+            ArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
             ARDP_ReleaseConnection(ardpHandle, conn);
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            ArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
             m_connLock.Lock(MUTEX_CONTEXT);
             --m_currAuth;
@@ -7770,9 +7909,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
             QCC_LogError(status, ("UDPTransport::DoConnectCb(): Can't UnmarhsalArgs() BusHello Reply Message"));
             event->SetEvent();
             m_endpointListLock.Unlock(MUTEX_CONTEXT);
-            m_ardpLock.Lock(MUTEX_CONTEXT);
+            ArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
             ARDP_ReleaseConnection(ardpHandle, conn);
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            ArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
             m_connLock.Lock(MUTEX_CONTEXT);
             --m_currAuth;
@@ -7798,9 +7937,9 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
             QCC_LogError(status, ("UDPTransport::DoConnectCb(): Unexpected number or type of arguments in BusHello Reply Message"));
             event->SetEvent();
             m_endpointListLock.Unlock(MUTEX_CONTEXT);
-            m_ardpLock.Lock(MUTEX_CONTEXT);
+            ArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
             ARDP_ReleaseConnection(ardpHandle, conn);
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
+            ArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
             m_connLock.Lock(MUTEX_CONTEXT);
             --m_currAuth;
@@ -7824,10 +7963,10 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
          * We have everything we need to start up, so it is now time to create
          * our new endpoint.
          */
-        m_ardpLock.Lock(MUTEX_CONTEXT);
+        ArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
         qcc::IPEndpoint endpoint;
         ARDP_GetRemoteIPEndpointFromConn(ardpHandle, conn, endpoint);
-        m_ardpLock.Unlock(MUTEX_CONTEXT);
+        ArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
         static const bool truthiness = true;
         UDPTransport* ptr = this;
@@ -7916,7 +8055,7 @@ void UDPTransport::DoConnectCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, uin
          */
         udpEp->SetEpActiveStarted();
         QCC_DbgPrintf(("UDPTransport::DoConnectCb(): adding endpoint with connId == %d. to m_endpointList", udpEp->GetConnId()));
-        m_endpointList.insert(udpEp);
+        EndpointListInsert(udpEp);
         m_connLock.Unlock(MUTEX_CONTEXT);
 
         /*
@@ -8215,9 +8354,9 @@ void UDPTransport::RecvCb(ArdpHandle* ardpHandle, ArdpConnRecord* conn, ArdpRcvB
 #if RETURN_ORPHAN_BUFS
 
         QCC_DbgPrintf(("UDPTransport::RecvCb(): ARDP_RecvReady()"));
-        m_ardpLock.Lock(MUTEX_CONTEXT);
+        ArdpLock(ardpHandle).Lock(MUTEX_CONTEXT);
         ARDP_RecvReady(ardpHandle, conn, rcv);
-        m_ardpLock.Unlock(MUTEX_CONTEXT);
+        ArdpLock(ardpHandle).Unlock(MUTEX_CONTEXT);
 
 #else // not RETURN_ORPHAN_BUFS
 
@@ -8659,13 +8798,11 @@ void* UDPTransport::Run(void* arg)
 
             uint32_t ms;
             QStatus ardpStatus;
-            m_ardpLock.Lock(MUTEX_CONTEXT);
             if (socketReady) {
-                ardpStatus = ARDP_Run(m_handle, (*i)->GetFD(), readReady, writeReady, &ms);
+                ardpStatus = ArdpRun((*i)->GetFD(), readReady, writeReady, &ms);
             } else {
-                ardpStatus = ARDP_Run(m_handle, qcc::INVALID_SOCKET_FD, false, false, &ms);
+                ardpStatus = ArdpRun(qcc::INVALID_SOCKET_FD, false, false, &ms);
             }
-            m_ardpLock.Unlock(MUTEX_CONTEXT);
 
             /*
              * Every time we call ARDP_Run(), it lets us know when its next
@@ -10117,11 +10254,15 @@ QStatus UDPTransport::Connect(const char* connectSpec, const SessionOpts& opts,
      * to do it.  It's also a common operation for our main thread to take the
      * ARDP lock and call into ARDP which calls out in a callback
      * and   We'll keep that order.
+     *
+     * Outbound connections are spread over the ARDP instances round-robin;
+     * inbound connections land wherever the main thread routes their SYN.
      */
+    ArdpShard* shard = m_ardpShards[static_cast<uint32_t>(IncrementAndFetch(&m_ardpConnectShard)) % m_ardpShards.size()];
     m_endpointListLock.Lock(MUTEX_CONTEXT);
-    m_ardpLock.Lock(MUTEX_CONTEXT);
+    shard->m_lock.Lock(MUTEX_CONTEXT);
     QCC_DbgPrintf(("UDPTransport::Connect(): ARDP_Connect()"));
-    status = ARDP_Connect(m_handle, sock, ipAddr, ipPort, m_ardpConfig.segmax, m_ardpConfig.segbmax, &conn, buf, buflen, &event);
+    status = ARDP_Connect(shard->m_handle, sock, ipAddr, ipPort, m_ardpConfig.segmax, m_ardpConfig.segbmax, &conn, buf, buflen, &event);
 
     /*
      * The ARDP code takes the hello buffer and copies it into its internal
@@ -10139,7 +10280,7 @@ QStatus UDPTransport::Connect(const char* connectSpec, const SessionOpts& opts,
     if (status != ER_OK) {
         QCC_ASSERT(conn == NULL && "UDPTransport::Connect(): ARDP_Connect() failed but returned ArdpConnRecord");
         QCC_LogError(status, ("UDPTransport::Connect(): ARDP_Connect() failed"));
-        m_ardpLock.Unlock(MUTEX_CONTEXT);
+        shard->m_lock.Unlock(MUTEX_CONTEXT);
         m_endpointListLock.Unlock(MUTEX_CONTEXT);
 
         m_connLock.Lock(MUTEX_CONTEXT);
@@ -10166,7 +10307,7 @@ QStatus UDPTransport::Connect(const char* connectSpec, const SessionOpts& opts,
     Thread* thread = GetThread();
     QCC_DbgPrintf(("UDPTransport::Connect(): Add thread=%p to m_connectThreads", thread));
     QCC_ASSERT(thread && "UDPTransport::Connect(): GetThread() returns NULL");
-    uint32_t cid = ARDP_GetConnId(m_handle, conn);
+    uint32_t cid = ARDP_GetConnId(shard->m_handle, conn);
     ConnectEntry entry(thread, conn, cid, &event);
 
     /*
@@ -10208,7 +10349,7 @@ QStatus UDPTransport::Connect(const char* connectSpec, const SessionOpts& opts,
     /*
      * All done with the tricky part, so release the locks in inverse order
      */
-    m_ardpLock.Unlock(MUTEX_CONTEXT);
+    shard->m_lock.Unlock(MUTEX_CONTEXT);
     m_endpointListLock.Unlock(MUTEX_CONTEXT);
 
     /*
@@ -10318,9 +10459,9 @@ QStatus UDPTransport::Connect(const char* connectSpec, const SessionOpts& opts,
      * we were worried about.
      */
     QCC_DbgPrintf(("UDPTransport::Connect(): Finding endpoint with conn ID = %d. in m_endpointList", cid));
-    set<UDPEndpoint>::iterator i;
-    for (i = m_endpointList.begin(); i != m_endpointList.end(); ++i) {
-        UDPEndpoint ep = *i;
+    EndpointConnIdRange range = m_endpointConnIdMap.equal_range(cid);
+    for (EndpointConnIdMap::iterator i = range.first; i != range.second; ++i) {
+        UDPEndpoint ep = i->second;
         if (ep->GetConnId() == cid) {
             QCC_DbgPrintf(("UDPTransport::Connect(): Success."));
             /*
@@ -29,6 +29,8 @@
 
 #include <list>
 #include <queue>
+#include <unordered_map>
+#include <vector>
 #include <alljoyn/Status.h>
 
 #include <qcc/platform.h>
@@ -305,6 +307,23 @@ class UDPTransport : public Transport, public _RemoteEndpoint::EndpointListener,
      */
     static const char* TransportName;
 
+    /**
+     * Choose the ARDP instance that owns an inbound datagram when connections
+     * are spread over several instances.  The instance is chosen by the ARDP
+     * local port the datagram is addressed to, which falls into the port
+     * partition of the instance that allocated it.  A connection request (SYN)
+     * has no local port yet, so it is chosen from the foreign ARDP and UDP
+     * ports and retransmissions of the request land on the same instance.
+     *
+     * @param buf         The datagram.
+     * @param len         The length of the datagram.
+     * @param remotePort  The UDP port the datagram came from.
+     * @param numShards   The number of ARDP instances.
+     *
+     * @return The index of the instance, less than numShards.
+     */
+    static uint32_t ArdpShardIndex(uint8_t* buf, uint16_t len, uint16_t remotePort, uint32_t numShards);
+
     class ConnectEntry;
     class ConnectEntry {
       public:
@@ -348,6 +367,9 @@ class UDPTransport : public Transport, public _RemoteEndpoint::EndpointListener,
     qcc::Mutex m_preListLock;                                      /**< Mutex that protects the endpoint and auth lists */
     std::set<UDPEndpoint> m_authList;                              /**< List of authenticating endpoints */
     std::set<UDPEndpoint> m_endpointList;                          /**< List of active endpoints */
+    typedef std::unordered_map<uint32_t, UDPEndpoint> EndpointConnIdMap;
+    typedef std::pair<EndpointConnIdMap::iterator, EndpointConnIdMap::iterator> EndpointConnIdRange;
+    EndpointConnIdMap m_endpointConnIdMap;                         /**< Endpoints on m_endpointList keyed by ARDP connection ID */
     std::set<ConnectEntry> m_connectThreads;                       /**< List of threads starting up active endpoints */
     qcc::Mutex m_endpointListLock;                                 /**< Mutex that protects the endpoint and auth lists */
 
@@ -870,10 +892,28 @@ class UDPTransport : public Transport, public _RemoteEndpoint::EndpointListener,
      */
     ArdpGlobalConfig m_ardpConfig;
 
-    qcc::Mutex m_ardpLock;  /**< Since written for embedded as well as daemon environments, ARDP is not thread-safe */
-    qcc::Mutex m_cbLock;    /**< Lock to synchronize interactions between callback contexts and other threads */
+    /**
+     * Since written for embedded as well as daemon environments, ARDP is not
+     * thread-safe.  Rather than serializing every connection on one lock, we
+     * spread connections over one or more ARDP instances, each protected by
+     * its own lock.  Each instance allocates ARDP local ports from its own
+     * partition of the port space, so the main thread can tell which instance
+     * owns an inbound datagram before handing it over.  The context of each
+     * ARDP handle points back at its shard, so whoever holds a handle (an
+     * endpoint, a connection callback) finds the right lock directly.
+     */
+    struct ArdpShard {
+        ArdpShard(UDPTransport* transport) : m_transport(transport), m_handle(NULL), m_lock(qcc::LOCK_LEVEL_UDPTRANSPORT_ARDPLOCK) { }
+        UDPTransport* m_transport;  /**< The transport that owns the ARDP instance */
+        ArdpHandle* m_handle;       /**< The ARDP instance */
+        qcc::Mutex m_lock;          /**< Serializes all calls into m_handle */
+    };
 
-    ArdpHandle* m_handle;
+    std::vector<ArdpShard*> m_ardpShards;  /**< The ARDP instances; never changes after construction */
+    volatile int32_t m_ardpConnectShard;   /**< Round-robin counter choosing the instance for outbound connections */
+    std::vector<qcc::RecvFromEntry> m_ardpRecvBatch;  /**< Receive buffers used by ArdpRun() when there are several instances */
+    std::vector<uint8_t> m_ardpRecvBuffers;          /**< Storage behind m_ardpRecvBatch */
+    qcc::Mutex m_cbLock;    /**< Lock to synchronize interactions between callback contexts and other threads */
 
     /**
      * MessageDispatcherThread handles AllJoyn messages that have been received
@@ -948,6 +988,39 @@ class UDPTransport : public Transport, public _RemoteEndpoint::EndpointListener,
     bool m_done1298; /**< True if workaround for "socket closed during CancelAdvertise" issue (ASACORE-1298) has been done */
 #endif
 
+    /**
+     * Add an endpoint to m_endpointList and to the connection ID index used to
+     * find it from ARDP callbacks.  Must be called with m_endpointListLock taken.
+     *
+     * @param ep The endpoint to add.
+     */
+    void EndpointListInsert(UDPEndpoint ep);
+
+    /**
+     * Remove an endpoint from m_endpointList and from the connection ID index.
+     * Must be called with m_endpointListLock taken.
+     *
+     * @param i Iterator referring to the endpoint on m_endpointList.
+     */
+    void EndpointListErase(std::set<UDPEndpoint>::iterator i);
+
+    /**
+     * Return the lock that must be held when calling into ARDP with the given
+     * handle.  The handle must be one of our ARDP instances.
+     *
+     * @param handle The ARDP handle that is about to be used.
+     */
+    qcc::Mutex& ArdpLock(ArdpHandle* handle);
+
+    /**
+     * Read every pending datagram from sock, hand each one to the ARDP
+     * instance that owns its connection, and then run the timers of every
+     * instance.  Takes the same arguments as ARDP_Run() and combines the
+     * results of the instances: ms is set to the earliest timer and
+     * ER_ARDP_WRITE_BLOCKED is returned if any instance is blocked on sock.
+     */
+    QStatus ArdpRun(qcc::SocketFd sock, bool readReady, bool writeReady, uint32_t* ms);
+
 #ifndef NDEBUG
     void DebugPreListCheck(UDPEndpoint uep);
     void DebugAuthListCheck(UDPEndpoint uep);
@@ -0,0 +1,319 @@
+/**
+ * @file
+ *
+ * Measures the per-datagram cost of ARDP as a function of the number of open
+ * connections on the same ARDP handle.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <qcc/IPAddress.h>
+#include <qcc/Socket.h>
+#include <qcc/SocketTypes.h>
+#include <qcc/Util.h>
+#include <qcc/time.h>
+
+#include <alljoyn/Init.h>
+#include <alljoyn/Status.h>
+
+#include <ArdpProtocol.h>
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+const uint32_t UDP_CONNECT_TIMEOUT = 1000;  /**< How long before we expect a connection to complete */
+const uint32_t UDP_CONNECT_RETRIES = 10;  /**< How many times do we retry a connection before giving up */
+const uint32_t UDP_INITIAL_DATA_TIMEOUT = 1000;  /**< Initial value for how long do we wait before retrying sending data */
+const uint32_t UDP_TOTAL_DATA_RETRY_TIMEOUT = 5000;  /**< Total amount of time to try and send data before giving up */
+const uint32_t UDP_MIN_DATA_RETRIES = 5;  /**< Minimum number of times to try and send data before giving up */
+const uint32_t UDP_PERSIST_INTERVAL = 1000;  /**< How long do we wait before pinging the other side due to a zero window */
+const uint32_t UDP_TOTAL_APP_TIMEOUT = 30000;  /**< How long to we try to ping for window opening before deciding app is not pulling data */
+const uint32_t UDP_LINK_TIMEOUT = 30000;  /**< How long before we decide a link is down (with no reponses to keepalive probes */
+const uint32_t UDP_KEEPALIVE_RETRIES = 5;  /**< How many times do we try to probe on an idle link before terminating the connection */
+const uint32_t UDP_FAST_RETRANSMIT_ACK_COUNTER = 1; /**< How many duplicate acknowledgements to we need to trigger a data retransmission */
+const uint32_t UDP_DELAYED_ACK_TIMEOUT = 100; /**< How long do we wait until acknowledging received segments */
+const uint32_t UDP_TIMEWAIT = 1000;         /**< How long do we stay in TIMWAIT state before releasing the per-connection resources */
+const uint32_t UDP_SEGBMAX = 65507;  /**< Maximum size of an ARDP message (for receive buffer sizing) */
+const uint32_t UDP_SEGMAX = 50;      /**< Maximum number of ARDP messages in-flight (bandwidth-delay product sizing) */
+
+/* Connections are opened in batches so the SYNs do not overflow the socket buffer */
+const uint32_t CONNECT_BATCH = 50;
+
+/*
+ * Stop waiting for connections after this many milliseconds without progress.
+ * ARDP may leave the odd connection half open when a SYN-ACK is dropped, so
+ * the benchmark runs on the connections that did come up.
+ */
+const uint32_t SETUP_STALL_TIMEOUT = 3000;
+
+static uint8_t g_connectData[] = "ardpconnbench";
+static uint8_t g_payload[64];
+
+static vector<ArdpConnRecord*> g_open;
+static vector<uint32_t> g_openIds;
+static uint32_t g_received = 0;
+
+static bool AcceptCb(ArdpHandle* handle, IPAddress ipAddr, uint16_t ipPort, ArdpConnRecord* conn, uint8_t* buf, uint16_t len, QStatus status)
+{
+    QCC_UNUSED(ipAddr);
+    QCC_UNUSED(ipPort);
+    QCC_UNUSED(buf);
+    QCC_UNUSED(len);
+    QCC_UNUSED(status);
+    return ARDP_Accept(handle, conn, UDP_SEGMAX, UDP_SEGBMAX, g_connectData, sizeof(g_connectData)) == ER_OK;
+}
+
+static void ConnectCb(ArdpHandle* handle, ArdpConnRecord* conn, bool passive, uint8_t* buf, uint16_t len, QStatus status)
+{
+    QCC_UNUSED(buf);
+    QCC_UNUSED(len);
+    if (!passive && (status == ER_OK)) {
+        g_open.push_back(conn);
+        g_openIds.push_back(ARDP_GetConnId(handle, conn));
+    }
+}
+
+static void DisconnectCb(ArdpHandle* handle, ArdpConnRecord* conn, QStatus status)
+{
+    QCC_UNUSED(handle);
+    QCC_UNUSED(conn);
+    QCC_UNUSED(status);
+}
+
+static void RecvCb(ArdpHandle* handle, ArdpConnRecord* conn, ArdpRcvBuf* rcv, QStatus status)
+{
+    QCC_UNUSED(status);
+    ++g_received;
+    ARDP_RecvReady(handle, conn, rcv);
+}
+
+static void SendCb(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf, uint32_t len, QStatus status)
+{
+    /* Every send uses g_payload so there is nothing to free */
+    QCC_UNUSED(handle);
+    QCC_UNUSED(conn);
+    QCC_UNUSED(buf);
+    QCC_UNUSED(len);
+    QCC_UNUSED(status);
+}
+
+static void SendWindowCb(ArdpHandle* handle, ArdpConnRecord* conn, uint16_t window, QStatus status)
+{
+    QCC_UNUSED(handle);
+    QCC_UNUSED(conn);
+    QCC_UNUSED(window);
+    QCC_UNUSED(status);
+}
+
+static ArdpHandle* AllocHandle(bool passive)
+{
+    ArdpGlobalConfig config;
+    memset(&config, 0, sizeof(config));
+    config.connectTimeout = UDP_CONNECT_TIMEOUT;
+    config.connectRetries = UDP_CONNECT_RETRIES;
+    config.initialDataTimeout = UDP_INITIAL_DATA_TIMEOUT;
+    config.totalDataRetryTimeout = UDP_TOTAL_DATA_RETRY_TIMEOUT;
+    config.minDataRetries = UDP_MIN_DATA_RETRIES;
+    config.persistInterval = UDP_PERSIST_INTERVAL;
+    config.totalAppTimeout = UDP_TOTAL_APP_TIMEOUT;
+    config.linkTimeout = UDP_LINK_TIMEOUT;
+    config.keepaliveRetries = UDP_KEEPALIVE_RETRIES;
+    config.fastRetransmitAckCounter = UDP_FAST_RETRANSMIT_ACK_COUNTER;
+    config.delayedAckTimeout = UDP_DELAYED_ACK_TIMEOUT;
+    config.timewait = UDP_TIMEWAIT;
+    config.segbmax = UDP_SEGBMAX;
+    config.segmax = UDP_SEGMAX;
+
+    ArdpHandle* handle = ARDP_AllocHandle(&config);
+    ARDP_SetAcceptCb(handle, AcceptCb);
+    ARDP_SetConnectCb(handle, ConnectCb);
+    ARDP_SetDisconnectCb(handle, DisconnectCb);
+    ARDP_SetRecvCb(handle, RecvCb);
+    ARDP_SetSendCb(handle, SendCb);
+    ARDP_SetSendWindowCb(handle, SendWindowCb);
+    if (passive) {
+        ARDP_StartPassive(handle);
+    }
+    return handle;
+}
+
+static QStatus OpenSocket(SocketFd& sock, IPAddress& addr, uint16_t& port)
+{
+    QStatus status = Socket(QCC_AF_INET, QCC_SOCK_DGRAM, sock);
+    if (status != ER_OK) {
+        return status;
+    }
+    status = SetBlocking(sock, false);
+    if (status == ER_OK) {
+        status = Bind(sock, IPAddress("127.0.0.1"), 0);
+    }
+    if (status == ER_OK) {
+        status = GetLocalAddress(sock, addr, port);
+    }
+    if (status != ER_OK) {
+        Close(sock);
+    }
+    return status;
+}
+
+static void Pump(ArdpHandle* server, SocketFd serverSock, ArdpHandle* client, SocketFd clientSock)
+{
+    uint32_t ms;
+    ARDP_Run(server, serverSock, true, true, &ms);
+    ARDP_Run(client, clientSock, true, true, &ms);
+}
+
+static void usage(void)
+{
+    printf("Usage: ardpconnbench [-h] [-c <connections>] [-i <iterations>]\n\n");
+    printf("Options:\n");
+    printf("   -h                    = Print this help message\n");
+    printf("   -c <connections>      = Number of ARDP connections, may be repeated (default 1 100 500)\n");
+    printf("   -i <iterations>       = Number of datagrams measured per run (default 20000)\n");
+}
+
+int CDECL_CALL main(int argc, char** argv)
+{
+    uint32_t iterations = 20000;
+    vector<uint32_t> counts;
+
+    for (int i = 1; i < argc; ++i) {
+        if (0 == strcmp("-h", argv[i])) {
+            usage();
+            return 0;
+        } else if ((0 == strcmp("-c", argv[i])) && (i + 1 < argc)) {
+            counts.push_back(strtoul(argv[++i], NULL, 10));
+        } else if ((0 == strcmp("-i", argv[i])) && (i + 1 < argc)) {
+            iterations = strtoul(argv[++i], NULL, 10);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (counts.empty()) {
+        const uint32_t defaults[] = { 1, 100, 500 };
+        counts.assign(defaults, defaults + ArraySize(defaults));
+    }
+    if (iterations == 0) {
+        usage();
+        return 1;
+    }
+
+    if (AllJoynInit() != ER_OK) {
+        return 1;
+    }
+
+    printf("%12s %20s %20s\n", "connections", "usec per datagram", "nsec per validate");
+
+    for (size_t c = 0; c < counts.size(); ++c) {
+        uint32_t numConns = counts[c];
+        SocketFd serverSock, clientSock;
+        IPAddress serverAddr, clientAddr;
+        uint16_t serverPort, clientPort;
+        if (OpenSocket(serverSock, serverAddr, serverPort) != ER_OK) {
+            printf("%12u %20s\n", numConns, "setup failed");
+            continue;
+        }
+        if (OpenSocket(clientSock, clientAddr, clientPort) != ER_OK) {
+            Close(serverSock);
+            printf("%12u %20s\n", numConns, "setup failed");
+            continue;
+        }
+        ArdpHandle* server = AllocHandle(true);
+        ArdpHandle* client = AllocHandle(false);
+
+        /* Establish the connections before measuring anything */
+        g_open.clear();
+        g_openIds.clear();
+        uint32_t requested = 0;
+        size_t lastOpen = 0;
+        uint64_t lastProgress = GetTimestamp64();
+        while ((g_open.size() < numConns) && (GetTimestamp64() < lastProgress + SETUP_STALL_TIMEOUT)) {
+            if ((requested < numConns) && (requested < g_open.size() + CONNECT_BATCH)) {
+                ArdpConnRecord* conn;
+                if (ARDP_Connect(client, clientSock, serverAddr, serverPort, UDP_SEGMAX, UDP_SEGBMAX, &conn,
+                                 g_connectData, sizeof(g_connectData), NULL) != ER_OK) {
+                    break;
+                }
+                ++requested;
+                continue;
+            }
+            Pump(server, serverSock, client, clientSock);
+            if (g_open.size() != lastOpen) {
+                lastOpen = g_open.size();
+                lastProgress = GetTimestamp64();
+            }
+        }
+
+        if (g_open.empty()) {
+            printf("%12u %20s\n", numConns, "connect failed");
+        } else {
+            /*
+             * Round-robin one datagram per connection.  The server demultiplexes
+             * every data segment and the client every acknowledgement.
+             */
+            g_received = 0;
+            uint32_t sent = 0;
+            uint64_t start = GetTimestamp64();
+            for (uint32_t i = 0; sent < iterations; ++i) {
+                if (ARDP_Send(client, g_open[i % g_open.size()], g_payload, sizeof(g_payload), 0) == ER_OK) {
+                    ++sent;
+                }
+                Pump(server, serverSock, client, clientSock);
+            }
+            lastProgress = GetTimestamp64();
+            while ((g_received < sent) && (GetTimestamp64() < lastProgress + SETUP_STALL_TIMEOUT)) {
+                Pump(server, serverSock, client, clientSock);
+            }
+            double datagramUsec = (static_cast<double>(GetTimestamp64() - start) * 1000.0) / sent;
+
+            /* Every call into the ARDP API starts by validating the connection */
+            uint32_t valid = 0;
+            uint32_t calls = 0;
+            start = GetTimestamp64();
+            while (calls < 1000 * iterations) {
+                for (size_t i = 0; i < g_open.size(); ++i) {
+                    valid += ARDP_IsConnValid(client, g_open[i], g_openIds[i]) ? 1 : 0;
+                }
+                calls += g_open.size();
+            }
+            double validateNsec = (static_cast<double>(GetTimestamp64() - start) * 1000000.0) / calls;
+
+            if ((g_received < sent) || (valid != calls)) {
+                printf("%12u %20s\n", static_cast<uint32_t>(g_open.size()), "lost datagrams");
+            } else {
+                printf("%12u %20.2f %20.1f\n", static_cast<uint32_t>(g_open.size()), datagramUsec, validateNsec);
+            }
+        }
+
+        ARDP_FreeHandle(client);
+        ARDP_FreeHandle(server);
+        Close(clientSock);
+        Close(serverSock);
+    }
+
+    AllJoynShutdown();
+    return 0;
+}
@@ -0,0 +1,309 @@
+/**
+ * @file
+ *
+ * Measures what the debug tracing in ARDP's receive path costs when tracing is not
+ * enabled at run time.  Small messages are sent over a loopback ARDP connection and
+ * the time the receiving handle spends in ARDP_Run() (reading the datagrams and
+ * running them through Receive() up to the RecvCb()) is reported per message.
+ *
+ * The traces are compiled in or out of ArdpProtocol.cc by QCC_DBG_HOT_PATH_MASK, so
+ * compare a build with the default mask against one built with a narrowed
+ * DBG_HOT_PATH_MASK, for example DBG_HOT_PATH_MASK=1.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <qcc/Debug.h>
+#include <qcc/IPAddress.h>
+#include <qcc/Socket.h>
+#include <qcc/SocketTypes.h>
+#include <qcc/Util.h>
+#include <qcc/time.h>
+
+#include <alljoyn/Init.h>
+#include <alljoyn/Status.h>
+
+#include <ArdpProtocol.h>
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+const uint32_t UDP_CONNECT_TIMEOUT = 1000;  /**< How long before we expect a connection to complete */
+const uint32_t UDP_CONNECT_RETRIES = 10;  /**< How many times do we retry a connection before giving up */
+const uint32_t UDP_INITIAL_DATA_TIMEOUT = 1000;  /**< Initial value for how long do we wait before retrying sending data */
+const uint32_t UDP_TOTAL_DATA_RETRY_TIMEOUT = 5000;  /**< Total amount of time to try and send data before giving up */
+const uint32_t UDP_MIN_DATA_RETRIES = 5;  /**< Minimum number of times to try and send data before giving up */
+const uint32_t UDP_PERSIST_INTERVAL = 1000;  /**< How long do we wait before pinging the other side due to a zero window */
+const uint32_t UDP_TOTAL_APP_TIMEOUT = 30000;  /**< How long to we try to ping for window opening before deciding app is not pulling data */
+const uint32_t UDP_LINK_TIMEOUT = 30000;  /**< How long before we decide a link is down (with no reponses to keepalive probes */
+const uint32_t UDP_KEEPALIVE_RETRIES = 5;  /**< How many times do we try to probe on an idle link before terminating the connection */
+const uint32_t UDP_FAST_RETRANSMIT_ACK_COUNTER = 1; /**< How many duplicate acknowledgements to we need to trigger a data retransmission */
+const uint32_t UDP_DELAYED_ACK_TIMEOUT = 100; /**< How long do we wait until acknowledging received segments */
+const uint32_t UDP_TIMEWAIT = 1000;         /**< How long do we stay in TIMWAIT state before releasing the per-connection resources */
+const uint32_t UDP_SEGBMAX = 1472;  /**< One Ethernet MTU worth of UDP payload per segment */
+const uint32_t UDP_SEGMAX = 100;   /**< Enough segments in flight for a maximally sized AllJoyn message */
+
+/* Stop waiting for the transfer after this many milliseconds without progress */
+const uint32_t STALL_TIMEOUT = 3000;
+
+static uint8_t g_connectData[] = "ardptracebench";
+
+static ArdpConnRecord* g_conn = NULL;
+static uint32_t g_received = 0;
+static uint32_t g_sendsDone = 0;
+
+static bool AcceptCb(ArdpHandle* handle, IPAddress ipAddr, uint16_t ipPort, ArdpConnRecord* conn, uint8_t* buf, uint16_t len, QStatus status)
+{
+    QCC_UNUSED(ipAddr);
+    QCC_UNUSED(ipPort);
+    QCC_UNUSED(buf);
+    QCC_UNUSED(len);
+    QCC_UNUSED(status);
+    return ARDP_Accept(handle, conn, UDP_SEGMAX, UDP_SEGBMAX, g_connectData, sizeof(g_connectData)) == ER_OK;
+}
+
+static void ConnectCb(ArdpHandle* handle, ArdpConnRecord* conn, bool passive, uint8_t* buf, uint16_t len, QStatus status)
+{
+    QCC_UNUSED(handle);
+    QCC_UNUSED(buf);
+    QCC_UNUSED(len);
+    if (!passive && (status == ER_OK)) {
+        g_conn = conn;
+    }
+}
+
+static void DisconnectCb(ArdpHandle* handle, ArdpConnRecord* conn, QStatus status)
+{
+    QCC_UNUSED(handle);
+    QCC_UNUSED(conn);
+    QCC_UNUSED(status);
+}
+
+static void RecvCb(ArdpHandle* handle, ArdpConnRecord* conn, ArdpRcvBuf* rcv, QStatus status)
+{
+    QCC_UNUSED(status);
+    ++g_received;
+    ARDP_RecvReady(handle, conn, rcv);
+}
+
+static void SendCb(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf, uint32_t len, QStatus status)
+{
+    /* Every send uses the same payload so there is nothing to free */
+    QCC_UNUSED(handle);
+    QCC_UNUSED(conn);
+    QCC_UNUSED(buf);
+    QCC_UNUSED(len);
+    QCC_UNUSED(status);
+    ++g_sendsDone;
+}
+
+static void SendWindowCb(ArdpHandle* handle, ArdpConnRecord* conn, uint16_t window, QStatus status)
+{
+    QCC_UNUSED(handle);
+    QCC_UNUSED(conn);
+    QCC_UNUSED(window);
+    QCC_UNUSED(status);
+}
+
+static ArdpHandle* AllocHandle(bool passive)
+{
+    ArdpGlobalConfig config;
+    memset(&config, 0, sizeof(config));
+    config.connectTimeout = UDP_CONNECT_TIMEOUT;
+    config.connectRetries = UDP_CONNECT_RETRIES;
+    config.initialDataTimeout = UDP_INITIAL_DATA_TIMEOUT;
+    config.totalDataRetryTimeout = UDP_TOTAL_DATA_RETRY_TIMEOUT;
+    config.minDataRetries = UDP_MIN_DATA_RETRIES;
+    config.persistInterval = UDP_PERSIST_INTERVAL;
+    config.totalAppTimeout = UDP_TOTAL_APP_TIMEOUT;
+    config.linkTimeout = UDP_LINK_TIMEOUT;
+    config.keepaliveRetries = UDP_KEEPALIVE_RETRIES;
+    config.fastRetransmitAckCounter = UDP_FAST_RETRANSMIT_ACK_COUNTER;
+    config.delayedAckTimeout = UDP_DELAYED_ACK_TIMEOUT;
+    config.timewait = UDP_TIMEWAIT;
+    config.segbmax = UDP_SEGBMAX;
+    config.segmax = UDP_SEGMAX;
+
+    ArdpHandle* handle = ARDP_AllocHandle(&config);
+    ARDP_SetAcceptCb(handle, AcceptCb);
+    ARDP_SetConnectCb(handle, ConnectCb);
+    ARDP_SetDisconnectCb(handle, DisconnectCb);
+    ARDP_SetRecvCb(handle, RecvCb);
+    ARDP_SetSendCb(handle, SendCb);
+    ARDP_SetSendWindowCb(handle, SendWindowCb);
+    if (passive) {
+        ARDP_StartPassive(handle);
+    }
+    return handle;
+}
+
+static QStatus OpenSocket(SocketFd& sock, IPAddress& addr, uint16_t& port)
+{
+    QStatus status = Socket(QCC_AF_INET, QCC_SOCK_DGRAM, sock);
+    if (status != ER_OK) {
+        return status;
+    }
+    status = SetBlocking(sock, false);
+    if (status == ER_OK) {
+        /* Room for a full window of segments in each direction */
+        status = SetRcvBuf(sock, 4 * 1024 * 1024);
+    }
+    if (status == ER_OK) {
+        status = Bind(sock, IPAddress("127.0.0.1"), 0);
+    }
+    if (status == ER_OK) {
+        status = GetLocalAddress(sock, addr, port);
+    }
+    if (status != ER_OK) {
+        Close(sock);
+    }
+    return status;
+}
+
+/* Run both handles, and return the microseconds the receiving (server) handle took */
+static uint64_t Pump(ArdpHandle* server, SocketFd serverSock, ArdpHandle* client, SocketFd clientSock)
+{
+    uint32_t ms;
+    uint64_t start = GetTimestampMicros();
+    ARDP_Run(server, serverSock, true, true, &ms);
+    uint64_t receiveUsec = GetTimestampMicros() - start;
+    ARDP_Run(client, clientSock, true, true, &ms);
+    return receiveUsec;
+}
+
+static void usage(void)
+{
+    printf("Usage: ardptracebench [-h] [-s <message size>] [-n <messages>] [-r <runs>]\n\n");
+    printf("Options:\n");
+    printf("   -h                    = Print this help message\n");
+    printf("   -s <message size>     = Size of each message in bytes (default 64)\n");
+    printf("   -n <messages>         = Number of messages sent per run (default 100000)\n");
+    printf("   -r <runs>             = Number of runs (default 5)\n");
+}
+
+int CDECL_CALL main(int argc, char** argv)
+{
+    uint32_t size = 64;
+    uint32_t numMessages = 100000;
+    uint32_t runs = 5;
+
+    for (int i = 1; i < argc; ++i) {
+        if (0 == strcmp("-h", argv[i])) {
+            usage();
+            return 0;
+        } else if ((0 == strcmp("-s", argv[i])) && (i + 1 < argc)) {
+            size = strtoul(argv[++i], NULL, 10);
+        } else if ((0 == strcmp("-n", argv[i])) && (i + 1 < argc)) {
+            numMessages = strtoul(argv[++i], NULL, 10);
+        } else if ((0 == strcmp("-r", argv[i])) && (i + 1 < argc)) {
+            runs = strtoul(argv[++i], NULL, 10);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if ((size == 0) || (numMessages == 0) || (runs == 0)) {
+        usage();
+        return 1;
+    }
+
+    if (AllJoynInit() != ER_OK) {
+        return 1;
+    }
+
+#if defined(NDEBUG)
+    printf("Release build: debug prints are compiled out whatever the mask\n");
+#endif
+    printf("QCC_DBG_HOT_PATH_MASK 0x%02x, ARDP_PROTOCOL tracing disabled at run time\n", QCC_DBG_HOT_PATH_MASK);
+    printf("%u messages of %u bytes per run\n", numMessages, size);
+    printf("%4s %16s %16s\n", "run", "usec per message", "receive usec");
+
+    vector<uint8_t> payload(size, 0xa5);
+    for (uint32_t run = 1; run <= runs; ++run) {
+        SocketFd serverSock, clientSock;
+        IPAddress serverAddr, clientAddr;
+        uint16_t serverPort, clientPort;
+        if (OpenSocket(serverSock, serverAddr, serverPort) != ER_OK) {
+            printf("%4u %16s\n", run, "setup failed");
+            continue;
+        }
+        if (OpenSocket(clientSock, clientAddr, clientPort) != ER_OK) {
+            Close(serverSock);
+            printf("%4u %16s\n", run, "setup failed");
+            continue;
+        }
+        ArdpHandle* server = AllocHandle(true);
+        ArdpHandle* client = AllocHandle(false);
+
+        g_conn = NULL;
+        ArdpConnRecord* conn;
+        uint64_t lastProgress = GetTimestamp64();
+        if (ARDP_Connect(client, clientSock, serverAddr, serverPort, UDP_SEGMAX, UDP_SEGBMAX, &conn,
+                         g_connectData, sizeof(g_connectData), NULL) == ER_OK) {
+            while ((g_conn == NULL) && (GetTimestamp64() < lastProgress + STALL_TIMEOUT)) {
+                Pump(server, serverSock, client, clientSock);
+            }
+        }
+
+        if (g_conn == NULL) {
+            printf("%4u %16s\n", run, "connect failed");
+        } else {
+            /* Keep the send window full so every pump of the server has segments to receive */
+            g_received = 0;
+            g_sendsDone = 0;
+            uint32_t sent = 0;
+            uint64_t receiveUsec = 0;
+            uint64_t start = GetTimestampMicros();
+            lastProgress = GetTimestamp64();
+            while ((g_received < numMessages) && (GetTimestamp64() < lastProgress + STALL_TIMEOUT)) {
+                uint32_t received = g_received;
+                while ((sent < numMessages) && (ARDP_Send(client, g_conn, &payload[0], size, 0) == ER_OK)) {
+                    ++sent;
+                }
+                receiveUsec += Pump(server, serverSock, client, clientSock);
+                if (g_received != received) {
+                    lastProgress = GetTimestamp64();
+                }
+            }
+            uint64_t elapsed = GetTimestampMicros() - start;
+
+            if (g_received < numMessages) {
+                printf("%4u %16s\n", run, "lost messages");
+            } else {
+                printf("%4u %16.3f %16.3f\n", run,
+                       static_cast<double>(elapsed) / numMessages,
+                       static_cast<double>(receiveUsec) / numMessages);
+            }
+        }
+
+        ARDP_FreeHandle(client);
+        ARDP_FreeHandle(server);
+        Close(clientSock);
+        Close(serverSock);
+    }
+
+    AllJoynShutdown();
+    return 0;
+}
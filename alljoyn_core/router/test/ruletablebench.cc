@@ -0,0 +1,203 @@
+/**
+ * @file
+ *
+ * Measures the cost of selecting the receivers of a broadcast signal with and
+ * without the RuleTable index.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include <qcc/String.h>
+#include <qcc/StringUtil.h>
+#include <qcc/time.h>
+
+#include <alljoyn/BusAttachment.h>
+#include <alljoyn/Init.h>
+#include <alljoyn/Message.h>
+#include <alljoyn/Status.h>
+
+#include "BusEndpoint.h"
+#include "Rule.h"
+#include "RuleTable.h"
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+static const char* BENCH_IFACE = "org.alljoyn.bench.RuleTable";
+
+class _BenchEndpoint : public _BusEndpoint {
+  public:
+    _BenchEndpoint(const String& name) : _BusEndpoint(ENDPOINT_TYPE_REMOTE), name(name) { }
+    const String& GetUniqueName() const { return name; }
+  private:
+    String name;
+};
+typedef ManagedObj<_BenchEndpoint> BenchEndpoint;
+
+class _BenchMessage : public _Message {
+  public:
+    _BenchMessage(BusAttachment& bus, const String& sender, const String& member) : _Message(bus)
+    {
+        SignalMsg("", sender, NULL, 0, "/bench", BENCH_IFACE, member, NULL, 0, 0, 0);
+    }
+};
+typedef ManagedObj<_BenchMessage> BenchMessage;
+
+static void usage(void)
+{
+    printf("Usage: ruletablebench [-h] [-e <endpoints>] [-r <rules per endpoint>] [-m <members>] [-i <iterations>]\n\n");
+    printf("Options:\n");
+    printf("   -h                 = Print this help message\n");
+    printf("   -e <endpoints>     = Number of endpoints (default 1000)\n");
+    printf("   -r <rules>         = Number of match rules per endpoint (default 10)\n");
+    printf("   -m <members>       = Number of distinct signal members (default 1000)\n");
+    printf("   -i <iterations>    = Number of signals routed per measurement (default 2000)\n");
+}
+
+int CDECL_CALL main(int argc, char** argv)
+{
+    uint32_t numEndpoints = 1000;
+    uint32_t rulesPerEndpoint = 10;
+    uint32_t numMembers = 1000;
+    uint32_t iterations = 2000;
+
+    for (int i = 1; i < argc; ++i) {
+        if (0 == strcmp("-h", argv[i])) {
+            usage();
+            return 0;
+        } else if ((0 == strcmp("-e", argv[i])) && (i + 1 < argc)) {
+            numEndpoints = strtoul(argv[++i], NULL, 10);
+        } else if ((0 == strcmp("-r", argv[i])) && (i + 1 < argc)) {
+            rulesPerEndpoint = strtoul(argv[++i], NULL, 10);
+        } else if ((0 == strcmp("-m", argv[i])) && (i + 1 < argc)) {
+            numMembers = strtoul(argv[++i], NULL, 10);
+        } else if ((0 == strcmp("-i", argv[i])) && (i + 1 < argc)) {
+            iterations = strtoul(argv[++i], NULL, 10);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if ((numEndpoints == 0) || (numMembers == 0) || (iterations == 0)) {
+        usage();
+        return 1;
+    }
+
+    if (AllJoynInit() != ER_OK) {
+        return 1;
+    }
+
+    {
+        BusAttachment bus("ruletablebench");
+        RuleTable ruleTable;
+        vector<BusEndpoint> allEps;
+
+        /*
+         * Most rules select a single signal member.  Every 100th endpoint also
+         * listens to the whole interface, which puts it in every candidate set.
+         */
+        uint32_t seed = 1;
+        for (uint32_t e = 0; e < numEndpoints; ++e) {
+            String name = ":bench." + U32ToString(e);
+            BenchEndpoint benchEp(name);
+            BusEndpoint ep = BusEndpoint::cast(benchEp);
+            allEps.push_back(ep);
+            for (uint32_t r = 0; r < rulesPerEndpoint; ++r) {
+                seed = seed * 1103515245 + 12345;
+                String ruleStr = String("type='signal',interface='") + BENCH_IFACE + "',member='Signal" + U32ToString((seed >> 8) % numMembers) + "'";
+                ruleTable.AddRule(ep, Rule(ruleStr.c_str()));
+            }
+            if ((e % 100) == 0) {
+                ruleTable.AddRule(ep, Rule((String("type='signal',interface='") + BENCH_IFACE + "'").c_str()));
+            }
+        }
+
+        vector<Message> msgs;
+        const String sender = ":sender.1";
+        for (uint32_t m = 0; m < numMembers; ++m) {
+            const String member = "Signal" + U32ToString(m);
+            BenchMessage msg(bus, sender, member);
+            msgs.push_back(Message::cast(msg));
+        }
+
+        /* Make sure both strategies pick the same receivers */
+        vector<BusEndpoint> candidates;
+        for (size_t m = 0; m < msgs.size(); ++m) {
+            vector<BusEndpoint> full;
+            for (size_t e = 0; e < allEps.size(); ++e) {
+                if (ruleTable.OkToSend(msgs[m], allEps[e])) {
+                    full.push_back(allEps[e]);
+                }
+            }
+            vector<BusEndpoint> indexed;
+            ruleTable.GetCandidateEndpoints(msgs[m], candidates);
+            for (size_t e = 0; e < candidates.size(); ++e) {
+                if (ruleTable.OkToSend(msgs[m], candidates[e])) {
+                    indexed.push_back(candidates[e]);
+                }
+            }
+            sort(full.begin(), full.end());
+            if (full != indexed) {
+                printf("Mismatch for Signal%u: %u receivers from full scan, %u from index\n",
+                       static_cast<uint32_t>(m), static_cast<uint32_t>(full.size()), static_cast<uint32_t>(indexed.size()));
+                return 1;
+            }
+        }
+
+        printf("%u endpoints, %u rules, %u signal members\n", numEndpoints,
+               numEndpoints * rulesPerEndpoint + (numEndpoints + 99) / 100, numMembers);
+
+        uint64_t receivers = 0;
+        uint64_t start = GetTimestamp64();
+        for (uint32_t i = 0; i < iterations; ++i) {
+            Message& msg = msgs[i % msgs.size()];
+            for (size_t e = 0; e < allEps.size(); ++e) {
+                receivers += ruleTable.OkToSend(msg, allEps[e]) ? 1 : 0;
+            }
+        }
+        double fullUsec = (static_cast<double>(GetTimestamp64() - start) * 1000.0) / iterations;
+
+        uint64_t candidateCount = 0;
+        start = GetTimestamp64();
+        for (uint32_t i = 0; i < iterations; ++i) {
+            Message& msg = msgs[i % msgs.size()];
+            ruleTable.GetCandidateEndpoints(msg, candidates);
+            candidateCount += candidates.size();
+            for (size_t e = 0; e < candidates.size(); ++e) {
+                receivers += ruleTable.OkToSend(msg, candidates[e]) ? 1 : 0;
+            }
+        }
+        double indexedUsec = (static_cast<double>(GetTimestamp64() - start) * 1000.0) / iterations;
+
+        printf("%-24s %12s %12s\n", "", "usec/signal", "endpoints");
+        printf("%-24s %12.2f %12u\n", "full scan", fullUsec, numEndpoints);
+        printf("%-24s %12.2f %12.1f\n", "indexed", indexedUsec, static_cast<double>(candidateCount) / iterations);
+        printf("(%u receivers per signal on average)\n", static_cast<uint32_t>(receivers / (2 * iterations)));
+    }
+
+    AllJoynShutdown();
+    return 0;
+}
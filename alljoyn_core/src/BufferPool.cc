@@ -0,0 +1,316 @@
+/**
+ * @file
+ * This file implements the pool that recycles message buffers and unmarshaled array storage.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <string.h>
+#include <functional>
+
+#include <qcc/LockLevel.h>
+#include <qcc/Metrics.h>
+#include <qcc/Mutex.h>
+#include <qcc/PerfCounters.h>
+#include <qcc/Thread.h>
+
+#include "BufferPool.h"
+
+#define QCC_MODULE "ALLJOYN"
+
+using namespace qcc;
+
+namespace ajn {
+
+/* Smallest and largest size classes as powers of two: 64 bytes to 256KB */
+static const uint32_t MIN_CLASS_SHIFT = 6;
+static const uint32_t MAX_CLASS_SHIFT = 18;
+static const uint32_t NUM_CLASSES = MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1;
+
+/* Size class recorded for buffers that are too big to pool */
+static const uint32_t UNPOOLED = NUM_CLASSES;
+
+/* The free lists are spread over 2^CACHE_SHIFT caches */
+static const uint32_t CACHE_SHIFT = 4;
+static const size_t NUM_CACHES = 1 << CACHE_SHIFT;
+
+/* Limits on what each cache keeps per size class */
+static const size_t CACHE_BYTES_PER_CLASS = 256 * 1024;
+static const size_t CACHE_MAX_BUFFERS = 256;
+
+/* Limit on what the transfer list keeps per size class */
+static const size_t TRANSFER_BYTES_PER_CLASS = 1024 * 1024;
+
+/*
+ * Every buffer is preceded by a header recording its size class. The header is 16 bytes so the
+ * buffer keeps the alignment of operator new[].
+ */
+union BufferHeader {
+    uint32_t sizeClass;
+    uint64_t align[2];
+};
+
+/*
+ * Free buffers are linked through their first bytes. The first buffer of a batch on a transfer
+ * list also links to the next batch.
+ */
+struct FreeBuffer {
+    FreeBuffer* next;
+    FreeBuffer* nextBatch;
+};
+
+struct Cache {
+    Mutex lock;
+    FreeBuffer* freeList[NUM_CLASSES];
+    size_t count[NUM_CLASSES];
+    size_t bytesHeld;
+
+    Cache() : lock(LOCK_LEVEL_BUFFERPOOL_LOCK), bytesHeld(0)
+    {
+        memset(freeList, 0, sizeof(freeList));
+        memset(count, 0, sizeof(count));
+    }
+};
+
+/*
+ * Batches of free buffers of one size class that a cache gave up when it was full, for any cache
+ * that runs dry. Buffers freed by a thread other than the one that allocated them come back to
+ * the allocating thread through here. The lock is never held together with a cache lock.
+ */
+struct TransferList {
+    Mutex lock;
+    FreeBuffer* batches;
+    size_t numBatches;
+
+    TransferList() : lock(LOCK_LEVEL_BUFFERPOOL_LOCK), batches(NULL), numBatches(0)
+    {
+    }
+};
+
+static Cache* caches = NULL;
+static TransferList* transferLists = NULL;
+
+/* Bytes on the free lists of all caches, "bufferpool.bytes.held" */
+static MetricCounter* bytesHeldMetric = NULL;
+
+static inline size_t ClassSize(uint32_t sizeClass)
+{
+    return static_cast<size_t>(1) << (MIN_CLASS_SHIFT + sizeClass);
+}
+
+static inline uint32_t SizeClass(size_t size)
+{
+    if (size > ClassSize(NUM_CLASSES - 1)) {
+        return UNPOOLED;
+    }
+    uint32_t sizeClass = 0;
+    while (ClassSize(sizeClass) < size) {
+        ++sizeClass;
+    }
+    return sizeClass;
+}
+
+static inline size_t MaxCached(uint32_t sizeClass)
+{
+    size_t max = CACHE_BYTES_PER_CLASS / ClassSize(sizeClass);
+    return (max < 2) ? 2 : ((max > CACHE_MAX_BUFFERS) ? CACHE_MAX_BUFFERS : max);
+}
+
+/* A full cache moves half of its buffers to the transfer list */
+static inline size_t BatchSize(uint32_t sizeClass)
+{
+    return MaxCached(sizeClass) / 2;
+}
+
+static inline size_t MaxBatches(uint32_t sizeClass)
+{
+    size_t max = TRANSFER_BYTES_PER_CLASS / (BatchSize(sizeClass) * ClassSize(sizeClass));
+    return (max < 1) ? 1 : max;
+}
+
+static void DeleteBuffers(FreeBuffer* buf)
+{
+    while (buf) {
+        FreeBuffer* next = buf->next;
+        delete [] (reinterpret_cast<uint8_t*>(buf) - sizeof(BufferHeader));
+        buf = next;
+    }
+}
+
+/*
+ * Thread ids are often aligned addresses so they are mixed before taking the top bits.
+ */
+static inline Cache& ThreadCache()
+{
+    uint64_t h = static_cast<uint64_t>(std::hash<ThreadId>()(Thread::GetCurrentThreadId()));
+    return caches[static_cast<size_t>((h * 0x9E3779B97F4A7C15ULL) >> (64 - CACHE_SHIFT))];
+}
+
+void* BufferPool::Alloc(size_t size)
+{
+    uint32_t sizeClass = SizeClass(size);
+    if (caches && (sizeClass != UNPOOLED)) {
+        Cache& cache = ThreadCache();
+        cache.lock.Lock(MUTEX_CONTEXT);
+        FreeBuffer* buf = cache.freeList[sizeClass];
+        if (buf) {
+            cache.freeList[sizeClass] = buf->next;
+            --cache.count[sizeClass];
+            cache.bytesHeld -= ClassSize(sizeClass);
+        }
+        cache.lock.Unlock(MUTEX_CONTEXT);
+        if (!buf) {
+            /* Refill from the transfer list before going to the heap */
+            TransferList& transfer = transferLists[sizeClass];
+            transfer.lock.Lock(MUTEX_CONTEXT);
+            buf = transfer.batches;
+            if (buf) {
+                transfer.batches = buf->nextBatch;
+                --transfer.numBatches;
+            }
+            transfer.lock.Unlock(MUTEX_CONTEXT);
+            if (buf && buf->next) {
+                FreeBuffer* tail = buf->next;
+                size_t count = 1;
+                while (tail->next) {
+                    tail = tail->next;
+                    ++count;
+                }
+                cache.lock.Lock(MUTEX_CONTEXT);
+                tail->next = cache.freeList[sizeClass];
+                cache.freeList[sizeClass] = buf->next;
+                cache.count[sizeClass] += count;
+                cache.bytesHeld += count * ClassSize(sizeClass);
+                cache.lock.Unlock(MUTEX_CONTEXT);
+            }
+        }
+        if (buf) {
+            bytesHeldMetric->Add(0 - static_cast<uint32_t>(ClassSize(sizeClass)));
+            IncrementPerfCounter(PERF_COUNTER_BUFFER_POOL_HIT);
+            return buf;
+        }
+        IncrementPerfCounter(PERF_COUNTER_BUFFER_POOL_MISS);
+    }
+    size_t bytes = (sizeClass == UNPOOLED) ? size : ClassSize(sizeClass);
+    uint8_t* mem = new uint8_t[sizeof(BufferHeader) + bytes];
+    reinterpret_cast<BufferHeader*>(mem)->sizeClass = sizeClass;
+    return mem + sizeof(BufferHeader);
+}
+
+void BufferPool::Free(void* buf)
+{
+    if (!buf) {
+        return;
+    }
+    uint8_t* mem = static_cast<uint8_t*>(buf) - sizeof(BufferHeader);
+    uint32_t sizeClass = reinterpret_cast<BufferHeader*>(mem)->sizeClass;
+    QCC_ASSERT(sizeClass <= UNPOOLED);
+    if (caches && (sizeClass != UNPOOLED)) {
+        Cache& cache = ThreadCache();
+        FreeBuffer* batch = NULL;
+        size_t batchSize = 0;
+        cache.lock.Lock(MUTEX_CONTEXT);
+        if (cache.count[sizeClass] >= MaxCached(sizeClass)) {
+            /* Make room by detaching a batch for the transfer list */
+            batchSize = BatchSize(sizeClass);
+            batch = cache.freeList[sizeClass];
+            FreeBuffer* tail = batch;
+            for (size_t i = 1; i < batchSize; ++i) {
+                tail = tail->next;
+            }
+            cache.freeList[sizeClass] = tail->next;
+            tail->next = NULL;
+            cache.count[sizeClass] -= batchSize;
+            cache.bytesHeld -= batchSize * ClassSize(sizeClass);
+        }
+        FreeBuffer* freeBuf = static_cast<FreeBuffer*>(buf);
+        freeBuf->next = cache.freeList[sizeClass];
+        cache.freeList[sizeClass] = freeBuf;
+        ++cache.count[sizeClass];
+        cache.bytesHeld += ClassSize(sizeClass);
+        cache.lock.Unlock(MUTEX_CONTEXT);
+        bytesHeldMetric->Add(static_cast<uint32_t>(ClassSize(sizeClass)));
+        if (batch) {
+            TransferList& transfer = transferLists[sizeClass];
+            transfer.lock.Lock(MUTEX_CONTEXT);
+            if (transfer.numBatches < MaxBatches(sizeClass)) {
+                batch->nextBatch = transfer.batches;
+                transfer.batches = batch;
+                ++transfer.numBatches;
+                batch = NULL;
+            }
+            transfer.lock.Unlock(MUTEX_CONTEXT);
+            if (batch) {
+                bytesHeldMetric->Add(0 - static_cast<uint32_t>(batchSize * ClassSize(sizeClass)));
+                DeleteBuffers(batch);
+            }
+        }
+        return;
+    }
+    delete [] mem;
+}
+
+void BufferPool::Trim()
+{
+    if (!caches) {
+        return;
+    }
+    for (size_t i = 0; i < NUM_CACHES; ++i) {
+        Cache& cache = caches[i];
+        cache.lock.Lock(MUTEX_CONTEXT);
+        for (uint32_t sizeClass = 0; sizeClass < NUM_CLASSES; ++sizeClass) {
+            DeleteBuffers(cache.freeList[sizeClass]);
+            cache.freeList[sizeClass] = NULL;
+            cache.count[sizeClass] = 0;
+        }
+        bytesHeldMetric->Add(0 - static_cast<uint32_t>(cache.bytesHeld));
+        cache.bytesHeld = 0;
+        cache.lock.Unlock(MUTEX_CONTEXT);
+    }
+    for (uint32_t sizeClass = 0; sizeClass < NUM_CLASSES; ++sizeClass) {
+        TransferList& transfer = transferLists[sizeClass];
+        transfer.lock.Lock(MUTEX_CONTEXT);
+        while (transfer.batches) {
+            FreeBuffer* batch = transfer.batches;
+            transfer.batches = batch->nextBatch;
+            bytesHeldMetric->Add(0 - static_cast<uint32_t>(BatchSize(sizeClass) * ClassSize(sizeClass)));
+            DeleteBuffers(batch);
+        }
+        transfer.numBatches = 0;
+        transfer.lock.Unlock(MUTEX_CONTEXT);
+    }
+}
+
+void BufferPool::Init()
+{
+    bytesHeldMetric = Metrics::GetCounter("bufferpool.bytes.held");
+    transferLists = new TransferList[NUM_CLASSES];
+    caches = new Cache[NUM_CACHES];
+}
+
+void BufferPool::Shutdown()
+{
+    Trim();
+    delete [] caches;
+    caches = NULL;
+    delete [] transferLists;
+    transferLists = NULL;
+}
+
+}
@@ -0,0 +1,86 @@
+#ifndef _ALLJOYN_BUFFERPOOL_H
+#define _ALLJOYN_BUFFERPOOL_H
+/**
+ * @file
+ * This file defines the pool that recycles message buffers and unmarshaled array storage.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#error Only include BufferPool.h in C++ code.
+#endif
+
+#include <qcc/platform.h>
+
+namespace ajn {
+
+/**
+ * %BufferPool hands out the raw storage behind message buffers and the scalar arrays that are
+ * copied out of a message while unmarshaling.
+ *
+ * Requests are rounded up to a power of two size class and freed buffers are kept on per-class
+ * free lists for reuse. The free lists are split over a number of caches, each with its own lock,
+ * and a thread always uses the cache its thread id hashes to so concurrent readers and writers
+ * rarely contend. A cache that fills up moves a batch of buffers to a transfer list shared by all
+ * caches, and a cache that runs dry takes a batch from it before going to the heap, so buffers
+ * freed on a different thread than they were allocated on are still reused. Requests larger than the biggest size class, and any request made while the
+ * pool is not initialized, go straight to the heap.
+ *
+ * The number of bytes kept on the free lists and transfer lists is published as the "bufferpool.bytes.held"
+ * qcc::Metrics counter, and hits and misses as perf counters.
+ *
+ * Buffers must be released with Free() and never with delete.
+ */
+class BufferPool {
+  public:
+
+    /**
+     * Allocate a buffer.
+     *
+     * @param size  Number of bytes needed.
+     *
+     * @return  A buffer of at least size bytes aligned for any scalar type.
+     */
+    static void* Alloc(size_t size);
+
+    /**
+     * Release a buffer obtained from Alloc().
+     *
+     * @param buf  The buffer to release, may be NULL.
+     */
+    static void Free(void* buf);
+
+    /**
+     * Release all buffers held on the free lists back to the heap.
+     */
+    static void Trim();
+
+    /**
+     * Initialize the pool; called from AllJoynInit().
+     */
+    static void Init();
+
+    /**
+     * Shut down the pool; called from AllJoynShutdown().
+     */
+    static void Shutdown();
+};
+
+}
+
+#endif
@@ -187,12 +187,13 @@ BusAttachment::Internal::Internal(const char* appName,
                                   Router* router,
                                   bool allowRemoteMessages,
                                   const char* listenAddresses,
-                                  uint32_t concurrency) :
+                                  uint32_t concurrency,
+                                  uint32_t ioDispatchShards) :
     application(appName ? appName : "unknown"),
     bus(bus),
     listenersLock(LOCK_LEVEL_BUSATTACHMENT_INTERNAL_LISTENERSLOCK),
     listeners(),
-    m_ioDispatch("iodisp", 96),
+    m_ioDispatch("iodisp", 96, ioDispatchShards),
     transportList(bus, factories, &m_ioDispatch, concurrency),
     keyStore(application),
     authManager(keyStore),
@@ -31,7 +31,7 @@
 #include <qcc/Event.h>
 #include <qcc/atomic.h>
 #include <qcc/ManagedObj.h>
-#include <qcc/IODispatch.h>
+#include <qcc/ShardedIODispatch.h>
 
 #include <alljoyn/BusAttachment.h>
 #include <alljoyn/InterfaceDescription.h>
@@ -148,7 +148,7 @@ class BusAttachment::Internal : public MessageReceiver, public JoinSessionAsyncC
      *
      * @return  The iodispatch
      */
-    qcc::IODispatch& GetIODispatch(void) { return m_ioDispatch; }
+    qcc::ShardedIODispatch& GetIODispatch(void) { return m_ioDispatch; }
 
     /**
      * Get the Announced Object Description for the BusObjects registered on
@@ -174,7 +174,8 @@ class BusAttachment::Internal : public MessageReceiver, public JoinSessionAsyncC
              Router* router,
              bool allowRemoteMessages,
              const char* listenAddresses,
-             uint32_t concurrency);
+             uint32_t concurrency,
+             uint32_t ioDispatchShards = 1);
 
     /*
      * Destructor also called by BusAttachment
@@ -571,7 +572,7 @@ class BusAttachment::Internal : public MessageReceiver, public JoinSessionAsyncC
     typedef qcc::ManagedObj<BusListener*> ProtectedBusListener;
     typedef std::set<ProtectedBusListener> ListenerSet;
     ListenerSet listeners;               /* List of registered BusListeners */
-    qcc::IODispatch m_ioDispatch;         /* iodispatch for this bus */
+    qcc::ShardedIODispatch m_ioDispatch;  /* iodispatch for this bus */
     std::map<std::string, InterfaceDescription> ifaceDescriptions;
     TransportList transportList;          /* List of active transports */
     KeyStore keyStore;                    /* The key store for the bus attachment */
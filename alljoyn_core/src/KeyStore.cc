@@ -32,6 +32,7 @@
 #include <qcc/KeyBlob.h>
 #include <qcc/LockLevel.h>
 #include <qcc/Util.h>
+#include <qcc/atomic.h>
 #include <qcc/StringSource.h>
 #include <qcc/StringSink.h>
 #include <qcc/Thread.h>
@@ -154,7 +155,8 @@ KeyStore::KeyStore(const qcc::String& application) :
     guidSet(false),
     guidSetEventLock(LOCK_LEVEL_KEYSTORE_GUIDSETEVENTLOCK),
     guidSetRefCount(0),
-    exclusiveLockRefreshState(ExclusiveLockNotHeld)
+    exclusiveLockRefreshState(ExclusiveLockNotHeld),
+    changeCount(0)
 {
 }
 
@@ -485,6 +487,10 @@ QStatus KeyStore::Reload()
                 dirty = true;
             }
         }
+        if (persistentRevision > revision) {
+            /* Another application changed the keys, our own changes were counted when they were made */
+            IncrementAndFetch(&changeCount);
+        }
         keys->clear();
         delete keys;
         keys = persistentKeys;
@@ -1207,6 +1213,8 @@ void KeyStore::ReleaseExclusiveLock(const char* file, uint32_t line)
     }
     /* We're about to leave the lock, set the state accordingly. */
     exclusiveLockRefreshState = ExclusiveLockNotHeld;
+    /* Whatever was changed under the exclusive lock is in place now */
+    IncrementAndFetch(&changeCount);
     QCC_VERIFY(ER_OK == lock.Unlock(file, line));
 
     /* Release the file lock. */
@@ -292,6 +292,15 @@ class KeyStore {
      */
     QStatus GetKeyExpiration(const Key& key, qcc::Timespec<qcc::EpochTime>& expiration);
 
+    /**
+     * Get a count that changes whenever the keys may have changed, either
+     * because they were written through this key store or because changes
+     * made by other applications were merged in by Reload().
+     *
+     * @return The change count.
+     */
+    uint32_t GetChangeCount() const { return static_cast<uint32_t>(changeCount); }
+
     /**
      * Test is there is a requested key blob in the key store
      *
@@ -696,6 +705,11 @@ class KeyStore {
         ExclusiveLockHeld_Clean   /**< Lock is held and keystore contents have been synchronized. */
     } exclusiveLockRefreshState;
 
+    /**
+     * Incremented after the keys were written or reloaded, see GetChangeCount()
+     */
+    volatile int32_t changeCount;
+
 };
 
 class KeyStoreKeyEventListener {
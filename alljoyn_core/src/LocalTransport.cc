@@ -204,7 +204,7 @@ _LocalEndpoint::_LocalEndpoint(BusAttachment& bus, uint32_t concurrency) :
     bus(&bus),
     objectsLock(LOCK_LEVEL_LOCALTRANSPORT_LOCALENDPOINT_OBJECTSLOCK),
     replyMapLock(LOCK_LEVEL_LOCALTRANSPORT_LOCALENDPOINT_REPLYMAPLOCK),
-    replyTimer("replyTimer", true),
+    replyTimer("replyTimer", true, 1, false, 0, Timer::TIMING_WHEEL),
     dbusObj(NULL),
     alljoynObj(NULL),
     alljoynDebugObj(NULL),
@@ -1329,8 +1329,9 @@ QStatus _LocalEndpoint::HandleSignal(Message& message)
      */
     list<SignalTable::Entry> callList;
     const InterfaceDescription::Member* signal = range.first->second.member;
+    MatchArgs matchArgs;
     do {
-        if (range.first->second.rule.IsMatch(message)) {
+        if (range.first->second.rule.IsMatch(message, nullptr, &matchArgs)) {
             callList.push_back(range.first->second);
         }
     } while (++range.first != range.second);
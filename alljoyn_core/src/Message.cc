@@ -36,6 +36,7 @@
 #include <alljoyn/Message.h>
 #include <alljoyn/BusAttachment.h>
 
+#include "BufferPool.h"
 #include "BusInternal.h"
 #include "BusUtil.h"
 #include "PermissionMgmtObj.h"
@@ -349,7 +350,7 @@ void _Message::Init(BusAttachment& busAttachment)
 
 _Message::~_Message(void)
 {
-    delete [] _msgBuf;
+    BufferPool::Free(_msgBuf);
     delete [] msgArgs;
     while (numHandles) {
         qcc::Close(handles[--numHandles]);
@@ -383,7 +384,7 @@ _Message::_Message(const _Message& other) :
 {
     if (bufSize > 0) {
         QCC_ASSERT(other.msgBuf != NULL);
-        _msgBuf = new uint8_t[bufSize + 7];
+        _msgBuf = static_cast<uint8_t*>(BufferPool::Alloc(bufSize + 7));
         msgBuf = (uint64_t*)((uintptr_t)(_msgBuf + 7) & ~7);
         bufEOD = ((uint8_t*)msgBuf) + (other.bufEOD - ((uint8_t*)other.msgBuf));
         bufPos = ((uint8_t*)msgBuf) + (other.bufPos - ((uint8_t*)other.msgBuf));
@@ -444,20 +445,52 @@ QStatus _Message::ReMarshal(const char* senderName)
     numRefMsgArgs = 0;
 
     /*
-     * We delete the current buffer after we have copied the body data
+     * Compute the new header sizes
      */
-    uint8_t* _savBuf = _msgBuf;
+    size_t hdrSize = ComputeHeaderLen();
+    /*
+     * Received messages have some space reserved in front of the header. If the new header fits
+     * in front of the body we rewrite it in place and leave the body where it is.
+     */
+    if (bodyPtr && (bodyPtr >= _msgBuf + hdrSize)) {
+        uint8_t* hdrPos = bodyPtr - hdrSize;
+        /*
+         * The header fields still point into the old header which may overlap the new one so we
+         * marshal them to a scratch buffer first and from there to their final position.
+         */
+        uint64_t* scratch = new uint64_t[hdrSize / sizeof(uint64_t)];
+        bufPos = reinterpret_cast<uint8_t*>(scratch) + sizeof(msgHeader);
+        MarshalHeaderFields();
+        bufPos = hdrPos + sizeof(msgHeader);
+        MarshalHeaderFields();
+        QCC_ASSERT(bufPos == bodyPtr);
+        delete [] scratch;
+
+        bufSize += reinterpret_cast<uint8_t*>(msgBuf) - hdrPos;
+        msgBuf = reinterpret_cast<uint64_t*>(hdrPos);
+        memcpy(msgBuf, &msgHeader, sizeof(msgHeader));
+        if (endianSwap) {
+            MessageHeader* hdr = (MessageHeader*)msgBuf;
+            hdr->bodyLen = EndianSwap32(hdr->bodyLen);
+            hdr->serialNum = EndianSwap32(hdr->serialNum);
+            hdr->headerLen = EndianSwap32(hdr->headerLen);
+        }
+        bufPos = bodyPtr + msgHeader.bodyLen;
+        bufEOD = bufPos;
+        return ER_OK;
+    }
 
     /*
-     * Compute the new header sizes
+     * We delete the current buffer after we have copied the body data
      */
-    ComputeHeaderLen();
+    uint8_t* _savBuf = _msgBuf;
+
     /*
      * Padding the end of the buffer ensures we can unmarshal a few bytes beyond the end of the
      * message reducing the places where we need to check for bufEOD when unmarshaling the body.
      */
     bufSize = sizeof(msgHeader) + ((((msgHeader.headerLen + 7) & ~7) + msgHeader.bodyLen + 7) & ~7) + 8;
-    _msgBuf = new uint8_t[bufSize + 7];
+    _msgBuf = static_cast<uint8_t*>(BufferPool::Alloc(bufSize + 7));
     msgBuf = (uint64_t*)((uintptr_t)(_msgBuf + 7) & ~7); /* Align to 8 byte boundary */
     bufPos = (uint8_t*)msgBuf;
     memcpy(bufPos, &msgHeader, sizeof(msgHeader));
@@ -490,7 +523,7 @@ QStatus _Message::ReMarshal(const char* senderName)
      */
     QCC_ASSERT((size_t)(bufEOD - (uint8_t*)msgBuf) < bufSize);
     memset(bufEOD, 0, (uint8_t*)msgBuf + bufSize - bufEOD);
-    delete [] _savBuf;
+    BufferPool::Free(_savBuf);
     return ER_OK;
 }
 
@@ -42,6 +42,7 @@
 #include "AllJoynPeerObj.h"
 #include "SignatureUtils.h"
 #include "BusInternal.h"
+#include "BufferPool.h"
 
 #define QCC_MODULE "ALLJOYN"
 
@@ -618,6 +619,54 @@ QStatus _Message::DeliverNonBlocking(RemoteEndpoint& endpoint)
     }
     return status;
 }
+
+QStatus _Message::GetBatchedDeliveryBuffer(const uint8_t*& buf, size_t& len) const
+{
+    /*
+     * Encryption and handle passing are left to DeliverNonBlocking() as is reporting an empty message.
+     */
+    if ((writeState != MESSAGE_NEW) || encrypt || handles || (bufEOD == reinterpret_cast<uint8_t*>(msgBuf))) {
+        return ER_FAIL;
+    }
+    buf = reinterpret_cast<const uint8_t*>(msgBuf);
+    if (ttl && IsExpired()) {
+        QCC_DbgHLPrintf(("TTL has expired - discarding message %s", Description().c_str()));
+        len = 0;
+    } else {
+        len = bufEOD - buf;
+    }
+    return ER_OK;
+}
+
+QStatus _Message::BeginBatchedDelivery(const uint8_t*& buf, size_t& len)
+{
+    QStatus status = GetBatchedDeliveryBuffer(buf, len);
+    if (status == ER_OK) {
+        writePtr = reinterpret_cast<uint8_t*>(msgBuf);
+        countWrite = len;
+        writeState = countWrite ? MESSAGE_HEADER_BODY : MESSAGE_COMPLETE;
+    }
+    return status;
+}
+
+void _Message::BatchedBytesWritten(size_t numBytes)
+{
+    if (writeState == MESSAGE_NEW) {
+        if (numBytes == 0) {
+            return;
+        }
+        /* Part of the message is on the wire so the rest must follow even if it has expired */
+        writePtr = reinterpret_cast<uint8_t*>(msgBuf);
+        countWrite = bufEOD - writePtr;
+        writeState = MESSAGE_HEADER_BODY;
+    }
+    QCC_ASSERT(numBytes <= countWrite);
+    countWrite -= numBytes;
+    writePtr += numBytes;
+    if (countWrite == 0) {
+        writeState = MESSAGE_COMPLETE;
+    }
+}
 /*
  * Map from our enumeration type to the wire protocol values
  */
@@ -966,7 +1015,7 @@ QStatus _Message::MarshalMessage(const qcc::String& expectedSignature,
      * Allocate buffer for entire message.
      */
     bufSize = (hdrLen + msgHeader.bodyLen + maxCryptoValsLen + 16);
-    _msgBuf = new uint8_t[bufSize];
+    _msgBuf = static_cast<uint8_t*>(BufferPool::Alloc(bufSize));
     msgBuf = (uint64_t*)((uintptr_t)(_msgBuf + 7) & ~7); /* Align to 8 byte boundary */
     /*
      * Initialize the buffer and copy in the message header
@@ -1051,14 +1100,14 @@ ExitMarshalMessage:
     /*
      * Don't need the old message buffer any more
      */
-    delete [] _oldMsgBuf;
+    BufferPool::Free(_oldMsgBuf);
 
     if (status == ER_OK) {
         QCC_DbgHLPrintf(("MarshalMessage: %d+%d %s %s", hdrLen, msgHeader.bodyLen, Description().c_str(), encrypt ? " (encrypted)" : ""));
     } else {
         QCC_LogError(status, ("MarshalMessage: %s", Description().c_str()));
         msgBuf = NULL;
-        delete [] _msgBuf;
+        BufferPool::Free(_msgBuf);
         _msgBuf = NULL;
         bodyPtr = NULL;
         bufPos = NULL;
@@ -41,6 +41,7 @@
 #include "AllJoynPeerObj.h"
 #include "SignatureUtils.h"
 #include "BusInternal.h"
+#include "BufferPool.h"
 
 #define QCC_MODULE "ALLJOYN"
 
@@ -61,6 +62,12 @@ namespace ajn {
 
 #define VALID_HEADER_FIELD(f) (((f) > ALLJOYN_HDR_FIELD_INVALID) && ((f) < ALLJOYN_HDR_FIELD_UNKNOWN))
 
+/*
+ * Space reserved in front of received messages so ReMarshal() can rewrite the sender field
+ * without moving the body. Large enough to add a sender field holding a unique name.
+ */
+#define REMARSHAL_HEADROOM  64
+
 
 
 QStatus _Message::ParseArray(MsgArg* arg,
@@ -117,14 +124,14 @@ QStatus _Message::ParseArray(MsgArg* arg,
             arg->typeId = (AllJoynTypeId)((elemTypeId << 8) | ALLJOYN_ARRAY);
             arg->v_scalarArray.numElements = (size_t)(len / 2);
             if (endianSwap) {
-                arg->v_scalarArray.v_uint16 = new uint16_t[arg->v_scalarArray.numElements];
+                arg->v_scalarArray.v_uint16 = static_cast<uint16_t*>(BufferPool::Alloc(len));
                 uint16_t* p = (uint16_t*)arg->v_scalarArray.v_uint16;
                 uint16_t* n = (uint16_t*)bufPos;
                 for (size_t i = 0; i < arg->v_scalarArray.numElements; i++) {
                     *p++ = EndianSwap16(*n);
                     n++;
                 }
-                arg->flags = MsgArg::OwnsData;
+                arg->flags = MsgArg::OwnsData | MsgArg::PooledData;
             } else {
                 arg->v_scalarArray.v_uint16 = (uint16_t*)bufPos;
             }
@@ -137,14 +144,14 @@ QStatus _Message::ParseArray(MsgArg* arg,
     case ALLJOYN_BOOLEAN:
         if ((len & 3) == 0) {
             size_t num = (size_t)(len / 4);
-            bool* bools = new bool[num];
+            bool* bools = static_cast<bool*>(BufferPool::Alloc(num * sizeof(bool)));
             for (size_t i = 0; i < num; i++) {
                 uint32_t b = *(uint32_t*)bufPos;
                 if (endianSwap) {
                     b = EndianSwap32(b);
                 }
                 if (b > 1) {
-                    delete [] bools;
+                    BufferPool::Free(bools);
                     status = ER_BUS_BAD_VALUE;
                     break;
                 }
@@ -163,7 +170,7 @@ QStatus _Message::ParseArray(MsgArg* arg,
             arg->typeId = ALLJOYN_BOOLEAN_ARRAY;
             arg->v_scalarArray.numElements = num;
             arg->v_scalarArray.v_bool = bools;
-            arg->flags = MsgArg::OwnsData;
+            arg->flags = MsgArg::OwnsData | MsgArg::PooledData;
         } else {
             status = ER_BUS_BAD_LENGTH;
         }
@@ -175,14 +182,14 @@ QStatus _Message::ParseArray(MsgArg* arg,
             arg->typeId = (AllJoynTypeId)((elemTypeId << 8) | ALLJOYN_ARRAY);
             arg->v_scalarArray.numElements = (size_t)(len / 4);
             if (endianSwap) {
-                arg->v_scalarArray.v_uint32 = new uint32_t[arg->v_scalarArray.numElements];
+                arg->v_scalarArray.v_uint32 = static_cast<uint32_t*>(BufferPool::Alloc(len));
                 uint32_t* p = (uint32_t*)arg->v_scalarArray.v_uint32;
                 uint32_t* n = (uint32_t*)bufPos;
                 for (size_t i = 0; i < arg->v_scalarArray.numElements; i++) {
                     *p++ = EndianSwap32(*n);
                     n++;
                 }
-                arg->flags = MsgArg::OwnsData;
+                arg->flags = MsgArg::OwnsData | MsgArg::PooledData;
             } else {
                 arg->v_scalarArray.v_uint32 = (uint32_t*)bufPos;
             }
@@ -201,14 +208,14 @@ QStatus _Message::ParseArray(MsgArg* arg,
             bufPos = AlignPtr(bufPos, 8);
             arg->v_scalarArray.v_uint64 = (uint64_t*)bufPos;
             if (endianSwap) {
-                arg->v_scalarArray.v_uint64 = new uint64_t[arg->v_scalarArray.numElements];
+                arg->v_scalarArray.v_uint64 = static_cast<uint64_t*>(BufferPool::Alloc(len));
                 uint64_t* p = (uint64_t*)arg->v_scalarArray.v_uint64;
                 uint64_t* n = (uint64_t*)bufPos;
                 for (size_t i = 0; i < arg->v_scalarArray.numElements; i++) {
                     *p++ = EndianSwap64(*n);
                     n++;
                 }
-                arg->flags = MsgArg::OwnsData;
+                arg->flags = MsgArg::OwnsData | MsgArg::PooledData;
             } else {
                 arg->v_scalarArray.v_uint64 = (uint64_t*)bufPos;
             }
@@ -940,8 +947,8 @@ QStatus _Message::InterpretHeader()
      */
     bufSize = sizeof(msgHeader) + ((pktSize + 7) & ~7) + sizeof(uint64_t);
     QCC_ASSERT(_msgBuf == nullptr);
-    _msgBuf = new uint8_t[bufSize + 7];
-    msgBuf = (uint64_t*)((uintptr_t)(_msgBuf + 7) & ~7); /* Align to 8 byte boundary */
+    _msgBuf = static_cast<uint8_t*>(BufferPool::Alloc(REMARSHAL_HEADROOM + bufSize + 7));
+    msgBuf = (uint64_t*)((uintptr_t)(_msgBuf + REMARSHAL_HEADROOM + 7) & ~7); /* Align to 8 byte boundary */
     /*
      * Copy header into the buffer
      */
@@ -1118,7 +1125,7 @@ QStatus _Message::Read(RemoteEndpoint& endpoint, bool checkSender, bool pedantic
      * Clear out any stale message state
      */
     msgBuf = NULL;
-    delete [] _msgBuf;
+    BufferPool::Free(_msgBuf);
     _msgBuf = NULL;
     ClearHeader();
     readState = MESSAGE_NEW;
@@ -1362,7 +1369,7 @@ ExitUnmarshal:
          * There was an unrecoverable failure while unmarshaling the message, cleanup before we return.
          */
         msgBuf = NULL;
-        delete [] _msgBuf;
+        BufferPool::Free(_msgBuf);
         _msgBuf = NULL;
         ClearHeader();
         if ((status != ER_SOCK_OTHER_END_CLOSED) && (status != ER_STOPPING_THREAD)) {
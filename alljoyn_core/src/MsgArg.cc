@@ -31,6 +31,7 @@
 #include <alljoyn/Message.h>
 #include <alljoyn/MsgArg.h>
 
+#include "BufferPool.h"
 #include "MsgArgUtils.h"
 #include "SignatureUtils.h"
 #include "BusUtil.h"
@@ -652,21 +653,27 @@ void MsgArg::Clear()
         break;
 
     case ALLJOYN_BOOLEAN_ARRAY:
-        if (flags & OwnsData) {
+        if (flags & PooledData) {
+            BufferPool::Free((void*)v_scalarArray.v_bool);
+        } else if (flags & OwnsData) {
             delete [] v_scalarArray.v_bool;
         }
         break;
 
     case ALLJOYN_INT32_ARRAY:
     case ALLJOYN_UINT32_ARRAY:
-        if (flags & OwnsData) {
+        if (flags & PooledData) {
+            BufferPool::Free((void*)v_scalarArray.v_uint32);
+        } else if (flags & OwnsData) {
             delete [] v_scalarArray.v_uint32;
         }
         break;
 
     case ALLJOYN_INT16_ARRAY:
     case ALLJOYN_UINT16_ARRAY:
-        if (flags & OwnsData) {
+        if (flags & PooledData) {
+            BufferPool::Free((void*)v_scalarArray.v_uint16);
+        } else if (flags & OwnsData) {
             delete [] v_scalarArray.v_uint16;
         }
         break;
@@ -674,7 +681,9 @@ void MsgArg::Clear()
     case ALLJOYN_DOUBLE_ARRAY:
     case ALLJOYN_UINT64_ARRAY:
     case ALLJOYN_INT64_ARRAY:
-        if (flags & OwnsData) {
+        if (flags & PooledData) {
+            BufferPool::Free((void*)v_scalarArray.v_uint64);
+        } else if (flags & OwnsData) {
             delete [] v_scalarArray.v_uint64;
         }
         break;
@@ -413,6 +413,7 @@ void _PeerState::SetGuildMetadata(const qcc::String& serial, const qcc::String&
         guildMap.erase(key);
     }
     guildMap[key] = guild;
+    ClearAuthorizationCache();
 }
 
 _PeerState::GuildMetadata* _PeerState::GetGuildMetadata(const qcc::String& serial, const String& issuerAki)
@@ -544,6 +545,7 @@ QStatus _PeerState::SetAuthSuite(const String& authSuite)
 QStatus _PeerState::StoreManifest(const Manifest& manifest)
 {
     m_manifests.push_back(manifest);
+    ClearAuthorizationCache();
 
     return ER_OK;
 }
@@ -551,6 +553,7 @@ QStatus _PeerState::StoreManifest(const Manifest& manifest)
 QStatus _PeerState::ClearManifests()
 {
     m_manifests.clear();
+    ClearAuthorizationCache();
 
     return ER_OK;
 }
@@ -560,6 +563,59 @@ const std::vector<Manifest> _PeerState::GetManifests() const
     return m_manifests;
 }
 
+/* Bounds the cache for a peer that exercises many distinct object paths */
+static const size_t MAX_CACHED_AUTHORIZATIONS = 1024;
+
+bool _PeerState::GetCachedAuthorization(const std::string& key, uint32_t generation, uint32_t keyStoreChanges, bool& authorized, uint32_t& epoch)
+{
+    bool found = false;
+    authorizationCacheLock.Lock(MUTEX_CONTEXT);
+    if ((authorizationCacheKeyStoreChanges != keyStoreChanges) ||
+        ((authorizationCacheExpiration.seconds != 0) && (authorizationCacheExpiration <= Timespec<EpochTime>(GetEpochTimestamp())))) {
+        /* The peer's key store entry may not be what the decisions were made from */
+        authorizationCache.clear();
+        ++authorizationCacheEpoch;
+        authorizationCacheKeyStoreChanges = keyStoreChanges;
+        authorizationCacheExpiration = Timespec<EpochTime>();
+    }
+    epoch = authorizationCacheEpoch;
+    if (authorizationCacheGeneration == generation) {
+        std::unordered_map<std::string, bool>::const_iterator it = authorizationCache.find(key);
+        if (it != authorizationCache.end()) {
+            authorized = it->second;
+            found = true;
+        }
+    }
+    authorizationCacheLock.Unlock(MUTEX_CONTEXT);
+    return found;
+}
+
+void _PeerState::CacheAuthorization(const std::string& key, uint32_t generation, uint32_t epoch, const Timespec<EpochTime>& expiration, bool authorized)
+{
+    authorizationCacheLock.Lock(MUTEX_CONTEXT);
+    if (epoch != authorizationCacheEpoch) {
+        authorizationCacheLock.Unlock(MUTEX_CONTEXT);
+        return;
+    }
+    if ((authorizationCacheGeneration != generation) || (authorizationCache.size() >= MAX_CACHED_AUTHORIZATIONS)) {
+        authorizationCache.clear();
+        authorizationCacheGeneration = generation;
+    }
+    if ((expiration.seconds != 0) && ((authorizationCacheExpiration.seconds == 0) || (expiration < authorizationCacheExpiration))) {
+        authorizationCacheExpiration = expiration;
+    }
+    authorizationCache[key] = authorized;
+    authorizationCacheLock.Unlock(MUTEX_CONTEXT);
+}
+
+void _PeerState::ClearAuthorizationCache()
+{
+    authorizationCacheLock.Lock(MUTEX_CONTEXT);
+    authorizationCache.clear();
+    ++authorizationCacheEpoch;
+    authorizationCacheLock.Unlock(MUTEX_CONTEXT);
+}
+
 /* Since we're using the signature as the key which has good randomness, we don't need to use
  * the entire signature as the key; this many bytes will do.
  */
@@ -168,7 +168,12 @@ class _PeerState {
         m_authSuite(0),
         m_manifests(),
         m_manifestsSent(),
-        m_haveExchangedManifests(false)
+        m_haveExchangedManifests(false),
+        authorizationCacheLock(qcc::LOCK_LEVEL_PEERSTATE_AUTHORIZATIONCACHELOCK),
+        authorizationCacheGeneration(0),
+        authorizationCacheEpoch(0),
+        authorizationCacheKeyStoreChanges(0),
+        authorizationCacheExpiration()
     {
         ::memset(authorizations, 0, sizeof(authorizations));
     }
@@ -228,6 +233,7 @@ class _PeerState {
     void SetKey(const qcc::KeyBlob& key, PeerKeyType keyType) {
         keys[keyType] = key;
         isSecure = key.IsValid();
+        ClearAuthorizationCache();
     }
 
     /**
@@ -261,6 +267,7 @@ class _PeerState {
         keys[PEER_GROUP_KEY].Erase();
         isSecure = false;
         m_authSuite = 0;
+        ClearAuthorizationCache();
     }
 
     /**
@@ -362,7 +369,8 @@ class _PeerState {
     GuildMetadata* GetGuildMetadata(const qcc::String& serial, const qcc::String& issuerAki);
 
     /**
-     * Mapping table for guild memberships
+     * Mapping table for guild memberships.  Call ClearAuthorizationCache()
+     * after changing it.
      */
     GuildMap guildMap;
 
@@ -646,6 +654,45 @@ class _PeerState {
      */
     ~_PeerState();
 
+    /**
+     * Look up a cached authorization decision for a request from or to this peer.
+     *
+     * The cached decisions are dropped first if the key store changed or the
+     * peer's key store entry expired since they were made.
+     *
+     * @param[in] key              Describes the request, see PermissionManager.
+     * @param[in] generation       The PermissionManager's current policy generation.
+     * @param[in] keyStoreChanges  The key store's current change count.
+     * @param[out] authorized      The cached decision.
+     * @param[out] epoch           Identifies the peer state the decision must be made
+     *                             under, to be passed to CacheAuthorization().
+     *
+     * @return true if a decision is cached for the key and generation, false otherwise.
+     */
+    bool GetCachedAuthorization(const std::string& key, uint32_t generation, uint32_t keyStoreChanges, bool& authorized, uint32_t& epoch);
+
+    /**
+     * Cache an authorization decision for a request from or to this peer.
+     *
+     * The decision is dropped if ClearAuthorizationCache() was called or the
+     * cache was found stale since the GetCachedAuthorization() call that
+     * returned epoch.
+     *
+     * @param[in] key         Describes the request, see PermissionManager.
+     * @param[in] generation  The policy generation the decision was made under.
+     * @param[in] epoch       The epoch returned by GetCachedAuthorization().
+     * @param[in] expiration  When the peer's key store entry the decision was
+     *                        made from expires, zero if it does not.
+     * @param[in] authorized  The decision.
+     */
+    void CacheAuthorization(const std::string& key, uint32_t generation, uint32_t epoch, const qcc::Timespec<qcc::EpochTime>& expiration, bool authorized);
+
+    /**
+     * Drop the cached authorization decisions.  Must be called whenever the
+     * peer's keys, manifests or memberships change.
+     */
+    void ClearAuthorizationCache();
+
   private:
     /**
      * private assignment operator to prevent double freeing of memory
@@ -781,6 +828,36 @@ class _PeerState {
      */
     bool m_haveExchangedManifests;
 
+    /**
+     * Mutex to protect the authorization cache
+     */
+    qcc::Mutex authorizationCacheLock;
+
+    /**
+     * Authorization decisions for requests from or to this peer, see PermissionManager.
+     */
+    std::unordered_map<std::string, bool> authorizationCache;
+
+    /**
+     * The policy generation the cached authorization decisions were made under.
+     */
+    uint32_t authorizationCacheGeneration;
+
+    /**
+     * Incremented by ClearAuthorizationCache() so decisions made from stale peer state are not cached.
+     */
+    uint32_t authorizationCacheEpoch;
+
+    /**
+     * The key store change count the cached authorization decisions were made under.
+     */
+    uint32_t authorizationCacheKeyStoreChanges;
+
+    /**
+     * When the earliest key store entry a cached authorization decision was made from expires, zero if none does.
+     */
+    qcc::Timespec<qcc::EpochTime> authorizationCacheExpiration;
+
 };
 
 
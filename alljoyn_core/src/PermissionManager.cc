@@ -229,15 +229,20 @@ static bool IsRuleMatched(const PermissionPolicy::Rule& rule, const Request& req
     }
 }
 
-static bool IsPolicyAclMatched(const PermissionPolicy::Acl& acl, const Request& request, uint8_t requiredAuth, bool scanForDenied, bool& denied)
+/**
+ * Only the rules the index returns for the request are checked, the others
+ * can neither allow nor deny it.
+ */
+static bool IsPolicyAclMatched(const PermissionPolicy::Acl& acl, const PermissionPolicyIndex& policyIndex, size_t aclIndex, const Request& request, uint8_t requiredAuth, bool scanForDenied, bool& denied)
 {
     bool strictGetAllProperties = request.outgoing;
     const PermissionPolicy::Rule* rules = acl.GetRules();
     bool allowed = false;
-    size_t rulesSize = acl.GetRulesSize();
-    QCC_DbgTrace(("%s: Checking if request matches against %u rules.", __FUNCTION__, rulesSize));
-    for (size_t cnt = 0; cnt < rulesSize; cnt++) {
-        if (IsRuleMatched(rules[cnt], request, requiredAuth, scanForDenied, denied, strictGetAllProperties)) {
+    std::vector<size_t> candidates;
+    policyIndex.GetCandidateRules(aclIndex, request.objPath, request.iName, request.mbrName, candidates);
+    QCC_DbgTrace(("%s: Checking if request matches against %u of %u rules.", __FUNCTION__, candidates.size(), acl.GetRulesSize()));
+    for (size_t cnt = 0; cnt < candidates.size(); cnt++) {
+        if (IsRuleMatched(rules[candidates[cnt]], request, requiredAuth, scanForDenied, denied, strictGetAllProperties)) {
             QCC_DbgTrace(("%s: Match found, rule allows access. Continuing search for explicit deny.", __FUNCTION__));
             allowed = true; /* track it */
         } else if (denied) {
@@ -396,7 +401,7 @@ static bool IsPeerQualifiedForAcl(const PermissionPolicy::Acl& acl, PeerState& p
  * The peer is authorized if there is no applicable deny and at least one allow.
  */
 
-static bool IsPeerAuthorized(const Request& request, const PermissionPolicy* policy, PeerState& peerState, bool trustedPeer, const qcc::ECCPublicKey* peerPublicKey, const std::vector<ECCPublicKey>& issuerChain, uint8_t requiredAuth, bool& denied)
+static bool IsPeerAuthorized(const Request& request, const PermissionPolicy* policy, const PermissionPolicyIndex& policyIndex, PeerState& peerState, bool trustedPeer, const qcc::ECCPublicKey* peerPublicKey, const std::vector<ECCPublicKey>& issuerChain, uint8_t requiredAuth, bool& denied)
 {
     bool allowed = false;
     denied = false;
@@ -412,7 +417,7 @@ static bool IsPeerAuthorized(const Request& request, const PermissionPolicy* pol
             continue;
         }
         QCC_DbgTrace(("%s: Peer qualified for ACL number %u.", __FUNCTION__, cnt));
-        if (IsPolicyAclMatched(acls[cnt], request, requiredAuth, qualifiedPeerWithPublicKey, denied)) {
+        if (IsPolicyAclMatched(acls[cnt], policyIndex, cnt, request, requiredAuth, qualifiedPeerWithPublicKey, denied)) {
             allowed = true;   /* track it */
         }
         if (denied) {
@@ -423,6 +428,69 @@ static bool IsPeerAuthorized(const Request& request, const PermissionPolicy* pol
     return allowed;
 }
 
+/**
+ * What the key store and the local keys say about the peer, as far as the
+ * policy is concerned.
+ */
+struct PeerAuthState {
+    bool trustedPeer;
+    bool enforceManifest;
+    const ECCPublicKey* trustedPeerPublicKey;  /**< Points at one of the keys below, or NULL */
+    ECCPublicKey peerPublicKey;
+    KeyInfoNISTP256 publicKeyInfo;
+    std::vector<ECCPublicKey> issuerPublicKeys;
+    qcc::Timespec<qcc::EpochTime> expiration;  /**< When the peer's key store entry expires, zero if it does not */
+
+    PeerAuthState() : trustedPeer(false), enforceManifest(true), trustedPeerPublicKey(NULL)
+    {
+    }
+
+  private:
+    /* The key pointer must not be copied */
+    PeerAuthState(const PeerAuthState& other);
+    PeerAuthState& operator=(const PeerAuthState& other);
+};
+
+/**
+ * Look up what the policy needs to know about an authenticated peer: whether
+ * it is trusted, its public key and issuers, and whether its manifests apply.
+ */
+static void GetPeerAuthState(PeerState& peerState, PermissionMgmtObj* permissionMgmtObj, bool authenticated, PeerAuthState& state)
+{
+    if (!authenticated) {
+        return;
+    }
+    if (peerState->IsLocalPeer()) {
+        if (ER_OK == permissionMgmtObj->GetPublicKey(state.publicKeyInfo)) {
+            state.trustedPeerPublicKey = state.publicKeyInfo.GetPublicKey();
+            state.trustedPeer = true;
+            state.enforceManifest = false;
+        }
+    } else {
+        bool publicKeyFound = false;
+        qcc::String authMechanism;
+        QStatus status = permissionMgmtObj->GetConnectedPeerAuthMetadata(peerState->GetGuid(), authMechanism, publicKeyFound, &state.peerPublicKey, NULL, state.issuerPublicKeys, &state.expiration);
+        if (ER_OK == status) {
+            /* trusted peer */
+            if (publicKeyFound) {
+                state.trustedPeerPublicKey = &state.peerPublicKey;
+                state.trustedPeer = true;
+            } else if ((authMechanism == KeyExchangerECDHE_PSK::AuthName()) ||
+                       (authMechanism == AuthMechSRP::AuthName()) ||
+                       (authMechanism == AuthMechLogon::AuthName())) {
+                state.trustedPeer = true;
+                state.enforceManifest = false;
+            } else {
+                state.enforceManifest = false;
+            }
+        } else if (ER_BUS_KEY_UNAVAILABLE == status) {
+            /* assuming the peer secret just expires so it is not a trusted
+             * peer */
+            state.enforceManifest = false;
+        }
+    }
+}
+
 /**
  * The search order through the Acls:
  * 1. peer public key
@@ -432,61 +500,21 @@ static bool IsPeerAuthorized(const Request& request, const PermissionPolicy* pol
  * 5. all peers
  */
 
-static bool IsAuthorized(const Request& request, const PermissionPolicy* policy, PeerState& peerState, PermissionMgmtObj* permissionMgmtObj, bool authenticated = true)
+static bool IsAuthorized(const Request& request, const Right& right, const PermissionPolicy* policy, const PermissionPolicyIndex* policyIndex, PeerState& peerState, const PeerAuthState& authState)
 {
-    Right right;
-    GenRight(request, right);
-
     bool authorized = false;
     bool denied = false;
-    bool enforceManifest = true;
 
     QCC_DbgPrintf(("IsAuthorized with required permission %d, iName %s, mbrName %s\n", right.authByPolicy, request.iName, request.mbrName));
 
     if (right.authByPolicy) {
-        if (policy == NULL) {
+        if ((policy == NULL) || (policyIndex == NULL)) {
             authorized = false;  /* no policy deny all */
             QCC_DbgPrintf(("Not authorized because of missing policy"));
             return false;
         }
         /* validate the remote peer auth data to make sure it was granted to perform such action */
-        ECCPublicKey peerPublicKey;
-        KeyInfoNISTP256 publicKeyInfo;
-        std::vector<ECCPublicKey> issuerPublicKeys;
-        const ECCPublicKey* trustedPeerPublicKey = NULL;
-        bool trustedPeer = false;
-        if (authenticated) {
-            if (peerState->IsLocalPeer()) {
-                if (ER_OK == permissionMgmtObj->GetPublicKey(publicKeyInfo)) {
-                    trustedPeerPublicKey = publicKeyInfo.GetPublicKey();
-                    trustedPeer = true;
-                    enforceManifest = false;
-                }
-            } else {
-                bool publicKeyFound = false;
-                qcc::String authMechanism;
-                QStatus status = permissionMgmtObj->GetConnectedPeerAuthMetadata(peerState->GetGuid(), authMechanism, publicKeyFound, &peerPublicKey, NULL, issuerPublicKeys);
-                if (ER_OK == status) {
-                    /* trusted peer */
-                    if (publicKeyFound) {
-                        trustedPeerPublicKey = &peerPublicKey;
-                        trustedPeer = true;
-                    } else if ((authMechanism == KeyExchangerECDHE_PSK::AuthName()) ||
-                               (authMechanism == AuthMechSRP::AuthName()) ||
-                               (authMechanism == AuthMechLogon::AuthName())) {
-                        trustedPeer = true;
-                        enforceManifest = false;
-                    } else {
-                        enforceManifest = false;
-                    }
-                } else if (ER_BUS_KEY_UNAVAILABLE == status) {
-                    /* assuming the peer secret just expires so it is not a trusted
-                     * peer */
-                    enforceManifest = false;
-                }
-            }
-        }
-        authorized = IsPeerAuthorized(request, policy, peerState, trustedPeer, trustedPeerPublicKey, issuerPublicKeys, right.authByPolicy, denied);
+        authorized = IsPeerAuthorized(request, policy, *policyIndex, peerState, authState.trustedPeer, authState.trustedPeerPublicKey, authState.issuerPublicKeys, right.authByPolicy, denied);
 #ifndef NDEBUG
         for (_PeerState::GuildMap::iterator it = peerState->guildMap.begin(); it != peerState->guildMap.end(); it++) {
             _PeerState::GuildMetadata* metadata = it->second;
@@ -498,13 +526,13 @@ static bool IsAuthorized(const Request& request, const PermissionPolicy* policy,
             }
         }
 #endif
-        QCC_DbgPrintf(("Peer's trusted peer: %d public key: %s Authorized: %d Denied: %d Manifest required: %d", trustedPeer, trustedPeerPublicKey ? trustedPeerPublicKey->ToString().c_str() : "N/A", authorized, denied, enforceManifest));
+        QCC_DbgPrintf(("Peer's trusted peer: %d public key: %s Authorized: %d Denied: %d Manifest required: %d", authState.trustedPeer, authState.trustedPeerPublicKey ? authState.trustedPeerPublicKey->ToString().c_str() : "N/A", authorized, denied, authState.enforceManifest));
         if (denied || !authorized) {
             return false;
         }
     }
 
-    if (authorized && enforceManifest) {
+    if (authorized && authState.enforceManifest) {
         authorized = IsAuthorizedByPeerManifest(request, right, peerState);
         QCC_DbgPrintf(("Enforce peer's manifest: Authorized: %d", authorized));
     }
@@ -763,6 +791,53 @@ bool PermissionManager::AuthorizePermissionMgmt(bool outgoing, const char* iName
     return false;  /* not handled */
 }
 
+/**
+ * Build the key a request's authorization decision is cached under.  Object
+ * paths, interface names and member names cannot contain spaces or '*'.
+ */
+static std::string AuthorizationCacheKey(const Request& request, bool authenticated)
+{
+    std::string key;
+    key += request.outgoing ? 'o' : 'i';
+    key += authenticated ? 'a' : 'u';
+    key += request.propertyRequest ? (request.isSetProperty ? 's' : 'g') : '-';
+    key += static_cast<char>('0' + request.mbrType);
+    key += ' ';
+    key += request.objPath ? request.objPath : "";
+    key += ' ';
+    key += request.iName ? request.iName : "";
+    key += ' ';
+    key += request.mbrName ? request.mbrName : "*";
+    return key;
+}
+
+bool PermissionManager::IsAuthorizedCached(const Request& request, PeerState& peerState, bool authenticated)
+{
+    std::string key = AuthorizationCacheKey(request, authenticated);
+    /*
+     * Read the generation and the key store change count first so a decision
+     * racing with a policy or key store change is cached as stale.
+     */
+    uint32_t generation = static_cast<uint32_t>(policyGeneration);
+    uint32_t keyStoreChanges = permissionMgmtObj ? permissionMgmtObj->GetKeyStoreChangeCount() : 0;
+    bool authorized = false;
+    uint32_t epoch;
+    if (peerState->GetCachedAuthorization(key, generation, keyStoreChanges, authorized, epoch)) {
+        authorizationCacheHits->Increment();
+        return authorized;
+    }
+    authorizationCacheMisses->Increment();
+    Right right;
+    GenRight(request, right);
+    PeerAuthState authState;
+    if (right.authByPolicy) {
+        GetPeerAuthState(peerState, permissionMgmtObj, authenticated, authState);
+    }
+    authorized = IsAuthorized(request, right, GetPolicy(), policyIndex, peerState, authState);
+    peerState->CacheAuthorization(key, generation, epoch, authState.expiration, authorized);
+    return authorized;
+}
+
 QStatus PermissionManager::AuthorizeMessage(bool outgoing, Message& msg, PeerState& peerState, bool authenticated)
 {
     QStatus status = ER_PERMISSION_DENIED;
@@ -816,7 +891,7 @@ QStatus PermissionManager::AuthorizeMessage(bool outgoing, Message& msg, PeerSta
     QCC_DbgPrintf(("PermissionManager::AuthorizeMessage with outgoing: %d msg %s", outgoing, msg->ToString().c_str()));
     QCC_DbgPrintf(("PermissionManager::AuthorizeMessage: local policy %s", GetPolicy() ? GetPolicy()->ToString().c_str() : "NULL"));
 
-    authorized = IsAuthorized(request, GetPolicy(), peerState, permissionMgmtObj, authenticated);
+    authorized = IsAuthorizedCached(request, peerState, authenticated);
     if (!authorized) {
         QCC_DbgPrintf(("PermissionManager::AuthorizeMessage IsAuthorized returns ER_PERMISSION_DENIED\n"));
         return ER_PERMISSION_DENIED;
@@ -838,7 +913,7 @@ QStatus PermissionManager::AuthorizeGetProperty(const char* objPath, const char*
     QCC_DbgPrintf(("PermissionManager::AuthorizeGetProperty: ifc %s prop %s local policy %s", ifcName, propName, GetPolicy() ? GetPolicy()->ToString().c_str() : "NULL"));
 
     Request request(objPath, ifcName, propName, PermissionPolicy::Rule::Member::PROPERTY, false, true);
-    if (!IsAuthorized(request, GetPolicy(), peerState, permissionMgmtObj)) {
+    if (!IsAuthorizedCached(request, peerState, true)) {
         QCC_DbgPrintf(("PermissionManager::AuthorizeGetProperty IsAuthorized returns ER_PERMISSION_DENIED\n"));
         return ER_PERMISSION_DENIED;
     }
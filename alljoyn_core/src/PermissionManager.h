@@ -25,11 +25,27 @@
 #error Only include PermissionManager.h in C++ code.
 #endif
 
+#include <qcc/Metrics.h>
+#include <qcc/atomic.h>
 #include <alljoyn/PermissionPolicy.h>
 #include "PermissionMgmtObj.h"
+#include "PermissionPolicyIndex.h"
 
 namespace ajn {
 
+struct Request;
+
+/**
+ * Authorizes secure messages against the local policy and the peers' manifests.
+ *
+ * The policy rules are indexed by object path, interface name and member name
+ * when the policy is set so only the rules that may match a request are
+ * evaluated.  Decisions are cached per peer, keyed on the direction, message type, object
+ * path, interface and member of the request.  The cache for every peer is
+ * dropped when the policy generation changes, and a peer's cache is dropped
+ * when its keys, manifests or memberships change, when the key store changes
+ * or when the peer's key store entry expires.
+ */
 class PermissionManager {
 
   public:
@@ -38,7 +54,9 @@ class PermissionManager {
      * Constructor
      *
      */
-    PermissionManager() : policy(NULL), permissionMgmtObj(NULL)
+    PermissionManager() : policy(NULL), policyIndex(NULL), permissionMgmtObj(NULL), policyGeneration(0),
+        authorizationCacheHits(qcc::Metrics::GetCounter("permission.authorize.cache.hits")),
+        authorizationCacheMisses(qcc::Metrics::GetCounter("permission.authorize.cache.misses"))
     {
     }
 
@@ -47,6 +65,7 @@ class PermissionManager {
      */
     virtual ~PermissionManager()
     {
+        delete policyIndex;
         delete policy;
     }
 
@@ -57,8 +76,20 @@ class PermissionManager {
 
     void SetPolicy(PermissionPolicy* policy)
     {
+        delete policyIndex;
         delete this->policy;
         this->policy = policy;
+        policyIndex = policy ? new PermissionPolicyIndex(*policy) : NULL;
+        InvalidateAuthorizationCache();
+    }
+
+    /**
+     * Drop every cached authorization decision, for changes other than the
+     * policy itself that affect authorization, such as the trust anchors.
+     */
+    void InvalidateAuthorizationCache()
+    {
+        qcc::IncrementAndFetch(&policyGeneration);
     }
 
     /**
@@ -124,8 +155,21 @@ class PermissionManager {
 
     bool AuthorizePermissionMgmt(bool outgoing, const char* iName, const char* mbrName, bool& authorized, PeerState& peerState);
 
+    /**
+     * Authorize a request using the peer's cached decision if there is one.
+     * @param request the request
+     * @param peerState the peer's PeerState object
+     * @param authenticated flag indicating the message is authenticated
+     * @return true if the request is authorized, false otherwise.
+     */
+    bool IsAuthorizedCached(const Request& request, PeerState& peerState, bool authenticated);
+
     PermissionPolicy* policy;
+    PermissionPolicyIndex* policyIndex;             /**< The rules of the policy by object path, interface and member */
     PermissionMgmtObj* permissionMgmtObj;
+    volatile int32_t policyGeneration;              /**< Changes whenever every cached decision becomes stale */
+    qcc::MetricCounter* authorizationCacheHits;     /**< Requests authorized from the cache */
+    qcc::MetricCounter* authorizationCacheMisses;   /**< Requests authorized by walking the policy */
 };
 
 }
@@ -183,6 +183,8 @@ void PermissionMgmtObj::PolicyChanged(PermissionPolicy* policy)
     ca->GetGuid(localGUID);
     bus.GetInternal().GetPermissionManager().SetPolicy(policy);
     ManageTrustAnchors(policy);
+    /* Decisions made between SetPolicy() and ManageTrustAnchors() saw the old trust anchors */
+    bus.GetInternal().GetPermissionManager().InvalidateAuthorizationCache();
 
     /* Finally, inform the application that it's security policy has changed. */
     bus.GetInternal().CallPolicyChangedCallback();
@@ -2419,6 +2421,7 @@ QStatus PermissionMgmtObj::ParseSendMemberships(Message& msg, bool& done)
         status = GetConnectedPeerPublicKey(peerState->GetGuid(), &peerPublicKey);
         if (ER_OK != status) {
             _PeerState::ClearGuildMap(peerState->guildMap);
+            peerState->ClearAuthorizationCache();
             done = true;
             return ER_OK;  /* could not validate */
         }
@@ -2462,6 +2465,7 @@ QStatus PermissionMgmtObj::ParseSendMemberships(Message& msg, bool& done)
                 break;  /* done */
             }
         }
+        peerState->ClearAuthorizationCache();
         done = true;
     }
     return ER_OK;
@@ -2639,7 +2643,7 @@ void PermissionMgmtObj::Reset(const InterfaceDescription::Member* member, Messag
     MethodReply(msg, Reset());
 }
 
-QStatus PermissionMgmtObj::GetConnectedPeerAuthMetadata(const GUID128& guid, qcc::String& authMechanism, bool& publicKeyFound, qcc::ECCPublicKey* publicKey, uint8_t* identityCertificateThumbprint, std::vector<ECCPublicKey>& issuerPublicKeys)
+QStatus PermissionMgmtObj::GetConnectedPeerAuthMetadata(const GUID128& guid, qcc::String& authMechanism, bool& publicKeyFound, qcc::ECCPublicKey* publicKey, uint8_t* identityCertificateThumbprint, std::vector<ECCPublicKey>& issuerPublicKeys, qcc::Timespec<qcc::EpochTime>* expiration)
 {
     CredentialAccessor ca(bus);
     KeyBlob kb;
@@ -2648,6 +2652,9 @@ QStatus PermissionMgmtObj::GetConnectedPeerAuthMetadata(const GUID128& guid, qcc
     if (ER_OK != status) {
         return status;
     }
+    if (expiration) {
+        kb.GetExpiration(*expiration);
+    }
     KeyBlob msBlob;
     publicKeyFound = false;
     status = KeyExchanger::ParsePeerSecretRecord(kb, msBlob, publicKey, identityCertificateThumbprint, issuerPublicKeys, publicKeyFound);
@@ -2658,6 +2665,11 @@ QStatus PermissionMgmtObj::GetConnectedPeerAuthMetadata(const GUID128& guid, qcc
     return status;
 }
 
+uint32_t PermissionMgmtObj::GetKeyStoreChangeCount()
+{
+    return bus.GetInternal().GetKeyStore().GetChangeCount();
+}
+
 QStatus PermissionMgmtObj::GetConnectedPeerPublicKey(const GUID128& guid, qcc::ECCPublicKey* publicKey, std::vector<ECCPublicKey>& issuerPublicKeys)
 {
     bool publicKeyFound = false;
@@ -360,9 +360,18 @@ class PermissionMgmtObj : public BusObject {
      * @param[out] identityCertificateThumbprint buffer to receive the SHA-256 thumbprint of the identity certificate
      * @param[out] issuerPublicKeys the vector for the list of issuer public
      *                               keys.
+     * @param[out] expiration the time the peer's key store entry expires,
+     *                        zero if it does not.  Pass NULL to skip.
      * @return ER_OK if successful; otherwise, error code.
      */
-    QStatus GetConnectedPeerAuthMetadata(const qcc::GUID128& guid, qcc::String& authMechanism, bool& publicKeyFound, qcc::ECCPublicKey* publicKey, uint8_t* identityCertificateThumbprint, std::vector<qcc::ECCPublicKey>& issuerPublicKeys);
+    QStatus GetConnectedPeerAuthMetadata(const qcc::GUID128& guid, qcc::String& authMechanism, bool& publicKeyFound, qcc::ECCPublicKey* publicKey, uint8_t* identityCertificateThumbprint, std::vector<qcc::ECCPublicKey>& issuerPublicKeys, qcc::Timespec<qcc::EpochTime>* expiration = NULL);
+
+    /**
+     * Get the change count of the key store holding the connected peers'
+     * authentication metadata.
+     * @return the count returned by KeyStore::GetChangeCount()
+     */
+    uint32_t GetKeyStoreChangeCount();
 
     /**
      * Get the connected peer ECC public key if the connection uses the
@@ -0,0 +1,156 @@
+/**
+ * @file
+ * This file implements an index of the rules of a permission policy by object
+ * path, interface name and member name.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <algorithm>
+#include <iterator>
+
+#include "PermissionPolicyIndex.h"
+
+#define QCC_MODULE "PERMISSION_MGMT"
+
+using namespace std;
+using namespace qcc;
+
+namespace ajn {
+
+PermissionPolicyIndex::PatternTrie::Node::~Node()
+{
+    for (map<char, Node*>::iterator it = children.begin(); it != children.end(); ++it) {
+        delete it->second;
+    }
+}
+
+void PermissionPolicyIndex::PatternTrie::Add(const String& pattern, size_t rule)
+{
+    /*
+     * WildcardMatch() treats a trailing '*' as "any suffix, including none",
+     * anything else with a wildcard is left for the caller to match.
+     */
+    size_t wildcard = pattern.find_first_of("*?");
+    bool isPrefix = (wildcard == pattern.size() - 1) && (pattern[wildcard] == '*');
+    if ((wildcard != String::npos) && !isPrefix) {
+        generic.push_back(rule);
+        return;
+    }
+    size_t len = isPrefix ? wildcard : pattern.size();
+    Node* node = &root;
+    for (size_t i = 0; i < len; ++i) {
+        Node*& child = node->children[pattern[i]];
+        if (!child) {
+            child = new Node();
+        }
+        node = child;
+    }
+    if (isPrefix) {
+        node->prefix.push_back(rule);
+    } else {
+        node->exact.push_back(rule);
+    }
+}
+
+void PermissionPolicyIndex::PatternTrie::Lookup(const char* str, vector<size_t>& rules) const
+{
+    rules = generic;
+    const Node* node = &root;
+    const char* c = str ? str : "";
+    while (true) {
+        rules.insert(rules.end(), node->prefix.begin(), node->prefix.end());
+        if (*c == '\0') {
+            rules.insert(rules.end(), node->exact.begin(), node->exact.end());
+            break;
+        }
+        map<char, Node*>::const_iterator it = node->children.find(*c++);
+        if (it == node->children.end()) {
+            break;
+        }
+        node = it->second;
+    }
+    sort(rules.begin(), rules.end());
+    rules.erase(unique(rules.begin(), rules.end()), rules.end());
+}
+
+PermissionPolicyIndex::PermissionPolicyIndex(const PermissionPolicy& policy)
+{
+    const PermissionPolicy::Acl* policyAcls = policy.GetAcls();
+    for (size_t acl = 0; acl < policy.GetAclsSize(); ++acl) {
+        AclIndex* index = new AclIndex();
+        const PermissionPolicy::Rule* rules = policyAcls[acl].GetRules();
+        for (size_t rule = 0; rule < policyAcls[acl].GetRulesSize(); ++rule) {
+            /* A rule without an object path, an interface name or members never matches */
+            String objPath = rules[rule].GetObjPath();
+            String iName = rules[rule].GetInterfaceName();
+            if (objPath.empty() || iName.empty() || (rules[rule].GetMembersSize() == 0)) {
+                continue;
+            }
+            index->objPaths.Add(objPath, rule);
+            index->interfaces.Add(iName, rule);
+            const PermissionPolicy::Rule::Member* members = rules[rule].GetMembers();
+            for (size_t member = 0; member < rules[rule].GetMembersSize(); ++member) {
+                String mbrName = members[member].GetMemberName();
+                if (!mbrName.empty()) {
+                    index->members.Add(mbrName, rule);
+                }
+            }
+        }
+        acls.push_back(index);
+    }
+}
+
+PermissionPolicyIndex::~PermissionPolicyIndex()
+{
+    for (size_t i = 0; i < acls.size(); ++i) {
+        delete acls[i];
+    }
+}
+
+void PermissionPolicyIndex::GetCandidateRules(size_t aclIndex, const char* objPath, const char* iName, const char* mbrName, vector<size_t>& rules) const
+{
+    rules.clear();
+    if (aclIndex >= acls.size()) {
+        return;
+    }
+    const AclIndex* index = acls[aclIndex];
+    vector<size_t> byObjPath;
+    vector<size_t> byInterface;
+    index->objPaths.Lookup(objPath, byObjPath);
+    if (byObjPath.empty()) {
+        return;
+    }
+    index->interfaces.Lookup(iName, byInterface);
+    if (!mbrName || (*mbrName == '\0')) {
+        /* Every member is considered, see IsRuleMatched() */
+        set_intersection(byObjPath.begin(), byObjPath.end(), byInterface.begin(), byInterface.end(), back_inserter(rules));
+        return;
+    }
+    vector<size_t> byBoth;
+    vector<size_t> byMember;
+    set_intersection(byObjPath.begin(), byObjPath.end(), byInterface.begin(), byInterface.end(), back_inserter(byBoth));
+    if (byBoth.empty()) {
+        return;
+    }
+    index->members.Lookup(mbrName, byMember);
+    set_intersection(byBoth.begin(), byBoth.end(), byMember.begin(), byMember.end(), back_inserter(rules));
+}
+
+}
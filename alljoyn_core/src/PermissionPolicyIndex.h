@@ -0,0 +1,134 @@
+#ifndef _ALLJOYN_PERMISSION_POLICY_INDEX_H
+#define _ALLJOYN_PERMISSION_POLICY_INDEX_H
+/**
+ * @file
+ * This file defines an index of the rules of a permission policy by object
+ * path, interface name and member name.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#ifndef __cplusplus
+#error Only include PermissionPolicyIndex.h in C++ code.
+#endif
+
+#include <qcc/platform.h>
+
+#include <map>
+#include <vector>
+
+#include <alljoyn/PermissionPolicy.h>
+
+namespace ajn {
+
+/**
+ * The rules of a permission policy compiled into prefix tries over the rule
+ * object paths, interface names and member names, one set of tries per ACL.
+ *
+ * A lookup returns, in policy order, the rules whose patterns may match a
+ * request.  It never leaves out a rule that matches, but it may return rules
+ * that do not (for example patterns with a '?' or a '*' that is not at the
+ * end are returned for every request) so the caller still has to match each
+ * rule it gets back.
+ */
+class PermissionPolicyIndex {
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param policy  The policy to index.  The index refers to rules by
+     *                position and must be rebuilt whenever the policy changes.
+     */
+    PermissionPolicyIndex(const PermissionPolicy& policy);
+
+    /**
+     * Destructor
+     */
+    ~PermissionPolicyIndex();
+
+    /**
+     * Get the rules of an ACL that may match a request.
+     *
+     * @param aclIndex      Position of the ACL in the policy.
+     * @param objPath       Object path of the request.
+     * @param iName         Interface name of the request.
+     * @param mbrName       Member name of the request.  NULL or empty matches
+     *                      every member, as for a GetAll properties request.
+     * @param[out] rules    Receives the positions of the candidate rules in
+     *                      increasing order.
+     */
+    void GetCandidateRules(size_t aclIndex, const char* objPath, const char* iName, const char* mbrName, std::vector<size_t>& rules) const;
+
+  private:
+
+    /**
+     * A prefix trie of wildcard patterns, each tagged with a rule position.
+     */
+    class PatternTrie {
+      public:
+        PatternTrie() { }
+
+        /**
+         * Add a pattern.
+         *
+         * @param pattern  The pattern, as understood by WildcardMatch().
+         * @param rule     Position of the rule the pattern belongs to.
+         */
+        void Add(const qcc::String& pattern, size_t rule);
+
+        /**
+         * Get the rules with a pattern that may match a string.
+         *
+         * @param str         The string.
+         * @param[out] rules  Receives the rule positions, sorted and without
+         *                    duplicates.
+         */
+        void Lookup(const char* str, std::vector<size_t>& rules) const;
+
+      private:
+        struct Node {
+            std::map<char, Node*> children;
+            std::vector<size_t> exact;      /**< Rules whose pattern ends at this node */
+            std::vector<size_t> prefix;     /**< Rules whose pattern is this node followed by '*' */
+            ~Node();
+        };
+
+        /* Private copy constructor and assignment operator to prevent copies */
+        PatternTrie(const PatternTrie& other);
+        PatternTrie& operator=(const PatternTrie& other);
+
+        Node root;
+        std::vector<size_t> generic;        /**< Rules whose pattern cannot be expressed as a prefix */
+    };
+
+    /** The tries of one ACL */
+    struct AclIndex {
+        PatternTrie objPaths;
+        PatternTrie interfaces;
+        PatternTrie members;
+    };
+
+    /* Private copy constructor and assignment operator to prevent copies */
+    PermissionPolicyIndex(const PermissionPolicyIndex& other);
+    PermissionPolicyIndex& operator=(const PermissionPolicyIndex& other);
+
+    std::vector<AclIndex*> acls;
+};
+
+}
+#endif
@@ -29,6 +29,8 @@
 #include <qcc/atomic.h>
 #include <qcc/IODispatch.h>
 #include <qcc/LockLevel.h>
+#include <qcc/MPSCRing.h>
+#include <qcc/Metrics.h>
 
 #include <alljoyn/BusAttachment.h>
 #include <alljoyn/AllJoynStd.h>
@@ -53,6 +55,12 @@ namespace ajn {
 
 #define ENDPOINT_IS_DEAD_ALERTCODE  1
 
+/*
+ * Limits on the number of queued messages, and the number of bytes, coalesced into a single write
+ */
+static const size_t MAX_TX_BATCH_MESSAGES = 16;
+static const size_t MAX_TX_BATCH_BYTES = 64 * 1024;
+
 /*
  * SetState is defined as a macro so that the line number in the debug logs
  * corresponds to the location the state was changed at.
@@ -90,6 +98,7 @@ class _RemoteEndpoint::Internal {
         bus(bus),
         stream(stream),
         txQueue(),
+        txRing(MAX_TX_DATA_MESSAGES),
         txWaitQueue(),
         lock(LOCK_LEVEL_REMOTEENDPOINT_INTERNAL_LOCK),
         listener(NULL),
@@ -110,14 +119,33 @@ class _RemoteEndpoint::Internal {
         hasRxSessionMsg(false),
         getNextMsg(true),
         currentWriteMsg(bus),
+        txBatch(),
         state(STOPPED),
         stopAfterTxEmpty(false),
         pingCallSerial(0),
         sendTimeout(0),
         maxControlMessages(30),
         numControlMessages(0),
-        numDataMessages(0)
+        numDataMessages(0),
+        numTxQueued(0),
+        numTxWaiters(0),
+        stats()
+    {
+        String prefix = MetricPrefix(connectSpec);
+        rxMessages = Metrics::GetCounter(prefix + "rx.messages");
+        txMessages = Metrics::GetCounter(prefix + "tx.messages");
+        txQueueDepth = Metrics::GetHistogram(prefix + "tx.queue.depth");
+        txPushUsec = Metrics::GetHistogram(prefix + "tx.push.usec");
+    }
+
+    /* Metrics are kept per transport, which is named by the connect spec prefix, e.g. "tcp" */
+    static String MetricPrefix(const qcc::String& connectSpec)
     {
+        size_t colon = connectSpec.find_first_of(':');
+        if ((colon == String::npos) || (colon == 0)) {
+            return "remote.unknown.";
+        }
+        return "remote." + connectSpec.substr(0, colon) + ".";
     }
 
     ~Internal() {
@@ -127,6 +155,7 @@ class _RemoteEndpoint::Internal {
     qcc::Stream* stream;                     /**< Stream for this endpoint or NULL if uninitialized */
 
     std::deque<Message> txQueue;             /**< Transmit message queue */
+    qcc::MPSCRing<Message> txRing;           /**< Data messages pushed without the lock, moved to txQueue by DrainTxRing() */
     std::deque<qcc::Thread*> txWaitQueue;    /**< Threads waiting for txQueue to become not-full */
     qcc::Mutex lock;                         /**< Mutex that protects the txQueue and timeout values */
 
@@ -157,7 +186,9 @@ class _RemoteEndpoint::Internal {
     bool hasRxSessionMsg;                    /**< true iff this endpoint has previously processed a non-control message */
     bool getNextMsg;                         /**< If true, read the next message from the txQueue */
     Message currentWriteMsg;                 /**< The message currently being read for this endpoint */
-    State state;                             /**< The state of the stream, protected by lock */
+    std::vector<Message> txBatch;            /**< Messages being written together, starting with currentWriteMsg */
+    IOVec txBatchIov[MAX_TX_BATCH_MESSAGES]; /**< The bytes of each message in txBatch as they were gathered */
+    volatile State state;                    /**< The state of the stream, changed with lock held */
     bool stopAfterTxEmpty;                   /**< True to StopStream() when txQueue is empty */
     set<SessionId> sessionIdSet;                    /**< Set of session Ids that this endpoint is a part of */
     uint32_t pingCallSerial;                 /**< Serial number of last Heartbeat DBus ping sent */
@@ -168,7 +199,14 @@ class _RemoteEndpoint::Internal {
     size_t maxControlMessages;               /**< Number of control messages that can be queued up before disconnecting this endpoint.
                                                   - used on Routing nodes only */
     volatile size_t numControlMessages;      /**< Number of control messages in txQueue - used on Routing nodes only */
-    volatile size_t numDataMessages;         /**< Number of data messages in txQueue - used on Routing nodes only */
+    volatile int32_t numDataMessages;        /**< Number of data messages in txQueue and txRing - used on Routing nodes only */
+    volatile int32_t numTxQueued;            /**< Number of messages in txQueue and txRing that have not been written */
+    volatile int32_t numTxWaiters;           /**< Size of txWaitQueue, readable without the lock */
+    Stats stats;                             /**< Traffic statistics, updated and read with the lock held */
+    qcc::MetricCounter* rxMessages;          /**< Messages received on this transport */
+    qcc::MetricCounter* txMessages;          /**< Messages written on this transport */
+    qcc::MetricHistogram* txQueueDepth;      /**< Number of queued messages seen by each PushMessage() */
+    qcc::MetricHistogram* txPushUsec;        /**< Time PushMessage() takes, including waiting for room in the queue */
   private:
     Internal& operator=(const Internal&);
 };
@@ -259,6 +297,18 @@ const qcc::String& _RemoteEndpoint::GetConnectSpec() const
     }
 }
 
+void _RemoteEndpoint::GetStats(Stats& stats) const
+{
+    if (internal) {
+        internal->lock.Lock(MUTEX_CONTEXT);
+        stats = internal->stats;
+        internal->lock.Unlock(MUTEX_CONTEXT);
+        stats.txQueueDepth = static_cast<uint32_t>(internal->numTxQueued);
+    } else {
+        stats = Stats();
+    }
+}
+
 void _RemoteEndpoint::SetConnectSpec(const qcc::String& connSpec)
 {
     if (internal) {
@@ -549,7 +599,7 @@ QStatus _RemoteEndpoint::Stop(bool stopAfterTxEmpty)
     case Internal::STARTED:
         SetState(Internal::OTHER_END_STOP_WAIT);
         internal->stopAfterTxEmpty = stopAfterTxEmpty;
-        if (internal->txQueue.empty() && internal->txWaitQueue.empty()) {
+        if (IsTxQueueEmpty()) {
             status = internal->stream->Shutdown();
             if ((ER_OK == status) && internal->stopAfterTxEmpty) {
                 internal->bus.GetInternal().GetIODispatch().StopStream(internal->stream);
@@ -561,7 +611,7 @@ QStatus _RemoteEndpoint::Stop(bool stopAfterTxEmpty)
 
     case Internal::STOP_WAIT:
         SetState(Internal::STOPPING);
-        if (internal->txQueue.empty() && internal->txWaitQueue.empty()) {
+        if (IsTxQueueEmpty()) {
             status = internal->stream->Shutdown();
             if (ER_OK == status) {
                 internal->bus.GetInternal().GetIODispatch().StopStream(internal->stream);
@@ -658,6 +708,7 @@ void _RemoteEndpoint::ThreadExit(Thread* thread)
     if (it != internal->txWaitQueue.end()) {
         (*it)->RemoveAuxListener(this);
         internal->txWaitQueue.erase(it);
+        DecrementAndFetch(&internal->numTxWaiters);
     }
     internal->lock.Unlock(MUTEX_CONTEXT);
 
@@ -763,7 +814,7 @@ void _RemoteEndpoint::ExitCallback()
     case Internal::OTHER_END_STOP_WAIT:
     case Internal::STOPPING:
     case Internal::EXIT_WAIT:
-        if (!(internal->txQueue.empty() && internal->txWaitQueue.empty())) {
+        if (!IsTxQueueEmpty()) {
             internal->stream->Abort();
         }
         SetState(Internal::STOPPED);
@@ -799,6 +850,9 @@ QStatus _RemoteEndpoint::ReadCallback(qcc::Source& source, bool isTimedOut)
                 status = msg->Unmarshal(rep, (internal->validateSender && !bus2bus));
                 switch (status) {
                 case ER_OK:
+                    internal->rxMessages->Increment();
+                    internal->stats.rxMessages++;
+                    internal->stats.rxBytes += msg->GetBufferSize();
                     internal->idleTimeoutCount = 0;
                     bool isAck;
                     if ((internal->pingCallSerial != 0) &&
@@ -866,12 +920,14 @@ QStatus _RemoteEndpoint::ReadCallback(qcc::Source& source, bool isTimedOut)
                     internal->idleTimeoutCount = 0;
                     if (router.IsDaemon()) {
                         QCC_LogError(status, ("%s: Discarding %s", GetUniqueName().c_str(), msg->Description().c_str()));
+                        internal->stats.rxDropped++;
                         status = ER_OK;
                     }
                     break;
 
                 case ER_BUS_TIME_TO_LIVE_EXPIRED:
                     internal->idleTimeoutCount = 0;
+                    internal->stats.rxDropped++;
                     QCC_DbgHLPrintf(("%s: TTL expired discarding %s", GetUniqueName().c_str(), msg->Description().c_str()));
                     status = ER_OK;
                     break;
@@ -939,7 +995,7 @@ QStatus _RemoteEndpoint::ReadCallback(qcc::Source& source, bool isTimedOut)
                  * instead, we rely on the state of pending sends to tell us
                  * when we can close the connection.
                  */
-                if (internal->txQueue.empty() && internal->txWaitQueue.empty()) {
+                if (IsTxQueueEmpty()) {
                     internal->stream->Shutdown();
                     internal->bus.GetInternal().GetIODispatch().StopStream(internal->stream);
                     SetState(Internal::EXIT_WAIT);
@@ -950,7 +1006,7 @@ QStatus _RemoteEndpoint::ReadCallback(qcc::Source& source, bool isTimedOut)
                 break;
 
             case Internal::OTHER_END_STOP_WAIT:
-                if (internal->txQueue.empty() && internal->txWaitQueue.empty()) {
+                if (IsTxQueueEmpty()) {
                     internal->bus.GetInternal().GetIODispatch().StopStream(internal->stream);
                     SetState(Internal::EXIT_WAIT);
                     Invalidate();
@@ -1061,6 +1117,9 @@ QStatus _RemoteEndpoint::WriteCallback(qcc::Sink& sink, bool isTimedOut)
             return ER_BUS_NO_ENDPOINT;
         }
 
+        /* Pick up the messages pushed without the lock */
+        DrainTxRing();
+
         /* Get the message */
         if (internal->getNextMsg) {
             if (!internal->txQueue.empty()) {
@@ -1073,7 +1132,14 @@ QStatus _RemoteEndpoint::WriteCallback(qcc::Sink& sink, bool isTimedOut)
                 internal->getNextMsg = false;
             } else {
                 internal->bus.GetInternal().GetIODispatch().DisableWriteCallback(internal->stream);
-                if (internal->txWaitQueue.empty()) {
+                if (internal->numTxQueued != 0) {
+                    /*
+                     * A message is being pushed onto the txRing, or was pushed after it was
+                     * drained.  Its producer may have found the write callback enabled and not
+                     * enabled it again so do that here.
+                     */
+                    internal->bus.GetInternal().GetIODispatch().EnableWriteCallbackNow(internal->stream);
+                } else if (internal->txWaitQueue.empty()) {
                     switch (internal->state) {
                     case Internal::STARTED:
                         /* Nothing to do */
@@ -1117,36 +1183,63 @@ QStatus _RemoteEndpoint::WriteCallback(qcc::Sink& sink, bool isTimedOut)
             }
         }
 
+        /*
+         * Coalesce the messages queued behind a new write message into a single write. The batch
+         * is gathered with the lock held since the txQueue can change once it is released, but
+         * the messages are only referenced, not copied, until they are written.
+         */
+        size_t batchSize = 0;
+        if (internal->isSocket && (internal->txQueue.size() > 1) && (internal->currentWriteMsg->writeState == MESSAGE_NEW)) {
+            batchSize = GatherTxBatch();
+        }
+
         /* Deliver the message */
         internal->lock.Unlock(MUTEX_CONTEXT);
-        RemoteEndpoint rep = RemoteEndpoint::wrap(this);
-        status = internal->currentWriteMsg->DeliverNonBlocking(rep);
-        /* Report authorization failure as a security violation */
-        if ((status == ER_BUS_NOT_AUTHORIZED) || (status == ER_PERMISSION_DENIED)) {
-            internal->bus.GetInternal().GetLocalEndpoint()->GetPeerObj()->HandleSecurityViolation(internal->currentWriteMsg, status);
-            /*
-             * Clear the error after reporting the security violation otherwise we will exit
-             * this thread which will shut down the endpoint.
-             * In the case of ER_PERMISSION_DENIED, we can't deliver this
-             * message to the peer since the peer is not authorized to receive
-             * it.
-             */
-            status = ER_OK;
+        size_t numDelivered = 0;
+        if (batchSize > 1) {
+            status = WriteTxBatch(numDelivered);
+        } else {
+            RemoteEndpoint rep = RemoteEndpoint::wrap(this);
+            status = internal->currentWriteMsg->DeliverNonBlocking(rep);
+            /* Report authorization failure as a security violation */
+            if ((status == ER_BUS_NOT_AUTHORIZED) || (status == ER_PERMISSION_DENIED)) {
+                internal->bus.GetInternal().GetLocalEndpoint()->GetPeerObj()->HandleSecurityViolation(internal->currentWriteMsg, status);
+                /*
+                 * Clear the error after reporting the security violation otherwise we will exit
+                 * this thread which will shut down the endpoint.
+                 * In the case of ER_PERMISSION_DENIED, we can't deliver this
+                 * message to the peer since the peer is not authorized to receive
+                 * it.
+                 */
+                status = ER_OK;
+            }
+            if (status == ER_OK) {
+                numDelivered = 1;
+            }
+        }
+        if (numDelivered > 0) {
+            internal->txMessages->Add(static_cast<uint32_t>(numDelivered));
         }
         internal->lock.Lock(MUTEX_CONTEXT);
-        if (status == ER_OK) {
-            /* Message has been successfully delivered. i.e. PushBytes is complete */
-            internal->txQueue.pop_back();
-            internal->getNextMsg = true;
-            if (internal->bus.GetInternal().GetRouter().IsDaemon()) {
-                if (IsControlMessage(internal->currentWriteMsg)) {
-                    QCC_ASSERT(internal->numControlMessages > 0);
-                    internal->numControlMessages--;
-                } else {
-                    QCC_ASSERT(internal->numDataMessages > 0);
-                    internal->numDataMessages--;
+        if (numDelivered > 0) {
+            /* Messages have been successfully delivered. i.e. PushBytes is complete */
+            internal->stats.txMessages += static_cast<uint32_t>(numDelivered);
+            for (size_t i = 0; i < numDelivered; ++i) {
+                Message& msg = (batchSize > 1) ? internal->txBatch[i] : internal->currentWriteMsg;
+                internal->stats.txBytes += msg->GetBufferSize();
+                internal->txQueue.pop_back();
+                DecrementAndFetch(&internal->numTxQueued);
+                if (internal->bus.GetInternal().GetRouter().IsDaemon()) {
+                    if (IsControlMessage(msg)) {
+                        QCC_ASSERT(internal->numControlMessages > 0);
+                        internal->numControlMessages--;
+                    } else {
+                        QCC_ASSERT(internal->numDataMessages > 0);
+                        DecrementAndFetch(&internal->numDataMessages);
+                    }
                 }
             }
+            internal->getNextMsg = true;
             /* Alert the first one in the txWaitQueue */
             if (0 < internal->txWaitQueue.size()) {
                 Thread* wakeMe = internal->txWaitQueue.back();
@@ -1156,6 +1249,11 @@ QStatus _RemoteEndpoint::WriteCallback(qcc::Sink& sink, bool isTimedOut)
                 }
             }
         }
+        /* The rest of a partially written batch is delivered by DeliverNonBlocking() */
+        if ((batchSize > 1) && (numDelivered < batchSize)) {
+            internal->getNextMsg = false;
+        }
+        internal->txBatch.clear();
     }
 
     if (status == ER_TIMEOUT) {
@@ -1181,19 +1279,171 @@ QStatus _RemoteEndpoint::WriteCallback(qcc::Sink& sink, bool isTimedOut)
     return status;
 }
 
+size_t _RemoteEndpoint::GatherTxBatch()
+{
+    const uint8_t* buf;
+    size_t len;
+    size_t numBytes = 0;
+
+    QCC_ASSERT(internal->txBatch.empty());
+    if (internal->currentWriteMsg->BeginBatchedDelivery(buf, len) != ER_OK) {
+        return 0;
+    }
+    internal->txBatch.push_back(internal->currentWriteMsg);
+    internal->txBatchIov[0].buf = const_cast<uint8_t*>(buf);
+    internal->txBatchIov[0].len = len;
+    numBytes += len;
+
+    /*
+     * The current write message is at the back of the txQueue, the ones queued after it are in
+     * front. Those may be queued on other endpoints too so are written from their shared buffers
+     * and only get their own write state, in WriteTxBatch(), if they are left partially written.
+     */
+    deque<Message>::reverse_iterator it = internal->txQueue.rbegin() + 1;
+    while ((it != internal->txQueue.rend()) && (internal->txBatch.size() < MAX_TX_BATCH_MESSAGES) && (numBytes < MAX_TX_BATCH_BYTES)) {
+        if ((*it)->GetBatchedDeliveryBuffer(buf, len) != ER_OK) {
+            break;
+        }
+        IOVec& iov = internal->txBatchIov[internal->txBatch.size()];
+        iov.buf = const_cast<uint8_t*>(buf);
+        iov.len = len;
+        internal->txBatch.push_back(*it);
+        numBytes += len;
+        ++it;
+    }
+    return internal->txBatch.size();
+}
+
+QStatus _RemoteEndpoint::WriteTxBatch(size_t& numDelivered)
+{
+    IOVec iov[MAX_TX_BATCH_MESSAGES];
+    size_t numIov = 0;
+    uint32_t ttl = 0;
+
+    for (size_t i = 0; i < internal->txBatch.size(); ++i) {
+        if (internal->txBatchIov[i].len > 0) {
+            /* The push is bounded by the ttl of the first message just as DeliverNonBlocking() would be */
+            if (numIov == 0) {
+                const Message& msg = internal->txBatch[i];
+                ttl = (msg->GetFlags() & ALLJOYN_FLAG_SESSIONLESS) ? (msg->ttl * 1000) : msg->ttl;
+            }
+            iov[numIov++] = internal->txBatchIov[i];
+        }
+    }
+
+    /* Nothing to write if all the messages had expired */
+    size_t numSent = 0;
+    QStatus status = (numIov > 0) ? internal->stream->PushBytesV(iov, numIov, numSent, ttl) : ER_OK;
+    if (status != ER_OK) {
+        numSent = 0;
+    }
+
+    /* Hand out the bytes that were sent to the messages in order */
+    numDelivered = 0;
+    size_t written = 0;
+    while (numDelivered < internal->txBatch.size()) {
+        written = (std::min)(numSent, internal->txBatchIov[numDelivered].len);
+        numSent -= written;
+        if (written < internal->txBatchIov[numDelivered].len) {
+            break;
+        }
+        ++numDelivered;
+    }
+
+    /* Only the message left partially written needs a write state of its own */
+    if (numDelivered < internal->txBatch.size()) {
+        if (numDelivered > 0) {
+            internal->currentWriteMsg = Message(internal->txBatch[numDelivered], true);
+        }
+        internal->currentWriteMsg->BatchedBytesWritten(written);
+    }
+    return status;
+}
+
+/*
+ * Take one of the MAX_TX_DATA_MESSAGES places counted by count without holding the lock.
+ * Returns the new count or 0 if there was no room.
+ */
+static inline int32_t ReserveTxSlot(volatile int32_t* count)
+{
+    int32_t reserved = IncrementAndFetch(count);
+    if (reserved > static_cast<int32_t>(_RemoteEndpoint::MAX_TX_DATA_MESSAGES)) {
+        DecrementAndFetch(count);
+        return 0;
+    }
+    return reserved;
+}
+
+bool _RemoteEndpoint::PushTxRing(Message& msg, size_t& count)
+{
+    /* Threads blocked on a full queue go first */
+    if (internal->numTxWaiters != 0) {
+        return false;
+    }
+
+    bool isDaemon = internal->bus.GetInternal().GetRouter().IsDaemon();
+    int32_t queued;
+    if (isDaemon) {
+        /* Routing nodes limit data messages, control messages never come here */
+        if (!ReserveTxSlot(&internal->numDataMessages)) {
+            return false;
+        }
+        queued = IncrementAndFetch(&internal->numTxQueued);
+    } else {
+        queued = ReserveTxSlot(&internal->numTxQueued);
+        if (queued == 0) {
+            return false;
+        }
+    }
+
+    if (!internal->txRing.TryPush(msg)) {
+        DecrementAndFetch(&internal->numTxQueued);
+        if (isDaemon) {
+            DecrementAndFetch(&internal->numDataMessages);
+        }
+        return false;
+    }
+    count = queued - 1;
+    if (queued == 1) {
+        internal->bus.GetInternal().GetIODispatch().EnableWriteCallbackNow(internal->stream);
+    }
+    return true;
+}
+
+void _RemoteEndpoint::DrainTxRing()
+{
+    Message* msg;
+    while ((msg = internal->txRing.WaitFront()) != NULL) {
+        internal->txQueue.push_front(*msg);
+        internal->txRing.PopFront();
+    }
+}
+
+bool _RemoteEndpoint::IsTxQueueEmpty()
+{
+    return (internal->numTxQueued == 0) && internal->txWaitQueue.empty();
+}
+
 QStatus _RemoteEndpoint::PushMessageRouter(Message& msg, size_t& count)
 {
     QStatus status = ER_OK;
-    static const size_t MAX_DATA_MESSAGES = 1;
+    bool isControl = IsControlMessage(msg);
+
+    if (!isControl && PushTxRing(msg, count)) {
+        return ER_OK;
+    }
 
     internal->lock.Lock(MUTEX_CONTEXT);
-    count = internal->txQueue.size();
-    bool wasEmpty = (count == 0);
+    /* Messages this thread pushed onto the txRing earlier must go out first */
+    DrainTxRing();
+    count = internal->numTxQueued;
+    bool wasEmpty = false;
 
-    if (IsControlMessage(msg)) {
+    if (isControl) {
         if (internal->numControlMessages < internal->maxControlMessages) {
             internal->txQueue.push_front(msg);
             internal->numControlMessages++;
+            wasEmpty = (IncrementAndFetch(&internal->numTxQueued) == 1);
             if (wasEmpty) {
                 internal->bus.GetInternal().GetIODispatch().EnableWriteCallbackNow(internal->stream);
             }
@@ -1210,9 +1460,9 @@ QStatus _RemoteEndpoint::PushMessageRouter(Message& msg, size_t& count)
          * There are other threads that are blocked trying to send a message to
          * this RemoteEndpoint
          */
-        if ((internal->numDataMessages < MAX_DATA_MESSAGES) && (internal->txWaitQueue.empty())) {
+        if (internal->txWaitQueue.empty() && ReserveTxSlot(&internal->numDataMessages)) {
             internal->txQueue.push_front(msg);
-            internal->numDataMessages++;
+            wasEmpty = (IncrementAndFetch(&internal->numTxQueued) == 1);
         } else {
             /* This thread will have to wait for room in the queue */
             Thread* thread = Thread::GetThread();
@@ -1220,6 +1470,7 @@ QStatus _RemoteEndpoint::PushMessageRouter(Message& msg, size_t& count)
 
             thread->AddAuxListener(this);
             internal->txWaitQueue.push_front(thread);
+            IncrementAndFetch(&internal->numTxWaiters);
 
             for (;;) {
                 /* Remove a queue entry whose TTLs is expired.
@@ -1230,6 +1481,7 @@ QStatus _RemoteEndpoint::PushMessageRouter(Message& msg, size_t& count)
                  */
                 uint32_t maxWait = Event::WAIT_FOREVER;
                 if (internal->txWaitQueue.back() == thread) {
+                    DrainTxRing();
                     deque<Message>::iterator it = internal->txQueue.begin();
                     while (it != internal->txQueue.end()) {
                         uint32_t expMs;
@@ -1239,9 +1491,11 @@ QStatus _RemoteEndpoint::PushMessageRouter(Message& msg, size_t& count)
                                 internal->numControlMessages--;
                             } else {
                                 QCC_ASSERT(internal->numDataMessages > 0);
-                                internal->numDataMessages--;
+                                DecrementAndFetch(&internal->numDataMessages);
                             }
                             internal->txQueue.erase(it);
+                            DecrementAndFetch(&internal->numTxQueued);
+                            internal->stats.txDropped++;
                             break;
                         } else {
                             ++it;
@@ -1253,14 +1507,11 @@ QStatus _RemoteEndpoint::PushMessageRouter(Message& msg, size_t& count)
                         }
                     }
 
-                    if (internal->numDataMessages < MAX_DATA_MESSAGES) {
-                        count = internal->txQueue.size();
-                        /* Check queue wasn't drained while we were waiting */
-                        if (internal->txQueue.size() == 0) {
-                            wasEmpty = true;
-                        }
+                    if (ReserveTxSlot(&internal->numDataMessages)) {
+                        count = internal->numTxQueued;
                         internal->txQueue.push_front(msg);
-                        internal->numDataMessages++;
+                        /* Check queue wasn't drained while we were waiting */
+                        wasEmpty = (IncrementAndFetch(&internal->numTxQueued) == 1);
                         status = ER_OK;
                         break;
                     }
@@ -1299,6 +1550,7 @@ QStatus _RemoteEndpoint::PushMessageRouter(Message& msg, size_t& count)
             deque<Thread*>::iterator eit = find(internal->txWaitQueue.begin(), internal->txWaitQueue.end(), thread);
             if (eit != internal->txWaitQueue.end()) {
                 internal->txWaitQueue.erase(eit);
+                DecrementAndFetch(&internal->numTxWaiters);
             }
 
             /* Alert the first one in the txWaitQueue */
@@ -1323,18 +1575,25 @@ QStatus _RemoteEndpoint::PushMessageRouter(Message& msg, size_t& count)
 
 QStatus _RemoteEndpoint::PushMessageLeaf(Message& msg, size_t& count)
 {
-    static const size_t MAX_TX_QUEUE_SIZE = 1;
-
     QStatus status = ER_OK;
+
+    if (PushTxRing(msg, count)) {
+        return ER_OK;
+    }
+
     internal->lock.Lock(MUTEX_CONTEXT);
-    count = internal->txQueue.size();
-    bool wasEmpty = (count == 0);
+    /* Messages this thread pushed onto the txRing earlier must go out first */
+    DrainTxRing();
+    count = internal->numTxQueued;
+    bool wasEmpty = false;
     /* If the txWaitQueue is not empty, dont queue the message.
      * There are other threads that are blocked trying to send a message to
      * this RemoteEndpoint
      */
-    if ((count < MAX_TX_QUEUE_SIZE) && (internal->txWaitQueue.empty())) {
+    int32_t queued = internal->txWaitQueue.empty() ? ReserveTxSlot(&internal->numTxQueued) : 0;
+    if (queued > 0) {
         internal->txQueue.push_front(msg);
+        wasEmpty = (queued == 1);
     } else {
         /* This thread will have to wait for room in the queue */
         Thread* thread = Thread::GetThread();
@@ -1342,6 +1601,7 @@ QStatus _RemoteEndpoint::PushMessageLeaf(Message& msg, size_t& count)
 
         thread->AddAuxListener(this);
         internal->txWaitQueue.push_front(thread);
+        IncrementAndFetch(&internal->numTxWaiters);
 
         for (;;) {
             /* Remove a queue entry whose TTLs is expired.
@@ -1352,11 +1612,14 @@ QStatus _RemoteEndpoint::PushMessageLeaf(Message& msg, size_t& count)
              */
             uint32_t maxWait = Event::WAIT_FOREVER;
             if (internal->txWaitQueue.back() == thread) {
+                DrainTxRing();
                 deque<Message>::iterator it = internal->txQueue.begin();
                 while (it != internal->txQueue.end()) {
                     uint32_t expMs;
                     if ((*it)->IsExpired(&expMs)) {
                         internal->txQueue.erase(it);
+                        DecrementAndFetch(&internal->numTxQueued);
+                        internal->stats.txDropped++;
                         break;
                     } else {
                         ++it;
@@ -1368,13 +1631,12 @@ QStatus _RemoteEndpoint::PushMessageLeaf(Message& msg, size_t& count)
                     }
                 }
 
-                if (internal->txQueue.size() < MAX_TX_QUEUE_SIZE) {
-                    count = internal->txQueue.size();
-                    /* Check queue wasn't drained while we were waiting */
-                    if (internal->txQueue.size() == 0) {
-                        wasEmpty = true;
-                    }
+                queued = ReserveTxSlot(&internal->numTxQueued);
+                if (queued > 0) {
+                    count = queued - 1;
                     internal->txQueue.push_front(msg);
+                    /* Check queue wasn't drained while we were waiting */
+                    wasEmpty = (queued == 1);
                     status = ER_OK;
                     break;
                 }
@@ -1413,6 +1675,7 @@ QStatus _RemoteEndpoint::PushMessageLeaf(Message& msg, size_t& count)
         deque<Thread*>::iterator eit = find(internal->txWaitQueue.begin(), internal->txWaitQueue.end(), thread);
         if (eit != internal->txWaitQueue.end()) {
             internal->txWaitQueue.erase(eit);
+            DecrementAndFetch(&internal->numTxWaiters);
         }
 
         /* Alert the first one in the txWaitQueue */
@@ -1448,18 +1711,19 @@ QStatus _RemoteEndpoint::PushMessage(Message& msg)
      * Otherwise we risk deadlock when sending NameOwnerChanged signal to
      * this dying endpoint
      */
-    internal->lock.Lock(MUTEX_CONTEXT);
     if (internal->state != Internal::STARTED) {
-        internal->lock.Unlock(MUTEX_CONTEXT);
         return ER_BUS_ENDPOINT_CLOSING;
     }
-    internal->lock.Unlock(MUTEX_CONTEXT);
 
+    ScopedMetricTimer pushTimer(internal->txPushUsec);
     if (internal->bus.GetInternal().GetRouter().IsDaemon()) {
         status = PushMessageRouter(msg, count);
     } else {
         status = PushMessageLeaf(msg, count);
     }
+    if (status == ER_OK) {
+        internal->txQueueDepth->Record(static_cast<uint32_t>(count));
+    }
 #ifndef NDEBUG
 #undef QCC_MODULE
 #define QCC_MODULE "TXSTATS"
@@ -88,6 +88,25 @@ class _RemoteEndpoint : public _BusEndpoint, public qcc::ThreadListener, public
 
     };
 
+    /**
+     * Traffic statistics of an endpoint.
+     */
+    struct Stats {
+        uint32_t rxMessages;      /**< Messages received */
+        uint32_t txMessages;      /**< Messages written */
+        uint64_t rxBytes;         /**< Bytes of received messages */
+        uint64_t txBytes;         /**< Bytes of written messages */
+        uint32_t txQueueDepth;    /**< Messages waiting to be written */
+        uint32_t rxDropped;       /**< Received messages discarded because they expired or could not be expanded */
+        uint32_t txDropped;       /**< Queued messages discarded because they expired before they were written */
+    };
+
+    /**
+     * Number of data messages that can be queued for transmission before PushMessage() blocks.
+     * Queuing more than one lets the transmit side coalesce queued messages into a single write.
+     */
+    static const size_t MAX_TX_DATA_MESSAGES = 8;
+
     /**
      * Listener called when endpoint changes state.
      */
@@ -338,6 +357,14 @@ class _RemoteEndpoint : public _BusEndpoint, public qcc::ThreadListener, public
      */
     const qcc::String& GetConnectSpec() const;
 
+    /**
+     * Get the traffic statistics of this endpoint.  The values are read
+     * without synchronizing with the threads updating them.
+     *
+     * @param[out] stats  The statistics.
+     */
+    void GetStats(Stats& stats) const;
+
     /**
      * Set the connect spec for this endpoint.
      *
@@ -633,6 +660,49 @@ class _RemoteEndpoint : public _BusEndpoint, public qcc::ThreadListener, public
      */
     QStatus WriteCallback(qcc::Sink& sink, bool isTimedOut);
 
+    /**
+     * Gather the messages at the back of the txQueue that can be written together with the
+     * current write message. Called with the internal lock held.
+     *
+     * @return   Number of messages gathered, 0 or 1 means there is nothing to coalesce.
+     */
+    size_t GatherTxBatch();
+
+    /**
+     * Write the gathered messages to the stream with a single push.
+     *
+     * @param[out] numDelivered   Number of messages that were written in full.
+     * @return   ER_OK if successful
+     */
+    QStatus WriteTxBatch(size_t& numDelivered);
+
+    /**
+     * Queue a data message on the txRing without taking the internal lock. This only
+     * succeeds while no thread is blocked on a full queue and there is room under the
+     * MAX_TX_DATA_MESSAGES limit, otherwise the caller takes the locked path.
+     *
+     * @param msg         Message to be sent.
+     * @param[out] count  Number of messages queued ahead of msg
+     * @return   true if the message was queued.
+     */
+    bool PushTxRing(Message& msg, size_t& count);
+
+    /**
+     * Move the messages on the txRing to the front of the txQueue in the order they were
+     * pushed, waiting for positions that have been claimed but not yet published so no
+     * message pushed later through the txQueue can overtake them. Called with the internal
+     * lock held, which also serializes the txRing consumers.
+     */
+    void DrainTxRing();
+
+    /**
+     * Check that no message is waiting to be written, whether on the txQueue, on the txRing
+     * or held by a thread blocked on a full queue. Called with the internal lock held.
+     *
+     * @return   true if there is nothing left to send.
+     */
+    bool IsTxQueueEmpty();
+
     /**
      * Internal callback used to indicate that the Stream for this endpoint has been removed
      * from the IODispatch.
@@ -127,7 +127,7 @@ Rule::Rule(const char* ruleSpec, QStatus* outStatus) : type(MESSAGE_INVALID), se
     }
 }
 
-bool Rule::IsMatch(const Message& msg, std::set<qcc::String>* cachedWhoImplements /* = nullptr */) const
+bool Rule::IsMatch(const Message& msg, std::set<qcc::String>* cachedWhoImplements /* = nullptr */, MatchArgs* cachedArgs /* = nullptr */) const
 {
     /* The fields of a rule (if specified) are logically anded together */
     if ((type != MESSAGE_INVALID) && (type != msg->GetType())) {
@@ -149,25 +149,36 @@ bool Rule::IsMatch(const Message& msg, std::set<qcc::String>* cachedWhoImplement
         return false;
     }
     if (!args.empty()) {
-        /*
-         * Clone the message since this message is unmarshalled by the
-         * LocalEndpoint too and the process of unmarshalling is not
-         * thread-safe.
-         */
-        Message clone = Message(msg, true);
-        QStatus status = clone->UnmarshalArgs(clone->GetSignature());
-        if (status != ER_OK) {
-            return false;
+        MatchArgs nonCacheArgs;
+        MatchArgs* matchArgs = (cachedArgs == nullptr) ? &nonCacheArgs : cachedArgs;
+        /* The arguments are parsed once and shared by every rule given the same cache */
+        if (!matchArgs->parsed) {
+            /*
+             * Clone the message since this message is unmarshalled by the
+             * LocalEndpoint too and the process of unmarshalling is not
+             * thread-safe.
+             */
+            Message clone = Message(msg, true);
+            if (clone->UnmarshalArgs(clone->GetSignature()) == ER_OK) {
+                size_t numArgs;
+                const MsgArg* msgArgs;
+                clone->GetArgs(numArgs, msgArgs);
+                matchArgs->values.resize(numArgs);
+                matchArgs->isString.resize(numArgs);
+                for (size_t i = 0; i < numArgs; ++i) {
+                    if (msgArgs[i].typeId == ALLJOYN_STRING) {
+                        matchArgs->values[i] = msgArgs[i].v_string.str;
+                        matchArgs->isString[i] = true;
+                    }
+                }
+            }
+            matchArgs->parsed = true;
         }
         for (map<uint32_t, String>::const_iterator it = args.begin(); it != args.end(); ++it) {
-            const MsgArg* arg = clone->GetArg(it->first);
-            if (!arg) {
-                return false;
-            }
-            if (ALLJOYN_STRING != arg->typeId) {
+            if ((it->first >= matchArgs->isString.size()) || !matchArgs->isString[it->first]) {
                 return false;
             }
-            if (it->second != arg->v_string.str) {
+            if (it->second != matchArgs->values[it->first]) {
                 return false;
             }
         }
@@ -25,6 +25,7 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 #include <qcc/String.h>
 #include <alljoyn/Message.h>
@@ -32,6 +33,24 @@
 
 namespace ajn {
 
+/**
+ * The string arguments of a message body for argN rules.  A caller that
+ * matches one message against several rules passes the same MatchArgs to
+ * each of them so the body is only unmarshalled once.
+ */
+struct MatchArgs {
+    MatchArgs() : parsed(false) { }
+
+    /** true once the arguments have been parsed */
+    bool parsed;
+
+    /** values[i] is only meaningful if isString[i] is true */
+    std::vector<qcc::String> values;
+
+    /** true for the arguments that are strings */
+    std::vector<bool> isString;
+};
+
 /**
  * Rule defines a message bus routing rule.
  */
@@ -93,9 +112,11 @@ struct Rule {
      * @param cachedWhoImplements   Optional in/out collection of who-implements interfaces
      *                              cached from 'msg' param. If provided, the interfaces
      *                              found in the message will be populated.
+     * @param cachedArgs   Optional in/out string arguments of 'msg'.  If provided
+     *                     they are parsed by the first argN rule that needs them.
      * @return      true if this rule matches the message.
      */
-    bool IsMatch(const Message& msg, std::set<qcc::String>* cachedWhoImplements = nullptr) const;
+    bool IsMatch(const Message& msg, std::set<qcc::String>* cachedWhoImplements = nullptr, MatchArgs* cachedArgs = nullptr) const;
 
     /**
      * String representation of a rule
@@ -25,6 +25,7 @@
 #include <alljoyn/Init.h>
 #include <alljoyn/PasswordManager.h>
 #include "AutoPingerInternal.h"
+#include "BufferPool.h"
 #include "BusInternal.h"
 #include "KeyStoreListener.h"
 #include "NamedPipeClientTransport.h"
@@ -46,6 +47,7 @@ class StaticGlobals {
   public:
     static void Init()
     {
+        BufferPool::Init();
         KeyStore::Init();
         NamedPipeClientTransport::Init();
         AutoPingerInternal::Init();
@@ -74,6 +76,7 @@ class StaticGlobals {
         AutoPingerInternal::Shutdown();
         NamedPipeClientTransport::Shutdown();
         KeyStore::Shutdown();
+        BufferPool::Shutdown();
     }
 };
 
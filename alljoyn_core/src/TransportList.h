@@ -23,7 +23,7 @@
 
 #include <qcc/platform.h>
 #include <qcc/String.h>
-#include <qcc/IODispatch.h>
+#include <qcc/ShardedIODispatch.h>
 
 #include <vector>
 
@@ -48,7 +48,7 @@ class TransportList : public TransportListener {
      * @param m_ioDispatch      The IODispatch for this bus.
      * @param concurrency       The maximum number of concurrent method and signal handlers locally executing.
      */
-    TransportList(BusAttachment& bus, TransportFactoryContainer& factories, qcc::IODispatch* m_ioDispatch, uint32_t concurrency);
+    TransportList(BusAttachment& bus, TransportFactoryContainer& factories, qcc::ShardedIODispatch* m_ioDispatch, uint32_t concurrency);
 
     /** Destructor  */
     virtual ~TransportList();
@@ -166,7 +166,7 @@ class TransportList : public TransportListener {
     TransportFactoryContainer& m_factories;         /**< container for transport factories */
     bool isStarted;                                 /**< true iff transports are running */
     bool isInitialized;                             /**< true iff transportlist is initialized */
-    qcc::IODispatch* m_ioDispatch;                  /**< pointer to the iodispatch for this bus */
+    qcc::ShardedIODispatch* m_ioDispatch;           /**< pointer to the iodispatch for this bus */
 };
 
 }  /* namespace */
@@ -0,0 +1,155 @@
+/**
+ * @file
+ *
+ * Measures AES-CCM throughput for message bodies of various sizes the way
+ * AllJoynCrypto uses it: a Crypto_AES is created per message and the message
+ * header is authenticated as additional data.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <qcc/Crypto.h>
+#include <qcc/KeyBlob.h>
+#include <qcc/Util.h>
+#include <qcc/time.h>
+
+#include <alljoyn/Init.h>
+#include <alljoyn/Status.h>
+
+using namespace qcc;
+using namespace std;
+
+/* A typical message header and the MAC length AllJoynCrypto uses with current peers */
+static const size_t HEADER_LEN = 32;
+static const uint8_t MAC_LEN = 16;
+
+/*
+ * Returns the throughput in MB/s of encrypting (or decrypting) a body of the
+ * given size, or a negative value if CCM failed.
+ */
+static double RunBenchmark(bool decrypt, size_t bodyLen, uint32_t totalMB)
+{
+    uint8_t keyData[Crypto_AES::AES128_SIZE];
+    uint8_t nonceData[11];
+    Crypto_GetRandomBytes(keyData, sizeof(keyData));
+    Crypto_GetRandomBytes(nonceData, sizeof(nonceData));
+    KeyBlob key(keyData, sizeof(keyData), KeyBlob::AES);
+    /* An 11 byte nonce leaves room for 32 bit body lengths */
+    KeyBlob nonce(nonceData, sizeof(nonceData), KeyBlob::GENERIC);
+
+    vector<uint8_t> header(HEADER_LEN, 0x5A);
+    vector<uint8_t> body(bodyLen + MAC_LEN);
+    vector<uint8_t> cipherText(bodyLen + MAC_LEN);
+    Crypto_GetRandomBytes(&body[0], bodyLen);
+    size_t len = bodyLen;
+    if (Crypto_AES(key, Crypto_AES::CCM).Encrypt_CCM(&body[0], &cipherText[0], len, nonce, &header[0], header.size(), MAC_LEN) != ER_OK) {
+        return -1.0;
+    }
+
+    uint32_t iterations = static_cast<uint32_t>((static_cast<uint64_t>(totalMB) << 20) / bodyLen);
+    if (iterations == 0) {
+        iterations = 1;
+    }
+    uint64_t start = GetTimestamp64();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        Crypto_AES aes(key, Crypto_AES::CCM);
+        QStatus status;
+        if (decrypt) {
+            len = bodyLen + MAC_LEN;
+            status = aes.Decrypt_CCM(&cipherText[0], &body[0], len, nonce, &header[0], header.size(), MAC_LEN);
+        } else {
+            len = bodyLen;
+            status = aes.Encrypt_CCM(&body[0], &cipherText[0], len, nonce, &header[0], header.size(), MAC_LEN);
+        }
+        if (status != ER_OK) {
+            return -1.0;
+        }
+    }
+    uint64_t elapsed = GetTimestamp64() - start;
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+    return (static_cast<double>(iterations) * bodyLen * 1000.0) / (static_cast<double>(elapsed) * 1000000.0);
+}
+
+static void usage(void)
+{
+    printf("Usage: ccmbench [-h] [-m <megabytes>] [-s <size>]...\n\n");
+    printf("Options:\n");
+    printf("   -h                    = Print this help message\n");
+    printf("   -m <megabytes>        = Amount of body data processed per run (default 64)\n");
+    printf("   -s <size>             = Body size in bytes, may be repeated (default 64 1024 65536)\n");
+    printf("\nSet ER_CRYPTO_AESNI=0 to measure the table implementation on CPUs with AES-NI.\n");
+}
+
+int CDECL_CALL main(int argc, char** argv)
+{
+    uint32_t totalMB = 64;
+    vector<size_t> sizes;
+
+    for (int i = 1; i < argc; ++i) {
+        if (0 == strcmp("-h", argv[i])) {
+            usage();
+            return 0;
+        } else if ((0 == strcmp("-m", argv[i])) && (i + 1 < argc)) {
+            totalMB = strtoul(argv[++i], NULL, 10);
+        } else if ((0 == strcmp("-s", argv[i])) && (i + 1 < argc)) {
+            sizes.push_back(strtoul(argv[++i], NULL, 10));
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (totalMB == 0) {
+        usage();
+        return 1;
+    }
+    if (sizes.empty()) {
+        const size_t defaults[] = { 64, 1024, 65536 };
+        sizes.assign(defaults, defaults + ArraySize(defaults));
+    }
+
+    if (AllJoynInit() != ER_OK) {
+        return 1;
+    }
+
+    printf("%u MB per run on one thread, %u byte header, %u byte MAC\n", totalMB, static_cast<uint32_t>(HEADER_LEN), MAC_LEN);
+    printf("%10s %16s %16s\n", "body bytes", "encrypt MB/s", "decrypt MB/s");
+
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        if (sizes[i] == 0) {
+            continue;
+        }
+        double encryptMBs = RunBenchmark(false, sizes[i], totalMB);
+        double decryptMBs = RunBenchmark(true, sizes[i], totalMB);
+        if ((encryptMBs < 0) || (decryptMBs < 0)) {
+            printf("%10u %16s\n", static_cast<uint32_t>(sizes[i]), "CCM failed");
+        } else {
+            printf("%10u %16.1f %16.1f\n", static_cast<uint32_t>(sizes[i]), encryptMBs, decryptMBs);
+        }
+    }
+
+    AllJoynShutdown();
+    return 0;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file
+ *
+ * Measures the rate of P-256 key generation, ECDSA signing and ECDSA
+ * verification, checking signatures against one key as is done for the keys
+ * of certificate authorities, and against a new key every time.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+
+#include <qcc/platform.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <qcc/Crypto.h>
+#include <qcc/CryptoECC.h>
+#include <qcc/time.h>
+
+#include <alljoyn/Init.h>
+#include <alljoyn/Status.h>
+
+using namespace qcc;
+using namespace std;
+
+enum Operation {
+    GENERATE,
+    SIGN,
+    VERIFY_SAME_KEY,
+    VERIFY_NEW_KEY
+};
+
+/*
+ * Returns the number of operations per second, or a negative value if an
+ * operation failed.
+ */
+static double RunBenchmark(Operation op, uint32_t iterations)
+{
+    uint8_t digest[Crypto_SHA256::DIGEST_SIZE];
+    Crypto_GetRandomBytes(digest, sizeof(digest));
+
+    /* One key pair with a signature per key pair for the new key runs */
+    uint32_t numKeys = (op == VERIFY_NEW_KEY) ? iterations : 1;
+    vector<Crypto_ECC> keys(numKeys);
+    vector<ECCSignature> sigs(numKeys);
+    for (uint32_t i = 0; i < numKeys; ++i) {
+        if ((keys[i].GenerateDSAKeyPair() != ER_OK) || (keys[i].DSASignDigest(digest, sizeof(digest), &sigs[i]) != ER_OK)) {
+            return -1.0;
+        }
+    }
+
+    uint64_t start = GetTimestamp64();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        QStatus status;
+        switch (op) {
+        case GENERATE:
+            status = keys[0].GenerateDSAKeyPair();
+            break;
+
+        case SIGN:
+            status = keys[0].DSASignDigest(digest, sizeof(digest), &sigs[0]);
+            break;
+
+        default:
+            status = keys[i % numKeys].DSAVerifyDigest(digest, sizeof(digest), &sigs[i % numKeys]);
+            break;
+        }
+        if (status != ER_OK) {
+            return -1.0;
+        }
+    }
+    uint64_t elapsed = GetTimestamp64() - start;
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+    return (static_cast<double>(iterations) * 1000.0) / static_cast<double>(elapsed);
+}
+
+static void usage(void)
+{
+    printf("Usage: eccbench [-h] [-i <iterations>]\n\n");
+    printf("Options:\n");
+    printf("   -h                    = Print this help message\n");
+    printf("   -i <iterations>       = Number of operations per run (default 1000)\n");
+}
+
+int CDECL_CALL main(int argc, char** argv)
+{
+    uint32_t iterations = 1000;
+
+    for (int i = 1; i < argc; ++i) {
+        if (0 == strcmp("-h", argv[i])) {
+            usage();
+            return 0;
+        } else if ((0 == strcmp("-i", argv[i])) && (i + 1 < argc)) {
+            iterations = strtoul(argv[++i], NULL, 10);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (iterations == 0) {
+        usage();
+        return 1;
+    }
+
+    if (AllJoynInit() != ER_OK) {
+        return 1;
+    }
+
+    const char* names[] = { "generate key", "sign", "verify, same key", "verify, new key" };
+    printf("NIST P-256, %u operations per run on one thread\n", iterations);
+    printf("%18s %16s\n", "operation", "ops/s");
+    for (int op = GENERATE; op <= VERIFY_NEW_KEY; ++op) {
+        double rate = RunBenchmark(static_cast<Operation>(op), iterations);
+        if (rate < 0) {
+            printf("%18s %16s\n", names[op], "failed");
+        } else {
+            printf("%18s %16.0f\n", names[op], rate);
+        }
+    }
+
+    AllJoynShutdown();
+    return 0;
+}
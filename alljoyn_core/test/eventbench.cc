@@ -0,0 +1,140 @@
+/**
+ * @file
+ *
+ * Measures the latency of qcc::Event::Wait() on a set of events as a function of the
+ * number of events waited on.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <qcc/Event.h>
+#include <qcc/Util.h>
+#include <qcc/time.h>
+
+#include <alljoyn/Init.h>
+#include <alljoyn/Status.h>
+
+using namespace qcc;
+using namespace std;
+
+/*
+ * Waits iterations times on numEvents general purpose events. When signalLast is true the
+ * last event is set so every wait returns it, otherwise no event is set and every wait
+ * times out immediately.
+ *
+ * Returns the average time of a wait in microseconds or a negative value if a wait did not
+ * return what was expected.
+ */
+static double RunBenchmark(uint32_t numEvents, uint32_t iterations, bool signalLast)
+{
+    vector<Event*> checkEvents;
+    vector<Event*> signaledEvents;
+    for (uint32_t i = 0; i < numEvents; ++i) {
+        checkEvents.push_back(new Event());
+    }
+    if (signalLast) {
+        checkEvents.back()->SetEvent();
+    }
+    QStatus expected = signalLast ? ER_OK : ER_TIMEOUT;
+    bool failed = false;
+
+    /* The first wait sets up whatever the backend keeps between waits */
+    Event::Wait(checkEvents, signaledEvents, 0);
+
+    uint64_t start = GetTimestamp64();
+    for (uint32_t i = 0; (i < iterations) && !failed; ++i) {
+        signaledEvents.clear();
+        failed = (Event::Wait(checkEvents, signaledEvents, 0) != expected);
+    }
+    uint64_t elapsed = GetTimestamp64() - start;
+
+    for (size_t i = 0; i < checkEvents.size(); ++i) {
+        delete checkEvents[i];
+    }
+    return failed ? -1.0 : (static_cast<double>(elapsed) * 1000.0) / iterations;
+}
+
+static void usage(void)
+{
+    printf("Usage: eventbench [-h] [-i <iterations>] [-n <events>]...\n\n");
+    printf("Options:\n");
+    printf("   -h                    = Print this help message\n");
+    printf("   -i <iterations>       = Number of waits per run (default 10000)\n");
+    printf("   -n <events>           = Number of events waited on, may be repeated (default 1 10 100 500 1000)\n");
+}
+
+int CDECL_CALL main(int argc, char** argv)
+{
+    uint32_t iterations = 10000;
+    vector<uint32_t> counts;
+
+    for (int i = 1; i < argc; ++i) {
+        if (0 == strcmp("-h", argv[i])) {
+            usage();
+            return 0;
+        } else if ((0 == strcmp("-i", argv[i])) && (i + 1 < argc)) {
+            iterations = strtoul(argv[++i], NULL, 10);
+        } else if ((0 == strcmp("-n", argv[i])) && (i + 1 < argc)) {
+            counts.push_back(strtoul(argv[++i], NULL, 10));
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (iterations == 0) {
+        usage();
+        return 1;
+    }
+    if (counts.empty()) {
+        const uint32_t defaults[] = { 1, 10, 100, 500, 1000 };
+        counts.assign(defaults, defaults + ArraySize(defaults));
+    }
+
+    if (AllJoynInit() != ER_OK) {
+        return 1;
+    }
+
+#if defined(QCC_EVENT_EPOLL)
+    printf("epoll backend, %u waits per run\n", iterations);
+#else
+    printf("Default backend, %u waits per run\n", iterations);
+#endif
+    printf("%10s %20s %20s\n", "events", "usec per wait (set)", "usec per wait (idle)");
+
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] == 0) {
+            continue;
+        }
+        double setUsec = RunBenchmark(counts[i], iterations, true);
+        double idleUsec = RunBenchmark(counts[i], iterations, false);
+        if ((setUsec < 0) || (idleUsec < 0)) {
+            printf("%10u %20s\n", counts[i], "wait failed");
+        } else {
+            printf("%10u %20.3f %20.3f\n", counts[i], setUsec, idleUsec);
+        }
+    }
+
+    AllJoynShutdown();
+    return 0;
+}
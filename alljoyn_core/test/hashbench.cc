@@ -0,0 +1,189 @@
+/**
+ * @file
+ *
+ * Measures SHA-256 throughput for messages of various sizes and the rate of
+ * HMAC-SHA256 computations with one key, re-keying for every MAC as
+ * Crypto_PseudorandomFunction used to and keeping the key with GetMAC().
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <qcc/Crypto.h>
+#include <qcc/Util.h>
+#include <qcc/time.h>
+
+#include <alljoyn/Init.h>
+#include <alljoyn/Status.h>
+
+using namespace qcc;
+using namespace std;
+
+/* A master secret and a PRF label plus seed as used by the key exchangers */
+static const size_t KEY_LEN = 48;
+static const size_t PRF_MSG_LEN = 64;
+
+/*
+ * Returns the SHA-256 throughput in MB/s for messages of the given size, or a
+ * negative value if hashing failed.
+ */
+static double RunHashBenchmark(size_t msgLen, uint32_t totalMB)
+{
+    vector<uint8_t> msg(msgLen);
+    uint8_t digest[Crypto_SHA256::DIGEST_SIZE];
+    Crypto_GetRandomBytes(&msg[0], msgLen);
+
+    uint32_t iterations = static_cast<uint32_t>((static_cast<uint64_t>(totalMB) << 20) / msgLen);
+    if (iterations == 0) {
+        iterations = 1;
+    }
+    Crypto_SHA256 hash;
+    uint64_t start = GetTimestamp64();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        if ((hash.Init() != ER_OK) || (hash.Update(&msg[0], msgLen) != ER_OK) || (hash.GetDigest(digest) != ER_OK)) {
+            return -1.0;
+        }
+    }
+    uint64_t elapsed = GetTimestamp64() - start;
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+    return (static_cast<double>(iterations) * msgLen * 1000.0) / (static_cast<double>(elapsed) * 1000000.0);
+}
+
+/*
+ * Returns the number of HMAC-SHA256 computations per second over a PRF sized
+ * message, or a negative value if hashing failed.
+ */
+static double RunHmacBenchmark(bool keepKey, uint32_t iterations)
+{
+    uint8_t key[KEY_LEN];
+    uint8_t msg[PRF_MSG_LEN];
+    uint8_t digest[Crypto_SHA256::DIGEST_SIZE];
+    Crypto_GetRandomBytes(key, sizeof(key));
+    Crypto_GetRandomBytes(msg, sizeof(msg));
+
+    Crypto_SHA256 hash;
+    if (keepKey && (hash.Init(key, sizeof(key)) != ER_OK)) {
+        return -1.0;
+    }
+    uint64_t start = GetTimestamp64();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        QStatus status;
+        if (keepKey) {
+            status = hash.Update(msg, sizeof(msg));
+            if (status == ER_OK) {
+                status = hash.GetMAC(digest);
+            }
+        } else {
+            status = hash.Init(key, sizeof(key));
+            if (status == ER_OK) {
+                status = hash.Update(msg, sizeof(msg));
+            }
+            if (status == ER_OK) {
+                status = hash.GetDigest(digest);
+            }
+        }
+        if (status != ER_OK) {
+            return -1.0;
+        }
+    }
+    uint64_t elapsed = GetTimestamp64() - start;
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+    return (static_cast<double>(iterations) * 1000.0) / static_cast<double>(elapsed);
+}
+
+static void usage(void)
+{
+    printf("Usage: hashbench [-h] [-m <megabytes>] [-i <iterations>] [-s <size>]...\n\n");
+    printf("Options:\n");
+    printf("   -h                    = Print this help message\n");
+    printf("   -m <megabytes>        = Amount of data hashed per run (default 64)\n");
+    printf("   -i <iterations>       = Number of HMACs computed per run (default 200000)\n");
+    printf("   -s <size>             = Message size in bytes, may be repeated (default 64 1024 65536)\n");
+    printf("\nSet ER_CRYPTO_SHANI=0 to measure the portable SHA-256 on CPUs with the SHA extensions.\n");
+}
+
+int CDECL_CALL main(int argc, char** argv)
+{
+    uint32_t totalMB = 64;
+    uint32_t iterations = 200000;
+    vector<size_t> sizes;
+
+    for (int i = 1; i < argc; ++i) {
+        if (0 == strcmp("-h", argv[i])) {
+            usage();
+            return 0;
+        } else if ((0 == strcmp("-m", argv[i])) && (i + 1 < argc)) {
+            totalMB = strtoul(argv[++i], NULL, 10);
+        } else if ((0 == strcmp("-i", argv[i])) && (i + 1 < argc)) {
+            iterations = strtoul(argv[++i], NULL, 10);
+        } else if ((0 == strcmp("-s", argv[i])) && (i + 1 < argc)) {
+            sizes.push_back(strtoul(argv[++i], NULL, 10));
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if ((totalMB == 0) || (iterations == 0)) {
+        usage();
+        return 1;
+    }
+    if (sizes.empty()) {
+        const size_t defaults[] = { 64, 1024, 65536 };
+        sizes.assign(defaults, defaults + ArraySize(defaults));
+    }
+
+    if (AllJoynInit() != ER_OK) {
+        return 1;
+    }
+
+    printf("SHA-256, %u MB per run on one thread\n", totalMB);
+    printf("%10s %16s\n", "msg bytes", "MB/s");
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        if (sizes[i] == 0) {
+            continue;
+        }
+        double mbs = RunHashBenchmark(sizes[i], totalMB);
+        if (mbs < 0) {
+            printf("%10u %16s\n", static_cast<uint32_t>(sizes[i]), "hash failed");
+        } else {
+            printf("%10u %16.1f\n", static_cast<uint32_t>(sizes[i]), mbs);
+        }
+    }
+
+    printf("\nHMAC-SHA256, %u byte key, %u byte message, %u MACs per run\n", static_cast<uint32_t>(KEY_LEN), static_cast<uint32_t>(PRF_MSG_LEN), iterations);
+    printf("%16s %16s\n", "Init per MAC/s", "GetMAC/s");
+    double rekeyed = RunHmacBenchmark(false, iterations);
+    double kept = RunHmacBenchmark(true, iterations);
+    if ((rekeyed < 0) || (kept < 0)) {
+        printf("%16s\n", "HMAC failed");
+    } else {
+        printf("%16.0f %16.0f\n", rekeyed, kept);
+    }
+
+    AllJoynShutdown();
+    return 0;
+}
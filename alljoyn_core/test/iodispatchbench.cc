@@ -0,0 +1,245 @@
+/**
+ * @file
+ *
+ * Measures the cost of an IODispatch read wakeup as a function of the number of
+ * idle streams registered with the same IODispatch.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#if !defined(QCC_OS_GROUP_WINDOWS)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/select.h>
+#endif
+
+#include <qcc/Condition.h>
+#include <qcc/Debug.h>
+#include <qcc/IODispatch.h>
+#include <qcc/Mutex.h>
+#include <qcc/Socket.h>
+#include <qcc/SocketStream.h>
+#include <qcc/Util.h>
+#include <qcc/time.h>
+
+#include <alljoyn/Init.h>
+#include <alljoyn/Status.h>
+
+using namespace qcc;
+using namespace std;
+
+class BenchListener : public IOReadListener, public IOWriteListener, public IOExitListener {
+  public:
+    BenchListener(IODispatch& io) : io(io), wakeups(0) { }
+
+    virtual QStatus ReadCallback(Source& source, bool isTimedOut) {
+        if (!isTimedOut) {
+            /*
+             * Read the socket directly; SocketStream::PullBytes() may wait with
+             * select() which cannot handle the descriptor numbers used here.
+             */
+            uint8_t buf[64];
+            size_t actual;
+            Recv(static_cast<SocketStream&>(source).GetSocketFd(), buf, sizeof(buf), actual);
+            mutex.Lock();
+            ++wakeups;
+            condition.Signal();
+            mutex.Unlock();
+        }
+        io.EnableReadCallback(&source);
+        return ER_OK;
+    }
+
+    virtual QStatus WriteCallback(Sink& sink, bool isTimedOut) {
+        QCC_UNUSED(sink);
+        QCC_UNUSED(isTimedOut);
+        return ER_OK;
+    }
+
+    virtual void ExitCallback() { }
+
+    void WaitForWakeups(uint32_t count) {
+        mutex.Lock();
+        while (wakeups < count) {
+            condition.Wait(mutex);
+        }
+        mutex.Unlock();
+    }
+
+  private:
+    IODispatch& io;
+    Mutex mutex;
+    Condition condition;
+    uint32_t wakeups;
+};
+
+#if defined(QCC_IODISPATCH_EPOLL)
+/*
+ * Other parts of qcc (timer and thread events) still wait with select(), so
+ * keep the benchmark sockets out of the low descriptor range those use.
+ */
+static SocketFd MoveAboveFdSetSize(SocketFd fd)
+{
+    SocketFd moved = fcntl(fd, F_DUPFD, FD_SETSIZE);
+    if (moved < 0) {
+        return fd;
+    }
+    close(fd);
+    return moved;
+}
+#endif
+
+/*
+ * Returns the average wakeup latency in microseconds or a negative value if
+ * the streams could not be set up.
+ */
+static double RunBenchmark(uint32_t numIdle, uint32_t iterations)
+{
+    IODispatch io("iodispatchbench", 4);
+    BenchListener listener(io);
+    vector<SocketStream*> streams;
+    vector<SocketFd> peers;
+    double result = -1.0;
+
+    if (io.Start() != ER_OK) {
+        return result;
+    }
+
+    /* The last stream created is the active one */
+    for (uint32_t i = 0; i <= numIdle; ++i) {
+        SocketFd fds[2];
+        if (SocketPair(fds) != ER_OK) {
+            break;
+        }
+#if defined(QCC_IODISPATCH_EPOLL)
+        fds[0] = MoveAboveFdSetSize(fds[0]);
+        fds[1] = MoveAboveFdSetSize(fds[1]);
+#endif
+        SocketStream* stream = new SocketStream(fds[0]);
+        if (io.StartStream(stream, &listener, &listener, &listener, true, false) != ER_OK) {
+            delete stream;
+            Close(fds[1]);
+            break;
+        }
+        streams.push_back(stream);
+        peers.push_back(fds[1]);
+    }
+
+    if (streams.size() == numIdle + 1) {
+        SocketFd active = peers.back();
+        uint8_t byte = 0;
+        size_t sent;
+        uint64_t start = GetTimestamp64();
+        for (uint32_t i = 1; i <= iterations; ++i) {
+            Send(active, &byte, sizeof(byte), sent);
+            listener.WaitForWakeups(i);
+        }
+        result = (static_cast<double>(GetTimestamp64() - start) * 1000.0) / iterations;
+    }
+
+    for (size_t i = 0; i < streams.size(); ++i) {
+        io.StopStream(streams[i]);
+    }
+    for (size_t i = 0; i < streams.size(); ++i) {
+        io.JoinStream(streams[i]);
+        delete streams[i];
+        Close(peers[i]);
+    }
+    io.Stop();
+    io.Join();
+    return result;
+}
+
+static void usage(void)
+{
+    printf("Usage: iodispatchbench [-h] [-i <iterations>] [-n <idle streams>]...\n\n");
+    printf("Options:\n");
+    printf("   -h                    = Print this help message\n");
+    printf("   -i <iterations>       = Number of wakeups measured per run (default 2000)\n");
+    printf("   -n <idle streams>     = Number of idle streams, may be repeated (default 0 10 100 400 1000 4000)\n");
+}
+
+int CDECL_CALL main(int argc, char** argv)
+{
+    uint32_t iterations = 2000;
+    vector<uint32_t> counts;
+
+    for (int i = 1; i < argc; ++i) {
+        if (0 == strcmp("-h", argv[i])) {
+            usage();
+            return 0;
+        } else if ((0 == strcmp("-i", argv[i])) && (i + 1 < argc)) {
+            iterations = strtoul(argv[++i], NULL, 10);
+        } else if ((0 == strcmp("-n", argv[i])) && (i + 1 < argc)) {
+            counts.push_back(strtoul(argv[++i], NULL, 10));
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (counts.empty()) {
+        const uint32_t defaults[] = { 0, 10, 100, 400, 1000, 4000 };
+        counts.assign(defaults, defaults + ArraySize(defaults));
+    }
+
+    if (AllJoynInit() != ER_OK) {
+        return 1;
+    }
+
+#if !defined(QCC_OS_GROUP_WINDOWS)
+    /* Each idle stream needs two descriptors */
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+#endif
+
+#if defined(QCC_IODISPATCH_EPOLL)
+    printf("IODispatch backend: epoll\n");
+#else
+    printf("IODispatch backend: select\n");
+#endif
+    printf("%12s %20s\n", "idle streams", "usec per wakeup");
+
+    for (size_t i = 0; i < counts.size(); ++i) {
+#if !defined(QCC_IODISPATCH_EPOLL) && !defined(QCC_OS_GROUP_WINDOWS)
+        /* select() cannot wait on descriptors numbered at or above FD_SETSIZE */
+        if ((2 * counts[i] + 64) > FD_SETSIZE) {
+            printf("%12u %20s\n", counts[i], "exceeds FD_SETSIZE");
+            continue;
+        }
+#endif
+        double usec = RunBenchmark(counts[i], iterations);
+        if (usec < 0) {
+            printf("%12u %20s\n", counts[i], "setup failed");
+        } else {
+            printf("%12u %20.2f\n", counts[i], usec);
+        }
+    }
+
+    AllJoynShutdown();
+    return 0;
+}
@@ -0,0 +1,200 @@
+/**
+ * @file
+ *
+ * Measures how long it takes to find the permission policy rules matching a request,
+ * by walking every rule of the ACL as PermissionManager used to and by looking the
+ * request up in a PermissionPolicyIndex first, for policies of growing size.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <qcc/String.h>
+#include <qcc/StringUtil.h>
+#include <qcc/Util.h>
+#include <qcc/time.h>
+
+#include <alljoyn/Init.h>
+#include <alljoyn/PermissionPolicy.h>
+#include <alljoyn/Status.h>
+#include "../src/BusUtil.h"
+#include "../src/PermissionPolicyIndex.h"
+
+using namespace qcc;
+using namespace std;
+using namespace ajn;
+
+/* The rules and requests of the SecurityWildCardPolicyRulesTest scenarios */
+static const char* wildcardRules[][3] = {
+    { "/test/a*", "test.c*", "m*" },
+    { "/test/argentina", "test.calcium", "march" },
+    { "/test/arabic", "test.ca*", "*" },
+    { "*", "test.cashew", "mi*" },
+};
+
+static const char* requests[][3] = {
+    { "/test/argentina", "test.calcium", "march" },
+    { "/test/arabic", "test.camera", "mob" },
+    { "/test/arabic", "test.cashew", "mint" },
+    { "/test/argentina", "test.california", "metal" },
+    { "/app/obj7", "org.example.app7", "Method7" },
+};
+
+/* Same test as PermissionManager applies before looking at the action mask */
+static bool Matches(const char* str, const String& pattern)
+{
+    return (pattern == str) || !WildcardMatch(String(str), pattern);
+}
+
+static bool RuleMatches(const PermissionPolicy::Rule& rule, const char* objPath, const char* iName, const char* mbrName)
+{
+    if (rule.GetObjPath().empty() || rule.GetInterfaceName().empty() || (rule.GetMembersSize() == 0)) {
+        return false;
+    }
+    if (!Matches(objPath, rule.GetObjPath()) || !Matches(iName, rule.GetInterfaceName())) {
+        return false;
+    }
+    const PermissionPolicy::Rule::Member* members = rule.GetMembers();
+    for (size_t i = 0; i < rule.GetMembersSize(); ++i) {
+        if (!members[i].GetMemberName().empty() && Matches(mbrName, members[i].GetMemberName())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* The wildcard scenario rules followed by numFillers rules for unrelated objects */
+static void BuildPolicy(PermissionPolicy& policy, uint32_t numFillers)
+{
+    vector<PermissionPolicy::Rule> rules;
+    PermissionPolicy::Rule::Member member;
+    PermissionPolicy::Rule rule;
+    for (size_t i = 0; i < ArraySize(wildcardRules); ++i) {
+        member.Set(wildcardRules[i][2], PermissionPolicy::Rule::Member::NOT_SPECIFIED, PermissionPolicy::Rule::Member::ACTION_PROVIDE);
+        rule.SetObjPath(wildcardRules[i][0]);
+        rule.SetInterfaceName(wildcardRules[i][1]);
+        rule.SetMembers(1, &member);
+        rules.push_back(rule);
+    }
+    for (uint32_t i = 0; i < numFillers; ++i) {
+        member.Set("Method" + U32ToString(i), PermissionPolicy::Rule::Member::METHOD_CALL, PermissionPolicy::Rule::Member::ACTION_PROVIDE);
+        rule.SetObjPath("/app/obj" + U32ToString(i));
+        rule.SetInterfaceName("org.example.app" + U32ToString(i));
+        rule.SetMembers(1, &member);
+        rules.push_back(rule);
+    }
+    PermissionPolicy::Acl acl;
+    acl.SetRules(rules.size(), &rules[0]);
+    policy.SetAcls(1, &acl);
+}
+
+/*
+ * Returns the average time to find the matching rules of a request in microseconds.
+ * The number of rules that matched each pass is returned in matched.
+ */
+static double RunBenchmark(const PermissionPolicy& policy, const PermissionPolicyIndex* index, uint32_t iterations, uint32_t& matched)
+{
+    const PermissionPolicy::Acl& acl = policy.GetAcls()[0];
+    const PermissionPolicy::Rule* rules = acl.GetRules();
+    vector<size_t> candidates;
+    matched = 0;
+
+    uint64_t start = GetTimestamp64();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        const char** request = requests[i % ArraySize(requests)];
+        if (index) {
+            index->GetCandidateRules(0, request[0], request[1], request[2], candidates);
+            for (size_t r = 0; r < candidates.size(); ++r) {
+                matched += RuleMatches(rules[candidates[r]], request[0], request[1], request[2]) ? 1 : 0;
+            }
+        } else {
+            for (size_t r = 0; r < acl.GetRulesSize(); ++r) {
+                matched += RuleMatches(rules[r], request[0], request[1], request[2]) ? 1 : 0;
+            }
+        }
+    }
+    uint64_t elapsed = GetTimestamp64() - start;
+    return (static_cast<double>(elapsed) * 1000.0) / iterations;
+}
+
+static void usage(void)
+{
+    printf("Usage: policybench [-h] [-i <iterations>] [-r <rules>]...\n\n");
+    printf("Options:\n");
+    printf("   -h                    = Print this help message\n");
+    printf("   -i <iterations>       = Number of requests looked up per run (default 100000)\n");
+    printf("   -r <rules>            = Number of unrelated rules in the policy, may be repeated (default 10 100 500 1000)\n");
+}
+
+int CDECL_CALL main(int argc, char** argv)
+{
+    uint32_t iterations = 100000;
+    vector<uint32_t> counts;
+
+    for (int i = 1; i < argc; ++i) {
+        if (0 == strcmp("-h", argv[i])) {
+            usage();
+            return 0;
+        } else if ((0 == strcmp("-i", argv[i])) && (i + 1 < argc)) {
+            iterations = strtoul(argv[++i], NULL, 10);
+        } else if ((0 == strcmp("-r", argv[i])) && (i + 1 < argc)) {
+            counts.push_back(strtoul(argv[++i], NULL, 10));
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (iterations == 0) {
+        usage();
+        return 1;
+    }
+    if (counts.empty()) {
+        const uint32_t defaults[] = { 10, 100, 500, 1000 };
+        counts.assign(defaults, defaults + ArraySize(defaults));
+    }
+
+    if (AllJoynInit() != ER_OK) {
+        return 1;
+    }
+
+    printf("%u requests per run, %u wildcard rules plus the unrelated rules\n", iterations, static_cast<uint32_t>(ArraySize(wildcardRules)));
+    printf("%10s %16s %16s %10s\n", "rules", "scan usec/req", "index usec/req", "matched");
+
+    for (size_t i = 0; i < counts.size(); ++i) {
+        PermissionPolicy policy;
+        BuildPolicy(policy, counts[i]);
+        PermissionPolicyIndex index(policy);
+        uint32_t scanMatched;
+        uint32_t indexMatched;
+        double scanUsec = RunBenchmark(policy, NULL, iterations, scanMatched);
+        double indexUsec = RunBenchmark(policy, &index, iterations, indexMatched);
+        if (scanMatched != indexMatched) {
+            printf("%10u %16s\n", counts[i], "index missed a matching rule");
+            continue;
+        }
+        printf("%10u %16.3f %16.3f %10u\n", counts[i], scanUsec, indexUsec, indexMatched);
+    }
+
+    AllJoynShutdown();
+    return 0;
+}
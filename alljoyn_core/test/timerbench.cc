@@ -0,0 +1,189 @@
+/**
+ * @file
+ *
+ * Measures the cost of adding and cancelling alarms on a qcc::Timer for each kind of
+ * alarm queue as a function of the number of outstanding alarms.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <qcc/Debug.h>
+#include <qcc/Timer.h>
+#include <qcc/Util.h>
+#include <qcc/time.h>
+
+#include <alljoyn/Init.h>
+#include <alljoyn/Status.h>
+
+using namespace qcc;
+using namespace std;
+
+class BenchListener : public AlarmListener {
+  public:
+    virtual void AlarmTriggered(const Alarm& alarm, QStatus reason) {
+        QCC_UNUSED(alarm);
+        QCC_UNUSED(reason);
+    }
+};
+
+/* Cheap generator so the benchmark does not measure the random number source */
+static uint32_t NextRandom(uint32_t& state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+/*
+ * Starts with numPending alarms on the timer then adds iterations more. Each new alarm is
+ * cancelled, along with a random pending one, cancelPercent percent of the time, which is
+ * roughly what happens to method call reply timeouts. Alarm delays are spread between
+ * minDelay and maxDelay milliseconds so nothing fires while the benchmark runs.
+ *
+ * Returns the average cost of an add or a cancel in microseconds or a negative value if
+ * the timer could not be started.
+ */
+static double RunBenchmark(Timer::AlarmQueueType queueType, uint32_t numPending, uint32_t iterations,
+                           uint32_t cancelPercent, uint32_t minDelay, uint32_t maxDelay)
+{
+    Timer timer("timerbench", false, 1, false, 0, queueType);
+    BenchListener listener;
+    AlarmListener* al = &listener;
+    vector<Alarm> pending;
+    uint32_t seed = 0x9E3779B9;
+    uint32_t range = maxDelay - minDelay + 1;
+
+    if (timer.Start() != ER_OK) {
+        return -1.0;
+    }
+
+    pending.reserve(numPending + iterations);
+    for (uint32_t i = 0; i < numPending; ++i) {
+        uint32_t delay = minDelay + NextRandom(seed) % range;
+        Alarm alarm(delay, al);
+        timer.AddAlarm(alarm);
+        pending.push_back(alarm);
+    }
+
+    /* Alarms are created up front so only the timer operations are timed */
+    vector<Alarm> added;
+    added.reserve(iterations);
+    for (uint32_t i = 0; i < iterations; ++i) {
+        uint32_t delay = minDelay + NextRandom(seed) % range;
+        added.push_back(Alarm(delay, al));
+    }
+
+    uint64_t ops = 0;
+    uint64_t start = GetTimestamp64();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        timer.AddAlarm(added[i]);
+        ++ops;
+        if ((NextRandom(seed) % 100) < cancelPercent) {
+            timer.RemoveAlarm(added[i]);
+            ++ops;
+            if (!pending.empty()) {
+                size_t victim = NextRandom(seed) % pending.size();
+                timer.RemoveAlarm(pending[victim]);
+                ++ops;
+                pending[victim] = pending.back();
+                pending.pop_back();
+            }
+        } else {
+            pending.push_back(added[i]);
+        }
+    }
+    uint64_t elapsed = GetTimestamp64() - start;
+
+    timer.Stop();
+    timer.Join();
+    return (static_cast<double>(elapsed) * 1000.0) / ops;
+}
+
+static void usage(void)
+{
+    printf("Usage: timerbench [-h] [-i <iterations>] [-c <cancel percent>] [-d <min delay ms> <max delay ms>] [-n <pending alarms>]...\n\n");
+    printf("Options:\n");
+    printf("   -h                    = Print this help message\n");
+    printf("   -i <iterations>       = Number of alarms added per run (default 100000)\n");
+    printf("   -c <cancel percent>   = Percentage of added alarms that are cancelled (default 90)\n");
+    printf("   -d <min> <max>        = Range of alarm delays in milliseconds (default 10000 60000)\n");
+    printf("   -n <pending alarms>   = Number of alarms pending at the start, may be repeated (default 100 1000 10000 100000)\n");
+}
+
+int CDECL_CALL main(int argc, char** argv)
+{
+    uint32_t iterations = 100000;
+    uint32_t cancelPercent = 90;
+    uint32_t minDelay = 10000;
+    uint32_t maxDelay = 60000;
+    vector<uint32_t> counts;
+
+    for (int i = 1; i < argc; ++i) {
+        if (0 == strcmp("-h", argv[i])) {
+            usage();
+            return 0;
+        } else if ((0 == strcmp("-i", argv[i])) && (i + 1 < argc)) {
+            iterations = strtoul(argv[++i], NULL, 10);
+        } else if ((0 == strcmp("-c", argv[i])) && (i + 1 < argc)) {
+            cancelPercent = strtoul(argv[++i], NULL, 10);
+        } else if ((0 == strcmp("-d", argv[i])) && (i + 2 < argc)) {
+            minDelay = strtoul(argv[++i], NULL, 10);
+            maxDelay = strtoul(argv[++i], NULL, 10);
+        } else if ((0 == strcmp("-n", argv[i])) && (i + 1 < argc)) {
+            counts.push_back(strtoul(argv[++i], NULL, 10));
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if ((iterations == 0) || (cancelPercent > 100) || (minDelay > maxDelay)) {
+        usage();
+        return 1;
+    }
+    if (counts.empty()) {
+        const uint32_t defaults[] = { 100, 1000, 10000, 100000 };
+        counts.assign(defaults, defaults + ArraySize(defaults));
+    }
+
+    if (AllJoynInit() != ER_OK) {
+        return 1;
+    }
+
+    printf("%u alarms added per run, %u%% cancelled, delays %u-%u ms\n", iterations, cancelPercent, minDelay, maxDelay);
+    printf("%16s %20s %20s\n", "pending alarms", "set usec per op", "wheel usec per op");
+
+    for (size_t i = 0; i < counts.size(); ++i) {
+        double setUsec = RunBenchmark(Timer::ALARM_SET, counts[i], iterations, cancelPercent, minDelay, maxDelay);
+        double wheelUsec = RunBenchmark(Timer::TIMING_WHEEL, counts[i], iterations, cancelPercent, minDelay, maxDelay);
+        if ((setUsec < 0) || (wheelUsec < 0)) {
+            printf("%16u %20s\n", counts[i], "timer start failed");
+        } else {
+            printf("%16u %20.3f %20.3f\n", counts[i], setUsec, wheelUsec);
+        }
+    }
+
+    AllJoynShutdown();
+    return 0;
+}
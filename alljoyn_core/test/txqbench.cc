@@ -0,0 +1,283 @@
+/**
+ * @file
+ *
+ * Measures fan-in onto a RemoteEndpoint style transmit queue: many threads pushing
+ * messages onto one bounded queue drained by a single writer, either through a mutex
+ * protected deque or through a lock-free qcc::MPSCRing. Like bbsig, each producer
+ * marshals a new broadcast signal with an a{ys} argument for every push.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+#include <vector>
+
+#include <qcc/MPSCRing.h>
+#include <qcc/ManagedObj.h>
+#include <qcc/Mutex.h>
+#include <qcc/StringUtil.h>
+#include <qcc/Thread.h>
+#include <qcc/Util.h>
+#include <qcc/atomic.h>
+#include <qcc/time.h>
+
+#include <alljoyn/BusAttachment.h>
+#include <alljoyn/Init.h>
+#include <alljoyn/Message.h>
+#include <alljoyn/MsgArg.h>
+#include <alljoyn/Status.h>
+
+using namespace qcc;
+using namespace std;
+using namespace ajn;
+
+/* The signal bbsig sends */
+class _BenchSignal : public _Message {
+  public:
+    _BenchSignal(BusAttachment& bus, const String& sender) : _Message(bus)
+    {
+        MsgArg arg("a{ys}", 0, NULL);
+        SignalMsg("a{ys}", sender, NULL, 0, "/org/alljoyn/alljoyn_test", "org.alljoyn.alljoyn_test", "my_signal",
+                  &arg, 1, ALLJOYN_FLAG_GLOBAL_BROADCAST, 0);
+    }
+};
+typedef ManagedObj<_BenchSignal> BenchMsg;
+
+/* Same bound as _RemoteEndpoint::MAX_TX_DATA_MESSAGES */
+static const size_t MAX_QUEUED = 8;
+
+/* The transmit queue under test, shared by the producers and the writer */
+class TxQueue {
+  public:
+    TxQueue(bool useRing) : useRing(useRing), ring(MAX_QUEUED), contended(0) { }
+
+    /* Returns false if the queue was full */
+    bool Push(const Message& msg)
+    {
+        if (useRing) {
+            if (ring.TryPush(msg)) {
+                return true;
+            }
+            IncrementAndFetch(&contended);
+            return false;
+        }
+        if (!lock.TryLock()) {
+            IncrementAndFetch(&contended);
+            lock.Lock(MUTEX_CONTEXT);
+        }
+        bool pushed = (queue.size() < MAX_QUEUED);
+        if (pushed) {
+            queue.push_front(msg);
+        }
+        lock.Unlock(MUTEX_CONTEXT);
+        return pushed;
+    }
+
+    /* Called by the writer, returns the number of messages taken off the queue */
+    size_t Drain()
+    {
+        size_t count = 0;
+        lock.Lock(MUTEX_CONTEXT);
+        if (useRing) {
+            Message* msg;
+            while ((msg = ring.Front()) != NULL) {
+                queue.push_front(*msg);
+                ring.PopFront();
+            }
+        }
+        while (!queue.empty()) {
+            queue.pop_back();
+            ++count;
+        }
+        lock.Unlock(MUTEX_CONTEXT);
+        return count;
+    }
+
+    bool useRing;
+    Mutex lock;
+    deque<Message> queue;
+    MPSCRing<Message> ring;
+    volatile int32_t contended;
+};
+
+class Producer : public Thread {
+  public:
+    Producer(BusAttachment& bus, TxQueue& txQueue, uint32_t iterations, uint32_t delay, uint32_t id) :
+        Thread("txqbench"), bus(bus), txQueue(txQueue), iterations(iterations), delay(delay), sender(":txqbench.") {
+        sender += U32ToString(id);
+    }
+
+  protected:
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        for (uint32_t i = 0; i < iterations; ++i) {
+            BenchMsg signal(bus, sender);
+            Message msg = Message::cast(signal);
+            /* A real producer would block on the txWaitQueue here */
+            while (!txQueue.Push(msg)) {
+                Sleep(0);
+            }
+            if (delay > 0) {
+                Sleep(delay);
+            }
+        }
+        return 0;
+    }
+
+  private:
+    BusAttachment& bus;
+    TxQueue& txQueue;
+    uint32_t iterations;
+    uint32_t delay;
+    String sender;
+};
+
+class Writer : public Thread {
+  public:
+    Writer(TxQueue& txQueue, uint64_t expected) : Thread("txqbenchWriter"), txQueue(txQueue), expected(expected) { }
+
+  protected:
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        uint64_t written = 0;
+        while (written < expected) {
+            size_t count = txQueue.Drain();
+            if (count == 0) {
+                Sleep(0);
+            }
+            written += count;
+        }
+        return 0;
+    }
+
+  private:
+    TxQueue& txQueue;
+    uint64_t expected;
+};
+
+/*
+ * Runs numProducers threads each pushing iterations messages. Returns the average time
+ * of a push in microseconds or a negative value if a thread could not be started. The
+ * number of pushes that found the lock held (mutex) or the queue full (ring) is returned
+ * in contended.
+ */
+static double RunBenchmark(BusAttachment& bus, bool useRing, uint32_t numProducers, uint32_t iterations, uint32_t delay, uint32_t& contended)
+{
+    TxQueue txQueue(useRing);
+    Writer writer(txQueue, static_cast<uint64_t>(numProducers) * iterations);
+    vector<Producer*> producers;
+    bool failed = false;
+
+    for (uint32_t i = 0; i < numProducers; ++i) {
+        producers.push_back(new Producer(bus, txQueue, iterations, delay, i));
+    }
+
+    uint64_t start = GetTimestamp64();
+    failed = (writer.Start() != ER_OK);
+    for (size_t i = 0; !failed && (i < producers.size()); ++i) {
+        failed = (producers[i]->Start() != ER_OK);
+    }
+    for (size_t i = 0; i < producers.size(); ++i) {
+        producers[i]->Join();
+    }
+    if (failed) {
+        writer.Stop();
+    }
+    writer.Join();
+    uint64_t elapsed = GetTimestamp64() - start;
+
+    for (size_t i = 0; i < producers.size(); ++i) {
+        delete producers[i];
+    }
+    contended = static_cast<uint32_t>(txQueue.contended);
+    return failed ? -1.0 : (static_cast<double>(elapsed) * 1000.0) / (static_cast<double>(numProducers) * iterations);
+}
+
+static void usage(void)
+{
+    printf("Usage: txqbench [-h] [-i <iterations>] [-r <delay>] [-p <producers>]...\n\n");
+    printf("Options:\n");
+    printf("   -h                    = Print this help message\n");
+    printf("   -i <iterations>       = Number of messages pushed by each producer (default 100000)\n");
+    printf("   -r <delay>            = Delay in ms between the signals of a producer, as bbsig -r (default 0)\n");
+    printf("   -p <producers>        = Number of producer threads, may be repeated (default 1 2 4 8 16)\n");
+}
+
+int CDECL_CALL main(int argc, char** argv)
+{
+    uint32_t iterations = 100000;
+    uint32_t delay = 0;
+    vector<uint32_t> counts;
+
+    for (int i = 1; i < argc; ++i) {
+        if (0 == strcmp("-h", argv[i])) {
+            usage();
+            return 0;
+        } else if ((0 == strcmp("-i", argv[i])) && (i + 1 < argc)) {
+            iterations = strtoul(argv[++i], NULL, 10);
+        } else if ((0 == strcmp("-r", argv[i])) && (i + 1 < argc)) {
+            delay = strtoul(argv[++i], NULL, 10);
+        } else if ((0 == strcmp("-p", argv[i])) && (i + 1 < argc)) {
+            counts.push_back(strtoul(argv[++i], NULL, 10));
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (iterations == 0) {
+        usage();
+        return 1;
+    }
+    if (counts.empty()) {
+        const uint32_t defaults[] = { 1, 2, 4, 8, 16 };
+        counts.assign(defaults, defaults + ArraySize(defaults));
+    }
+
+    if (AllJoynInit() != ER_OK) {
+        return 1;
+    }
+    BusAttachment* bus = new BusAttachment("txqbench", true);
+
+    printf("%u messages pushed per producer, queue bound %u\n", iterations, static_cast<uint32_t>(MAX_QUEUED));
+    printf("%10s %16s %16s %16s %16s\n", "producers", "mutex usec/push", "mutex contended", "ring usec/push", "ring full");
+
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] == 0) {
+            continue;
+        }
+        uint32_t mutexContended;
+        uint32_t ringFull;
+        double mutexUsec = RunBenchmark(*bus, false, counts[i], iterations, delay, mutexContended);
+        double ringUsec = RunBenchmark(*bus, true, counts[i], iterations, delay, ringFull);
+        if ((mutexUsec < 0) || (ringUsec < 0)) {
+            printf("%10u %16s\n", counts[i], "thread start failed");
+        } else {
+            printf("%10u %16.3f %16u %16.3f %16u\n", counts[i], mutexUsec, mutexContended, ringUsec, ringFull);
+        }
+    }
+
+    delete bus;
+    AllJoynShutdown();
+    return 0;
+}
@@ -348,6 +348,68 @@ TEST(MarshalTest, ReplayProtection) {
     delete bus;
 }
 
+TEST(MarshalTest, ReplaceSender) {
+    QStatus status = ER_OK;
+
+    BusAttachment* bus = new BusAttachment("ReplaceSender", false);
+    bus->Start();
+
+    TestPipe stream;
+    TestPipe* pStream = &stream;
+    static const bool falsiness = false;
+    RemoteEndpoint ep(*bus, falsiness, String::Empty, pStream);
+
+    uint8_t* body = new uint8_t[65536];
+    for (size_t i = 0; i < 65536; ++i) {
+        body[i] = static_cast<uint8_t>(i * 7);
+    }
+    MsgArg arg("ay", 65536, body);
+
+    /*
+     * Unmarshal replaces the sender with the unique name of the receiving endpoint. Use names that
+     * are shorter and longer than the original sender so the header both shrinks and grows.
+     */
+    const char* senders[] = { ":1.2", ":ReplaceSenderReplaceSender.12345", ":1.3" };
+    for (size_t n = 0; n < ArraySize(senders); ++n) {
+        MyMessage msg(*bus);
+        status = msg.Signal(NULL, "/foo/bar", "foo.bar", "test", &arg, 1);
+        ASSERT_EQ(ER_OK, status);
+
+        status = msg.Deliver(ep);
+        ASSERT_EQ(ER_OK, status);
+        status = msg.Read(ep, ":88.88");
+        ASSERT_EQ(ER_OK, status);
+
+        ep->SetUniqueName(senders[n]);
+        status = msg.Unmarshal(ep, senders[n]);
+        ASSERT_EQ(ER_OK, status);
+        EXPECT_STREQ(senders[n], msg.GetSender());
+
+        /* The rewritten message must survive being forwarded again */
+        status = msg.Deliver(ep);
+        ASSERT_EQ(ER_OK, status);
+        status = msg.Read(ep, ":88.88");
+        ASSERT_EQ(ER_OK, status);
+        ep->SetUniqueName(":88.88");
+        status = msg.Unmarshal(ep, ":88.88");
+        ASSERT_EQ(ER_OK, status);
+        EXPECT_STREQ(":88.88", msg.GetSender());
+        EXPECT_STREQ("test", msg.GetMemberName());
+        status = msg.UnmarshalBody();
+        ASSERT_EQ(ER_OK, status);
+
+        uint8_t* ay;
+        size_t len;
+        status = msg.GetArgs("ay", &len, &ay);
+        ASSERT_EQ(ER_OK, status);
+        ASSERT_EQ(static_cast<size_t>(65536), len);
+        EXPECT_EQ(0, memcmp(body, ay, len));
+    }
+
+    delete [] body;
+    delete bus;
+}
+
 
 /*--------------------------FUZZING TEST CODE---------------------------------*/
 static bool fuzzing = false;
@@ -0,0 +1,65 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+
+#include <alljoyn/Status.h>
+
+/* Private files included for unit testing */
+#include <PeerState.h>
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "ajTestCommon.h"
+
+using namespace ajn;
+
+TEST(PeerStateTest, AuthorizationCacheFollowsPolicyGeneration)
+{
+    PeerState peerState;
+    bool authorized = false;
+    uint32_t epoch;
+
+    EXPECT_FALSE(peerState->GetCachedAuthorization("ia-1 /obj org.test Method", 1, authorized, epoch));
+    peerState->CacheAuthorization("ia-1 /obj org.test Method", 1, epoch, true);
+    EXPECT_TRUE(peerState->GetCachedAuthorization("ia-1 /obj org.test Method", 1, authorized, epoch));
+    EXPECT_TRUE(authorized);
+    EXPECT_FALSE(peerState->GetCachedAuthorization("oa-1 /obj org.test Method", 1, authorized, epoch));
+
+    /* A decision made under an older policy is never returned */
+    EXPECT_FALSE(peerState->GetCachedAuthorization("ia-1 /obj org.test Method", 2, authorized, epoch));
+    peerState->CacheAuthorization("ia-1 /obj org.test Method", 2, epoch, false);
+    EXPECT_TRUE(peerState->GetCachedAuthorization("ia-1 /obj org.test Method", 2, authorized, epoch));
+    EXPECT_FALSE(authorized);
+}
+
+TEST(PeerStateTest, AuthorizationCacheClearedOnPeerChanges)
+{
+    PeerState peerState;
+    bool authorized = false;
+    uint32_t epoch;
+
+    EXPECT_FALSE(peerState->GetCachedAuthorization("ia-1 /obj org.test Method", 1, authorized, epoch));
+    peerState->CacheAuthorization("ia-1 /obj org.test Method", 1, epoch, true);
+    EXPECT_EQ(ER_OK, peerState->ClearManifests());
+    EXPECT_FALSE(peerState->GetCachedAuthorization("ia-1 /obj org.test Method", 1, authorized, epoch));
+
+    /* A decision computed from the peer state before the change is not cached */
+    uint32_t staleEpoch = epoch;
+    peerState->ClearKeys();
+    peerState->CacheAuthorization("ia-1 /obj org.test Method", 1, staleEpoch, true);
+    EXPECT_FALSE(peerState->GetCachedAuthorization("ia-1 /obj org.test Method", 1, authorized, epoch));
+    EXPECT_NE(staleEpoch, epoch);
+}
@@ -0,0 +1,206 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+
+#include <memory>
+
+#include <qcc/CertificateECC.h>
+#include <qcc/GUID.h>
+#include <qcc/Metrics.h>
+#include <qcc/Thread.h>
+
+#include <alljoyn/PermissionPolicy.h>
+#include <alljoyn/Status.h>
+
+#include "BusInternal.h"
+#include "PeerState.h"
+#include "PermissionManager.h"
+#include "TestSecureApplication.h"
+#include "TestSecurityManager.h"
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "ajTestCommon.h"
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+/*
+ * These tests authorize a Get of the provider's test property by the consumer
+ * directly through the provider's PermissionManager, and check that a cached
+ * decision does not survive a change to anything it was made from.
+ */
+class PermissionManagerTest : public testing::Test {
+  public:
+    PermissionManagerTest() : prov("provider"), cons("consumer"),
+        cacheHits(Metrics::GetCounter("permission.authorize.cache.hits"))
+    {
+    }
+
+    virtual void SetUp()
+    {
+        ASSERT_EQ(ER_OK, tsm.Init());
+        ASSERT_EQ(ER_OK, prov.Init(tsm));
+        ASSERT_EQ(ER_OK, cons.Init(tsm));
+        ASSERT_EQ(ER_OK, prov.HostSession());
+        SessionId sessionId = 0;
+        ASSERT_EQ(ER_OK, cons.JoinSession(prov, sessionId));
+        ASSERT_EQ(ER_OK, prov.SetAnyTrustedUserPolicy(tsm, PermissionPolicy::Rule::Member::ACTION_OBSERVE | PermissionPolicy::Rule::Member::ACTION_MODIFY));
+        ASSERT_EQ(ER_OK, cons.SetAnyTrustedUserPolicy(tsm, PermissionPolicy::Rule::Member::ACTION_PROVIDE));
+
+        /* The consumer only sends its manifest along with a message that needs it */
+        proxy = shared_ptr<ProxyBusObject>(cons.GetProxyObject(prov, sessionId));
+        ASSERT_TRUE(proxy != NULL);
+        MsgArg value;
+        ASSERT_EQ(ER_OK, proxy->GetProperty(TEST_INTERFACE, TEST_PROP_NAME, value));
+
+        BusAttachment& provBus = prov.GetBusAttachement();
+        String consName = cons.GetBusAttachement().GetUniqueName();
+        peerState = provBus.GetInternal().GetPeerStateTable()->GetPeerState(consName);
+        ASSERT_EQ(ER_OK, provBus.GetPeerGUID(consName.c_str(), consGuid));
+        ASSERT_EQ(ER_OK, cons.GetBusAttachement().GetPermissionConfigurator().GetSigningPublicKey(consKey));
+    }
+
+    /* Replace the provider's policy with a single ACL granting peer everything on interfaceName */
+    void SetPolicy(const PermissionPolicy::Peer& peer, const char* interfaceName = TEST_INTERFACE)
+    {
+        PermissionPolicy::Rule::Member member;
+        member.Set("*", PermissionPolicy::Rule::Member::NOT_SPECIFIED,
+                   PermissionPolicy::Rule::Member::ACTION_PROVIDE |
+                   PermissionPolicy::Rule::Member::ACTION_OBSERVE |
+                   PermissionPolicy::Rule::Member::ACTION_MODIFY);
+        PermissionPolicy::Rule rule;
+        rule.SetObjPath("*");
+        rule.SetInterfaceName(interfaceName);
+        rule.SetMembers(1, &member);
+        PermissionPolicy::Acl acl;
+        acl.SetPeers(1, &peer);
+        acl.SetRules(1, &rule);
+        PermissionPolicy* policy = new PermissionPolicy();
+        policy->SetAcls(1, &acl);
+        GetPermissionManager().SetPolicy(policy);
+    }
+
+    void SetPolicy(PermissionPolicy::Peer::PeerType type, const char* interfaceName = TEST_INTERFACE)
+    {
+        PermissionPolicy::Peer peer;
+        peer.SetType(type);
+        SetPolicy(peer, interfaceName);
+    }
+
+    PermissionManager& GetPermissionManager()
+    {
+        return prov.GetBusAttachement().GetInternal().GetPermissionManager();
+    }
+
+    QStatus Authorize()
+    {
+        return GetPermissionManager().AuthorizeGetProperty(DEFAULT_TEST_OBJ_PATH, TEST_INTERFACE, TEST_PROP_NAME, peerState);
+    }
+
+    /* Authorize twice and check that the second decision came from the cache */
+    QStatus AuthorizeCached()
+    {
+        QStatus first = Authorize();
+        uint32_t hits = cacheHits->GetValue();
+        QStatus second = Authorize();
+        EXPECT_LT(hits, cacheHits->GetValue());
+        EXPECT_EQ(first, second);
+        return second;
+    }
+
+    TestSecurityManager tsm;
+    TestSecureApplication prov;
+    TestSecureApplication cons;
+    shared_ptr<ProxyBusObject> proxy;
+    PeerState peerState;
+    String consGuid;
+    KeyInfoNISTP256 consKey;
+    MetricCounter* cacheHits;
+};
+
+TEST_F(PermissionManagerTest, PolicyChangeInvalidatesCache)
+{
+    SetPolicy(PermissionPolicy::Peer::PEER_ANY_TRUSTED);
+    EXPECT_EQ(ER_OK, AuthorizeCached());
+
+    SetPolicy(PermissionPolicy::Peer::PEER_ANY_TRUSTED, "other.interface");
+    EXPECT_EQ(ER_PERMISSION_DENIED, AuthorizeCached());
+
+    SetPolicy(PermissionPolicy::Peer::PEER_ANY_TRUSTED);
+    EXPECT_EQ(ER_OK, AuthorizeCached());
+}
+
+TEST_F(PermissionManagerTest, ManifestChangeInvalidatesCache)
+{
+    SetPolicy(PermissionPolicy::Peer::PEER_ANY_TRUSTED);
+    std::vector<Manifest> manifests = peerState->GetManifests();
+    ASSERT_FALSE(manifests.empty());
+    EXPECT_EQ(ER_OK, AuthorizeCached());
+
+    peerState->ClearManifests();
+    EXPECT_EQ(ER_PERMISSION_DENIED, AuthorizeCached());
+
+    for (size_t i = 0; i < manifests.size(); ++i) {
+        peerState->StoreManifest(manifests[i]);
+    }
+    EXPECT_EQ(ER_OK, AuthorizeCached());
+}
+
+TEST_F(PermissionManagerTest, MembershipChangeInvalidatesCache)
+{
+    GUID128 group;
+    PermissionPolicy::Peer peer;
+    peer.SetType(PermissionPolicy::Peer::PEER_WITH_MEMBERSHIP);
+    peer.SetSecurityGroupId(group);
+    SetPolicy(peer);
+    EXPECT_EQ(ER_PERMISSION_DENIED, AuthorizeCached());
+
+    MembershipCertificate* cert = new MembershipCertificate();
+    cert->SetGuild(group);
+    _PeerState::GuildMetadata* guild = new _PeerState::GuildMetadata();
+    guild->certChain.push_back(cert);
+    peerState->SetGuildMetadata("1", "issuer", guild);
+    EXPECT_EQ(ER_OK, AuthorizeCached());
+}
+
+TEST_F(PermissionManagerTest, ClearKeysInvalidatesCache)
+{
+    PermissionPolicy::Peer peer;
+    peer.SetType(PermissionPolicy::Peer::PEER_WITH_PUBLIC_KEY);
+    peer.SetKeyInfo(&consKey);
+    SetPolicy(peer);
+    EXPECT_EQ(ER_OK, AuthorizeCached());
+
+    /* Only the key store entry goes away, the peer state keeps its session keys */
+    ASSERT_EQ(ER_OK, prov.GetBusAttachement().ClearKeys(consGuid));
+    EXPECT_EQ(ER_PERMISSION_DENIED, AuthorizeCached());
+}
+
+TEST_F(PermissionManagerTest, KeyExpirationInvalidatesCache)
+{
+    PermissionPolicy::Peer peer;
+    peer.SetType(PermissionPolicy::Peer::PEER_WITH_PUBLIC_KEY);
+    peer.SetKeyInfo(&consKey);
+    SetPolicy(peer);
+
+    ASSERT_EQ(ER_OK, prov.GetBusAttachement().SetKeyExpiration(consGuid, 1));
+    EXPECT_EQ(ER_OK, AuthorizeCached());
+
+    qcc::Sleep(1500);
+    EXPECT_EQ(ER_PERMISSION_DENIED, AuthorizeCached());
+}
@@ -0,0 +1,119 @@
+/**
+ * @file
+ * This program tests the PermissionPolicyIndex for Alljoyn security 2.0. It uses
+ * google test as the test automation framework.
+ */
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "ajTestCommon.h"
+
+#include <PermissionPolicy.h>
+#include <PermissionPolicyIndex.h>
+
+using namespace ajn;
+
+struct RuleSpec {
+    const char* objPath;
+    const char* iName;
+    const char* mbrName;
+};
+
+/* Rules modeled on the SecurityWildCardPolicyRulesTest scenarios */
+static const RuleSpec ruleSpecs[] = {
+    { "/test/argentina", "test.calcium", "march" },     /* 0: exact */
+    { "/test/a*", "test.c*", "m*" },                    /* 1: prefix */
+    { "*", "*", "*" },                                  /* 2: everything */
+    { "/other", "test.calcium", "march" },              /* 3: other object */
+    { "/test/*/x", "test.calcium", "*" },               /* 4: wildcard not at the end */
+    { "", "test.calcium", "march" },                    /* 5: never matches */
+};
+
+static void BuildPolicy(PermissionPolicy& policy)
+{
+    const size_t count = sizeof(ruleSpecs) / sizeof(ruleSpecs[0]);
+    PermissionPolicy::Rule rules[count];
+    for (size_t i = 0; i < count; ++i) {
+        PermissionPolicy::Rule::Member member;
+        member.Set(ruleSpecs[i].mbrName, PermissionPolicy::Rule::Member::NOT_SPECIFIED, PermissionPolicy::Rule::Member::ACTION_PROVIDE);
+        rules[i].SetObjPath(ruleSpecs[i].objPath);
+        rules[i].SetInterfaceName(ruleSpecs[i].iName);
+        rules[i].SetMembers(1, &member);
+    }
+    PermissionPolicy::Acl acl;
+    acl.SetRules(count, rules);
+    policy.SetAcls(1, &acl);
+}
+
+static std::vector<size_t> Rules(size_t a, size_t b = SIZE_MAX, size_t c = SIZE_MAX, size_t d = SIZE_MAX)
+{
+    std::vector<size_t> rules;
+    size_t all[] = { a, b, c, d };
+    for (size_t i = 0; (i < 4) && (all[i] != SIZE_MAX); ++i) {
+        rules.push_back(all[i]);
+    }
+    return rules;
+}
+
+TEST(PermissionPolicyIndexTest, CandidatesMatchWildcards)
+{
+    PermissionPolicy policy;
+    BuildPolicy(policy);
+    PermissionPolicyIndex index(policy);
+    std::vector<size_t> rules;
+
+    index.GetCandidateRules(0, "/test/argentina", "test.calcium", "march", rules);
+    EXPECT_EQ(Rules(0, 1, 2, 4), rules);
+
+    index.GetCandidateRules(0, "/test/arabic", "test.camera", "mob", rules);
+    EXPECT_EQ(Rules(1, 2), rules);
+
+    /* The exact member name no longer matches but the prefix does */
+    index.GetCandidateRules(0, "/test/argentina", "test.calcium", "marches", rules);
+    EXPECT_EQ(Rules(1, 2, 4), rules);
+
+    index.GetCandidateRules(0, "/other", "org.example", "run", rules);
+    EXPECT_EQ(Rules(2), rules);
+
+    index.GetCandidateRules(0, "/other", "test.calcium", "march", rules);
+    EXPECT_EQ(Rules(2, 3, 4), rules);
+}
+
+TEST(PermissionPolicyIndexTest, EmptyMemberNameConsidersEveryMember)
+{
+    PermissionPolicy policy;
+    BuildPolicy(policy);
+    PermissionPolicyIndex index(policy);
+    std::vector<size_t> rules;
+
+    /* GetAll properties requests have no member name */
+    index.GetCandidateRules(0, "/test/argentina", "test.calcium", NULL, rules);
+    EXPECT_EQ(Rules(0, 1, 2, 4), rules);
+    index.GetCandidateRules(0, "/test/argentina", "test.calcium", "", rules);
+    EXPECT_EQ(Rules(0, 1, 2, 4), rules);
+}
+
+TEST(PermissionPolicyIndexTest, UnknownAcl)
+{
+    PermissionPolicy policy;
+    BuildPolicy(policy);
+    PermissionPolicyIndex index(policy);
+    std::vector<size_t> rules(1, 0);
+
+    index.GetCandidateRules(1, "/test/argentina", "test.calcium", "march", rules);
+    EXPECT_TRUE(rules.empty());
+}
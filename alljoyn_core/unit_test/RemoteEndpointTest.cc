@@ -57,6 +57,13 @@ class _TestMessage : public _Message {
     _TestMessage(BusAttachment& bus, const char* sender) : _Message(bus) {
         EXPECT_EQ(ER_OK, SignalMsg("", sender, NULL, 0, "/path", "iface", "signalName", NULL, 0, 0, 0));
     }
+    _TestMessage(BusAttachment& bus, const char* sender, uint16_t ttl) : _Message(bus) {
+        EXPECT_EQ(ER_OK, SignalMsg("", sender, NULL, 0, "/path", "iface", "signalName", NULL, 0, 0, ttl));
+    }
+    _TestMessage(BusAttachment& bus, uint32_t value) : _Message(bus) {
+        MsgArg arg("u", value);
+        EXPECT_EQ(ER_OK, SignalMsg("u", "sender", NULL, 0, "/path", "iface", "signalName", &arg, 1, 0, 0));
+    }
     virtual ~_TestMessage() { }
 };
 typedef qcc::ManagedObj<_TestMessage> TestMessage;
@@ -201,6 +208,234 @@ TEST_F(RemoteEndpointTest, TxFail)
     EXPECT_TRUE(tts.closed);
 }
 
+class BatchTestStream : public TestStream {
+  public:
+    size_t msgSize;
+    size_t bytesSent;
+    size_t maxBatch;
+    uint32_t ttl;
+    BatchTestStream() : msgSize(0), bytesSent(0), maxBatch(0), ttl(0) { }
+    virtual QStatus PushBytes(const void*, size_t numBytes, size_t& numSent) {
+        msgSize = numBytes;
+        numSent = numBytes;
+        bytesSent += numBytes;
+        return ER_OK;
+    }
+    virtual QStatus PushBytesV(const IOVec* iov, size_t numIov, size_t& numSent, uint32_t ttl) {
+        this->ttl = ttl;
+        msgSize = iov[0].len;
+        numSent = 0;
+        for (size_t i = 0; i < numIov; ++i) {
+            numSent += iov[i].len;
+        }
+        bytesSent += numSent;
+        maxBatch = (std::max)(maxBatch, numIov);
+        return ER_OK;
+    }
+};
+
+TEST_F(RemoteEndpointTest, TxCoalescesQueuedMessages)
+{
+    BatchTestStream bts;
+    s = &bts;
+    TestRemoteEndpoint trep(":test.3", bus, incoming, connectSpec, s);
+    EXPECT_EQ(ER_OK, trep->Start());
+
+    /*
+     * Nothing is written until the sink event is set so the queued messages are all written together.
+     */
+    const size_t numMessages = 4;
+    TestMessage tm(bus);
+    Message m = Message::cast(tm);
+    for (size_t i = 0; i < numMessages; ++i) {
+        EXPECT_EQ(ER_OK, trep->PushMessage(m));
+    }
+    bts.sinkEvent.SetEvent();
+    for (uint32_t waited = 0; ((bts.msgSize == 0) || (bts.bytesSent < numMessages * bts.msgSize)) && (waited < ENDPOINT_TEST_WAIT_TIME); waited += 10) {
+        qcc::Sleep(10);
+    }
+    EXPECT_NE(0U, bts.msgSize);
+    EXPECT_EQ(numMessages * bts.msgSize, bts.bytesSent);
+    EXPECT_EQ(numMessages, bts.maxBatch);
+
+    trep->Stop();
+    bts.sourceEvent.SetEvent();
+    EXPECT_EQ(ER_OK, trep->Join(ENDPOINT_TEST_JOIN_TIMEOUT));
+}
+
+TEST_F(RemoteEndpointTest, TxBatchCarriesTtl)
+{
+    BatchTestStream bts;
+    s = &bts;
+    TestRemoteEndpoint trep(":test.3", bus, incoming, connectSpec, s);
+    EXPECT_EQ(ER_OK, trep->Start());
+
+    const size_t numMessages = 4;
+    const uint16_t ttl = 60000;
+    TestMessage tm(bus, "sender", ttl);
+    Message m = Message::cast(tm);
+    for (size_t i = 0; i < numMessages; ++i) {
+        EXPECT_EQ(ER_OK, trep->PushMessage(m));
+    }
+    bts.sinkEvent.SetEvent();
+    for (uint32_t waited = 0; ((bts.msgSize == 0) || (bts.bytesSent < numMessages * bts.msgSize)) && (waited < ENDPOINT_TEST_WAIT_TIME); waited += 10) {
+        qcc::Sleep(10);
+    }
+    EXPECT_EQ(numMessages, bts.maxBatch);
+    EXPECT_EQ(ttl, bts.ttl);
+
+    trep->Stop();
+    bts.sourceEvent.SetEvent();
+    EXPECT_EQ(ER_OK, trep->Join(ENDPOINT_TEST_JOIN_TIMEOUT));
+}
+
+/* Records what is written so the messages can be checked in the order they went out */
+class OrderTestStream : public TestStream {
+  public:
+    Mutex lock;
+    vector<uint8_t> written;
+    size_t writes;
+    size_t maxPush;
+    OrderTestStream(size_t maxPush = 0) : writes(0), maxPush(maxPush) { }
+    virtual QStatus PushBytes(const void* buf, size_t numBytes, size_t& numSent) {
+        IOVec iov = { const_cast<void*>(buf), numBytes };
+        return PushBytesV(&iov, 1, numSent, 0);
+    }
+    /* Consumes at most maxPush bytes, if set, so batches are left partially written */
+    virtual QStatus PushBytesV(const IOVec* iov, size_t numIov, size_t& numSent, uint32_t) {
+        lock.Lock();
+        numSent = 0;
+        for (size_t i = 0; i < numIov; ++i) {
+            size_t len = maxPush ? (std::min)(iov[i].len, maxPush - numSent) : iov[i].len;
+            const uint8_t* bytes = static_cast<const uint8_t*>(iov[i].buf);
+            written.insert(written.end(), bytes, bytes + len);
+            numSent += len;
+        }
+        bool slow = ((++writes % 16) == 0);
+        lock.Unlock();
+        /* Now and then be slow so the tx queue fills and pushers also take the locked path */
+        if (slow) {
+            qcc::Sleep(1);
+        }
+        return ER_OK;
+    }
+    /* The uint32 argument of each complete message written so far */
+    vector<uint32_t> GetValues() {
+        vector<uint32_t> values;
+        lock.Lock();
+        size_t pos = 0;
+        while (pos + 16 <= written.size()) {
+            uint32_t bodyLen, fieldsLen, value;
+            memcpy(&bodyLen, &written[pos + 4], sizeof(bodyLen));
+            memcpy(&fieldsLen, &written[pos + 12], sizeof(fieldsLen));
+            size_t headerLen = (16 + fieldsLen + 7) & ~static_cast<size_t>(7);
+            if (pos + headerLen + bodyLen > written.size()) {
+                break;
+            }
+            memcpy(&value, &written[pos + headerLen], sizeof(value));
+            values.push_back(value);
+            pos += headerLen + bodyLen;
+        }
+        lock.Unlock();
+        return values;
+    }
+};
+
+static const uint32_t NUM_PUSHERS = 4;
+static const uint32_t PUSHES_PER_PUSHER = 1000;
+
+class PusherThread : public Thread {
+  public:
+    PusherThread(BusAttachment& bus, TestRemoteEndpoint& ep, uint32_t id) : Thread("Pusher"), bus(bus), ep(ep), id(id) { }
+
+  protected:
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        for (uint32_t i = 0; i < PUSHES_PER_PUSHER; ++i) {
+            uint32_t value = (id << 24) | i;
+            TestMessage tm(bus, value);
+            Message m = Message::cast(tm);
+            EXPECT_EQ(ER_OK, ep->PushMessage(m));
+        }
+        return 0;
+    }
+
+  private:
+    BusAttachment& bus;
+    TestRemoteEndpoint& ep;
+    uint32_t id;
+};
+
+TEST_F(RemoteEndpointTest, ConcurrentPushersKeepTheirOrder)
+{
+    OrderTestStream ots;
+    s = &ots;
+    TestRemoteEndpoint trep(":test.3", bus, incoming, connectSpec, s);
+    EXPECT_EQ(ER_OK, trep->Start());
+    ots.sinkEvent.SetEvent();
+
+    vector<PusherThread*> pushers;
+    for (uint32_t i = 0; i < NUM_PUSHERS; ++i) {
+        pushers.push_back(new PusherThread(bus, trep, i));
+        EXPECT_EQ(ER_OK, pushers.back()->Start());
+    }
+    for (uint32_t i = 0; i < NUM_PUSHERS; ++i) {
+        pushers[i]->Join();
+        delete pushers[i];
+    }
+    vector<uint32_t> values = ots.GetValues();
+    for (uint32_t waited = 0; (values.size() < NUM_PUSHERS * PUSHES_PER_PUSHER) && (waited < ENDPOINT_TEST_JOIN_TIMEOUT); waited += 10) {
+        qcc::Sleep(10);
+        values = ots.GetValues();
+    }
+
+    /* Each pusher's messages must go out in the order it pushed them */
+    ASSERT_EQ(NUM_PUSHERS * PUSHES_PER_PUSHER, values.size());
+    vector<uint32_t> next(NUM_PUSHERS, 0);
+    for (size_t i = 0; i < values.size(); ++i) {
+        uint32_t id = values[i] >> 24;
+        ASSERT_LT(id, NUM_PUSHERS);
+        EXPECT_EQ(next[id], values[i] & 0xFFFFFF);
+        next[id] = (values[i] & 0xFFFFFF) + 1;
+    }
+
+    trep->Stop();
+    ots.sourceEvent.SetEvent();
+    EXPECT_EQ(ER_OK, trep->Join(ENDPOINT_TEST_JOIN_TIMEOUT));
+}
+
+TEST_F(RemoteEndpointTest, PartiallyWrittenBatchesKeepTheirOrder)
+{
+    /* Less than two messages fit in a push so every batch is left partially written */
+    OrderTestStream ots(150);
+    s = &ots;
+    TestRemoteEndpoint trep(":test.3", bus, incoming, connectSpec, s);
+    EXPECT_EQ(ER_OK, trep->Start());
+
+    const uint32_t numMessages = 8;
+    for (uint32_t i = 0; i < numMessages; ++i) {
+        TestMessage tm(bus, i);
+        Message m = Message::cast(tm);
+        EXPECT_EQ(ER_OK, trep->PushMessage(m));
+    }
+    ots.sinkEvent.SetEvent();
+    vector<uint32_t> values = ots.GetValues();
+    for (uint32_t waited = 0; (values.size() < numMessages) && (waited < ENDPOINT_TEST_JOIN_TIMEOUT); waited += 10) {
+        qcc::Sleep(10);
+        values = ots.GetValues();
+    }
+
+    ASSERT_EQ(numMessages, values.size());
+    for (uint32_t i = 0; i < numMessages; ++i) {
+        EXPECT_EQ(i, values[i]);
+    }
+
+    trep->Stop();
+    ots.sourceEvent.SetEvent();
+    EXPECT_EQ(ER_OK, trep->Join(ENDPOINT_TEST_JOIN_TIMEOUT));
+}
+
 #ifdef ROUTER
 #include "DaemonRouter.h"
 
@@ -238,7 +473,9 @@ static ThreadReturn STDCALL PushMessages(void* arg)
     RemoteEndpointTest* thiz = reinterpret_cast<RemoteEndpointTest*>(arg);
     TestMessage tm(thiz->bus);
     Message m = Message::cast(tm);
-    EXPECT_EQ(ER_OK, thiz->rep->PushMessage(m));
+    for (size_t i = 0; i < _RemoteEndpoint::MAX_TX_DATA_MESSAGES; ++i) {
+        EXPECT_EQ(ER_OK, thiz->rep->PushMessage(m));
+    }
     EXPECT_EQ(ER_OK, thiz->rep->PushMessage(m)); /* This will block */
     return 0;
 }
@@ -253,7 +490,7 @@ TEST_F(RemoteEndpointTest, TxQueueIsFull)
     ts.sourceEvent.SetEvent();
     EXPECT_EQ(ER_OK, rep->Join(ENDPOINT_TEST_JOIN_TIMEOUT));
     EXPECT_EQ(ER_OK, pmThread.Join());
-    /* Test passes if both PushMessage() calls succeed. */
+    /* Test passes if all PushMessage() calls succeed. */
 }
 
 TEST_F(RemoteEndpointTest, CreateDestroy)
@@ -15,6 +15,14 @@
  ******************************************************************************/
 #include <qcc/platform.h>
 
+#include <algorithm>
+
+#include <qcc/Event.h>
+#include <qcc/Metrics.h>
+#include <qcc/Mutex.h>
+#include <qcc/StringUtil.h>
+#include <qcc/Thread.h>
+
 #include "AllJoynObj.h"
 #include "ConfigDB.h"
 #include "SessionInternal.h"
@@ -372,3 +380,183 @@ TEST(AllJoynObjTest, JoinSessionTriesAllAvailableTransportsAfterAttachSessionFai
     EXPECT_EQ(TRANSPORT_UDP | TRANSPORT_TCP, ajObj.triedTransports);
     EXPECT_EQ(TRANSPORT_TCP, ajObj.connectedTransport);
 }
+
+/*
+ * JoinSessionExecutor
+ */
+
+/* What the requests run by a JoinSessionExecutor saw */
+struct ExecutorLog {
+    ExecutorLog() : running(0), maxRunning(0), overlapped(false), completed(0) { }
+    Mutex lock;
+    uint32_t running;                       /* Requests running now */
+    uint32_t maxRunning;                    /* Most requests ever running at once */
+    map<String, uint32_t> runningByKey;     /* Requests running now for each key */
+    bool overlapped;                        /* True if two requests for one key ever ran at once */
+    map<String, vector<uint32_t> > order;   /* Sequence numbers of each key's requests in the order they ran */
+    uint32_t completed;                     /* Requests that have finished */
+};
+
+class ExecutorAllJoynObj : public TestAllJoynObj {
+  public:
+    typedef JoinSessionExecutor Executor;
+
+    ExecutorAllJoynObj(Bus& bus) : TestAllJoynObj(bus) { }
+
+    /* A request that records when it runs, then sleeps or waits for release to be set */
+    class Request : public JoinSessionThread {
+      public:
+        Request(ExecutorAllJoynObj& ajObj, ExecutorLog& log, const String& key, uint32_t seq, Event* release = NULL)
+            : JoinSessionThread(ajObj, Message(ajObj.bus), true), log(log), key(key), seq(seq), release(release) { }
+        virtual void Run(void) {
+            log.lock.Lock();
+            log.maxRunning = max(log.maxRunning, ++log.running);
+            if (++log.runningByKey[key] > 1) {
+                log.overlapped = true;
+            }
+            log.order[key].push_back(seq);
+            log.lock.Unlock();
+
+            if (release) {
+                Event::Wait(*release, 10000);
+            } else {
+                qcc::Sleep(5);
+            }
+
+            log.lock.Lock();
+            --log.running;
+            --log.runningByKey[key];
+            ++log.completed;
+            log.lock.Unlock();
+        }
+      private:
+        ExecutorLog& log;
+        String key;
+        uint32_t seq;
+        Event* release;
+    };
+
+    QStatus Submit(Executor& executor, ExecutorLog& log, const String& key, uint32_t seq, Event* release = NULL) {
+        return executor.Submit(key, Ptr<JoinSessionThread>(new Request(*this, log, key, seq, release)));
+    }
+};
+
+/* Wait until count requests have finished or started */
+static bool WaitFor(ExecutorLog& log, uint32_t count, bool started = false)
+{
+    for (uint32_t i = 0; i < 1000; ++i) {
+        log.lock.Lock();
+        uint32_t n = started ? (log.completed + log.running) : log.completed;
+        log.lock.Unlock();
+        if (n >= count) {
+            return true;
+        }
+        qcc::Sleep(10);
+    }
+    return false;
+}
+
+static void ExpectInOrder(ExecutorLog& log, const String& key, uint32_t count)
+{
+    vector<uint32_t>& order = log.order[key];
+    ASSERT_EQ(count, order.size());
+    for (uint32_t i = 0; i < count; ++i) {
+        EXPECT_EQ(i, order[i]);
+    }
+}
+
+TEST(AllJoynObjTest, JoinSessionExecutorRunsOneKeyInOrder)
+{
+    ConfigDB configDb("");
+    configDb.LoadConfig();
+
+    TransportFactoryContainer factories;
+    Bus bus("AllJoynObjTest", factories);
+    ExecutorAllJoynObj ajObj(bus);
+
+    ExecutorLog log;
+    ExecutorAllJoynObj::Executor executor("test.onekey", 4);
+    const uint32_t count = 20;
+    for (uint32_t i = 0; i < count; ++i) {
+        EXPECT_EQ(ER_OK, ajObj.Submit(executor, log, "key", i));
+    }
+    EXPECT_TRUE(WaitFor(log, count));
+    executor.Stop();
+    executor.Join();
+
+    // Verify that the requests for a key ran one at a time in the order they were submitted
+    ExpectInOrder(log, "key", count);
+    EXPECT_FALSE(log.overlapped);
+    EXPECT_EQ(1U, log.maxRunning);
+    EXPECT_EQ(0U, Metrics::GetCounter("session.test.onekey.active")->GetValue());
+    EXPECT_EQ(0U, Metrics::GetCounter("session.test.onekey.queued")->GetValue());
+}
+
+TEST(AllJoynObjTest, JoinSessionExecutorRunsManyKeysWithinConcurrency)
+{
+    ConfigDB configDb("");
+    configDb.LoadConfig();
+
+    TransportFactoryContainer factories;
+    Bus bus("AllJoynObjTest", factories);
+    ExecutorAllJoynObj ajObj(bus);
+
+    ExecutorLog log;
+    const uint32_t concurrency = 3;
+    ExecutorAllJoynObj::Executor executor("test.manykeys", concurrency);
+    const uint32_t keys = 8;
+    const uint32_t count = 10;
+    for (uint32_t i = 0; i < count; ++i) {
+        for (uint32_t k = 0; k < keys; ++k) {
+            EXPECT_EQ(ER_OK, ajObj.Submit(executor, log, U32ToString(k), i));
+        }
+    }
+    EXPECT_TRUE(WaitFor(log, keys * count));
+    executor.Stop();
+    executor.Join();
+
+    // Verify that each key kept its order and that no more than concurrency requests ran at once
+    for (uint32_t k = 0; k < keys; ++k) {
+        ExpectInOrder(log, U32ToString(k), count);
+    }
+    EXPECT_FALSE(log.overlapped);
+    EXPECT_LE(log.maxRunning, concurrency);
+    EXPECT_EQ(0U, Metrics::GetCounter("session.test.manykeys.active")->GetValue());
+    EXPECT_EQ(0U, Metrics::GetCounter("session.test.manykeys.queued")->GetValue());
+}
+
+TEST(AllJoynObjTest, JoinSessionExecutorStopDropsQueuedRequests)
+{
+    ConfigDB configDb("");
+    configDb.LoadConfig();
+
+    TransportFactoryContainer factories;
+    Bus bus("AllJoynObjTest", factories);
+    ExecutorAllJoynObj ajObj(bus);
+
+    ExecutorLog log;
+    ExecutorAllJoynObj::Executor executor("test.stop", 1);
+    MetricCounter* queued = Metrics::GetCounter("session.test.stop.queued");
+
+    // Hold the only thread with one request and queue others behind it, on its key and on another
+    Event release;
+    EXPECT_EQ(ER_OK, ajObj.Submit(executor, log, "key", 0, &release));
+    ASSERT_TRUE(WaitFor(log, 1, true));
+    EXPECT_EQ(ER_OK, ajObj.Submit(executor, log, "key", 1));
+    EXPECT_EQ(ER_OK, ajObj.Submit(executor, log, "key", 2));
+    EXPECT_EQ(ER_OK, ajObj.Submit(executor, log, "other", 0));
+    EXPECT_EQ(3U, queued->GetValue());
+
+    executor.Stop();
+    EXPECT_EQ(0U, queued->GetValue());
+    EXPECT_EQ(ER_THREADPOOL_STOPPING, ajObj.Submit(executor, log, "key", 3));
+    release.SetEvent();
+    executor.Join();
+
+    // Verify that only the request that was running ran
+    ExpectInOrder(log, "key", 1);
+    EXPECT_TRUE(log.order["other"].empty());
+    EXPECT_EQ(1U, log.completed);
+    EXPECT_EQ(0U, Metrics::GetCounter("session.test.stop.active")->GetValue());
+    EXPECT_EQ(0U, queued->GetValue());
+}
@@ -0,0 +1,444 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+
+#include <string.h>
+#include <map>
+#include <vector>
+
+#include <qcc/IPAddress.h>
+#include <qcc/Mutex.h>
+#include <qcc/Socket.h>
+#include <qcc/SocketTypes.h>
+#include <qcc/time.h>
+
+#include "ArdpProtocol.h"
+#include "UDPTransport.h"
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "../ajTestCommon.h"
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+/*
+ * These tests run ARDP traffic through several ARDP instances sharing one
+ * socket, set up the way UDPTransport does it when udp_ardp_shards is greater
+ * than one.  Inbound datagrams are routed with UDPTransport::ArdpShardIndex(),
+ * which UDPTransport::ArdpRun() uses.  Every callback checks that it comes
+ * from the instance that owns the connection, found through the handle
+ * context just like UDPTransport::ArdpLock() finds the lock of an instance.
+ */
+
+static const uint16_t SEGMAX = 50;
+static const uint16_t SEGBMAX = 65507;
+static const uint32_t STALL_TIMEOUT = 5000;
+
+static uint8_t connectData[] = "ArdpShardTest";
+static uint8_t payload[100];
+
+struct Shard {
+    Shard() : handle(NULL), wrongContext(0), disconnected(0) { }
+    ArdpHandle* handle;
+    Mutex lock;
+    uint32_t wrongContext;      /* Callbacks whose handle did not match the context */
+    uint32_t disconnected;      /* Connections that went down */
+    map<uint32_t, uint32_t> conns;  /* Connection ID to segments received */
+};
+
+struct Side {
+    Side() : sock(INVALID_SOCKET_FD), port(0), opened(0) { }
+    SocketFd sock;
+    IPAddress addr;
+    uint16_t port;
+    vector<Shard*> shards;
+    uint32_t opened;  /* Active connections that came up */
+};
+
+/* Look up the shard the way UDPTransport::ArdpLock() does and check it owns the handle */
+static Shard* GetShard(ArdpHandle* handle)
+{
+    Shard* shard = static_cast<Shard*>(ARDP_GetHandleContext(handle));
+    if (shard->handle != handle) {
+        ++shard->wrongContext;
+    }
+    return shard;
+}
+
+static bool AcceptCb(ArdpHandle* handle, IPAddress ipAddr, uint16_t ipPort, ArdpConnRecord* conn, uint8_t* buf, uint16_t len, QStatus status)
+{
+    QCC_UNUSED(ipAddr);
+    QCC_UNUSED(ipPort);
+    QCC_UNUSED(buf);
+    QCC_UNUSED(len);
+    QCC_UNUSED(status);
+    Shard* shard = GetShard(handle);
+    shard->conns[ARDP_GetConnId(handle, conn)] = 0;
+    return ARDP_Accept(handle, conn, SEGMAX, SEGBMAX, connectData, sizeof(connectData)) == ER_OK;
+}
+
+static void ConnectCb(ArdpHandle* handle, ArdpConnRecord* conn, bool passive, uint8_t* buf, uint16_t len, QStatus status)
+{
+    QCC_UNUSED(buf);
+    QCC_UNUSED(len);
+    Shard* shard = GetShard(handle);
+    if (!passive && (status == ER_OK)) {
+        shard->conns[ARDP_GetConnId(handle, conn)] = 0;
+        ++static_cast<Side*>(ARDP_GetConnContext(handle, conn))->opened;
+    }
+}
+
+static void DisconnectCb(ArdpHandle* handle, ArdpConnRecord* conn, QStatus status)
+{
+    QCC_UNUSED(status);
+    Shard* shard = GetShard(handle);
+    shard->conns.erase(ARDP_GetConnId(handle, conn));
+    ++shard->disconnected;
+}
+
+static void RecvCb(ArdpHandle* handle, ArdpConnRecord* conn, ArdpRcvBuf* rcv, QStatus status)
+{
+    QCC_UNUSED(status);
+    Shard* shard = GetShard(handle);
+    map<uint32_t, uint32_t>::iterator i = shard->conns.find(ARDP_GetConnId(handle, conn));
+    if (i != shard->conns.end()) {
+        ++i->second;
+    }
+    ARDP_RecvReady(handle, conn, rcv);
+}
+
+static void SendCb(ArdpHandle* handle, ArdpConnRecord* conn, uint8_t* buf, uint32_t len, QStatus status)
+{
+    QCC_UNUSED(conn);
+    QCC_UNUSED(buf);
+    QCC_UNUSED(len);
+    QCC_UNUSED(status);
+    GetShard(handle);
+}
+
+static void SendWindowCb(ArdpHandle* handle, ArdpConnRecord* conn, uint16_t window, QStatus status)
+{
+    QCC_UNUSED(conn);
+    QCC_UNUSED(window);
+    QCC_UNUSED(status);
+    GetShard(handle);
+}
+
+class ArdpShardTest : public testing::TestWithParam<uint32_t> {
+  public:
+    virtual void SetUp()
+    {
+        Open(server, true);
+        Open(client, false);
+    }
+
+    virtual void TearDown()
+    {
+        Close(client);
+        Close(server);
+    }
+
+    void Open(Side& side, bool passive)
+    {
+        ASSERT_EQ(ER_OK, Socket(QCC_AF_INET, QCC_SOCK_DGRAM, side.sock));
+        ASSERT_EQ(ER_OK, SetBlocking(side.sock, false));
+        ASSERT_EQ(ER_OK, Bind(side.sock, IPAddress("127.0.0.1"), 0));
+        ASSERT_EQ(ER_OK, GetLocalAddress(side.sock, side.addr, side.port));
+
+        ArdpGlobalConfig config;
+        memset(&config, 0, sizeof(config));
+        config.connectTimeout = 1000;
+        config.connectRetries = 10;
+        config.initialDataTimeout = 1000;
+        config.totalDataRetryTimeout = 5000;
+        config.minDataRetries = 5;
+        config.persistInterval = 1000;
+        config.totalAppTimeout = 30000;
+        config.linkTimeout = 30000;
+        config.keepaliveRetries = 5;
+        config.fastRetransmitAckCounter = 1;
+        config.delayedAckTimeout = 100;
+        config.timewait = 1000;
+        config.segbmax = SEGBMAX;
+        config.segmax = SEGMAX;
+
+        uint32_t numShards = GetParam();
+        for (uint32_t i = 0; i < numShards; ++i) {
+            Shard* shard = new Shard();
+            shard->handle = ARDP_AllocHandle(&config);
+            ARDP_SetHandleContext(shard->handle, shard);
+            ARDP_SetLocalPortPartition(shard->handle, i, numShards);
+            ARDP_SetAcceptCb(shard->handle, AcceptCb);
+            ARDP_SetConnectCb(shard->handle, ConnectCb);
+            ARDP_SetDisconnectCb(shard->handle, DisconnectCb);
+            ARDP_SetRecvCb(shard->handle, RecvCb);
+            ARDP_SetSendCb(shard->handle, SendCb);
+            ARDP_SetSendWindowCb(shard->handle, SendWindowCb);
+            if (passive) {
+                ASSERT_EQ(ER_OK, ARDP_StartPassive(shard->handle));
+            }
+            side.shards.push_back(shard);
+        }
+    }
+
+    void Close(Side& side)
+    {
+        for (size_t i = 0; i < side.shards.size(); ++i) {
+            EXPECT_EQ(0U, side.shards[i]->wrongContext);
+            ARDP_FreeHandle(side.shards[i]->handle);
+            delete side.shards[i];
+        }
+        side.shards.clear();
+        if (side.sock != INVALID_SOCKET_FD) {
+            qcc::Close(side.sock);
+        }
+    }
+
+    /* Read and dispatch everything pending on one side, as UDPTransport::ArdpRun() does */
+    void Run(Side& side)
+    {
+        uint8_t buf[65536];
+        size_t received;
+        IPAddress remoteAddr;
+        uint16_t remotePort;
+        uint32_t numShards = side.shards.size();
+        while (RecvFrom(side.sock, remoteAddr, remotePort, buf, sizeof(buf), received) == ER_OK && received) {
+            Shard* shard = side.shards[UDPTransport::ArdpShardIndex(buf, received, remotePort, numShards)];
+            shard->lock.Lock(MUTEX_CONTEXT);
+            ARDP_Deliver(shard->handle, side.sock, remoteAddr, remotePort, buf, received);
+            shard->lock.Unlock(MUTEX_CONTEXT);
+        }
+        for (size_t i = 0; i < side.shards.size(); ++i) {
+            uint32_t ms;
+            side.shards[i]->lock.Lock(MUTEX_CONTEXT);
+            ARDP_Run(side.shards[i]->handle, side.sock, false, true, &ms);
+            side.shards[i]->lock.Unlock(MUTEX_CONTEXT);
+        }
+    }
+
+    void Pump()
+    {
+        Run(server);
+        Run(client);
+    }
+
+    uint32_t ServerConnections()
+    {
+        uint32_t n = 0;
+        for (size_t i = 0; i < server.shards.size(); ++i) {
+            n += server.shards[i]->conns.size();
+        }
+        return n;
+    }
+
+    uint32_t Disconnected(Side& side)
+    {
+        uint32_t n = 0;
+        for (size_t i = 0; i < side.shards.size(); ++i) {
+            n += side.shards[i]->disconnected;
+        }
+        return n;
+    }
+
+    /* Open connections spread round-robin over the client instances, like UDPTransport::Connect() */
+    void Connect(uint32_t numConns, vector<ArdpConnRecord*>& conns, vector<Shard*>& owners)
+    {
+        uint32_t numShards = client.shards.size();
+        uint32_t opened = client.opened + numConns;
+        uint32_t accepted = ServerConnections() + numConns;
+        for (uint32_t i = 0; i < numConns; ++i) {
+            Shard* shard = client.shards[i % numShards];
+            ArdpConnRecord* conn;
+            ASSERT_EQ(ER_OK, ARDP_Connect(shard->handle, client.sock, server.addr, server.port, SEGMAX, SEGBMAX, &conn,
+                                          connectData, sizeof(connectData), &client));
+            conns.push_back(conn);
+            owners.push_back(shard);
+        }
+        uint64_t deadline = GetTimestamp64() + STALL_TIMEOUT;
+        while ((client.opened < opened || ServerConnections() < accepted) && GetTimestamp64() < deadline) {
+            Pump();
+        }
+        ASSERT_EQ(opened, client.opened);
+        ASSERT_EQ(accepted, ServerConnections());
+    }
+
+    /* Send one segment on each connection and wait for the server to receive them all */
+    void SendOnEach(vector<ArdpConnRecord*>& conns, vector<Shard*>& owners)
+    {
+        uint32_t expected = ServerSegments() + conns.size();
+        for (size_t i = 0; i < conns.size(); ++i) {
+            Shard* shard = owners[i];
+            shard->lock.Lock(MUTEX_CONTEXT);
+            EXPECT_EQ(ER_OK, ARDP_Send(shard->handle, conns[i], payload, sizeof(payload), 0));
+            shard->lock.Unlock(MUTEX_CONTEXT);
+        }
+        uint64_t deadline = GetTimestamp64() + STALL_TIMEOUT;
+        while (ServerSegments() < expected && GetTimestamp64() < deadline) {
+            Pump();
+        }
+        EXPECT_EQ(expected, ServerSegments());
+    }
+
+    uint32_t ServerSegments()
+    {
+        uint32_t n = 0;
+        for (size_t i = 0; i < server.shards.size(); ++i) {
+            for (map<uint32_t, uint32_t>::iterator j = server.shards[i]->conns.begin(); j != server.shards[i]->conns.end(); ++j) {
+                n += j->second;
+            }
+        }
+        return n;
+    }
+
+    Side server;
+    Side client;
+};
+
+TEST_P(ArdpShardTest, TrafficStaysOnOwningInstance)
+{
+    const uint32_t numShards = GetParam();
+    const uint32_t connsPerShard = 4;
+    const uint32_t sendsPerConn = 20;
+    const uint32_t numConns = numShards * connsPerShard;
+
+    /* Spread outbound connections round-robin, like UDPTransport::Connect() */
+    vector<ArdpConnRecord*> conns;
+    vector<Shard*> owners;
+    for (uint32_t i = 0; i < numConns; ++i) {
+        Shard* shard = client.shards[i % numShards];
+        ArdpConnRecord* conn;
+        ASSERT_EQ(ER_OK, ARDP_Connect(shard->handle, client.sock, server.addr, server.port, SEGMAX, SEGBMAX, &conn,
+                                      connectData, sizeof(connectData), &client));
+        conns.push_back(conn);
+        owners.push_back(shard);
+    }
+
+    uint64_t deadline = GetTimestamp64() + STALL_TIMEOUT;
+    while ((client.opened < numConns || ServerConnections() < numConns) && GetTimestamp64() < deadline) {
+        Pump();
+    }
+    ASSERT_EQ(numConns, client.opened);
+    ASSERT_EQ(numConns, ServerConnections());
+
+    /*
+     * Every instance owns a share of the connections on both sides: the ARDP
+     * ports of each client instance fall into its own partition, which (for a
+     * power of two instances) also decides the server instance that accepts
+     * the connection.
+     */
+    for (uint32_t i = 0; i < numShards; ++i) {
+        EXPECT_EQ(connsPerShard, client.shards[i]->conns.size());
+        EXPECT_EQ(connsPerShard, server.shards[i]->conns.size());
+    }
+
+    for (uint32_t n = 0; n < sendsPerConn; ++n) {
+        for (uint32_t i = 0; i < numConns; ++i) {
+            Shard* shard = owners[i];
+            shard->lock.Lock(MUTEX_CONTEXT);
+            EXPECT_EQ(ER_OK, ARDP_Send(shard->handle, conns[i], payload, sizeof(payload), 0));
+            shard->lock.Unlock(MUTEX_CONTEXT);
+        }
+        Pump();
+    }
+
+    deadline = GetTimestamp64() + STALL_TIMEOUT;
+    while (ServerSegments() < numConns * sendsPerConn && GetTimestamp64() < deadline) {
+        Pump();
+    }
+
+    /* Each connection received all of its data on the instance that accepted it */
+    for (uint32_t i = 0; i < numShards; ++i) {
+        Shard* shard = server.shards[i];
+        for (map<uint32_t, uint32_t>::iterator j = shard->conns.begin(); j != shard->conns.end(); ++j) {
+            EXPECT_EQ(sendsPerConn, j->second) << "instance " << i << " connection " << j->first;
+        }
+    }
+}
+
+/*
+ * Every datagram is matched to its connection by local and foreign port, and every API call
+ * validates the connection it is given.  Check that connections are found as they are added,
+ * that removed connections are no longer found and that the remaining and the replacement
+ * connections still get their own data.
+ */
+TEST_P(ArdpShardTest, ConnectionsAreFoundUntilRemoved)
+{
+    const uint32_t numConns = GetParam() * 8;
+
+    vector<ArdpConnRecord*> conns;
+    vector<Shard*> owners;
+    Connect(numConns, conns, owners);
+    SendOnEach(conns, owners);
+
+    /* A record pointer that was never handed out, or an ID that does not match, is rejected */
+    ArdpConnRecord* bogus = reinterpret_cast<ArdpConnRecord*>(&owners);
+    EXPECT_EQ(ER_ARDP_INVALID_CONNECTION, ARDP_Send(owners[0]->handle, bogus, payload, sizeof(payload), 0));
+    uint32_t connId = ARDP_GetConnId(owners[0]->handle, conns[0]);
+    EXPECT_EQ(ER_ARDP_INVALID_CONNECTION, ARDP_Disconnect(owners[0]->handle, conns[0], connId + 1));
+
+    /* Remove every other connection */
+    vector<ArdpConnRecord*> removed;
+    vector<Shard*> removedOwners;
+    vector<ArdpConnRecord*> kept;
+    vector<Shard*> keptOwners;
+    for (uint32_t i = 0; i < numConns; ++i) {
+        if (i & 1) {
+            Shard* shard = owners[i];
+            shard->lock.Lock(MUTEX_CONTEXT);
+            EXPECT_EQ(ER_OK, ARDP_Disconnect(shard->handle, conns[i], ARDP_GetConnId(shard->handle, conns[i])));
+            shard->lock.Unlock(MUTEX_CONTEXT);
+            removed.push_back(conns[i]);
+            removedOwners.push_back(shard);
+        } else {
+            kept.push_back(conns[i]);
+            keptOwners.push_back(owners[i]);
+        }
+    }
+    uint64_t deadline = GetTimestamp64() + STALL_TIMEOUT;
+    while ((Disconnected(client) < removed.size() || Disconnected(server) < removed.size()) && GetTimestamp64() < deadline) {
+        Pump();
+    }
+    ASSERT_EQ(removed.size(), Disconnected(client));
+    ASSERT_EQ(removed.size(), Disconnected(server));
+    EXPECT_EQ(kept.size(), ServerConnections());
+
+    /* The client deletes a record right after reporting its disconnect, so only the pointer is looked up */
+    for (size_t i = 0; i < removed.size(); ++i) {
+        EXPECT_EQ(ER_ARDP_INVALID_CONNECTION, ARDP_Send(removedOwners[i]->handle, removed[i], payload, sizeof(payload), 0));
+    }
+
+    SendOnEach(kept, keptOwners);
+
+    /* Replace the removed connections and check old and new connections keep their own data */
+    vector<ArdpConnRecord*> added;
+    vector<Shard*> addedOwners;
+    Connect(removed.size(), added, addedOwners);
+    kept.insert(kept.end(), added.begin(), added.end());
+    keptOwners.insert(keptOwners.end(), addedOwners.begin(), addedOwners.end());
+    SendOnEach(kept, keptOwners);
+
+    for (size_t i = 0; i < server.shards.size(); ++i) {
+        Shard* shard = server.shards[i];
+        for (map<uint32_t, uint32_t>::iterator j = shard->conns.begin(); j != shard->conns.end(); ++j) {
+            EXPECT_LE(1U, j->second) << "instance " << i << " connection " << j->first;
+            EXPECT_GE(3U, j->second) << "instance " << i << " connection " << j->first;
+        }
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(ArdpShards, ArdpShardTest, testing::Values(1U, 2U, 4U));
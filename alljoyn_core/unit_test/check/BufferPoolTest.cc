@@ -0,0 +1,143 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+
+#include <string.h>
+
+#include <qcc/Metrics.h>
+#include <qcc/PerfCounters.h>
+#include <qcc/Thread.h>
+
+#include "BufferPool.h"
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "../ajTestCommon.h"
+
+using namespace qcc;
+using namespace ajn;
+
+class BufferPoolTest : public testing::Test {
+  public:
+    BufferPoolTest() : bytesHeld(Metrics::GetCounter("bufferpool.bytes.held")) { }
+
+    virtual void SetUp() {
+        BufferPool::Trim();
+    }
+
+    uint32_t BytesHeld() {
+        return bytesHeld->GetValue();
+    }
+
+    MetricCounter* bytesHeld;
+};
+
+TEST_F(BufferPoolTest, FreedBuffersAreReused)
+{
+    void* buf = BufferPool::Alloc(1000);
+    ASSERT_TRUE(buf != NULL);
+    EXPECT_EQ(0U, (uintptr_t)buf & 7);
+    memset(buf, 0xa5, 1000);
+    BufferPool::Free(buf);
+    EXPECT_EQ(1024U, BytesHeld());
+
+    /* Any request in the same size class gets the cached buffer back */
+    uint32_t hits = s_PerfCounters[PERF_COUNTER_BUFFER_POOL_HIT];
+    void* again = BufferPool::Alloc(600);
+    EXPECT_EQ(buf, again);
+    EXPECT_EQ(hits + 1, s_PerfCounters[PERF_COUNTER_BUFFER_POOL_HIT]);
+    EXPECT_EQ(0U, BytesHeld());
+
+    /* A different size class does not */
+    void* other = BufferPool::Alloc(2000);
+    EXPECT_NE(buf, other);
+    BufferPool::Free(other);
+    BufferPool::Free(again);
+    EXPECT_EQ(1024U + 2048U, BytesHeld());
+
+    BufferPool::Trim();
+    EXPECT_EQ(0U, BytesHeld());
+}
+
+TEST_F(BufferPoolTest, LargeBuffersAreNotPooled)
+{
+    size_t size = 1024 * 1024;
+    uint8_t* buf = static_cast<uint8_t*>(BufferPool::Alloc(size));
+    ASSERT_TRUE(buf != NULL);
+    buf[0] = 1;
+    buf[size - 1] = 2;
+    BufferPool::Free(buf);
+    EXPECT_EQ(0U, BytesHeld());
+}
+
+TEST_F(BufferPoolTest, CacheIsBounded)
+{
+    const size_t count = 64;
+    void* bufs[count];
+    for (size_t i = 0; i < count; ++i) {
+        bufs[i] = BufferPool::Alloc(128 * 1024);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        BufferPool::Free(bufs[i]);
+    }
+    EXPECT_GT(BytesHeld(), 0U);
+    EXPECT_LT(BytesHeld(), count * 128 * 1024);
+    BufferPool::Trim();
+}
+
+class FreeThread : public Thread {
+  public:
+    FreeThread(void** bufs, size_t count) : Thread("Free"), bufs(bufs), count(count) { }
+
+  protected:
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        for (size_t i = 0; i < count; ++i) {
+            BufferPool::Free(bufs[i]);
+        }
+        return 0;
+    }
+
+  private:
+    void** bufs;
+    size_t count;
+};
+
+TEST_F(BufferPoolTest, BuffersFreedOnAnotherThreadAreReused)
+{
+    const size_t count = 1024;
+    void* bufs[count];
+    for (size_t i = 0; i < count; ++i) {
+        bufs[i] = BufferPool::Alloc(1000);
+    }
+    FreeThread freeThread(bufs, count);
+    ASSERT_EQ(ER_OK, freeThread.Start());
+    ASSERT_EQ(ER_OK, freeThread.Join());
+    EXPECT_EQ(count * 1024, BytesHeld());
+
+    /* Only what the freeing thread's cache kept for itself has to come from the heap */
+    uint32_t misses = s_PerfCounters[PERF_COUNTER_BUFFER_POOL_MISS];
+    for (size_t i = 0; i < count; ++i) {
+        bufs[i] = BufferPool::Alloc(1000);
+    }
+    EXPECT_LE(s_PerfCounters[PERF_COUNTER_BUFFER_POOL_MISS] - misses, count / 4);
+    for (size_t i = 0; i < count; ++i) {
+        BufferPool::Free(bufs[i]);
+    }
+    BufferPool::Trim();
+    EXPECT_EQ(0U, BytesHeld());
+}
@@ -0,0 +1,174 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+
+#include <vector>
+
+#include <qcc/StringUtil.h>
+#include <qcc/Thread.h>
+
+#include <alljoyn/DBusStd.h>
+
+#include "BusEndpoint.h"
+#include "NameTable.h"
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "../ajTestCommon.h"
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+namespace {
+
+class _NameTableTestEndpoint : public _BusEndpoint {
+  public:
+    _NameTableTestEndpoint(const String& name) : _BusEndpoint(ENDPOINT_TYPE_REMOTE), name(name) { }
+    const String& GetUniqueName() const { return name; }
+  private:
+    String name;
+};
+typedef ManagedObj<_NameTableTestEndpoint> NameTableTestEndpoint;
+
+static const uint32_t NUM_CHANGES = 2000;
+static const uint32_t NUM_FINDERS = 3;
+static const uint32_t NUM_CHURNED = 4;
+
+static String ChurnedUniqueName(uint32_t i) { return ":churn." + U32ToString(i); }
+static String ChurnedAlias(uint32_t i) { return "org.test.Churn" + U32ToString(i); }
+
+/*
+ * Adds and removes unique names and their aliases while the finders look them up.
+ */
+class ChangerThread : public Thread {
+  public:
+    ChangerThread(NameTable& names) : Thread("Changer"), names(names), failures(0) { }
+
+    uint32_t failures;
+
+  protected:
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        vector<BusEndpoint> eps;
+        for (uint32_t i = 0; i < NUM_CHURNED; ++i) {
+            String name = ChurnedUniqueName(i);
+            NameTableTestEndpoint ep(name);
+            eps.push_back(BusEndpoint::cast(ep));
+        }
+        for (uint32_t n = 0; n < NUM_CHANGES; ++n) {
+            uint32_t i = n % NUM_CHURNED;
+            uint32_t disposition = 0;
+            names.AddUniqueName(eps[i]);
+            if ((names.AddAlias(ChurnedAlias(i), ChurnedUniqueName(i), 0, disposition) != ER_OK) ||
+                (disposition != DBUS_REQUEST_NAME_REPLY_PRIMARY_OWNER)) {
+                ++failures;
+            }
+            names.RemoveUniqueName(ChurnedUniqueName(i));
+        }
+        return 0;
+    }
+
+  private:
+    NameTable& names;
+};
+
+/*
+ * Looks up names that never change, which must always be found, and names that are being
+ * changed, which must either be missing or resolve to their own endpoint.
+ */
+class FinderThread : public Thread {
+  public:
+    FinderThread(NameTable& names, BusEndpoint& stable, volatile bool& done) :
+        Thread("Finder"), names(names), stable(stable), done(done), lookups(0), failures(0) { }
+
+    uint32_t lookups;
+    uint32_t failures;
+
+  protected:
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        while (!done) {
+            if (names.FindEndpoint(":stable.1") != stable) {
+                ++failures;
+            }
+            if (names.FindEndpoint("org.test.Stable") != stable) {
+                ++failures;
+            }
+            for (uint32_t i = 0; i < NUM_CHURNED; ++i) {
+                BusEndpoint ep = names.FindEndpoint(ChurnedAlias(i));
+                if (ep->IsValid() && (ep->GetUniqueName() != ChurnedUniqueName(i))) {
+                    ++failures;
+                }
+                ep = names.FindEndpoint(ChurnedUniqueName(i));
+                if (ep->IsValid() && (ep->GetUniqueName() != ChurnedUniqueName(i))) {
+                    ++failures;
+                }
+            }
+            ++lookups;
+        }
+        return 0;
+    }
+
+  private:
+    NameTable& names;
+    BusEndpoint& stable;
+    volatile bool& done;
+};
+
+}
+
+TEST(NameTableTest, FindEndpointWhileNamesChange)
+{
+    NameTable names;
+    NameTableTestEndpoint stableEp(":stable.1");
+    BusEndpoint stable = BusEndpoint::cast(stableEp);
+    uint32_t disposition = 0;
+    names.AddUniqueName(stable);
+    ASSERT_EQ(ER_OK, names.AddAlias("org.test.Stable", ":stable.1", 0, disposition));
+    ASSERT_EQ((uint32_t)DBUS_REQUEST_NAME_REPLY_PRIMARY_OWNER, disposition);
+
+    volatile bool done = false;
+    vector<FinderThread*> finders;
+    for (uint32_t i = 0; i < NUM_FINDERS; ++i) {
+        finders.push_back(new FinderThread(names, stable, done));
+        EXPECT_EQ(ER_OK, finders.back()->Start());
+    }
+    ChangerThread changer(names);
+    EXPECT_EQ(ER_OK, changer.Start());
+    EXPECT_EQ(ER_OK, changer.Join());
+    done = true;
+
+    EXPECT_EQ(0U, changer.failures);
+    for (uint32_t i = 0; i < NUM_FINDERS; ++i) {
+        EXPECT_EQ(ER_OK, finders[i]->Join());
+        EXPECT_LT(0U, finders[i]->lookups);
+        EXPECT_EQ(0U, finders[i]->failures);
+        delete finders[i];
+    }
+
+    /* Every churned name was removed with its unique name */
+    for (uint32_t i = 0; i < NUM_CHURNED; ++i) {
+        EXPECT_FALSE(names.FindEndpoint(ChurnedAlias(i))->IsValid());
+        EXPECT_FALSE(names.FindEndpoint(ChurnedUniqueName(i))->IsValid());
+    }
+    EXPECT_TRUE(names.FindEndpoint("org.test.Stable") == stable);
+
+    names.RemoveUniqueName(":stable.1");
+    EXPECT_FALSE(names.FindEndpoint("org.test.Stable")->IsValid());
+}
@@ -0,0 +1,246 @@
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/platform.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <qcc/StringUtil.h>
+#include <qcc/Util.h>
+
+#include <alljoyn/BusAttachment.h>
+#include <alljoyn/Message.h>
+
+#include "BusEndpoint.h"
+#include "Rule.h"
+#include "RuleTable.h"
+
+/* Header files included for Google Test Framework */
+#include <gtest/gtest.h>
+#include "../ajTestCommon.h"
+
+using namespace std;
+using namespace qcc;
+using namespace ajn;
+
+namespace {
+
+class _RuleTableTestEndpoint : public _BusEndpoint {
+  public:
+    _RuleTableTestEndpoint(const String& name) : _BusEndpoint(ENDPOINT_TYPE_REMOTE), name(name) { }
+    const String& GetUniqueName() const { return name; }
+  private:
+    String name;
+};
+typedef ManagedObj<_RuleTableTestEndpoint> RuleTableTestEndpoint;
+
+class _RuleTableTestMessage : public _Message {
+  public:
+    _RuleTableTestMessage(BusAttachment& bus, const String& sender, const String& path, const String& iface, const String& member) :
+        _Message(bus)
+    {
+        SignalMsg("", sender, NULL, 0, path, iface, member, NULL, 0, 0, 0);
+    }
+};
+typedef ManagedObj<_RuleTableTestMessage> RuleTableTestMessage;
+
+class _ArgsTestMessage : public _Message {
+  public:
+    _ArgsTestMessage(BusAttachment& bus, MsgArg* args, size_t numArgs) : _Message(bus)
+    {
+        qcc::String sig = MsgArg::Signature(args, numArgs);
+        SignalMsg(sig, ":sender.1", NULL, 0, "/foo", "org.test.A", "Foo", args, numArgs, 0, 0);
+    }
+};
+typedef ManagedObj<_ArgsTestMessage> ArgsTestMessage;
+
+class RuleTableTest : public testing::Test {
+  public:
+    RuleTableTest() : bus("RuleTableTest") { }
+
+    virtual void SetUp() {
+        for (int i = 0; i < 4; ++i) {
+            String name = ":ep." + U32ToString(i);
+            RuleTableTestEndpoint ep(name);
+            eps.push_back(BusEndpoint::cast(ep));
+        }
+    }
+
+    virtual void TearDown() {
+        for (size_t i = 0; i < eps.size(); ++i) {
+            ruleTable.RemoveAllRules(eps[i]);
+        }
+    }
+
+    Message Signal(const char* sender, const char* path, const char* iface, const char* member) {
+        String s(sender), p(path), i(iface), m(member);
+        RuleTableTestMessage msg(bus, s, p, i, m);
+        return Message::cast(msg);
+    }
+
+    /* Endpoints returned by GetCandidateEndpoints() that pass OkToSend() */
+    vector<BusEndpoint> Receivers(const Message& msg) {
+        vector<BusEndpoint> candidates;
+        vector<BusEndpoint> receivers;
+        ruleTable.GetCandidateEndpoints(msg, candidates);
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            if (ruleTable.OkToSend(msg, candidates[i])) {
+                receivers.push_back(candidates[i]);
+            }
+        }
+        sort(receivers.begin(), receivers.end());
+        return receivers;
+    }
+
+    /* Endpoints that pass OkToSend() when every endpoint is checked */
+    vector<BusEndpoint> ReceiversFullScan(const Message& msg) {
+        vector<BusEndpoint> receivers;
+        for (size_t i = 0; i < eps.size(); ++i) {
+            if (ruleTable.OkToSend(msg, eps[i])) {
+                receivers.push_back(eps[i]);
+            }
+        }
+        sort(receivers.begin(), receivers.end());
+        return receivers;
+    }
+
+    BusAttachment bus;
+    RuleTable ruleTable;
+    vector<BusEndpoint> eps;
+};
+
+}
+
+TEST_F(RuleTableTest, CandidatesMatchFullScan)
+{
+    ruleTable.AddRule(eps[0], Rule("type='signal',interface='org.test.A',member='Foo'"));
+    ruleTable.AddRule(eps[1], Rule("type='signal',interface='org.test.A'"));
+    ruleTable.AddRule(eps[2], Rule("type='signal',path='/bar'"));
+    ruleTable.AddRule(eps[2], Rule("type='signal',sender=':sender.1'"));
+    ruleTable.AddRule(eps[3], Rule("type='signal'"));
+
+    const char* senders[] = { ":sender.1", ":sender.2" };
+    const char* paths[] = { "/foo", "/bar" };
+    const char* ifaces[] = { "org.test.A", "org.test.B" };
+    const char* members[] = { "Foo", "Bar" };
+    for (size_t s = 0; s < ArraySize(senders); ++s) {
+        for (size_t p = 0; p < ArraySize(paths); ++p) {
+            for (size_t i = 0; i < ArraySize(ifaces); ++i) {
+                for (size_t m = 0; m < ArraySize(members); ++m) {
+                    Message msg = Signal(senders[s], paths[p], ifaces[i], members[m]);
+                    EXPECT_EQ(ReceiversFullScan(msg), Receivers(msg)) << msg->Description().c_str();
+                }
+            }
+        }
+    }
+}
+
+TEST_F(RuleTableTest, CandidatesOnlyIncludeEndpointsWithPossibleMatch)
+{
+    ruleTable.AddRule(eps[0], Rule("type='signal',interface='org.test.A',member='Foo'"));
+    ruleTable.AddRule(eps[1], Rule("type='signal',interface='org.test.A',member='Bar'"));
+
+    vector<BusEndpoint> candidates;
+    ruleTable.GetCandidateEndpoints(Signal(":sender.1", "/foo", "org.test.A", "Foo"), candidates);
+    ASSERT_EQ(1U, candidates.size());
+    EXPECT_TRUE(candidates[0] == eps[0]);
+
+    ruleTable.GetCandidateEndpoints(Signal(":sender.1", "/foo", "org.test.A", "Baz"), candidates);
+    EXPECT_TRUE(candidates.empty());
+}
+
+TEST_F(RuleTableTest, RemovedRulesAreRemovedFromIndex)
+{
+    Rule foo("type='signal',interface='org.test.A',member='Foo'");
+    Rule any("type='signal'");
+    ruleTable.AddRule(eps[0], foo);
+    ruleTable.AddRule(eps[0], foo);
+    ruleTable.AddRule(eps[1], any);
+    Message msg = Signal(":sender.1", "/foo", "org.test.A", "Foo");
+
+    vector<BusEndpoint> candidates;
+    ruleTable.GetCandidateEndpoints(msg, candidates);
+    EXPECT_EQ(2U, candidates.size());
+
+    /* The endpoint stays a candidate until its last matching rule is removed */
+    EXPECT_EQ(ER_OK, ruleTable.RemoveRule(eps[0], foo));
+    ruleTable.GetCandidateEndpoints(msg, candidates);
+    EXPECT_EQ(2U, candidates.size());
+    EXPECT_EQ(ER_OK, ruleTable.RemoveRule(eps[0], foo));
+    ruleTable.GetCandidateEndpoints(msg, candidates);
+    ASSERT_EQ(1U, candidates.size());
+    EXPECT_TRUE(candidates[0] == eps[1]);
+
+    EXPECT_EQ(ER_OK, ruleTable.RemoveAllRules(eps[1]));
+    ruleTable.GetCandidateEndpoints(msg, candidates);
+    EXPECT_TRUE(candidates.empty());
+}
+
+TEST_F(RuleTableTest, RuleSetSnapshotsAreImmutable)
+{
+    Rule foo("type='signal',interface='org.test.A',member='Foo'");
+    Rule bar("type='signal',interface='org.test.A',member='Bar'");
+    ruleTable.AddRule(eps[0], foo);
+    RuleSetRef snapshot = ruleTable.GetRules(eps[0]);
+    ASSERT_EQ(1U, snapshot->size());
+
+    /* Changes publish a new rule set and leave the snapshot alone */
+    ruleTable.AddRule(eps[0], bar);
+    EXPECT_EQ(1U, snapshot->size());
+    EXPECT_EQ(2U, ruleTable.GetRules(eps[0])->size());
+
+    EXPECT_EQ(ER_OK, ruleTable.RemoveAllRules(eps[0]));
+    EXPECT_TRUE(ruleTable.GetRules(eps[0])->empty());
+    ASSERT_EQ(1U, snapshot->size());
+    EXPECT_TRUE((*snapshot)[0] == foo);
+    EXPECT_FALSE(ruleTable.OkToSend(Signal(":sender.1", "/foo", "org.test.A", "Foo"), eps[0]));
+    EXPECT_EQ(ER_BUS_MATCH_RULE_NOT_FOUND, ruleTable.RemoveRule(eps[0], foo));
+}
+
+TEST_F(RuleTableTest, ArgMatchRules)
+{
+    /* Message arguments can only be unmarshalled on a started bus */
+    ASSERT_EQ(ER_OK, bus.Start());
+
+    MsgArg args[3];
+    args[0].Set("s", "zero");
+    args[1].Set("u", 1);
+    args[2].Set("s", "two");
+    MsgArg* argList = args;
+    size_t numArgs = ArraySize(args);
+    ArgsTestMessage argsMsg(bus, argList, numArgs);
+    Message msg = Message::cast(argsMsg);
+
+    EXPECT_TRUE(Rule("type='signal',arg0='zero'").IsMatch(msg));
+    EXPECT_TRUE(Rule("type='signal',arg0='zero',arg2='two'").IsMatch(msg));
+    EXPECT_FALSE(Rule("type='signal',arg0='two'").IsMatch(msg));
+    EXPECT_FALSE(Rule("type='signal',arg2='zero'").IsMatch(msg));
+
+    /* Non-string and missing arguments never match */
+    EXPECT_FALSE(Rule("type='signal',arg1='1'").IsMatch(msg));
+    EXPECT_FALSE(Rule("type='signal',arg3=''").IsMatch(msg));
+
+    /* Results do not change when the rules share the parsed arguments */
+    MatchArgs matchArgs;
+    EXPECT_TRUE(Rule("type='signal',arg0='zero'").IsMatch(msg, nullptr, &matchArgs));
+    EXPECT_TRUE(matchArgs.parsed);
+    EXPECT_TRUE(Rule("type='signal',arg2='two'").IsMatch(msg, nullptr, &matchArgs));
+    EXPECT_FALSE(Rule("type='signal',arg2='tw'").IsMatch(msg, nullptr, &matchArgs));
+    EXPECT_FALSE(Rule("type='signal',arg1='1'").IsMatch(msg, nullptr, &matchArgs));
+
+    bus.Stop();
+    bus.Join();
+}
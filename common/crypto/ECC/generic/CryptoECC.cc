@@ -178,7 +178,6 @@ static verify_res_t ECDSA_verify_inner(bigval_t const* msgdgst,
     ecpoint_t Q;
     ecpoint_t P1;
     ecpoint_t P2;
-    ecpoint_t G;
     ecpoint_t X;
     ec_t curve;
 
@@ -192,8 +191,6 @@ static verify_res_t ECDSA_verify_inner(bigval_t const* msgdgst,
         goto Exit;
     }
 
-    ec_get_generator(&G, &curve);
-
     status = bigval_to_digit256(&(pubkey->x), Q.x);
     status = status && bigval_to_digit256(&(pubkey->y), Q.y);
     status = status && ecpoint_validation(&Q, &curve);
@@ -232,8 +229,9 @@ static verify_res_t ECDSA_verify_inner(bigval_t const* msgdgst,
         goto Exit;
     }
 
-    ec_scalarmul(&(curve.generator), digU1, &P1, &curve);
-    ec_scalarmul(&Q, digU2, &P2, &curve);
+    ec_scalarmul_fixedbase(ec_get_generator_table(&curve), digU1, &P1, &curve);
+    /* Signatures are mostly checked against a few keys, e.g., those of certificate authorities */
+    ec_scalarmul_cached(&Q, digU2, &P2, &curve);
 
     // copy P1 to X
     fpcopy_p256(P1.x, X.x);
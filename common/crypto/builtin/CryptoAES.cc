@@ -29,11 +29,30 @@
 #include <qcc/String.h>
 #include <qcc/StringUtil.h>
 #include <qcc/Crypto.h>
+#include <qcc/Environ.h>
 #include <qcc/KeyBlob.h>
 #include <qcc/Util.h>
 
 #include <Status.h>
 
+/*
+ * On x86 CPUs with the AES instructions CCM is done with AES-NI, the table
+ * implementation below is the fallback.  The instructions are enabled per
+ * function so the rest of the library does not require them.
+ */
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CRYPTO_AESNI
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define AESNI_TARGET
+#else
+#include <cpuid.h>
+#define AESNI_TARGET __attribute__((target("sse2,aes")))
+#endif
+#endif
+
 using namespace std;
 using namespace qcc;
 
@@ -59,6 +78,7 @@ const int MAX_SCHEDULE_LEN = 48;
 
 struct Crypto_AES::KeyState {
     uint32_t fkey[MAX_SCHEDULE_LEN];
+    bool aesni;     /* Use AES-NI for CCM */
 };
 
 #define ROTL8(x)  ((((uint32_t)(x)) << 8)  | (((uint32_t)(x)) >> 24))
@@ -277,6 +297,113 @@ static void AJ_AES_ECB_128_ENCRYPT(const uint32_t* fkey, const uint8_t* in, uint
     Unpack32(out, out32);
 }
 
+#ifdef CRYPTO_AESNI
+
+/*
+ * Setting the environment variable ER_CRYPTO_AESNI to 0 selects the table
+ * implementation even if the CPU has the AES instructions.
+ */
+static bool DetectAesNi()
+{
+    if (Environ::GetAppEnviron()->Find("ER_CRYPTO_AESNI", "1") == "0") {
+        return false;
+    }
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 25)) != 0;
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return (ecx & bit_AES) != 0;
+#endif
+}
+
+static bool UseAesNi()
+{
+    static const bool useAesNi = DetectAesNi();
+    return useAesNi;
+}
+
+/*
+ * On little endian CPUs the table key schedule is byte for byte the AES round keys
+ */
+static AESNI_TARGET void AesNiLoadKey(const uint32_t* fkey, __m128i* rk)
+{
+    for (int i = 0; i < 11; ++i) {
+        rk[i] = _mm_loadu_si128((const __m128i*)(fkey + 4 * i));
+    }
+}
+
+static inline AESNI_TARGET __m128i AesNiEncrypt(__m128i b, const __m128i* rk)
+{
+    b = _mm_xor_si128(b, rk[0]);
+    for (int i = 1; i < 10; ++i) {
+        b = _mm_aesenc_si128(b, rk[i]);
+    }
+    return _mm_aesenclast_si128(b, rk[10]);
+}
+
+/*
+ * Encrypts two independent blocks with their rounds interleaved so one block's
+ * rounds run while the other's are still in the pipeline.
+ */
+static inline AESNI_TARGET void AesNiEncrypt2(__m128i& a, __m128i& b, const __m128i* rk)
+{
+    a = _mm_xor_si128(a, rk[0]);
+    b = _mm_xor_si128(b, rk[0]);
+    for (int i = 1; i < 10; ++i) {
+        a = _mm_aesenc_si128(a, rk[i]);
+        b = _mm_aesenc_si128(b, rk[i]);
+    }
+    a = _mm_aesenclast_si128(a, rk[10]);
+    b = _mm_aesenclast_si128(b, rk[10]);
+}
+
+/*
+ * Returns the current counter block and increments the counter, which like in
+ * AJ_AES_CTR_128 is the big-endian last 32 bits of the block.
+ */
+static inline AESNI_TARGET __m128i AesNiNextCounter(uint8_t* ctr)
+{
+    __m128i block = _mm_loadu_si128((const __m128i*)ctr);
+    uint32_t counter;
+    memcpy(&counter, ctr + 12, sizeof(counter));
+    counter = htobe32(1 + betoh32(counter));
+    memcpy(ctr + 12, &counter, sizeof(counter));
+    return block;
+}
+
+/*
+ * CBC-MAC with AES-NI, used for the CCM B_0 and additional data blocks
+ */
+class AesNiCBCMAC {
+  public:
+    AESNI_TARGET AesNiCBCMAC(const __m128i* rk) : rk(rk), T(_mm_setzero_si128()) { }
+
+    AESNI_TARGET void Update(const uint8_t* block)
+    {
+        T = AesNiEncrypt(_mm_xor_si128(T, _mm_loadu_si128((const __m128i*)block)), rk);
+    }
+
+    const __m128i* rk;
+    __m128i T;
+};
+
+#else
+
+static bool UseAesNi()
+{
+    return false;
+}
+
+#endif
+
+/* Cleared by tests to check the table implementation on CPUs with AES-NI */
+static bool hardwareCCM = true;
+
 Crypto_AES::Crypto_AES(const KeyBlob& key, Mode mode) : mode(mode), keyState(new KeyState())
 {
     const int rounds = 10;
@@ -290,6 +417,7 @@ Crypto_AES::Crypto_AES(const KeyBlob& key, Mode mode) : mode(mode), keyState(new
         fkey[6] = fkey[2] ^ fkey[5];
         fkey[7] = fkey[3] ^ fkey[6];
     }
+    keyState->aesni = hardwareCCM && UseAesNi();
 }
 
 Crypto_AES::~Crypto_AES()
@@ -298,6 +426,13 @@ Crypto_AES::~Crypto_AES()
     delete keyState;
 }
 
+bool Crypto_AES::EnableHardwareCCM(bool enable)
+{
+    bool previous = hardwareCCM;
+    hardwareCCM = enable;
+    return previous;
+}
+
 QStatus Crypto_AES::Encrypt(const Block* in, Block* out, uint32_t numBlocks)
 {
     /*
@@ -346,7 +481,31 @@ QStatus Crypto_AES::Encrypt(const void* in, size_t len, Block* out, uint32_t num
     return status;
 }
 
-static void Compute_CCM_AuthField(const uint32_t* fkey, Crypto_AES::Block& T, uint8_t M, uint8_t L, const KeyBlob& nonce, const uint8_t* mData, size_t mLen, const uint8_t* addData, size_t addLen)
+/*
+ * CBC-MAC with the table implementation
+ */
+class TableCBCMAC {
+  public:
+    TableCBCMAC(const uint32_t* fkey, Crypto_AES::Block& T) : fkey(fkey), T(T), ivec(0) { }
+
+    void Update(const uint8_t* block)
+    {
+        AJ_AES_CBC_128_ENCRYPT(fkey, block, T.data, sizeof(T.data), ivec.data);
+        Trace("After AES:  ", T.data, sizeof(T.data));
+    }
+
+  private:
+    const uint32_t* fkey;
+    Crypto_AES::Block& T;
+    Crypto_AES::Block ivec;
+};
+
+/*
+ * Feeds the CCM B_0 block, which encodes the flags, the nonce and the data
+ * length, and the additional data to a CBC-MAC.
+ */
+template <class MAC>
+static void Compute_CCM_AuthPrefix(MAC& mac, uint8_t M, uint8_t L, const KeyBlob& nonce, size_t mLen, const uint8_t* addData, size_t addLen)
 {
     uint8_t flags = ((addLen) ? 0x40 : 0) | (((M - 2) / 2) << 3) | (L - 1);
     /*
@@ -363,10 +522,8 @@ static void Compute_CCM_AuthField(const uint32_t* fkey, Crypto_AES::Block& T, ui
     /*
      * Initialize CBC-MAC with B_0 initialization vector is 0.
      */
-    Crypto_AES::Block ivec(0);
     Trace("CBC IV in: ", B_0.data, sizeof(B_0.data));
-    AJ_AES_CBC_128_ENCRYPT(fkey, B_0.data, T.data, sizeof(T.data), ivec.data);
-    Trace("CBC IV out:", T.data, sizeof(T.data));
+    mac.Update(B_0.data);
     /*
      * Compute CBC-MAC for the add data.
      */
@@ -397,29 +554,31 @@ static void Compute_CCM_AuthField(const uint32_t* fkey, Crypto_AES::Block& T, ui
         /*
          * Continue computing the CBC-MAC
          */
-        AJ_AES_CBC_128_ENCRYPT(fkey, A.data, T.data, sizeof(T.data), ivec.data);
-        Trace("After AES 1: ", T.data, sizeof(T.data));
+        mac.Update(A.data);
         while (addLen >= sizeof(Crypto_AES::Block)) {
-            AJ_AES_CBC_128_ENCRYPT(fkey, addData, T.data, sizeof(T.data), ivec.data);
-            Trace("After AES 2: ", T.data, sizeof(T.data));
+            mac.Update(addData);
             addData += sizeof(Crypto_AES::Block);
             addLen -= sizeof(Crypto_AES::Block);
         }
         if (addLen) {
             memcpy(A.data, addData, addLen);
             A.Pad(16 - addLen);
-            AJ_AES_CBC_128_ENCRYPT(fkey, A.data, T.data, sizeof(T.data), ivec.data);
-            Trace("After AES 3: ", T.data, sizeof(T.data));
+            mac.Update(A.data);
         }
 
     }
+}
+
+static void Compute_CCM_AuthField(const uint32_t* fkey, Crypto_AES::Block& T, uint8_t M, uint8_t L, const KeyBlob& nonce, const uint8_t* mData, size_t mLen, const uint8_t* addData, size_t addLen)
+{
+    TableCBCMAC mac(fkey, T);
+    Compute_CCM_AuthPrefix(mac, M, L, nonce, mLen, addData, addLen);
     /*
      * Continue computing CBC-MAC over the message data.
      */
     if (mLen) {
         while (mLen >= sizeof(Crypto_AES::Block)) {
-            AJ_AES_CBC_128_ENCRYPT(fkey, mData, T.data, sizeof(T.data), ivec.data);
-            Trace("After AES 4: ", T.data, sizeof(T.data));
+            mac.Update(mData);
             mData += sizeof(Crypto_AES::Block);
             mLen -= sizeof(Crypto_AES::Block);
         }
@@ -427,13 +586,64 @@ static void Compute_CCM_AuthField(const uint32_t* fkey, Crypto_AES::Block& T, ui
             Crypto_AES::Block final;
             memcpy(final.data, mData, mLen);
             final.Pad(16 - mLen);
-            AJ_AES_CBC_128_ENCRYPT(fkey, final.data, T.data, sizeof(T.data), ivec.data);
-            Trace("After AES 5: ", T.data, sizeof(T.data));
+            mac.Update(final.data);
         }
     }
     Trace("CBC-MAC:   ", T.data, M);
 }
 
+#ifdef CRYPTO_AESNI
+/*
+ * AES-CCM with AES-NI.  Each message block goes through the CBC-MAC and is
+ * encrypted or decrypted in CTR mode with the two AES operations interleaved.
+ * When decrypting, the key stream for the next block is computed with the
+ * CBC-MAC of the current one since the CBC-MAC needs the plain text.
+ *
+ * Returns the encrypted authentication field in U.
+ */
+static AESNI_TARGET void Compute_CCM_AesNi(const uint32_t* fkey, bool encrypt, uint8_t M, uint8_t L, const KeyBlob& nonce, const uint8_t* in, uint8_t* out, size_t len, const uint8_t* addData, size_t addLen, Crypto_AES::Block& U)
+{
+    __m128i rk[11];
+    AesNiLoadKey(fkey, rk);
+    AesNiCBCMAC mac(rk);
+    Compute_CCM_AuthPrefix(mac, M, L, nonce, len, addData, addLen);
+    __m128i T = mac.T;
+
+    Crypto_AES::Block ctr(0);
+    ctr.data[0] = (L - 1);
+    memcpy(&ctr.data[1], nonce.GetData(), nonce.GetSize());
+    /* The first key stream block encrypts the authentication field */
+    __m128i S_0 = AesNiEncrypt(AesNiNextCounter(ctr.data), rk);
+    __m128i S = encrypt ? _mm_setzero_si128() : AesNiEncrypt(AesNiNextCounter(ctr.data), rk);
+
+    while (len) {
+        Crypto_AES::Block block(0);
+        size_t n = min(len, sizeof(block.data));
+        memcpy(block.data, in, n);
+        __m128i x = _mm_loadu_si128((const __m128i*)block.data);
+        __m128i C = AesNiNextCounter(ctr.data);
+        if (encrypt) {
+            T = _mm_xor_si128(T, x);
+            AesNiEncrypt2(T, C, rk);
+            _mm_storeu_si128((__m128i*)block.data, _mm_xor_si128(x, C));
+        } else {
+            _mm_storeu_si128((__m128i*)block.data, _mm_xor_si128(x, S));
+            /* The CBC-MAC of a partial final block is over the zero padded plain text */
+            memset(block.data + n, 0, sizeof(block.data) - n);
+            T = _mm_xor_si128(T, _mm_loadu_si128((const __m128i*)block.data));
+            AesNiEncrypt2(T, C, rk);
+            S = C;
+        }
+        memcpy(out, block.data, n);
+        in += n;
+        out += n;
+        len -= n;
+    }
+    _mm_storeu_si128((__m128i*)U.data, _mm_xor_si128(T, S_0));
+    ClearMemory(rk, sizeof(rk));
+}
+#endif
+
 static uint8_t LengthOctetsFor(size_t len)
 {
     if (len <= 0xFFFF) {
@@ -473,6 +683,15 @@ QStatus Crypto_AES::Encrypt_CCM(const void* in, void* out, size_t& len, const Ke
     if (L < LengthOctetsFor(len)) {
         return ER_BAD_ARG_3;
     }
+#ifdef CRYPTO_AESNI
+    if (keyState->aesni) {
+        Block U;
+        Compute_CCM_AesNi(keyState->fkey, true, authLen, L, nonce, (const uint8_t*)in, (uint8_t*)out, len, (const uint8_t*)addData, addLen, U);
+        memcpy((uint8_t*)out + len, U.data, authLen);
+        len += authLen;
+        return ER_OK;
+    }
+#endif
     /*
      * Compute the authentication field T.
      */
@@ -523,31 +742,42 @@ QStatus Crypto_AES::Decrypt_CCM(const void* in, void* out, size_t& len, const Ke
     if (L < LengthOctetsFor(len)) {
         return ER_BAD_ARG_3;
     }
-    /*
-     * Initialize ivec and other initial args.
-     */
-    Block ivec(0);
-    ivec.data[0] = (L - 1);
-    memcpy(&ivec.data[1], nonce.GetData(), nLen);
-    Block ecount_buf(0);
-    /*
-     * Decrypt the authentication field
-     */
-    Block U;
-    Block T;
-    len = len - authLen;
-    memcpy(U.data, (const uint8_t*)in + len, authLen);
-    AJ_AES_CTR_128(keyState->fkey, U.data, T.data, sizeof(T.data), ivec.data);
-    /*
-     * Decrypt message.
-     */
-    AJ_AES_CTR_128(keyState->fkey, (const uint8_t*)in, (uint8_t*)out, len, ivec.data);
-    /*
-     * Compute and verify the authentication field T.
-     */
-    Block F;
-    Compute_CCM_AuthField(keyState->fkey, F, authLen, L, nonce, (uint8_t*)out, len, (uint8_t*)addData, addLen);
-    if (Crypto_Compare(F.data, T.data, authLen) == 0) {
+    bool authentic;
+#ifdef CRYPTO_AESNI
+    if (keyState->aesni) {
+        Block F;
+        len = len - authLen;
+        Compute_CCM_AesNi(keyState->fkey, false, authLen, L, nonce, (const uint8_t*)in, (uint8_t*)out, len, (const uint8_t*)addData, addLen, F);
+        authentic = (Crypto_Compare(F.data, (const uint8_t*)in + len, authLen) == 0);
+    } else
+#endif
+    {
+        /*
+         * Initialize ivec and other initial args.
+         */
+        Block ivec(0);
+        ivec.data[0] = (L - 1);
+        memcpy(&ivec.data[1], nonce.GetData(), nLen);
+        /*
+         * Decrypt the authentication field
+         */
+        Block U;
+        Block T;
+        len = len - authLen;
+        memcpy(U.data, (const uint8_t*)in + len, authLen);
+        AJ_AES_CTR_128(keyState->fkey, U.data, T.data, sizeof(T.data), ivec.data);
+        /*
+         * Decrypt message.
+         */
+        AJ_AES_CTR_128(keyState->fkey, (const uint8_t*)in, (uint8_t*)out, len, ivec.data);
+        /*
+         * Compute and verify the authentication field T.
+         */
+        Block F;
+        Compute_CCM_AuthField(keyState->fkey, F, authLen, L, nonce, (uint8_t*)out, len, (uint8_t*)addData, addLen);
+        authentic = (Crypto_Compare(F.data, T.data, authLen) == 0);
+    }
+    if (authentic) {
         return ER_OK;
     } else {
         /* Clear the decrypted data */
@@ -25,10 +25,28 @@
 #include <qcc/platform.h>
 #include <qcc/Debug.h>
 #include <qcc/Crypto.h>
+#include <qcc/Environ.h>
 #include <qcc/Util.h>
 
 #include <Status.h>
 
+/*
+ * On x86 CPUs with the SHA extensions the SHA-256 compression function is done
+ * with SHA-NI, the portable transform in sha2.c is the fallback.  As for AES-NI
+ * the instructions are enabled per function.
+ */
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CRYPTO_SHANI
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SHANI_TARGET
+#else
+#include <cpuid.h>
+#define SHANI_TARGET __attribute__((target("sse4.1,sha")))
+#endif
+#endif
+
 using namespace std;
 using namespace qcc;
 
@@ -44,6 +62,9 @@ namespace qcc {
  * __cplusplus is manipulated to skip 'extern "C"' in the included files.
  */
 #undef __cplusplus
+#ifdef CRYPTO_SHANI
+#define SHA256_PORTABLE_TRANSFORM
+#endif
 #include "sha1.c"
 #include "hmac_sha1.c"
 #include "sha2.c"
@@ -52,6 +73,93 @@ namespace qcc {
  */
 #define __cplusplus
 
+#ifdef CRYPTO_SHANI
+
+static bool DetectShaNi()
+{
+    if (Environ::GetAppEnviron()->Find("ER_CRYPTO_SHANI", "1") == "0") {
+        return false;
+    }
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool sse41 = (info[2] & (1 << 19)) != 0;
+    __cpuidex(info, 7, 0);
+    return sse41 && ((info[1] & (1 << 29)) != 0);
+#else
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0, NULL) < 7) {
+        return false;
+    }
+    __cpuid(1, eax, ebx, ecx, edx);
+    bool sse41 = (ecx & bit_SSE4_1) != 0;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return sse41 && ((ebx & (1 << 29)) != 0);
+#endif
+}
+
+static bool UseShaNi()
+{
+    static const bool useShaNi = DetectShaNi();
+    return useShaNi;
+}
+
+/*
+ * One SHA-256 compression with the SHA instructions.  The instructions keep
+ * the state as ABEF and CDGH and do two rounds at a time, the message
+ * schedule for the next four rounds is computed while the current ones run.
+ */
+static SHANI_TARGET void ShaNiTransform(sha2_word32* state, const sha2_byte* data)
+{
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[0]), 0xB1);
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[4]), 0x1B);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+    const __m128i abefStart = state0;
+    const __m128i cdghStart = state1;
+
+    __m128i w[4];
+    for (int i = 0; i < 4; ++i) {
+        w[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16 * i)), byteSwap);
+    }
+    for (int i = 0; i < 16; ++i) {
+        __m128i msg = _mm_add_epi32(w[i & 3], _mm_loadu_si128((const __m128i*)&K256[4 * i]));
+        state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+        state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+        if (i < 12) {
+            __m128i next = _mm_sha256msg1_epu32(w[i & 3], w[(i + 1) & 3]);
+            next = _mm_add_epi32(next, _mm_alignr_epi8(w[(i + 3) & 3], w[(i + 2) & 3], 4));
+            w[i & 3] = _mm_sha256msg2_epu32(next, w[(i + 3) & 3]);
+        }
+    }
+
+    state0 = _mm_add_epi32(state0, abefStart);
+    state1 = _mm_add_epi32(state1, cdghStart);
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    _mm_storeu_si128((__m128i*)&state[0], _mm_blend_epi16(tmp, state1, 0xF0));
+    _mm_storeu_si128((__m128i*)&state[4], _mm_alignr_epi8(state1, tmp, 8));
+}
+
+/*
+ * Called by SHA256_Update() and SHA256_Final() for every 64 byte block.
+ */
+void SHA256_Transform(SHA256_CTX* context, const sha2_word32* data)
+{
+    if (UseShaNi()) {
+        ShaNiTransform(context->state, (const sha2_byte*)data);
+    } else {
+        SHA256_Transform_Portable(context, data);
+    }
+}
+
+#endif
+
 class Crypto_Hash::Context {
   public:
 
@@ -59,10 +167,17 @@ class Crypto_Hash::Context {
     Context(const Context& orig) : algorithm(orig.algorithm) {
         memcpy(&sha1, &orig.sha1, sizeof(HMAC_SHA1_CTX));
         memcpy(&sha256, &orig.sha256, sizeof(SHA256_CTX));
+        memcpy(&innerStart, &orig.innerStart, sizeof(SHA256_CTX));
+        memcpy(&outerStart, &orig.outerStart, sizeof(SHA256_CTX));
     }
 
     SHA256_CTX sha256;
-    uint8_t opad[SHA256_BLOCK_LENGTH];
+    /*
+     * For HMAC-SHA256 the states after hashing the inner and the outer pad,
+     * so each message starts from a copy instead of hashing the pads again.
+     */
+    SHA256_CTX innerStart;
+    SHA256_CTX outerStart;
     union {
         SHA_CTX md;
         HMAC_SHA1_CTX mac;
@@ -70,6 +185,18 @@ class Crypto_Hash::Context {
 
     Algorithm algorithm;
 
+    /*
+     * Finish the inner hash of an HMAC-SHA256 and compute the outer hash
+     * from the saved outer pad state.
+     */
+    void FinalHMAC_SHA256(uint8_t* digest)
+    {
+        SHA256_Final(digest, &sha256);
+        memcpy(&sha256, &outerStart, sizeof(SHA256_CTX));
+        SHA256_Update(&sha256, digest, SHA256_DIGEST_LENGTH);
+        SHA256_Final(digest, &sha256);
+    }
+
   private:
     Context& operator=(const Context& orig);
 };
@@ -117,8 +244,9 @@ QStatus Crypto_Hash::Init(Algorithm alg, const uint8_t* hmacKey, size_t keyLen)
     case qcc::Crypto_Hash::SHA256:
         if (MAC) {
             uint8_t ipad[SHA256_BLOCK_LENGTH];
+            uint8_t opad[SHA256_BLOCK_LENGTH];
             memset(ipad, 0, SHA256_BLOCK_LENGTH);
-            memset(ctx->opad, 0, SHA256_BLOCK_LENGTH);
+            memset(opad, 0, SHA256_BLOCK_LENGTH);
 
             if (keyLen > SHA256_BLOCK_LENGTH) {
                 uint8_t keyDigest[SHA256_DIGEST_LENGTH];
@@ -127,21 +255,26 @@ QStatus Crypto_Hash::Init(Algorithm alg, const uint8_t* hmacKey, size_t keyLen)
                 SHA256_Final(keyDigest, &ctx->sha256);
                 keyLen = SHA256_DIGEST_LENGTH;
                 memcpy(ipad, keyDigest, SHA256_DIGEST_LENGTH);
-                memcpy(ctx->opad, keyDigest, SHA256_DIGEST_LENGTH);
+                memcpy(opad, keyDigest, SHA256_DIGEST_LENGTH);
+                ClearMemory(keyDigest, SHA256_DIGEST_LENGTH);
             } else {
                 memcpy(ipad, hmacKey, keyLen);
-                memcpy(ctx->opad, hmacKey, keyLen);
+                memcpy(opad, hmacKey, keyLen);
             }
 
             /* Prepare inner and outer pads */
             for (i = 0; i < SHA256_BLOCK_LENGTH; i++) {
                 ipad[i] ^= 0x36;
-                ctx->opad[i] ^= 0x5C;
+                opad[i] ^= 0x5C;
             }
 
-            SHA256_Init(&ctx->sha256);
-            SHA256_Update(&ctx->sha256, ipad, SHA256_BLOCK_LENGTH);
+            SHA256_Init(&ctx->innerStart);
+            SHA256_Update(&ctx->innerStart, ipad, SHA256_BLOCK_LENGTH);
+            SHA256_Init(&ctx->outerStart);
+            SHA256_Update(&ctx->outerStart, opad, SHA256_BLOCK_LENGTH);
+            memcpy(&ctx->sha256, &ctx->innerStart, sizeof(SHA256_CTX));
             ClearMemory(ipad, SHA256_BLOCK_LENGTH);
+            ClearMemory(opad, SHA256_BLOCK_LENGTH);
         } else {
             SHA256_Init(&ctx->sha256);
         }
@@ -256,14 +389,9 @@ QStatus Crypto_Hash::GetDigest(uint8_t* digest, bool keepAlive)
 
     case qcc::Crypto_Hash::SHA256:
         if (MAC) {
-            // Get inner hash
-            SHA256_Final(digest, &ctx->sha256);
-            // Get outer hash (we can reuse the context)
-            SHA256_Init(&ctx->sha256);
-            SHA256_Update(&ctx->sha256, ctx->opad, SHA256_BLOCK_LENGTH);
-            SHA256_Update(&ctx->sha256, digest, SHA256_DIGEST_LENGTH);
-            SHA256_Final(digest, &ctx->sha256);
-            ClearMemory(ctx->opad, SHA256_BLOCK_LENGTH);
+            ctx->FinalHMAC_SHA256(digest);
+            ClearMemory(&ctx->innerStart, sizeof(SHA256_CTX));
+            ClearMemory(&ctx->outerStart, sizeof(SHA256_CTX));
             initialized = false;
         } else {
             if (keepAlive) {
@@ -286,4 +414,42 @@ QStatus Crypto_Hash::GetDigest(uint8_t* digest, bool keepAlive)
     return status;
 }
 
+QStatus Crypto_Hash::GetMAC(uint8_t* digest)
+{
+    QStatus status = ER_OK;
+
+    if (!initialized) {
+        QCC_LogError(status, ("Hash function not initialized"));
+        return ER_CRYPTO_HASH_UNINITIALIZED;
+    }
+
+    if (!digest) {
+        return ER_BAD_ARG_1;
+    }
+
+    if (!MAC) {
+        status = ER_CRYPTO_ERROR;
+        QCC_LogError(status, ("GetMAC requires an HMAC key"));
+        return status;
+    }
+
+    switch (ctx->algorithm) {
+    case qcc::Crypto_Hash::SHA1:
+        HMAC_SHA1_EndMessage(digest, &ctx->sha1.mac);
+        HMAC_SHA1_StartMessage(&ctx->sha1.mac);
+        break;
+
+    case qcc::Crypto_Hash::SHA256:
+        ctx->FinalHMAC_SHA256(digest);
+        memcpy(&ctx->sha256, &ctx->innerStart, sizeof(SHA256_CTX));
+        break;
+
+    default:
+        status = ER_CRYPTO_ERROR;
+        break;
+    }
+
+    return status;
+}
+
 }
@@ -42,19 +42,26 @@ namespace qcc {
 class Crypto_Hash::Context {
   public:
 
-    Context(size_t digestSize) : digestSize(digestSize), handle(0), hashObj(NULL) { }
+    Context(size_t digestSize) : digestSize(digestSize), handle(0), hashObj(NULL), keyedHandle(0), keyedObj(NULL) { }
 
     ~Context() {
         if (handle) {
             BCryptDestroyHash(handle);
         }
         delete [] hashObj;
+        if (keyedHandle) {
+            BCryptDestroyHash(keyedHandle);
+        }
+        delete [] keyedObj;
     }
 
     size_t digestSize;
     BCRYPT_HASH_HANDLE handle;
     uint8_t* hashObj;
     DWORD hashObjLen;
+    /* For HMAC, an untouched copy of the keyed hash that GetMAC() restarts from */
+    BCRYPT_HASH_HANDLE keyedHandle;
+    uint8_t* keyedObj;
   private:
     /**
      * Private copy constructor to prevent copying
@@ -130,6 +137,14 @@ QStatus Crypto_Hash::Init(Algorithm alg, const uint8_t* hmacKey, size_t keyLen)
         QCC_LogError(status, ("Failed to create hash"));
         delete ctx;
         ctx = NULL;
+    } else if (MAC) {
+        ctx->keyedObj = new uint8_t[ctx->hashObjLen];
+        if (!BCRYPT_SUCCESS(BCryptDuplicateHash(ctx->handle, &ctx->keyedHandle, ctx->keyedObj, ctx->hashObjLen, 0))) {
+            status = ER_CRYPTO_ERROR;
+            QCC_LogError(status, ("Failed to create hash"));
+            delete ctx;
+            ctx = NULL;
+        }
     }
 
     if (status == ER_OK) {
@@ -218,4 +233,37 @@ QStatus Crypto_Hash::GetDigest(uint8_t* digest, bool keepAlive)
     return status;
 }
 
+QStatus Crypto_Hash::GetMAC(uint8_t* digest)
+{
+    QStatus status = ER_OK;
+
+    if (!digest) {
+        return ER_BAD_ARG_1;
+    }
+    if (!initialized) {
+        status = ER_CRYPTO_HASH_UNINITIALIZED;
+        QCC_LogError(status, ("Hash function not initialized"));
+        return status;
+    }
+    if (!MAC) {
+        status = ER_CRYPTO_ERROR;
+        QCC_LogError(status, ("GetMAC requires an HMAC key"));
+        return status;
+    }
+    if (!BCRYPT_SUCCESS(BCryptFinishHash(ctx->handle, digest, ctx->digestSize, 0))) {
+        status = ER_CRYPTO_ERROR;
+        QCC_LogError(status, ("Finalizing hash digest"));
+    }
+    /* Start the next message from the copy of the keyed hash */
+    BCryptDestroyHash(ctx->handle);
+    ctx->handle = 0;
+    if (!BCRYPT_SUCCESS(BCryptDuplicateHash(ctx->keyedHandle, &ctx->handle, ctx->hashObj, ctx->hashObjLen, 0))) {
+        status = ER_CRYPTO_ERROR;
+        QCC_LogError(status, ("Failed to create hash"));
+        ctx->handle = 0;
+        initialized = false;
+    }
+    return status;
+}
+
 }
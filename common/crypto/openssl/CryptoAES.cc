@@ -70,6 +70,13 @@ Crypto_AES::~Crypto_AES()
     delete keyState;
 }
 
+bool Crypto_AES::EnableHardwareCCM(bool enable)
+{
+    /* CCM is entirely up to the platform library */
+    QCC_UNUSED(enable);
+    return true;
+}
+
 QStatus Crypto_AES::Encrypt(const Block* in, Block* out, uint32_t numBlocks)
 {
     /*
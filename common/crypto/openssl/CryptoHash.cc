@@ -220,4 +220,30 @@ QStatus Crypto_Hash::GetDigest(uint8_t* digest, bool keepAlive)
     return status;
 }
 
+QStatus Crypto_Hash::GetMAC(uint8_t* digest)
+{
+    /*
+     * Protect the open ssl APIs.
+     */
+    OpenSsl_ScopedLock lock;
+
+    QStatus status = ER_OK;
+
+    if (!digest) {
+        return ER_BAD_ARG_1;
+    }
+    if (!initialized) {
+        status = ER_CRYPTO_HASH_UNINITIALIZED;
+        QCC_LogError(status, ("Hash function not initialized"));
+    } else if (!MAC) {
+        status = ER_CRYPTO_ERROR;
+        QCC_LogError(status, ("GetMAC requires an HMAC key"));
+    } else if (!HMAC_Final(&ctx->hmac, digest, NULL) || !HMAC_Init_ex(&ctx->hmac, NULL, 0, NULL, NULL)) {
+        /* With a NULL key HMAC_Init_ex() restarts from the pads computed by Init() */
+        status = ER_CRYPTO_ERROR;
+        QCC_LogError(status, ("Finalizing HMAC"));
+    }
+    return status;
+}
+
 }
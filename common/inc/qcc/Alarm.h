@@ -39,6 +39,8 @@ class Timer;
 class _Alarm;
 class TimerImpl;
 class TimerThread;
+class AlarmSet;
+class TimingWheel;
 
 typedef ManagedObj<_Alarm> Alarm;
 
@@ -69,6 +71,8 @@ class AlarmListener {
 class _Alarm {
     friend class TimerImpl;
     friend class TimerThread;
+    friend class AlarmSet;
+    friend class TimingWheel;
 
   public:
 
@@ -147,6 +151,7 @@ class _Alarm {
     mutable void* context;
     int32_t id;
     const bool limitable;               /*< Whether this alarm needs to be counted towards the Timer's max alarm limit */
+    mutable void* wheelEntry;           /*< Entry of the timing wheel this alarm is queued on, if any */
 
     _Alarm& operator=(const _Alarm& other);
 };
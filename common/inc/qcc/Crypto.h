@@ -211,6 +211,18 @@ class Crypto_AES {
      */
     ~Crypto_AES();
 
+    /**
+     * Allow or prevent the use of CPU instructions for CCM in Crypto_AES
+     * objects created afterwards.  Meant for tests that need to check the
+     * portable implementation on a CPU that has the instructions; has no
+     * effect where there is only one implementation.
+     *
+     * @param enable  false to use the portable implementation only
+     *
+     * @return the previous setting
+     */
+    static bool EnableHardwareCCM(bool enable);
+
   private:
 
     Crypto_AES() { }
@@ -320,6 +332,18 @@ class Crypto_Hash {
      */
     QStatus GetDigest(uint8_t* digest, bool keepAlive = false);
 
+    /**
+     * Retrieve the HMAC of the data added since Init() or the previous call to GetMAC() and
+     * start a new message with the same key.  Unlike GetDigest() the hash instance stays
+     * usable, and the key pads are not computed again, so computing many MACs with one key
+     * only costs the hashing of each message.  Only allowed for HMAC.
+     *
+     * @param digest     Buffer for storing the MAC.
+     *
+     * @return  Indication of success or failure.
+     */
+    QStatus GetMAC(uint8_t* digest);
+
   protected:
 
     static const size_t SHA1_SIZE = 20;   ///< SHA1 digest size - 20 bytes == 160 bits
@@ -64,6 +64,19 @@ typedef struct {
     digit256_t Z3;
 } ecpoint_chudnovsky_t;
 
+/* Window size of fixed-base scalar multiplication.  A table for one point takes about 33 KB. */
+#define W_FIXEDBASE 5
+/* Number of windows of the fixed window representation of a 256-bit scalar, including the last digit */
+#define FIXEDBASE_WINDOWS ((256 + W_FIXEDBASE - 2) / (W_FIXEDBASE - 1) + 1)
+/* Number of odd multiples stored per window */
+#define FIXEDBASE_POINTS (1 << (W_FIXEDBASE - 2))
+
+/* Precomputed multiples of a fixed point P for ec_scalarmul_fixedbase().
+ * points[i][j] = (2j+1) * 2^((W_FIXEDBASE-1)*i) * P in affine coordinates. */
+typedef struct {
+    ecpoint_t points[FIXEDBASE_WINDOWS][FIXEDBASE_POINTS];
+} ec_fixedbase_table_t;
+
 /* An identifier for the curve.  This field may be serialized, so numbers should be re-used
  * for different curves between releases. */
 typedef enum {
@@ -166,6 +179,62 @@ void ec_affine_tojacobian(const ecpoint_t* Q, ecpoint_jacobian_t* P);
  */
 QStatus ec_scalarmul(const ecpoint_t* P, digit256_t k, ecpoint_t* Q, ec_t* curve);
 
+/**
+ * Compute the table of multiples of P used by ec_scalarmul_fixedbase.
+ *
+ * @param[in]  P     The point, validated as for ec_scalarmul.
+ * @param[out] table The table for P.
+ * @param[in]  curve The curve P is on.
+ *
+ * @return ER_OK if successful
+ */
+QStatus ec_fixedbase_precomp(const ecpoint_t* P, ec_fixedbase_table_t* table, ec_t* curve);
+
+/**
+ * Compute the scalar multiplication k*P for a point P with a precomputed table.
+ * Takes no doublings and runs in constant time like ec_scalarmul.
+ *
+ * @param[in]  table The table of P computed by ec_fixedbase_precomp.
+ * @param[in]  k     The scalar.
+ * @param[out] Q     The output point Q = k*P.
+ * @param[in]  curve The curve P is on.
+ *
+ * @return ER_OK if successful
+ */
+QStatus ec_scalarmul_fixedbase(const ec_fixedbase_table_t* table, digit256_t k, ecpoint_t* Q, ec_t* curve);
+
+/**
+ * Get the built-in table of the generator of the curve for ec_scalarmul_fixedbase.
+ *
+ * @param[in] curve The curve.
+ *
+ * @return The table, or NULL if there is none for the curve.
+ */
+const ec_fixedbase_table_t* ec_get_generator_table(ec_t* curve);
+
+/**
+ * Compute the scalar multiplication k*P, using a table for P once P has been
+ * multiplied often enough.  Meant for public keys that are used repeatedly,
+ * such as the keys of certificate authorities verifying signatures.
+ * Computes the same result as ec_scalarmul.
+ *
+ * @param[in]  P     The point to be multiplied.
+ * @param[in]  k     The scalar.
+ * @param[out] Q     The output point Q = k*P.
+ * @param[in]  curve The curve P is on.
+ *
+ * @return ER_OK if successful
+ */
+QStatus ec_scalarmul_cached(const ecpoint_t* P, digit256_t k, ecpoint_t* Q, ec_t* curve);
+
+/**
+ * Set up and tear down the tables used by ec_scalarmul_cached.  Called by
+ * qcc::Init and qcc::Shutdown; before ec_scalarmul_cache_init is called
+ * ec_scalarmul_cached behaves like ec_scalarmul.
+ */
+void ec_scalarmul_cache_init(void);
+void ec_scalarmul_cache_shutdown(void);
+
 /**
  * Check that a point is on the given curve.
  *
@@ -34,6 +34,43 @@
 #define QCC_MODULE "DEBUG"
 /** @endcond */
 
+/**
+ * Build a compile-time debug mask bit for a debug message type.
+ *
+ * @param _msgType  Debug message mode defined in DbgMsgType enum.
+ */
+#define QCC_DBG_MASK_BIT(_msgType) (1 << (_msgType))
+
+/**
+ * Mask of the debug message types that are compiled in.  Debug prints whose
+ * type is not in the mask are constant-folded away together with their
+ * arguments and without the runtime level check.  Defaults to every type;
+ * the build may narrow it with -DQCC_DBG_COMPILED_MASK=<mask>.
+ */
+#ifndef QCC_DBG_COMPILED_MASK
+#define QCC_DBG_COMPILED_MASK 0x7F
+#endif
+
+/**
+ * Mask of the debug message types compiled into modules that run once per
+ * message or packet (ARDP, UDP, ROUTER).  Defaults to QCC_DBG_COMPILED_MASK;
+ * the build may narrow it with -DQCC_DBG_HOT_PATH_MASK=<mask> to remove the
+ * tracing from those modules only.
+ */
+#ifndef QCC_DBG_HOT_PATH_MASK
+#define QCC_DBG_HOT_PATH_MASK QCC_DBG_COMPILED_MASK
+#endif
+
+/**
+ * Mask of the debug message types compiled into the current module.  A
+ * module may narrow it by redefining it next to its QCC_MODULE definition:
+ *
+ *     #define QCC_MODULE "ARDP_PROTOCOL"
+ *     #undef QCC_MODULE_DBG_MASK
+ *     #define QCC_MODULE_DBG_MASK QCC_DBG_HOT_PATH_MASK
+ */
+#define QCC_MODULE_DBG_MASK QCC_DBG_COMPILED_MASK
+
 /**
  * Some products using AllJoyn source code(e.g.Microsoft Windows) can override
  * this macro to direct the log output to their product-specific log.
@@ -185,7 +222,8 @@
 #else
 #define _QCC_DbgPrint(_msgType, _msg)                                  \
     do {                                                               \
-        if (_QCC_DbgPrintCheck((_msgType), QCC_MODULE)) {              \
+        if (((QCC_MODULE_DBG_MASK) & QCC_DBG_MASK_BIT(_msgType)) &&    \
+            _QCC_DbgPrintCheck((_msgType), QCC_MODULE)) {              \
             void* _ctx = _QCC_DbgPrintContext _msg;                    \
             _QCC_DbgPrintProcess(_ctx, (_msgType), QCC_MODULE, __FILE__, __LINE__); \
         }                                                               \
@@ -208,7 +246,11 @@
 #define _QCC_DbgDumpData(_msgType, _data, _len) do { } while (0)
 #else
 #define _QCC_DbgDumpData(_msgType, _data, _len)                         \
-    _QCC_DbgDumpHex((_msgType), QCC_MODULE, __FILE__, __LINE__, # _data, (_data), (_len))
+    do {                                                                \
+        if ((QCC_MODULE_DBG_MASK) & QCC_DBG_MASK_BIT(_msgType)) {       \
+            _QCC_DbgDumpHex((_msgType), QCC_MODULE, __FILE__, __LINE__, # _data, (_data), (_len)); \
+        }                                                               \
+    } while (0)
 #endif
 /** @endcond */
 
@@ -24,6 +24,7 @@
 
 #include <qcc/platform.h>
 
+#include <qcc/Metrics.h>
 #include <qcc/Stream.h>
 #include <qcc/Thread.h>
 #include <qcc/Timer.h>
@@ -153,6 +154,9 @@ struct IODispatchEntry {
 
     StoppingState stopping_state;          /* Whether this stream is in the process of being stopped*/
 
+    SocketFd pollFd;        /* FD registered with the epoll backend or INVALID_SOCKET_FD if the stream is select()ed */
+    uint32_t pollArmed;     /* Set of epoll events currently armed for pollFd */
+
     /**
      * Default Unusable entry
      *
@@ -168,7 +172,9 @@ struct IODispatchEntry {
         writeInProgress(false),
         mainAddingRead(false),
         mainAddingWrite(false),
-        stopping_state(IO_RUNNING) { }
+        stopping_state(IO_RUNNING),
+        pollFd(INVALID_SOCKET_FD),
+        pollArmed(0) { }
 
     /**
      * Constructor
@@ -193,12 +199,24 @@ struct IODispatchEntry {
         writeInProgress(writeInProgress),
         mainAddingRead(false),
         mainAddingWrite(false),
-        stopping_state(IO_RUNNING)
+        stopping_state(IO_RUNNING),
+        pollFd(INVALID_SOCKET_FD),
+        pollArmed(0)
     {
         QCC_UNUSED(stream);
     }
 };
 
+/**
+ * IODispatch waits for source/sink events on a set of streams and schedules the
+ * read/write/timeout/exit callbacks on its timer.
+ *
+ * On Linux builds with QCC_IODISPATCH_EPOLL defined (scons IODISPATCH_EPOLL=on)
+ * streams whose source and sink events are backed only by a socket are registered
+ * once with an edge-triggered, one-shot epoll set instead of being added to the
+ * select() set on every pass of the Run loop.  Other streams continue to go
+ * through Event::Wait.
+ */
 class IODispatch : public Thread, public AlarmListener {
   public:
     IODispatch(const char* name, uint32_t concurrency);
@@ -343,6 +361,42 @@ class IODispatch : public Thread, public AlarmListener {
      */
     virtual ThreadReturn STDCALL Run(void* arg);
 
+    /**
+     * Add a read alarm for a stream whose source event has fired.
+     * Must be called with lock held, returns with lock held.
+     */
+    void ScheduleReadAlarm(Stream* stream);
+
+    /**
+     * Add a write alarm for a stream whose sink event has fired.
+     * Must be called with lock held, returns with lock held.
+     */
+    void ScheduleWriteAlarm(Stream* stream);
+
+    /**
+     * Register a newly started stream with the epoll backend if it can be polled.
+     * Must be called with lock held.
+     */
+    void RegisterPoll(Stream* stream, IODispatchEntry& entry);
+
+    /**
+     * Remove a stream from the epoll backend.
+     * Must be called with lock held.
+     */
+    void UnregisterPoll(Stream* stream, IODispatchEntry& entry);
+
+    /**
+     * Re-arm the epoll registration of a stream to match its read/write state.
+     * Must be called with lock held.
+     */
+    void UpdatePoll(IODispatchEntry& entry);
+
+    /**
+     * Schedule callbacks for the streams that the epoll backend reports as ready.
+     * Must be called with lock held, returns with lock held.
+     */
+    void DispatchPolledEvents();
+
     Timer timer;                                /* The timer used to add and process callbacks */
     Mutex lock;                                 /* Lock for mutual exclusion of dispatchEntries */
     std::map<Stream*, IODispatchEntry> dispatchEntries; /* map holding details of various streams registered with this IODispatch */
@@ -354,6 +408,12 @@ class IODispatch : public Thread, public AlarmListener {
      * is waiting on it.
      */
     volatile bool crit;
+    std::map<Stream*, IODispatchEntry*> selectEntries;  /* Entries whose events are waited on with Event::Wait */
+    std::map<SocketFd, Stream*> polledFds;      /* Streams registered with the epoll backend keyed by FD */
+    int epollFd;                                /* epoll instance or -1 if the epoll backend is not in use */
+    Event* pollEvent;                           /* Read event on epollFd, signaled when polled streams are ready */
+    MetricHistogram* readCallbackUsec;          /* Time spent in read callbacks in microseconds */
+    MetricHistogram* writeCallbackUsec;         /* Time spent in write callbacks in microseconds */
     static volatile int32_t iodispatchCnt;
 };
 
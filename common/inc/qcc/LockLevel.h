@@ -208,6 +208,12 @@ typedef enum {
     /* BusAttachment.cc */
     LOCK_LEVEL_BUSATTACHMENT_INTERNAL_BUSATTACHMENTSETLOCK = 40000,
 
+    /* BufferPool.cc */
+    LOCK_LEVEL_BUFFERPOOL_LOCK = 41000,
+
+    /* PeerState.cc */
+    LOCK_LEVEL_PEERSTATE_AUTHORIZATIONCACHELOCK = 42000,
+
 } LockLevel;
 
 } /* namespace */
@@ -0,0 +1,214 @@
+/**
+ * @file
+ *
+ * Bounded lock-free multiple producer, single consumer ring
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#ifndef _QCC_MPSCRING_H
+#define _QCC_MPSCRING_H
+
+#include <qcc/platform.h>
+
+#include <new>
+
+#include <qcc/Thread.h>
+#include <qcc/Util.h>
+#include <qcc/atomic.h>
+
+namespace qcc {
+
+/**
+ * A fixed size queue that any number of threads can push onto without taking
+ * a lock, and that one thread at a time pops from.  Callers that pop from more
+ * than one thread must serialize the pops themselves, for example by holding
+ * a mutex they already hold while consuming.
+ *
+ * Each slot carries a sequence number that says whether the slot is free for
+ * the producer that claims the current tail position or holds an element for
+ * the consumer at the current head position.  A producer claims a position
+ * with a compare-and-exchange on the tail, constructs the element in place
+ * and then publishes it by advancing the slot's sequence number, so a pop
+ * never sees a partially constructed element.
+ *
+ * @tparam T  Copyable element type.  T does not need a default constructor.
+ */
+template <typename T>
+class MPSCRing {
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param capacity  Minimum number of elements the ring holds.  It is
+     *                  rounded up to a power of two.
+     */
+    MPSCRing(size_t capacity) : m_mask(0), m_slots(NULL), m_head(0), m_tail(0)
+    {
+        uint32_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_slots = new Slot[size];
+        for (uint32_t i = 0; i < size; ++i) {
+            m_slots[i].sequence = static_cast<int32_t>(i);
+        }
+    }
+
+    /**
+     * Destructor.  Destroys any elements still in the ring.
+     */
+    ~MPSCRing()
+    {
+        while (Front() != NULL) {
+            PopFront();
+        }
+        delete [] m_slots;
+    }
+
+    /**
+     * Add an element at the tail of the ring.  May be called from any thread.
+     *
+     * @param element  Element to copy into the ring.
+     * @return  true if the element was added, false if the ring was full.
+     */
+    bool TryPush(const T& element)
+    {
+        Slot* slot;
+        int32_t pos = m_tail;
+        for (;;) {
+            slot = &m_slots[static_cast<uint32_t>(pos) & m_mask];
+            int32_t diff = static_cast<int32_t>(static_cast<uint32_t>(slot->sequence) - static_cast<uint32_t>(pos));
+            if (diff == 0) {
+                /* The slot is free, claim the position.  CompareAndExchange() is a full barrier. */
+                if (CompareAndExchange(&m_tail, pos, Advance(pos, 1))) {
+                    break;
+                }
+            } else if (diff < 0) {
+                /* The consumer has not popped the element a lap behind this position yet */
+                return false;
+            }
+            pos = m_tail;
+        }
+        new (slot->storage) T(element);
+        /* Publish the element, the barrier orders the construction before the new sequence number */
+        CompareAndExchange(&slot->sequence, pos, Advance(pos, 1));
+        return true;
+    }
+
+    /**
+     * Get the element at the head of the ring.  Consumer only.
+     *
+     * @return  The head element or NULL if the ring is empty or the element at
+     *          the head has been claimed but not published yet.
+     */
+    T* Front()
+    {
+        Slot* slot = &m_slots[m_head & m_mask];
+        int32_t published = Advance(static_cast<int32_t>(m_head), 1);
+        /* The compare-and-exchange is used for its barrier so the element is read after the sequence number */
+        if (!CompareAndExchange(&slot->sequence, published, published)) {
+            return NULL;
+        }
+        return reinterpret_cast<T*>(slot->storage);
+    }
+
+    /**
+     * Get the element at the head of the ring, waiting for it to be published
+     * if a producer has already claimed the head position.  Consumer only.
+     *
+     * Front() returns NULL while the head position is claimed but not
+     * published even if later positions have been published, so a consumer
+     * that must see every element pushed before it started, in order, uses
+     * this instead.
+     *
+     * @return  The head element or NULL if no position is claimed.
+     */
+    T* WaitFront()
+    {
+        for (;;) {
+            T* front = Front();
+            if ((front != NULL) || (static_cast<int32_t>(m_head) == m_tail)) {
+                return front;
+            }
+            /* The producer publishes as soon as it has copied the element in */
+            qcc::Sleep(0);
+        }
+    }
+
+    /**
+     * Destroy the element at the head of the ring and free its slot for
+     * producers.  Consumer only, and only after Front() returned an element.
+     */
+    void PopFront()
+    {
+        Slot* slot = &m_slots[m_head & m_mask];
+        reinterpret_cast<T*>(slot->storage)->~T();
+        /* The slot is free again for the producer one lap ahead */
+        CompareAndExchange(&slot->sequence, Advance(static_cast<int32_t>(m_head), 1), Advance(static_cast<int32_t>(m_head), m_mask + 1));
+        ++m_head;
+    }
+
+    /**
+     * Move the element at the head of the ring out of it.  Consumer only.
+     *
+     * @param[out] element  Assigned the head element.
+     * @return  true if an element was popped, false if the ring looked empty.
+     */
+    bool TryPop(T& element)
+    {
+        T* front = Front();
+        if (front == NULL) {
+            return false;
+        }
+        element = *front;
+        PopFront();
+        return true;
+    }
+
+  private:
+
+    /**
+     * A slot of the ring.  The element is constructed in place so T does not
+     * need a default constructor and a popped element is released immediately.
+     */
+    struct Slot {
+        volatile int32_t sequence;
+        uint64_t storage[RequiredArrayLength(sizeof(T), uint64_t)];
+    };
+
+    /* Positions wrap around so they are advanced as unsigned values */
+    static int32_t Advance(int32_t pos, uint32_t n)
+    {
+        return static_cast<int32_t>(static_cast<uint32_t>(pos) + n);
+    }
+
+    /* Private copy constructor and assignment operator to prevent copies */
+    MPSCRing(const MPSCRing& other);
+    MPSCRing& operator=(const MPSCRing& other);
+
+    uint32_t m_mask;           /**< Number of slots minus one */
+    Slot* m_slots;             /**< The slots */
+    uint32_t m_head;           /**< Position of the next element to pop, only touched by the consumer */
+    volatile int32_t m_tail;   /**< Position the next producer claims */
+};
+
+} // namespace qcc
+
+#endif
@@ -0,0 +1,295 @@
+/**
+ * @file
+ *
+ * Named counters and latency histograms cheap enough to update on hot paths.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#ifndef _QCC_METRICS_H
+#define _QCC_METRICS_H
+
+#include <qcc/platform.h>
+
+#include <map>
+#include <vector>
+
+#include <qcc/String.h>
+#include <qcc/atomic.h>
+#include <qcc/time.h>
+
+namespace qcc {
+
+/**
+ * Number of shards each metric is split into.  A thread always updates the
+ * same shard so threads only contend when their ids hash to the same shard.
+ */
+static const size_t METRIC_SHARDS = 16;
+
+/**
+ * Get the shard the calling thread updates.
+ *
+ * @return A shard index less than METRIC_SHARDS.
+ */
+size_t GetMetricShard();
+
+/**
+ * A counter that many threads can increment without sharing a cache line.
+ *
+ * Values are kept modulo 2^32, so readers interested in rates should take the
+ * difference of two readings using unsigned arithmetic.
+ */
+class MetricCounter {
+  public:
+
+    /**
+     * Constructor
+     */
+    MetricCounter();
+
+    /**
+     * Add one to the counter.
+     */
+    void Increment()
+    {
+        IncrementAndFetch(&shards[GetMetricShard()].value);
+    }
+
+    /**
+     * Subtract one from the counter.  Together with Increment() this lets a
+     * counter track a current level, such as a queue length, rather than a
+     * running total.
+     */
+    void Decrement()
+    {
+        DecrementAndFetch(&shards[GetMetricShard()].value);
+    }
+
+    /**
+     * Add a value to the counter.
+     *
+     * @param n  Value to add.
+     */
+    void Add(uint32_t n);
+
+    /**
+     * Read the counter.  Concurrent updates may or may not be included.
+     *
+     * @return The sum of all shards modulo 2^32.
+     */
+    uint32_t GetValue() const;
+
+  private:
+
+    /** A shard padded out to its own cache line */
+    struct Shard {
+        volatile int32_t value;
+        uint8_t pad[64 - sizeof(int32_t)];
+    };
+
+    /* Private copy constructor and assignment operator to prevent copies */
+    MetricCounter(const MetricCounter& other);
+    MetricCounter& operator=(const MetricCounter& other);
+
+    Shard shards[METRIC_SHARDS];  /**< Per-thread shards */
+};
+
+/**
+ * The buckets of a MetricHistogram at the time it was read.
+ */
+class MetricHistogramSnapshot {
+  public:
+
+    /**
+     * Get the number of values recorded.
+     *
+     * @return Number of values recorded.
+     */
+    uint64_t GetCount() const;
+
+    /**
+     * Estimate a percentile of the recorded values.
+     *
+     * @param percent  Percentile between 0 and 100.
+     * @return The lower bound of the bucket holding the percentile, 0 if no
+     *         values were recorded.
+     */
+    uint32_t GetPercentile(double percent) const;
+
+    std::vector<uint32_t> buckets;   /**< Number of values in each bucket */
+};
+
+/**
+ * A histogram of 32 bit values, usually latencies in microseconds.
+ *
+ * Buckets are log-linear: values below 4 have their own bucket and every
+ * power of two above that is split into 4 equal buckets, so a value is never
+ * more than 25% away from the lower bound of its bucket.
+ */
+class MetricHistogram {
+  public:
+
+    /** Number of buckets needed to cover every 32 bit value */
+    static const size_t NUM_BUCKETS = 124;
+
+    /**
+     * Constructor
+     */
+    MetricHistogram();
+
+    /**
+     * Record a value.
+     *
+     * @param value  Value to record.
+     */
+    void Record(uint32_t value)
+    {
+        IncrementAndFetch(&buckets[GetMetricShard()][GetBucket(value)]);
+    }
+
+    /**
+     * Read the histogram.  Concurrent updates may or may not be included.
+     *
+     * @param[out] snapshot  Receives the sum of all shards.
+     */
+    void GetSnapshot(MetricHistogramSnapshot& snapshot) const;
+
+    /**
+     * Get the bucket a value falls in.
+     *
+     * @param value  The value.
+     * @return The bucket index.
+     */
+    static size_t GetBucket(uint32_t value)
+    {
+        if (value < 4) {
+            return value;
+        }
+        uint32_t exp = 31;
+        while (!(value & (1U << exp))) {
+            --exp;
+        }
+        return ((exp - 1) << 2) + ((value >> (exp - 2)) & 3);
+    }
+
+    /**
+     * Get the smallest value that falls in a bucket.
+     *
+     * @param bucket  The bucket index.
+     * @return The lower bound of the bucket.
+     */
+    static uint32_t GetBucketLowerBound(size_t bucket)
+    {
+        if (bucket < 4) {
+            return static_cast<uint32_t>(bucket);
+        }
+        uint32_t exp = static_cast<uint32_t>(bucket >> 2) + 1;
+        return (1U << exp) | (static_cast<uint32_t>(bucket & 3) << (exp - 2));
+    }
+
+  private:
+
+    /* Private copy constructor and assignment operator to prevent copies */
+    MetricHistogram(const MetricHistogram& other);
+    MetricHistogram& operator=(const MetricHistogram& other);
+
+    volatile int32_t buckets[METRIC_SHARDS][NUM_BUCKETS];  /**< Per-thread bucket counts */
+};
+
+/**
+ * Records the time between its construction and its destruction, in
+ * microseconds, into a histogram.
+ */
+class ScopedMetricTimer {
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param histogram  Histogram the elapsed time is recorded into.
+     */
+    ScopedMetricTimer(MetricHistogram* histogram) : histogram(histogram), start(GetTimestampMicros()) { }
+
+    /**
+     * Destructor
+     */
+    ~ScopedMetricTimer()
+    {
+        uint64_t elapsed = GetTimestampMicros() - start;
+        histogram->Record((elapsed > 0xFFFFFFFF) ? 0xFFFFFFFF : static_cast<uint32_t>(elapsed));
+    }
+
+  private:
+
+    /* Private copy constructor and assignment operator to prevent copies */
+    ScopedMetricTimer(const ScopedMetricTimer& other);
+    ScopedMetricTimer& operator=(const ScopedMetricTimer& other);
+
+    MetricHistogram* histogram;   /**< Histogram to record into */
+    uint64_t start;               /**< Time of construction in microseconds */
+};
+
+/**
+ * The values of all registered metrics at the time they were read.
+ */
+struct MetricsSnapshot {
+    std::map<qcc::String, uint32_t> counters;                       /**< Counter values by name */
+    std::map<qcc::String, MetricHistogramSnapshot> histograms;      /**< Histograms by name */
+};
+
+/**
+ * Registry of named metrics.
+ *
+ * Metrics are created the first time they are looked up and live until
+ * qcc::Shutdown() so callers should look them up once, for example when the
+ * object that updates them is constructed, and keep the pointer.
+ */
+class Metrics {
+  public:
+
+    /**
+     * Get a counter, creating it if it does not exist yet.
+     *
+     * @param name  Dotted name of the counter, e.g. "router.push.messages".
+     * @return The counter.
+     */
+    static MetricCounter* GetCounter(const qcc::String& name);
+
+    /**
+     * Get a histogram, creating it if it does not exist yet.
+     *
+     * @param name  Dotted name of the histogram, e.g. "router.push.usec".
+     * @return The histogram.
+     */
+    static MetricHistogram* GetHistogram(const qcc::String& name);
+
+    /**
+     * Read every registered metric.
+     *
+     * @param[out] snapshot  Receives the metric values.
+     */
+    static void GetSnapshot(MetricsSnapshot& snapshot);
+
+    /** @internal Called from qcc::Init() */
+    static void Init();
+
+    /** @internal Called from qcc::Shutdown() */
+    static void Shutdown();
+};
+
+}
+
+#endif
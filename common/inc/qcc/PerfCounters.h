@@ -65,12 +65,15 @@ typedef enum _PerfCounterIndex {
     PERF_COUNTER_IPNS_SEND_PROTOCOL_MESSAGE = 26,
     PERF_COUNTER_IPNS_HANDLE_PROTOCOL_MESSAGE = 27,
 
+    PERF_COUNTER_BUFFER_POOL_HIT = 28,
+    PERF_COUNTER_BUFFER_POOL_MISS = 29,
+
     /*
      * Insert new counters above this line, then update the total count below.
      * DO NOT remove or change the value of any of the existing counters,
      * because Windbg extensions depend on these existing values.
      */
-    PERF_COUNTER_COUNT = 28
+    PERF_COUNTER_COUNT = 30
 } PerfCounterIndex;
 
 /*
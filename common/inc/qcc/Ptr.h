@@ -45,6 +45,13 @@ class Ptr {
      */
     Ptr(T* p);
 
+    /**
+     * Copy constructor.  The copy holds its own reference to the object.  The
+     * conversion constructors below are templates and so never act as the copy
+     * constructor.
+     */
+    Ptr(const Ptr& other);
+
     /**
      * A conversion constructor to allow for casting between Ptr types.
      */
@@ -85,7 +92,7 @@ class Ptr {
      * Get the underlying object pointer.  You must never delete this pointer
      * yourself.
      */
-    T* Peek();
+    T* Peek() const;
 
   private:
     /**
@@ -107,6 +114,14 @@ Ptr<T>::Ptr(T* p) : ptr(p)
     }
 }
 
+template <typename T>
+Ptr<T>::Ptr(const Ptr& other) : ptr(other.ptr)
+{
+    if (ptr) {
+        ptr->IncRef();
+    }
+}
+
 /**
  * A copy constructor that allows for cast operations.
  *
@@ -230,7 +245,7 @@ T& Ptr<T>::operator*()
 }
 
 template <typename T>
-T* Ptr<T>::Peek(void)
+T* Ptr<T>::Peek(void) const
 {
     return ptr;
 }
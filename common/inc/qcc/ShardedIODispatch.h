@@ -0,0 +1,163 @@
+/**
+ * @file
+ *
+ * ShardedIODispatch spreads streams over several independent IODispatch loops
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#ifndef _QCC_SHARDEDIODISPATCH_H
+#define _QCC_SHARDEDIODISPATCH_H
+
+#include <qcc/platform.h>
+
+#include <vector>
+
+#include <qcc/IODispatch.h>
+#include <qcc/Stream.h>
+#include <Status.h>
+
+namespace qcc {
+
+/**
+ * ShardedIODispatch has the same stream interface as IODispatch but hashes
+ * every stream onto one of several IODispatch instances.  Each shard has its
+ * own Run thread, timer, lock and entry map so streams on different shards
+ * never contend with each other.  A stream stays on the same shard for its
+ * whole lifetime.
+ *
+ * With a single shard this behaves exactly like a plain IODispatch.
+ */
+class ShardedIODispatch {
+  public:
+
+    /**
+     * Constructor
+     *
+     * @param name          Name used for the shard threads and timers.
+     * @param concurrency   Total number of callbacks that may run concurrently,
+     *                      divided between the shards.
+     * @param numShards     Number of independent dispatch loops (at least 1).
+     */
+    ShardedIODispatch(const char* name, uint32_t concurrency, uint32_t numShards = 1);
+
+    /** Destructor */
+    ~ShardedIODispatch();
+
+    /**
+     * Start all shards.
+     *
+     * @return  ER_OK if successful.
+     */
+    QStatus Start();
+
+    /**
+     * Stop all shards.
+     *
+     * @return ER_OK if successful.
+     */
+    QStatus Stop();
+
+    /**
+     * Join all shards.
+     *
+     * @return ER_OK if successful.
+     */
+    QStatus Join();
+
+    /**
+     * Get the number of shards.
+     *
+     * @return The number of independent dispatch loops.
+     */
+    uint32_t GetNumShards() const { return static_cast<uint32_t>(shards.size()); }
+
+    /**
+     * Get the shard responsible for a stream.  Used by components that
+     * need a plain IODispatch for a single stream (e.g. UARTController).
+     *
+     * @param stream   The stream.
+     * @return The IODispatch that the stream is (or will be) registered with.
+     */
+    IODispatch& ShardFor(const Stream* stream) const;
+
+    /** @see IODispatch::StartStream */
+    QStatus StartStream(Stream* stream, IOReadListener* readListener, IOWriteListener* writeListener, IOExitListener* exitListener, bool readEnable = true, bool writeEnable = true)
+    {
+        return ShardFor(stream).StartStream(stream, readListener, writeListener, exitListener, readEnable, writeEnable);
+    }
+
+    /** @see IODispatch::StopStream */
+    QStatus StopStream(Stream* stream) { return ShardFor(stream).StopStream(stream); }
+
+    /** @see IODispatch::JoinStream */
+    QStatus JoinStream(Stream* stream) { return ShardFor(stream).JoinStream(stream); }
+
+    /** @see IODispatch::EnableReadCallback */
+    QStatus EnableReadCallback(const Source* source, uint32_t timeout = 0)
+    {
+        return ShardFor(static_cast<const Stream*>(source)).EnableReadCallback(source, timeout);
+    }
+
+    /** @see IODispatch::DisableReadCallback */
+    QStatus DisableReadCallback(const Source* source)
+    {
+        return ShardFor(static_cast<const Stream*>(source)).DisableReadCallback(source);
+    }
+
+    /** @see IODispatch::EnableWriteCallback */
+    QStatus EnableWriteCallback(Sink* sink, uint32_t timeout = 0)
+    {
+        return ShardFor(static_cast<const Stream*>(sink)).EnableWriteCallback(sink, timeout);
+    }
+
+    /** @see IODispatch::EnableWriteCallbackNow */
+    QStatus EnableWriteCallbackNow(Sink* sink)
+    {
+        return ShardFor(static_cast<const Stream*>(sink)).EnableWriteCallbackNow(sink);
+    }
+
+    /** @see IODispatch::DisableWriteCallback */
+    QStatus DisableWriteCallback(const Sink* sink)
+    {
+        return ShardFor(static_cast<const Stream*>(sink)).DisableWriteCallback(sink);
+    }
+
+    /** @see IODispatch::EnableTimeoutCallback */
+    QStatus EnableTimeoutCallback(const Source* source, uint32_t linkTimeout = 0)
+    {
+        return ShardFor(static_cast<const Stream*>(source)).EnableTimeoutCallback(source, linkTimeout);
+    }
+
+    /**
+     * Check whether or not the current thread belongs to the timer of any shard.
+     *
+     * @return true if the current thread is a timer thread from this instance
+     */
+    bool IsTimerCallbackThread() const;
+
+  private:
+
+    /* Private copy constructor and assignment operator to prevent double delete of shards */
+    ShardedIODispatch(const ShardedIODispatch&);
+    ShardedIODispatch& operator=(const ShardedIODispatch&);
+
+    std::vector<IODispatch*> shards;    /* The independent dispatch loops */
+};
+
+}
+
+#endif
@@ -297,6 +297,63 @@ QStatus RecvFrom(SocketFd sockfd, IPAddress& remoteAddr, uint16_t& remotePort,
 QStatus RecvWithAncillaryData(SocketFd sockfd, IPAddress& remoteAddr, uint16_t& remotePort, IPAddress& localAddr,
                               void* buf, size_t len, size_t& received, int32_t& interfaceIndex);
 
+/**
+ * One datagram of a batch sent by SendToBatch().
+ */
+struct SendToEntry {
+    IPAddress* remoteAddr;         ///< IP Address of remote host.
+    uint16_t remotePort;           ///< IP Port on remote host.
+    const IOVec* iov;              ///< Buffers holding the datagram, in order.
+    size_t numIov;                 ///< Number of entries in iov.
+};
+
+/**
+ * Send a batch of datagrams on a socket.  Where the platform allows, the whole
+ * batch is handed to the kernel in a single call (sendmmsg()), and runs of
+ * equally sized datagrams to the same remote host are further coalesced using
+ * UDP segmentation offload.  Elsewhere the datagrams are sent one at a time.
+ *
+ * @param sockfd        Socket descriptor.
+ * @param entries       The datagrams to send, in order.
+ * @param numEntries    Number of datagrams in entries.
+ * @param[out] numSent  Number of datagrams (from the start of entries) sent.
+ * @param flags         SendMsgFlags to underlying sockets call (see sendmsg() in sockets API)
+ *
+ * @return
+ * - #ER_OK every datagram was sent.
+ * - #ER_WOULDBLOCK sockfd is non-blocking and would block before every datagram was sent.
+ * - #ER_OS_ERROR the underlying send failed.
+ */
+QStatus SendToBatch(SocketFd sockfd, const SendToEntry* entries, size_t numEntries, size_t& numSent,
+                    SendMsgFlags flags = QCC_MSG_NONE);
+
+/**
+ * One datagram of a batch received by RecvFromBatch().
+ */
+struct RecvFromEntry {
+    void* buf;                     ///< Buffer where the received datagram will be stored.
+    size_t len;                    ///< Size of the buffer in octets.
+    IPAddress remoteAddr;          ///< OUT: IP Address of remote host.
+    uint16_t remotePort;           ///< OUT: IP Port on remote host.
+    size_t received;               ///< OUT: Number of octets received.
+};
+
+/**
+ * Receive up to numEntries datagrams from a socket.  Where the platform
+ * allows, a single call (recvmmsg()) is used.  Returns as soon as at least one
+ * datagram has been received and no more are immediately available.
+ *
+ * @param sockfd            Socket descriptor.
+ * @param entries           Buffers to receive into; the OUT fields of the first
+ *                          numReceived entries are filled in.
+ * @param numEntries        Number of entries.
+ * @param[out] numReceived  Number of datagrams received.
+ *
+ * @return  ER_OK if at least one datagram was received, otherwise an error
+ *          status as for RecvFrom().
+ */
+QStatus RecvFromBatch(SocketFd sockfd, RecvFromEntry* entries, size_t numEntries, size_t& numReceived);
+
 /**
  * Receive a buffer of data from a remote host on a socket and any file descriptors accompanying the
  * data.  This call will block until data is available, the socket is closed.
@@ -318,6 +375,22 @@ QStatus RecvWithAncillaryData(SocketFd sockfd, IPAddress& remoteAddr, uint16_t&
  */
 QStatus RecvWithFds(SocketFd sockfd, void* buf, size_t len, size_t& received, SocketFd* fdList, size_t maxFds, size_t& recvdFds);
 
+/**
+ * Send the contents of a scatter-gather list over a socket in a single call.
+ *
+ * @param sockfd    Socket descriptor.
+ * @param iov       Array of buffers to send in order.
+ * @param numIov    Number of entries in iov.
+ * @param[out] sent Number of octets sent, which may end part way through any entry.
+ *
+ * @return
+ * - #ER_BAD_ARG_3 numIov is 0.
+ * - #ER_OK the send succeeded.
+ * - #ER_OS_ERROR the underlying send failed.
+ * - #ER_WOULDBLOCK sockfd is non-blocking and the underlying send would block.
+ */
+QStatus SendV(SocketFd sockfd, const IOVec* iov, size_t numIov, size_t& sent);
+
 /**
  * Send a buffer of data with file descriptors to a socket. Depending on the transport this may may use out-of-band
  * or in-band data or some mix of the two.
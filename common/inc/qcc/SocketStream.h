@@ -201,6 +201,38 @@ class SocketStream : public Stream {
      */
     QStatus PushBytes(const void* buf, size_t numBytes, size_t& numSent);
 
+    /**
+     * Push the contents of a scatter-gather list into the sink with a single send.
+     *
+     * @param iov          Array of buffers to push in order.
+     * @param numIov       Number of entries in iov.
+     * @param[out] numSent Number of bytes actually consumed by sink.
+     *
+     * @return
+     * - #ER_OK if numIov is 0 or the push succeeds.
+     * - #ER_WRITE_ERROR if the socket is not connected.
+     * - #ER_TIMEOUT if timeout is reached before pushing any bytes.
+     * - #ER_OS_ERROR if the underlying socket request fails.
+     */
+    QStatus PushBytesV(const IOVec* iov, size_t numIov, size_t& numSent) { return PushBytesV(iov, numIov, numSent, 0); }
+
+    /**
+     * Push the contents of a scatter-gather list into the sink with a single send, waiting no
+     * longer than the ttl of the first message in the list for room in the socket.
+     *
+     * @param iov          Array of buffers to push in order.
+     * @param numIov       Number of entries in iov.
+     * @param[out] numSent Number of bytes actually consumed by sink.
+     * @param ttl          Time-to-live for the first message in the list or 0 for infinite.
+     *
+     * @return
+     * - #ER_OK if numIov is 0 or the push succeeds.
+     * - #ER_WRITE_ERROR if the socket is not connected.
+     * - #ER_TIMEOUT if the timeout or the ttl is reached before pushing any bytes.
+     * - #ER_OS_ERROR if the underlying socket request fails.
+     */
+    QStatus PushBytesV(const IOVec* iov, size_t numIov, size_t& numSent, uint32_t ttl);
+
     /**
      * Push bytes accompanied by one or more file/socket descriptors to a sink.
      *
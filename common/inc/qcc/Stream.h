@@ -148,6 +148,45 @@ class Sink {
         return PushBytes(buf, numBytes, numSent);
     }
 
+    /**
+     * Push the contents of a scatter-gather list into the sink with infinite ttl. Sinks that
+     * cannot consume a list in one operation push only the first non-empty entry.
+     *
+     * @param iov          Array of buffers to push in order.
+     * @param numIov       Number of entries in iov.
+     * @param numSent      Number of bytes actually consumed by sink.
+     * @return   ER_OK if successful.
+     */
+    virtual QStatus PushBytesV(const IOVec* iov, size_t numIov, size_t& numSent) {
+        for (size_t i = 0; i < numIov; ++i) {
+            if (iov[i].len > 0) {
+                return PushBytes(iov[i].buf, iov[i].len, numSent);
+            }
+        }
+        numSent = 0;
+        return ER_OK;
+    }
+
+    /**
+     * Push the contents of a scatter-gather list into the sink. Sinks that cannot consume a list
+     * in one operation push only the first non-empty entry.
+     *
+     * @param iov          Array of buffers to push in order.
+     * @param numIov       Number of entries in iov.
+     * @param numSent      Number of bytes actually consumed by sink.
+     * @param ttl          Time-to-live for the first message in the list or 0 for infinite.
+     * @return   ER_OK if successful.
+     */
+    virtual QStatus PushBytesV(const IOVec* iov, size_t numIov, size_t& numSent, uint32_t ttl) {
+        for (size_t i = 0; i < numIov; ++i) {
+            if (iov[i].len > 0) {
+                return PushBytes(iov[i].buf, iov[i].len, numSent, ttl);
+            }
+        }
+        numSent = 0;
+        return ER_OK;
+    }
+
     /**
      * Push one or more byte accompanied by one or more file/socket descriptors to a sink.
      *
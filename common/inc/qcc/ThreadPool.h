@@ -1,7 +1,7 @@
 /**
  * @file
  *
- * Simple ThreadPool using Timers and Alarms
+ * Work-stealing ThreadPool
  */
 
 /******************************************************************************
@@ -23,15 +23,18 @@
 #ifndef _QCC_THREADPOOL_H
 #define _QCC_THREADPOOL_H
 
-#include <map>
+#include <vector>
 
-#include <qcc/Timer.h>
+#include <qcc/Condition.h>
 #include <qcc/Event.h>
+#include <qcc/Mutex.h>
 #include <qcc/Ptr.h>
+#include <qcc/atomic.h>
 
 namespace qcc {
 
 class ThreadPool;
+class ThreadPoolWorker;
 
 /**
  * A class in the spirit of the Java Runnable object that is used to define an
@@ -53,7 +56,7 @@ class ThreadPool;
  * enclosed type.  Since we need the cast behavior, we use the Ptr intrusive
  * smart pointer class to manage our runnable closures.
  */
-class Runnable : public qcc::RefCountBase, public qcc::AlarmListener {
+class Runnable : public qcc::RefCountBase {
   public:
 
     /**
@@ -76,26 +79,13 @@ class Runnable : public qcc::RefCountBase, public qcc::AlarmListener {
 
   private:
     /**
-     * ThreadPool must be a friend in order to make AlarmTriggered an accessible
-     * base class method of a user's Runnable, and to allow the ThreadPool to
-     * set a pointer to itself here to allow for notifications.
+     * ThreadPool must be a friend in order to set a pointer to itself here.
      */
     friend class ThreadPool;
 
     /**
-     * AlarmTriggered is the method that is called to dispatch an alarm.
-     * Our Run() methods are driven by alarm expirations that happen to
-     * always occur immediately.
-     *
-     * Note that the enclosing runnable object is automatically deleted
-     * afte the Run method is executed.
-     */
-    virtual void AlarmTriggered(const Alarm& alarm, QStatus reason);
-
-    /**
-     * Private method used by the thread pool to tell this object how to contact
-     * the thread pool when the reference to the runnable closure is no longer
-     * needed.
+     * Private method used by the thread pool to record which thread pool the
+     * runnable closure was handed to.
      */
     void SetThreadPool(ThreadPool* threadpool)
     {
@@ -103,10 +93,7 @@ class Runnable : public qcc::RefCountBase, public qcc::AlarmListener {
     }
 
     /**
-     * A reference back to the thread pool that causes the run method to be
-     * called.  We need this reference so the thread pool can hook a "done"
-     * event since it would otherwise be unaware of the execution of the
-     * runderlying timer alarm callback that it arranged to be called.
+     * A reference back to the thread pool that runs this closure.
      */
     ThreadPool* m_threadpool;
 };
@@ -118,6 +105,13 @@ class Runnable : public qcc::RefCountBase, public qcc::AlarmListener {
  *
  * In order to ask a ThreadPool to execute a task, one must inherit from the
  * Runnable class and provide a Run() method.
+ *
+ * The thread pool is a work-stealing executor.  Each worker thread has its own
+ * queue of closures.  Closures executed from one of the pool's own threads go
+ * on that thread's queue and other closures are spread over the queues in turn.
+ * A worker runs the most recently queued closure from its own queue and, when
+ * that is empty, takes the oldest closure from another worker's queue.  There
+ * is no lock shared by every Execute() call.
  */
 class ThreadPool {
   public:
@@ -135,15 +129,16 @@ class ThreadPool {
     virtual ~ThreadPool();
 
     /**
-     * Request that we cancel all of our dispatched threads.
+     * Request that we cancel all of our dispatched threads.  Closures that
+     * have not started running are not run.
      */
     QStatus Stop();
 
     /**
-     * Wait for all of the threads in our associated timer to exit.  Once
-     * this happens, it is safe for us to finish tearing down our object.
-     * Note that this call can block or a time limited only by the execution
-     * time of the threads dispatched.
+     * Wait for all of the threads in the pool to exit.  Once this happens, it
+     * is safe for us to finish tearing down our object.  Note that this call
+     * can block or a time limited only by the execution time of the threads
+     * dispatched.
      */
     QStatus Join();
 
@@ -195,6 +190,7 @@ class ThreadPool {
      * @return
      *      - #ER_OK if the execute request was successful
      *      - #ER_THREADPOOL_EXHAUSTED if the thread pool has previously reached its specified concurrency.
+     *      - #ER_THREADPOOL_STOPPING if the thread pool is stopping.
      */
     QStatus Execute(Ptr<Runnable> runnable);
 
@@ -220,12 +216,10 @@ class ThreadPool {
 
   private:
     /**
-     * Runnable must be a friend in order to call back and tell us that it has
-     * finished executing.  Since this affects the memory management contract
-     * between the Runnable and ThreadPool objects, we don't let anyone else
-     * but Runnable make this call.
+     * The worker threads take closures from the queues and report when they
+     * have finished running them.
      */
-    friend class Runnable;
+    friend class ThreadPoolWorker;
 
     /**
      * Assignment operator is private - ThreadPools cannot be assigned.
@@ -237,13 +231,39 @@ class ThreadPool {
      */
     ThreadPool(const ThreadPool& other);
 
+    /**
+     * Take the next closure for a worker to run, from its own queue if possible
+     * and otherwise from the other workers' queues.
+     *
+     * @param worker  The worker looking for work.
+     *
+     * @return The closure with a reference held for the caller, or NULL if all
+     *         of the queues are empty.
+     */
+    Runnable* TakeWork(ThreadPoolWorker* worker);
+
+    /**
+     * Put a worker to sleep until there may be closures to run or the pool is
+     * stopping.
+     *
+     * @param worker  The worker with nothing to do.
+     */
+    void WaitForWork(ThreadPoolWorker* worker);
+
+    /**
+     * Account for a closure that has finished running, or that was refused,
+     * and wake any threads waiting in WaitForAvailableThread().
+     */
+    void Release(void);
+
     /**
      * A flag to remind if the thread pool is stopping or stopped.
      */
-    bool m_stopping;
+    volatile bool m_stopping;
 
     /**
-     * A mutex to protect the underlying data structures.
+     * A mutex to serialize callers of WaitForAvailableThread() with the
+     * completion of closures.
      */
     qcc::Mutex m_lock;
 
@@ -259,31 +279,39 @@ class ThreadPool {
     uint32_t m_poolsize;
 
     /**
-     * We need to hold a reference to an underlying Runnable object while we
-     * wait for its Run() method to be executed.  The Runnable object acts as a
-     * closure that a user will use to keep required variables.  When the Run()
-     * method is done executing, we release the reference to the runnable managed
-     * object by deleting the corresponding entry in the closure map.
+     * The number of closures that are waiting to run or are running.  Execute()
+     * refuses new closures while this is equal to the pool size.
+     */
+    volatile int32_t m_pending;
+
+    /**
+     * The number of threads blocked in WaitForAvailableThread().  Completing
+     * closures only touch m_event when this is non-zero.
+     */
+    volatile int32_t m_waiters;
+
+    /**
+     * Counter used to spread closures executed from other threads over the
+     * worker queues.
+     */
+    volatile int32_t m_nextWorker;
+
+    /**
+     * The number of workers asleep in WaitForWork().  Execute() only takes
+     * m_idleLock to wake a worker when this is non-zero.
      */
-    typedef std::map<Runnable*, Ptr<Runnable> > RunnableEntry;
-    RunnableEntry m_closures;
+    volatile int32_t m_idle;
 
     /**
-     * When the AlarmTriggered callback of the AlarmListener base class of the
-     * Runnable is called by the Timer, it will call the user's Run() function
-     * and then call back here to let us know that it has finished executing.
-     * That tells us that we can clean up any resources we may be holding.  That
-     * just means releasing our reference to the Ptr that holds the ulitmate
-     * reference to the runnable.  If we can't find a closure, we have screwed
-     * up massively and we should just die.
+     * Lock and condition idle workers sleep on.
      */
-    void Release(Runnable* runnable);
+    qcc::Mutex m_idleLock;
+    qcc::Condition m_idleCondition;
 
     /**
-     * The timer that actually does all of the work of dispatching threads and
-     * essentially doing all of the work of the thread pool.
+     * The worker threads, each with its own queue of closures.
      */
-    qcc::Timer m_dispatcher;
+    std::vector<ThreadPoolWorker*> m_workers;
 };
 
 } // namespace qcc
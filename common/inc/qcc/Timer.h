@@ -46,6 +46,15 @@ class Timer {
 
   public:
 
+    /**
+     * How a timer keeps its pending alarms.
+     */
+    typedef enum {
+        ALARM_SET,      /**< Ordered set, adding or removing an alarm is O(log n) */
+        TIMING_WHEEL    /**< Hierarchical timing wheel with millisecond ticks, adding or removing an alarm is O(1).
+                             An alarm can only be pending on one such timer at a time. */
+    } AlarmQueueType;
+
     /**
      * Constructor
      *
@@ -54,8 +63,10 @@ class Timer {
      * @param concurrency         Dispatch up to this number of alarms concurently (using multiple threads).
      * @param prevenReentrancy   Prevent re-entrant call of AlarmTriggered.
      * @param maxAlarms          Maximum number of outstanding alarms allowed before blocking calls to AddAlarm or 0 for infinite.
+     * @param queueType          How the pending alarms are kept.
      */
-    Timer(qcc::String name, bool expireOnExit = false, uint32_t concurrency = 1, bool preventReentrancy = false, uint32_t maxAlarms = 0);
+    Timer(qcc::String name, bool expireOnExit = false, uint32_t concurrency = 1, bool preventReentrancy = false, uint32_t maxAlarms = 0,
+          AlarmQueueType queueType = ALARM_SET);
 
     /**
      * Destructor.
@@ -116,6 +116,12 @@ class Event {
      * For portable uses of this method consider ER_OK and ER_TIMEOUT as
      * indicating success.
      *
+     * On Linux builds with QCC_EVENT_EPOLL defined (scons EVENT_EPOLL=on) each
+     * waiting thread keeps its own epoll set, which only changes when the
+     * events passed in change, and there is no limit on file descriptor
+     * numbers.  Other builds use select() and are limited to descriptors
+     * below FD_SETSIZE.
+     *
      * @param checkEvents    Vector of event object references to wait on.
      * @param signaledEvents Vector of event object references from checkEvents that are signaled.
      * @param maxMs          Max number of milliseconds to wait or WAIT_FOREVER to wait forever.
@@ -192,6 +198,16 @@ class Event {
      */
     SocketFd GetFD() { return ioFd; }
 
+    /**
+     * Indicate whether the state of this event is determined solely by its
+     * I/O file descriptor, i.e. it is an I/O event without a general purpose
+     * file descriptor attached.  Only such events can be registered directly
+     * with an OS-level poller such as epoll.
+     *
+     * @return  true iff the event is backed only by its I/O file descriptor.
+     */
+    bool IsIOOnly() const { return ((eventType == IO_READ) || (eventType == IO_WRITE)) && (fd < 0) && (0 <= ioFd); }
+
     /**
      * Get the underlying event type.
      *
@@ -219,6 +235,7 @@ class Event {
     uint32_t timestamp;     /**< time for next triggering of TIMED Event */
     uint32_t period;        /**< Number of milliseconds between periodic timed events */
     volatile int32_t numThreads; /**< Number of threads currently waiting on this event */
+    uint32_t serial;        /**< Distinguishes this event from earlier events that used the same file descriptors */
 
     /**
      * Protected copy constructor.
@@ -146,6 +146,15 @@ uint32_t GetTimestamp();
  */
 uint64_t GetTimestamp64();
 
+/**
+ * Gets the current time in microseconds, relative to some unspecified
+ * starting time.  Unlike GetTimestamp64() this is precise enough to time
+ * short operations on every platform.
+ *
+ * @return The time in microseconds.
+ */
+uint64_t GetTimestampMicros();
+
 /**
  * Gets the current time in milliseconds since the Epoch.
  *
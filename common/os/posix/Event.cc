@@ -24,6 +24,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <pthread.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
 #include <vector>
@@ -43,6 +44,14 @@
 #include <sys/eventfd.h>
 #endif
 
+#if defined(QCC_EVENT_EPOLL)
+#include <algorithm>
+#include <map>
+#include <poll.h>
+#include <sys/epoll.h>
+#endif
+
+#include <qcc/atomic.h>
 #include <qcc/Mutex.h>
 #include <qcc/Stream.h>
 #include <qcc/Thread.h>
@@ -63,6 +72,7 @@ using namespace qcc;
 static uint64_t _alwaysSet[RequiredArrayLength(sizeof(Event), uint64_t)];
 static uint64_t _neverSet[RequiredArrayLength(sizeof(Event), uint64_t)];
 static bool initialized = false;
+static volatile int32_t nextSerial = 0;
 
 Event& Event::alwaysSet = (Event&)_alwaysSet;
 Event& Event::neverSet = (Event&)_neverSet;
@@ -191,6 +201,78 @@ QStatus Event::Wait(Event& evt, uint32_t maxWaitMs)
         return ER_FAIL;
     }
 }
+#elif defined(QCC_EVENT_EPOLL)
+QStatus Event::Wait(Event& evt, uint32_t maxWaitMs)
+{
+    struct pollfd fds[3];
+    nfds_t numFds = 0;
+    int timeout = (maxWaitMs == WAIT_FOREVER) ? -1 : static_cast<int>(maxWaitMs);
+
+    Thread* thread = Thread::GetThread();
+
+    if (evt.eventType == TIMED) {
+        uint32_t now = GetTimestamp();
+        if (evt.timestamp <= now) {
+            if (0 < evt.period) {
+                evt.timestamp += (((now - evt.timestamp) / evt.period) + 1) * evt.period;
+            }
+            return ER_OK;
+        } else if ((timeout < 0) || ((evt.timestamp - now) < static_cast<uint32_t>(timeout))) {
+            timeout = static_cast<int>(evt.timestamp - now);
+        }
+    } else {
+        short events = (evt.eventType == IO_WRITE) ? POLLOUT : POLLIN;
+        if (0 <= evt.fd) {
+            fds[numFds].fd = evt.fd;
+            fds[numFds].events = events;
+            ++numFds;
+        }
+        if (0 <= evt.ioFd) {
+            fds[numFds].fd = evt.ioFd;
+            fds[numFds].events = events;
+            ++numFds;
+        }
+    }
+
+    nfds_t evtFds = numFds;
+    if (thread) {
+        fds[numFds].fd = thread->GetStopEvent().fd;
+        fds[numFds].events = POLLIN;
+        ++numFds;
+    }
+    for (nfds_t i = 0; i < numFds; ++i) {
+        fds[i].revents = 0;
+    }
+
+    evt.IncrementNumThreads();
+
+    int ret = poll(fds, numFds, timeout);
+
+    evt.DecrementNumThreads();
+
+    if (ret < 0) {
+        return ER_FAIL;
+    }
+    if (thread && fds[evtFds].revents) {
+        return thread->IsStopping() ? ER_STOPPING_THREAD : ER_ALERTED_THREAD;
+    } else if (evt.eventType == TIMED) {
+        uint32_t now = GetTimestamp();
+        if (now >= evt.timestamp) {
+            if (0 < evt.period) {
+                evt.timestamp += (((now - evt.timestamp) / evt.period) + 1) * evt.period;
+            }
+            return ER_OK;
+        } else {
+            return ER_TIMEOUT;
+        }
+    }
+    for (nfds_t i = 0; i < evtFds; ++i) {
+        if (fds[i].revents) {
+            return ER_OK;
+        }
+    }
+    return ER_TIMEOUT;
+}
 #else
 QStatus Event::Wait(Event& evt, uint32_t maxWaitMs)
 {
@@ -376,6 +458,268 @@ QStatus Event::Wait(const vector<Event*>& checkEvents, vector<Event*>& signaledE
         return ER_OS_ERROR;
     }
 }
+#elif defined(QCC_EVENT_EPOLL)
+
+/*
+ * The epoll set of a waiting thread along with what is registered in it.
+ */
+struct EpollWaiter {
+    /* What one file descriptor is registered for */
+    struct Registration {
+        uint32_t events;                /* EPOLLIN and/or EPOLLOUT */
+        std::vector<uint32_t> owners;   /* Sorted serials of the events that use the descriptor */
+    };
+
+    /* A file descriptor one of the events being waited on uses */
+    struct Wanted {
+        int fd;
+        uint32_t events;
+        uint32_t owner;
+        bool operator<(const Wanted& other) const { return (fd < other.fd) || ((fd == other.fd) && (owner < other.owner)); }
+    };
+
+    int epfd;
+    std::map<int, Registration> registered;
+
+    /* The events of the last wait, the epoll set is left alone while they stay the same */
+    std::vector<std::pair<Event*, uint32_t> > lastEvents;
+
+    /* Kept between calls to save allocating on every wait */
+    std::vector<Wanted> wanted;
+    std::vector<struct epoll_event> ready;
+
+    EpollWaiter() : epfd(epoll_create1(EPOLL_CLOEXEC)) { }
+    ~EpollWaiter()
+    {
+        if (0 <= epfd) {
+            close(epfd);
+        }
+    }
+
+    /* Make the epoll set match wanted, which must be sorted */
+    void Update();
+
+    /* Check whether wanted[first, last) are exactly the owners of a registration */
+    bool SameOwners(const Registration& reg, size_t first, size_t last) const;
+
+    /* Make wanted[first, last) the owners of a registration */
+    void SetOwners(Registration& reg, size_t first, size_t last) const;
+
+    /* Get the ready events of a file descriptor after epoll_wait() returned numReady entries in ready */
+    uint32_t ReadyEvents(int fd, int numReady) const;
+};
+
+bool EpollWaiter::SameOwners(const Registration& reg, size_t first, size_t last) const
+{
+    if (reg.owners.size() != (last - first)) {
+        return false;
+    }
+    for (size_t i = first; i < last; ++i) {
+        if (reg.owners[i - first] != wanted[i].owner) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void EpollWaiter::SetOwners(Registration& reg, size_t first, size_t last) const
+{
+    reg.owners.clear();
+    for (size_t i = first; i < last; ++i) {
+        reg.owners.push_back(wanted[i].owner);
+    }
+}
+
+void EpollWaiter::Update()
+{
+    std::map<int, Registration>::iterator reg = registered.begin();
+    size_t i = 0;
+    while (i < wanted.size()) {
+        /* Merge the entries for a descriptor used by several events */
+        int fd = wanted[i].fd;
+        size_t first = i;
+        uint32_t events = 0;
+        for (; (i < wanted.size()) && (wanted[i].fd == fd); ++i) {
+            events |= wanted[i].events;
+        }
+
+        /* Drop registrations for descriptors that are no longer wanted */
+        while ((reg != registered.end()) && (reg->first < fd)) {
+            epoll_ctl(epfd, EPOLL_CTL_DEL, reg->first, NULL);
+            registered.erase(reg++);
+        }
+
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = events;
+        ev.data.fd = fd;
+        if ((reg != registered.end()) && (reg->first == fd)) {
+            if (!SameOwners(reg->second, first, i)) {
+                /*
+                 * Different events use this descriptor number so the file it was
+                 * registered for may have been closed, which removes it from the
+                 * epoll set, and the number reused.
+                 */
+                if ((epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) != 0) && (errno == EEXIST)) {
+                    epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &ev);
+                }
+                SetOwners(reg->second, first, i);
+            } else if (reg->second.events != events) {
+                if ((epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &ev) != 0) && (errno == ENOENT)) {
+                    epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+                }
+            }
+            reg->second.events = events;
+            ++reg;
+        } else {
+            if ((epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) != 0) && (errno == EEXIST)) {
+                epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &ev);
+            }
+            Registration& added = registered.insert(reg, std::make_pair(fd, Registration()))->second;
+            added.events = events;
+            SetOwners(added, first, i);
+        }
+    }
+    while (reg != registered.end()) {
+        epoll_ctl(epfd, EPOLL_CTL_DEL, reg->first, NULL);
+        registered.erase(reg++);
+    }
+}
+
+uint32_t EpollWaiter::ReadyEvents(int fd, int numReady) const
+{
+    for (int i = 0; i < numReady; ++i) {
+        if (ready[i].data.fd == fd) {
+            /* Like select(), errors and hang ups make a descriptor both readable and writable */
+            uint32_t events = ready[i].events;
+            if (events & (EPOLLERR | EPOLLHUP)) {
+                events |= EPOLLIN | EPOLLOUT;
+            }
+            return events;
+        }
+    }
+    return 0;
+}
+
+static pthread_key_t epollWaiterKey;
+static pthread_once_t epollWaiterOnce = PTHREAD_ONCE_INIT;
+
+static void DeleteEpollWaiter(void* waiter)
+{
+    delete static_cast<EpollWaiter*>(waiter);
+}
+
+static void CreateEpollWaiterKey()
+{
+    pthread_key_create(&epollWaiterKey, DeleteEpollWaiter);
+}
+
+/*
+ * Get the calling thread's epoll set, creating it on first use.  It is closed
+ * when the thread exits.
+ */
+static EpollWaiter* GetEpollWaiter()
+{
+    pthread_once(&epollWaiterOnce, CreateEpollWaiterKey);
+    EpollWaiter* waiter = static_cast<EpollWaiter*>(pthread_getspecific(epollWaiterKey));
+    if (!waiter) {
+        waiter = new EpollWaiter();
+        if (waiter->epfd < 0) {
+            QCC_LogError(ER_OS_ERROR, ("epoll_create1 failed with %d (%s)", errno, strerror(errno)));
+            delete waiter;
+            return NULL;
+        }
+        pthread_setspecific(epollWaiterKey, waiter);
+    }
+    return waiter;
+}
+
+QStatus Event::Wait(const vector<Event*>& checkEvents, vector<Event*>& signaledEvents, uint32_t maxWaitMs)
+{
+    EpollWaiter* waiter = GetEpollWaiter();
+    if (!waiter) {
+        return ER_OS_ERROR;
+    }
+
+    int timeout = (maxWaitMs == WAIT_FOREVER) ? -1 : static_cast<int>(maxWaitMs);
+    vector<Event*>::const_iterator it;
+
+    bool changed = (checkEvents.size() != waiter->lastEvents.size());
+    for (size_t i = 0; !changed && (i < checkEvents.size()); ++i) {
+        changed = (checkEvents[i] != waiter->lastEvents[i].first) || (checkEvents[i]->serial != waiter->lastEvents[i].second);
+    }
+    if (changed) {
+        waiter->lastEvents.clear();
+        waiter->wanted.clear();
+    }
+
+    for (it = checkEvents.begin(); it != checkEvents.end(); ++it) {
+        Event* evt = *it;
+        evt->IncrementNumThreads();
+        if (changed) {
+            waiter->lastEvents.push_back(std::make_pair(evt, evt->serial));
+        }
+        if (evt->eventType == TIMED) {
+            uint32_t now = GetTimestamp();
+            if (evt->timestamp <= now) {
+                timeout = 0;
+            } else if ((timeout < 0) || ((evt->timestamp - now) < static_cast<uint32_t>(timeout))) {
+                timeout = static_cast<int>(evt->timestamp - now);
+            }
+        } else if (changed) {
+            EpollWaiter::Wanted wanted;
+            wanted.events = (evt->eventType == IO_WRITE) ? EPOLLOUT : EPOLLIN;
+            wanted.owner = evt->serial;
+            if (0 <= evt->fd) {
+                wanted.fd = evt->fd;
+                waiter->wanted.push_back(wanted);
+            }
+            if (0 <= evt->ioFd) {
+                wanted.fd = evt->ioFd;
+                waiter->wanted.push_back(wanted);
+            }
+        }
+    }
+    if (changed) {
+        std::sort(waiter->wanted.begin(), waiter->wanted.end());
+        waiter->Update();
+        waiter->ready.resize(std::max(waiter->registered.size(), static_cast<size_t>(1)));
+    }
+
+    int ret = epoll_wait(waiter->epfd, &waiter->ready[0], static_cast<int>(waiter->ready.size()), timeout);
+    if ((ret < 0) && (errno == EINTR)) {
+        ret = 0;
+    }
+
+    if (0 <= ret) {
+        for (it = checkEvents.begin(); it != checkEvents.end(); ++it) {
+            Event* evt = *it;
+            evt->DecrementNumThreads();
+            if (evt->eventType == TIMED) {
+                uint32_t now = GetTimestamp();
+                if (evt->timestamp <= now) {
+                    signaledEvents.push_back(evt);
+                    if (0 < evt->period) {
+                        evt->timestamp += (((now - evt->timestamp) / evt->period) + 1) * evt->period;
+                    }
+                }
+            } else if (0 < ret) {
+                uint32_t events = (evt->eventType == IO_WRITE) ? EPOLLOUT : EPOLLIN;
+                if (((0 <= evt->fd) && (waiter->ReadyEvents(evt->fd, ret) & events)) ||
+                    ((0 <= evt->ioFd) && (waiter->ReadyEvents(evt->ioFd, ret) & events))) {
+                    signaledEvents.push_back(evt);
+                }
+            }
+        }
+        return signaledEvents.empty() ? ER_TIMEOUT : ER_OK;
+    } else {
+        for (it = checkEvents.begin(); it != checkEvents.end(); ++it) {
+            (*it)->DecrementNumThreads();
+        }
+        QCC_LogError(ER_FAIL, ("epoll_wait failed with %d (%s)", errno, strerror(errno)));
+        return ER_FAIL;
+    }
+}
 #else
 QStatus Event::Wait(const vector<Event*>& checkEvents, vector<Event*>& signaledEvents, uint32_t maxWaitMs)
 {
@@ -731,18 +1075,18 @@ static QStatus ResetMechanism(int efd)
 
 #endif // defined(MECHANISM_EVENTFD)
 
-Event::Event() : fd(-1), signalFd(-1), ioFd(-1), eventType(GEN_PURPOSE), numThreads(0)
+Event::Event() : fd(-1), signalFd(-1), ioFd(-1), eventType(GEN_PURPOSE), numThreads(0), serial(IncrementAndFetch(&nextSerial))
 {
     CreateMechanism(&fd, &signalFd);
 }
 
 Event::Event(SocketFd ioFd, EventType eventType)
-    : fd(-1), signalFd(-1), ioFd(ioFd), eventType(eventType), timestamp(0), period(0), numThreads(0)
+    : fd(-1), signalFd(-1), ioFd(ioFd), eventType(eventType), timestamp(0), period(0), numThreads(0), serial(IncrementAndFetch(&nextSerial))
 {
 }
 
 Event::Event(Event& event, EventType eventType, bool genPurpose)
-    : fd(-1), signalFd(-1), ioFd(event.ioFd), eventType(eventType), timestamp(0), period(0), numThreads(0)
+    : fd(-1), signalFd(-1), ioFd(event.ioFd), eventType(eventType), timestamp(0), period(0), numThreads(0), serial(IncrementAndFetch(&nextSerial))
 {
     if (genPurpose) {
         CreateMechanism(&fd, &signalFd);
@@ -756,7 +1100,8 @@ Event::Event(uint32_t timestamp, uint32_t period)
     eventType(TIMED),
     timestamp(WAIT_FOREVER == timestamp ? WAIT_FOREVER : GetTimestamp() + timestamp),
     period(period),
-    numThreads(0)
+    numThreads(0),
+    serial(IncrementAndFetch(&nextSerial))
 {
 }
 
@@ -30,6 +30,7 @@
 #include <algorithm>
 #include <arpa/inet.h>
 #include <netinet/tcp.h>
+#include <netinet/udp.h>
 #include <net/if.h>
 #include <errno.h>
 #include <fcntl.h>
@@ -41,6 +42,7 @@
 #include <sys/un.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
+#include <vector>
 #if defined(QCC_OS_DARWIN)
 #include <sys/ucred.h>
 #endif
@@ -54,6 +56,10 @@
 
 #define QCC_MODULE "NETWORK"
 
+#if defined(QCC_OS_LINUX) && !defined(UDP_SEGMENT)
+#define UDP_SEGMENT 103
+#endif
+
 namespace qcc {
 
 const SocketFd INVALID_SOCKET_FD = -1;
@@ -557,6 +563,36 @@ QStatus Send(SocketFd sockfd, const void* buf, size_t len, size_t& sent)
     return status;
 }
 
+QStatus SendV(SocketFd sockfd, const IOVec* iov, size_t numIov, size_t& sent)
+{
+    QStatus status = ER_OK;
+
+    QCC_DbgTrace(("SendV(sockfd = %d, *iov = <>, numIov = %lu, sent = <>)", sockfd, numIov));
+    IncrementPerfCounter(PERF_COUNTER_SOCKET_SEND);
+
+    if (numIov == 0) {
+        return ER_BAD_ARG_3;
+    }
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = reinterpret_cast<struct iovec*>(const_cast<IOVec*>(iov));
+    msg.msg_iovlen = numIov;
+
+    ssize_t ret = sendmsg(static_cast<int>(sockfd), &msg, MSG_NOSIGNAL);
+    if (ret == -1) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            status = ER_WOULDBLOCK;
+        } else {
+            status = ER_OS_ERROR;
+            QCC_DbgHLPrintf(("SendV (sockfd = %u): %d - %s", sockfd, errno, strerror(errno)));
+        }
+    } else {
+        sent = static_cast<size_t>(ret);
+    }
+    return status;
+}
+
 QStatus SendTo(SocketFd sockfd, IPAddress& remoteAddr, uint16_t remotePort, uint32_t scopeId,
                const void* buf, size_t len, size_t& sent, SendMsgFlags flags)
 {
@@ -748,6 +784,245 @@ QStatus RecvWithAncillaryData(SocketFd sockfd, IPAddress& remoteAddr, uint16_t&
     return status;
 }
 
+#if defined(QCC_OS_LINUX)
+
+/*
+ * Upper bounds on a single sendmmsg()/recvmmsg() call, and on the number of
+ * datagrams the kernel will split a single UDP segmentation offload send into.
+ */
+static const size_t MMSG_BATCH_MAX = 64;
+static const size_t UDP_GSO_SEGMENTS_MAX = 64;
+static const size_t UDP_GSO_BYTES_MAX = 65507;
+
+/*
+ * UDP segmentation offload is available from Linux 4.18.  Older kernels
+ * silently ignore the UDP_SEGMENT control message and would send the whole
+ * run as one oversized datagram, so support is probed with getsockopt() before
+ * it is first used: 1 if supported, 0 if not and -1 if not yet known.
+ */
+static volatile int32_t udpGsoSupport = -1;
+
+static bool UdpGsoSupported(SocketFd sockfd)
+{
+    if (udpGsoSupport < 0) {
+        int gsoSize = 0;
+        socklen_t optLen = sizeof(gsoSize);
+        udpGsoSupport = (getsockopt(static_cast<int>(sockfd), SOL_UDP, UDP_SEGMENT, &gsoSize, &optLen) == 0) ? 1 : 0;
+        QCC_DbgPrintf(("UdpGsoSupported(): UDP segmentation offload %s", udpGsoSupport ? "available" : "not available"));
+    }
+    return udpGsoSupport == 1;
+}
+
+static size_t DatagramSize(const SendToEntry& entry)
+{
+    size_t size = 0;
+    for (size_t i = 0; i < entry.numIov; ++i) {
+        size += entry.iov[i].len;
+    }
+    return size;
+}
+
+QStatus SendToBatch(SocketFd sockfd, const SendToEntry* entries, size_t numEntries, size_t& numSent,
+                    SendMsgFlags flags)
+{
+    QStatus status = ER_OK;
+    QCC_DbgTrace(("SendToBatch(sockfd = %d, entries, numEntries = %u, numSent = <>, flags = 0x%x)",
+                  sockfd, numEntries, (int) flags));
+
+    numSent = 0;
+    while (numSent < numEntries) {
+        struct mmsghdr msgs[MMSG_BATCH_MAX];
+        struct sockaddr_storage addrs[MMSG_BATCH_MAX];
+        size_t counts[MMSG_BATCH_MAX];
+        union {
+            char buf[CMSG_SPACE(sizeof(uint16_t))];
+            struct cmsghdr align;
+        } controls[MMSG_BATCH_MAX];
+        std::vector<struct iovec> iov;
+        size_t iovStart[MMSG_BATCH_MAX];
+        bool gso = UdpGsoSupported(sockfd);
+
+        /*
+         * Build up to MMSG_BATCH_MAX messages.  With segmentation offload a
+         * message carries a run of datagrams to the same remote host that all
+         * have the size of the first, except that the last may be shorter.
+         */
+        size_t numMsgs = 0;
+        size_t next = numSent;
+        while (next < numEntries && numMsgs < MMSG_BATCH_MAX) {
+            const SendToEntry& first = entries[next];
+            size_t segSize = DatagramSize(first);
+            size_t total = 0;
+            size_t count = 0;
+            iovStart[numMsgs] = iov.size();
+            do {
+                const SendToEntry& entry = entries[next + count];
+                size_t size = DatagramSize(entry);
+                for (size_t i = 0; i < entry.numIov; ++i) {
+                    struct iovec v;
+                    v.iov_base = entry.iov[i].buf;
+                    v.iov_len = entry.iov[i].len;
+                    iov.push_back(v);
+                }
+                total += size;
+                ++count;
+                if (!gso || (size != segSize) || (count == UDP_GSO_SEGMENTS_MAX) || (next + count == numEntries)) {
+                    break;
+                }
+                const SendToEntry& candidate = entries[next + count];
+                size_t candidateSize = DatagramSize(candidate);
+                if ((*candidate.remoteAddr != *first.remoteAddr) || (candidate.remotePort != first.remotePort) ||
+                    (candidateSize > segSize) || (total + candidateSize > UDP_GSO_BYTES_MAX)) {
+                    break;
+                }
+            } while (true);
+
+            struct msghdr& msg = msgs[numMsgs].msg_hdr;
+            memset(&msg, 0, sizeof(msg));
+            socklen_t addrLen = sizeof(addrs[numMsgs]);
+            status = MakeSockAddr(*first.remoteAddr, first.remotePort, &addrs[numMsgs], addrLen);
+            if (status != ER_OK) {
+                return status;
+            }
+            msg.msg_name = &addrs[numMsgs];
+            msg.msg_namelen = addrLen;
+            msg.msg_iovlen = iov.size() - iovStart[numMsgs];
+            if (count > 1) {
+                msg.msg_control = controls[numMsgs].buf;
+                msg.msg_controllen = sizeof(controls[numMsgs].buf);
+                struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+                cmsg->cmsg_level = SOL_UDP;
+                cmsg->cmsg_type = UDP_SEGMENT;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                uint16_t gsoSize = static_cast<uint16_t>(segSize);
+                memcpy(CMSG_DATA(cmsg), &gsoSize, sizeof(gsoSize));
+            }
+            counts[numMsgs] = count;
+            next += count;
+            ++numMsgs;
+        }
+
+        /* The iovec array is complete, so its addresses are now stable */
+        for (size_t i = 0; i < numMsgs; ++i) {
+            msgs[i].msg_hdr.msg_iov = &iov[iovStart[i]];
+        }
+
+        int ret = sendmmsg(static_cast<int>(sockfd), msgs, numMsgs, (int)flags | MSG_NOSIGNAL);
+        if (ret == -1) {
+            if (errno == EAGAIN || errno == EINTR || errno == EWOULDBLOCK) {
+                return ER_WOULDBLOCK;
+            }
+            if (gso && (errno == EIO || errno == EINVAL) && counts[0] > 1) {
+                /*
+                 * The socket or the device it routes over cannot offload
+                 * segmentation (e.g. no checksum offload); stop trying.
+                 */
+                QCC_DbgPrintf(("SendToBatch(): UDP segmentation offload rejected (%d - %s)", errno, strerror(errno)));
+                udpGsoSupport = 0;
+                continue;
+            }
+            status = ER_OS_ERROR;
+            QCC_LogError(status, ("SendToBatch (sockfd = %u): %d - %s", sockfd, errno, strerror(errno)));
+            return status;
+        }
+        for (int i = 0; i < ret; ++i) {
+            numSent += counts[i];
+        }
+    }
+    return status;
+}
+
+QStatus RecvFromBatch(SocketFd sockfd, RecvFromEntry* entries, size_t numEntries, size_t& numReceived)
+{
+    struct mmsghdr msgs[MMSG_BATCH_MAX];
+    struct sockaddr_storage addrs[MMSG_BATCH_MAX];
+    struct iovec iov[MMSG_BATCH_MAX];
+    QCC_DbgTrace(("RecvFromBatch(sockfd = %d, entries, numEntries = %u, numReceived = <>)", sockfd, numEntries));
+
+    numReceived = 0;
+    numEntries = std::min(numEntries, MMSG_BATCH_MAX);
+    memset(msgs, 0, numEntries * sizeof(msgs[0]));
+    for (size_t i = 0; i < numEntries; ++i) {
+        iov[i].iov_base = entries[i].buf;
+        iov[i].iov_len = entries[i].len;
+        msgs[i].msg_hdr.msg_name = &addrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int ret = recvmmsg(static_cast<int>(sockfd), msgs, numEntries, MSG_WAITFORONE, NULL);
+    if (ret == -1) {
+        QCC_DbgHLPrintf(("RecvFromBatch (sockfd = %u): %d - %s", sockfd, errno, strerror(errno)));
+        return ER_OS_ERROR;
+    }
+
+    for (int i = 0; i < ret; ++i) {
+        RecvFromEntry& entry = entries[i];
+        entry.received = msgs[i].msg_len;
+        GetSockAddr(&addrs[i], msgs[i].msg_hdr.msg_namelen, entry.remoteAddr, entry.remotePort);
+        QCC_DbgPrintf(("Received %u bytes, remoteAddr = %s, remotePort = %u",
+                       entry.received, entry.remoteAddr.ToString().c_str(), entry.remotePort));
+        QCC_DbgRemoteData(entry.buf, entry.received);
+    }
+    numReceived = static_cast<size_t>(ret);
+    return ER_OK;
+}
+
+#else
+
+QStatus SendToBatch(SocketFd sockfd, const SendToEntry* entries, size_t numEntries, size_t& numSent,
+                    SendMsgFlags flags)
+{
+    QStatus status = ER_OK;
+    QCC_DbgTrace(("SendToBatch(sockfd = %d, entries, numEntries = %u, numSent = <>, flags = 0x%x)",
+                  sockfd, numEntries, (int) flags));
+
+    for (numSent = 0; numSent < numEntries; ++numSent) {
+        const SendToEntry& entry = entries[numSent];
+        struct sockaddr_storage addr;
+        socklen_t addrLen = sizeof(addr);
+        status = MakeSockAddr(*entry.remoteAddr, entry.remotePort, &addr, addrLen);
+        if (status != ER_OK) {
+            break;
+        }
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_name = &addr;
+        msg.msg_namelen = addrLen;
+        /* IOVec matches struct iovec for direct casting */
+        msg.msg_iov = reinterpret_cast<struct iovec*>(const_cast<IOVec*>(entry.iov));
+        msg.msg_iovlen = entry.numIov;
+        if (sendmsg(static_cast<int>(sockfd), &msg, (int)flags | MSG_NOSIGNAL) == -1) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                status = ER_WOULDBLOCK;
+            } else {
+                status = ER_OS_ERROR;
+                QCC_DbgHLPrintf(("SendToBatch (sockfd = %u): %d - %s", sockfd, errno, strerror(errno)));
+            }
+            break;
+        }
+    }
+    return status;
+}
+
+QStatus RecvFromBatch(SocketFd sockfd, RecvFromEntry* entries, size_t numEntries, size_t& numReceived)
+{
+    QStatus status = ER_OK;
+    QCC_DbgTrace(("RecvFromBatch(sockfd = %d, entries, numEntries = %u, numReceived = <>)", sockfd, numEntries));
+
+    for (numReceived = 0; numReceived < numEntries; ++numReceived) {
+        RecvFromEntry& entry = entries[numReceived];
+        status = RecvFrom(sockfd, entry.remoteAddr, entry.remotePort, entry.buf, entry.len, entry.received);
+        if (status != ER_OK) {
+            break;
+        }
+    }
+    return (numReceived > 0) ? ER_OK : status;
+}
+
+#endif
+
 QStatus RecvWithFds(SocketFd sockfd, void* buf, size_t len, size_t& received, SocketFd* fdList, size_t maxFds, size_t& recvdFds)
 {
     QStatus status = ER_OK;
@@ -89,6 +89,13 @@ uint64_t qcc::GetTimestamp64(void)
     return ret_val;
 }
 
+uint64_t qcc::GetTimestampMicros(void)
+{
+    struct timespec ts;
+    platform_gettime(&ts, true);
+    return ((uint64_t)ts.tv_sec * 1000000) + ((uint64_t)ts.tv_nsec / 1000);
+}
+
 uint64_t qcc::GetEpochTimestamp(void)
 {
     struct timespec ts;
@@ -435,6 +435,35 @@ QStatus Send(SocketFd sockfd, const void* buf, size_t len, size_t& sent)
     return status;
 }
 
+QStatus SendV(SocketFd sockfd, const IOVec* iov, size_t numIov, size_t& sent)
+{
+    QStatus status = ER_OK;
+    DWORD numSent = 0;
+
+    QCC_DbgTrace(("SendV(sockfd = %d, *iov = <>, numIov = %lu, sent = <>)", sockfd, numIov));
+    IncrementPerfCounter(PERF_COUNTER_SOCKET_SEND);
+
+    if (numIov == 0) {
+        return ER_BAD_ARG_3;
+    }
+
+    int ret = WSASend(static_cast<SOCKET>(sockfd), reinterpret_cast<LPWSABUF>(const_cast<IOVec*>(iov)),
+                      static_cast<DWORD>(numIov), &numSent, 0, NULL, NULL);
+    if (ret == SOCKET_ERROR) {
+        if (WSAGetLastError() == WSAEWOULDBLOCK) {
+            sent = 0;
+            status = ER_WOULDBLOCK;
+        } else {
+            status = ER_OS_ERROR;
+            QCC_DbgHLPrintf(("SendV: %s", GetLastErrorString().c_str()));
+        }
+    } else {
+        sent = static_cast<size_t>(numSent);
+        QCC_DbgPrintf(("Sent %u bytes", sent));
+    }
+    return status;
+}
+
 QStatus SendTo(SocketFd sockfd, IPAddress& remoteAddr, uint16_t remotePort, uint32_t scopeId,
                const void* buf, size_t len, size_t& sent, SendMsgFlags flags)
 {
@@ -606,6 +635,50 @@ QStatus RecvWithAncillaryData(SocketFd sockfd, IPAddress& remoteAddr, uint16_t&
     return status;
 }
 
+QStatus SendToBatch(SocketFd sockfd, const SendToEntry* entries, size_t numEntries, size_t& numSent,
+                    SendMsgFlags flags)
+{
+    QStatus status = ER_OK;
+    QCC_DbgTrace(("SendToBatch(sockfd = %d, entries, numEntries = %u, numSent = <>, flags = 0x%x)",
+                  sockfd, numEntries, (int) flags));
+
+    for (numSent = 0; numSent < numEntries; ++numSent) {
+        const SendToEntry& entry = entries[numSent];
+        SOCKADDR_STORAGE addr;
+        socklen_t addrLen = sizeof(addr);
+        DWORD sent = 0;
+        MakeSockAddr(*entry.remoteAddr, entry.remotePort, &addr, addrLen);
+        int ret = WSASendTo(static_cast<SOCKET>(sockfd), reinterpret_cast<LPWSABUF>(const_cast<IOVec*>(entry.iov)),
+                            static_cast<DWORD>(entry.numIov), &sent, (int)flags,
+                            reinterpret_cast<struct sockaddr*>(&addr), addrLen, NULL, NULL);
+        if (ret == SOCKET_ERROR) {
+            if (WSAGetLastError() == WSAEWOULDBLOCK) {
+                status = ER_WOULDBLOCK;
+            } else {
+                status = ER_OS_ERROR;
+                QCC_DbgHLPrintf(("SendToBatch: %s", GetLastErrorString().c_str()));
+            }
+            break;
+        }
+    }
+    return status;
+}
+
+QStatus RecvFromBatch(SocketFd sockfd, RecvFromEntry* entries, size_t numEntries, size_t& numReceived)
+{
+    QStatus status = ER_OK;
+    QCC_DbgTrace(("RecvFromBatch(sockfd = %d, entries, numEntries = %u, numReceived = <>)", sockfd, numEntries));
+
+    for (numReceived = 0; numReceived < numEntries; ++numReceived) {
+        RecvFromEntry& entry = entries[numReceived];
+        status = RecvFrom(sockfd, entry.remoteAddr, entry.remotePort, entry.buf, entry.len, entry.received);
+        if (status != ER_OK) {
+            break;
+        }
+    }
+    return (numReceived > 0) ? ER_OK : status;
+}
+
 QStatus RecvFrom(SocketFd sockfd, IPAddress& remoteAddr, uint16_t& remotePort,
                  void* buf, size_t len, size_t& received)
 {
@@ -43,6 +43,18 @@ uint64_t qcc::GetTimestamp64(void)
     return (current_count - base_count);
 }
 
+uint64_t qcc::GetTimestampMicros(void)
+{
+    static LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER count;
+    if (frequency.QuadPart == 0) {
+        ::QueryPerformanceFrequency(&frequency);
+    }
+    ::QueryPerformanceCounter(&count);
+    return ((uint64_t)(count.QuadPart / frequency.QuadPart) * 1000000) +
+           (((uint64_t)(count.QuadPart % frequency.QuadPart) * 1000000) / frequency.QuadPart);
+}
+
 uint64_t qcc::GetEpochTimestamp(void)
 {
     struct __timeb64 time_buffer;
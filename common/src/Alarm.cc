@@ -31,17 +31,17 @@ using namespace qcc;
 
 volatile int32_t qcc::_Alarm::nextId = 0;
 
-_Alarm::_Alarm() : listener(NULL), periodMs(0), context(NULL), id(IncrementAndFetch(&nextId)), limitable(true)
+_Alarm::_Alarm() : listener(NULL), periodMs(0), context(NULL), id(IncrementAndFetch(&nextId)), limitable(true), wheelEntry(NULL)
 {
 }
 
 _Alarm::_Alarm(Timespec<MonotonicTime> relativeTime, AlarmListener* listener, void* context, uint32_t periodMs, bool limitable)
-    : alarmTime(relativeTime), listener(listener), periodMs(periodMs), context(context), id(IncrementAndFetch(&nextId)), limitable(limitable)
+    : alarmTime(relativeTime), listener(listener), periodMs(periodMs), context(context), id(IncrementAndFetch(&nextId)), limitable(limitable), wheelEntry(NULL)
 {
 }
 
 _Alarm::_Alarm(uint32_t relativeTime, AlarmListener* listener, void* context, uint32_t periodMs, bool limitable)
-    : alarmTime(), listener(listener), periodMs(periodMs), context(context), id(IncrementAndFetch(&nextId)), limitable(limitable)
+    : alarmTime(), listener(listener), periodMs(periodMs), context(context), id(IncrementAndFetch(&nextId)), limitable(limitable), wheelEntry(NULL)
 {
     if (relativeTime == WAIT_FOREVER) {
         alarmTime = Timespec<MonotonicTime>(END_OF_TIME);
@@ -52,7 +52,7 @@ _Alarm::_Alarm(uint32_t relativeTime, AlarmListener* listener, void* context, ui
 }
 
 _Alarm::_Alarm(AlarmListener* listener, void* context, bool limitable)
-    : alarmTime(0), listener(listener), periodMs(0), context(context), id(IncrementAndFetch(&nextId)), limitable(limitable)
+    : alarmTime(0), listener(listener), periodMs(0), context(context), id(IncrementAndFetch(&nextId)), limitable(limitable), wheelEntry(NULL)
 {
 }
 
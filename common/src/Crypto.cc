@@ -49,11 +49,15 @@ QStatus Crypto_PseudorandomFunction(const KeyBlob& secret, const char* label, co
     uint8_t digest[Crypto_SHA256::DIGEST_SIZE];
     size_t len = 0;
 
+    /*
+     * Initialize SHA256 in HMAC mode with the secret, GetMAC() keeps the key
+     * for the following iterations.
+     */
+    QStatus status = hash.Init(secret.GetData(), secret.GetSize());
+    if (status != ER_OK) {
+        return status;
+    }
     while (outLen) {
-        /*
-         * Initialize SHA256 in HMAC mode with the secret
-         */
-        hash.Init(secret.GetData(), secret.GetSize());
         /*
          * If this is not the first iteration hash in the digest from the previous iteration.
          */
@@ -62,12 +66,13 @@ QStatus Crypto_PseudorandomFunction(const KeyBlob& secret, const char* label, co
         }
         hash.Update((const uint8_t*)label, strlen(label));
         hash.Update(seed);
-        hash.GetDigest(digest);
+        hash.GetMAC(digest);
         len =  (std::min)(sizeof(digest), outLen);
         memcpy(out, digest, len);
         outLen -= len;
         out += len;
     }
+    ClearMemory(digest, sizeof(digest));
     return ER_OK;
 }
 
@@ -18,10 +18,14 @@
  ******************************************************************************/
 
 #include <stdlib.h>
+#include <memory>
+#include <qcc/Mutex.h>
 #include <qcc/Util.h>
 #include <qcc/CryptoECC.h>
 #include <qcc/CryptoECCp256.h>
 
+#include "CryptoECCp256GeneratorTable.h"
+
 namespace qcc {
 
 #define W_VARBASE 6     /* Parameter for scalar multiplication.  Should use 2-2.5 KB.  Must be >= 2. */
@@ -846,4 +850,390 @@ QStatus ec_scalarmul(const ecpoint_t* P, digit256_t k, ecpoint_t* Q, ec_t* curve
     return status;
 }
 
+
+/* Replaces each of the n elements of a with its inverse, using one field inversion (Montgomery's trick) */
+static QStatus fpinv_many_p256(digit256_t* a, size_t n)
+{
+    digit256_t* prefix;
+    digit256_t inv, t1, t2;
+    digit_t temps[P256_TEMPS];
+    size_t i;
+
+    prefix = (digit256_t*)malloc(n * sizeof(digit256_t));
+    if (prefix == NULL) {
+        return ER_OUT_OF_MEMORY;
+    }
+
+    fpcopy_p256(a[0], prefix[0]);
+    for (i = 1; i < n; i++) {
+        fpmul_p256(prefix[i - 1], a[i], prefix[i], temps);     /* prefix[i] = a[0]*...*a[i]  */
+    }
+    fpinv_p256(prefix[n - 1], inv, temps);                      /* inv = (a[0]*...*a[n-1])^-1  */
+    for (i = n - 1; i >= 1; i--) {
+        fpmul_p256(inv, prefix[i - 1], t1, temps);              /* t1 = a[i]^-1  */
+        fpmul_p256(inv, a[i], t2, temps);                       /* t2 = (a[0]*...*a[i-1])^-1  */
+        fpcopy_p256(t1, a[i]);
+        fpcopy_p256(t2, inv);
+    }
+    fpcopy_p256(inv, a[0]);
+
+    free(prefix);
+    return ER_OK;
+}
+
+/* Precomputation of a fixed-base table: table[i][j] = (2j+1) * 2^((W_FIXEDBASE-1)*i) * P in affine coordinates
+ * Weierstrass a=-3 curve
+ * The point P is public, so this function does not need to run in constant time.
+ */
+QStatus ec_fixedbase_precomp(const ecpoint_t* P, ec_fixedbase_table_t* table, ec_t* curve)
+{
+    ecpoint_jacobian_t B;
+    ecpoint_t base;
+    ecpoint_chudnovsky_t row[FIXEDBASE_POINTS];
+    digit256_t* z;
+    digit256_t t1, t2;
+    digit_t temps[P256_TEMPS];
+    size_t i, j;
+    QStatus status;
+
+    if (P == NULL || table == NULL || curve == NULL) {
+        return ER_INVALID_ADDRESS;
+    }
+    if (!ecpoint_validation(P, curve)) {
+        return ER_INVALID_DATA;
+    }
+
+    /* z holds the Z-coordinates of the window bases first, then those of all the points of the table */
+    z = (digit256_t*)malloc(FIXEDBASE_WINDOWS * FIXEDBASE_POINTS * sizeof(digit256_t));
+    if (z == NULL) {
+        return ER_OUT_OF_MEMORY;
+    }
+
+    /* Window bases B_i = 2^((W_FIXEDBASE-1)*i) * P, with (X:Y) kept in table[i][0] until Z is inverted */
+    ec_affine_tojacobian(P, &B);
+    for (i = 0; i < FIXEDBASE_WINDOWS; i++) {
+        if (i > 0) {
+            for (j = 0; j < (W_FIXEDBASE - 1); j++) {
+                ec_double_jacobian(&B);
+            }
+        }
+        fpcopy_p256(B.X, table->points[i][0].x);
+        fpcopy_p256(B.Y, table->points[i][0].y);
+        fpcopy_p256(B.Z, z[i]);
+    }
+    status = fpinv_many_p256(z, FIXEDBASE_WINDOWS);
+    if (status != ER_OK) {
+        goto Exit;
+    }
+    for (i = 0; i < FIXEDBASE_WINDOWS; i++) {
+        fpsqr_p256(z[i], t1, temps);                                /* t1 = Z^-2  */
+        fpmul_p256(table->points[i][0].x, t1, t2, temps);           /* t2 = X/Z^2  */
+        fpcopy_p256(t2, table->points[i][0].x);
+        fpmul_p256(t1, z[i], t2, temps);                            /* t2 = Z^-3  */
+        fpmul_p256(table->points[i][0].y, t2, t1, temps);           /* t1 = Y/Z^3  */
+        fpcopy_p256(t1, table->points[i][0].y);
+    }
+
+    /* Odd multiples of each base, with (X:Y) kept in the table until Z is inverted */
+    for (i = 0; i < FIXEDBASE_WINDOWS; i++) {
+        fpcopy_p256(table->points[i][0].x, base.x);
+        fpcopy_p256(table->points[i][0].y, base.y);
+        ec_precomp(&base, row, FIXEDBASE_POINTS, curve);
+        for (j = 0; j < FIXEDBASE_POINTS; j++) {
+            fpcopy_p256(row[j].X, table->points[i][j].x);
+            fpcopy_p256(row[j].Y, table->points[i][j].y);
+            fpcopy_p256(row[j].Z, z[i * FIXEDBASE_POINTS + j]);
+        }
+    }
+    status = fpinv_many_p256(z, FIXEDBASE_WINDOWS * FIXEDBASE_POINTS);
+    if (status != ER_OK) {
+        goto Exit;
+    }
+    for (i = 0; i < FIXEDBASE_WINDOWS; i++) {
+        for (j = 0; j < FIXEDBASE_POINTS; j++) {
+            digit_t* zinv = z[i * FIXEDBASE_POINTS + j];
+            fpsqr_p256(zinv, t1, temps);                            /* t1 = Z^-2  */
+            fpmul_p256(table->points[i][j].x, t1, t2, temps);       /* t2 = X/Z^2  */
+            fpcopy_p256(t2, table->points[i][j].x);
+            fpmul_p256(t1, zinv, t2, temps);                        /* t2 = Z^-3  */
+            fpmul_p256(table->points[i][j].y, t2, t1, temps);       /* t1 = Y/Z^3  */
+            fpcopy_p256(t1, table->points[i][j].y);
+        }
+    }
+
+Exit:
+    free(z);
+    return status;
+}
+
+/* Constant-time table lookup to extract an affine point from a row of a fixed-base table, returned as the Jacobian point (X:Y:1)
+ * Weierstrass a=-3 curve
+ * Operation: P = sign * row[(|digit|-1)/2], where sign=1 if digit>0 and sign=-1 if digit<0
+ */
+static void lut_fixedbase(const ecpoint_t* row, ecpoint_jacobian_t* P, int digit, ec_t* curve)
+{
+    unsigned int i, j;
+    size_t nwords = NBITS_TO_NDIGITS(curve->pbits);
+    digit_t sign, mask, pos;
+    ecpoint_t point;
+    digit256_t negy;
+
+    sign = ((digit_t)digit >> (RADIX_BITS - 1)) - 1;                            /* if digit<0 then sign = 0x00...0 else sign = 0xFF...F */
+    pos = ((sign & ((digit_t)digit ^ (digit_t)-digit)) ^ (digit_t)-digit) >> 1; /* position = (|digit|-1)/2  */
+    fpcopy_p256(row[0].x, point.x);                                             /* point = row[0]  */
+    fpcopy_p256(row[0].y, point.y);
+
+    for (i = 1; i < FIXEDBASE_POINTS; i++) {
+        pos--;
+        /* If match then mask = 0xFF...F else mask = 0x00...0 */
+        mask = (digit_t)is_digit_nonzero_ct(pos) - 1;
+        /* If mask = 0x00...0 then point = point, else if mask = 0xFF...F then point = row[i] */
+        for (j = 0; j < nwords; j++) {
+            point.x[j] = (mask & (point.x[j] ^ row[i].x[j])) ^ point.x[j];
+            point.y[j] = (mask & (point.y[j] ^ row[i].y[j])) ^ point.y[j];
+        }
+    }
+
+    fpcopy_p256(point.y, negy);
+    fpneg_p256(negy);
+    for (j = 0; j < nwords; j++) {                                              /* if sign = 0x00...0 then choose negative of the point  */
+        P->Y[j] = (sign & (point.y[j] ^ negy[j])) ^ negy[j];
+    }
+    fpcopy_p256(point.x, P->X);
+    fpzero_p256(P->Z);
+    P->Z[0] = 1;
+
+    /* cleanup */
+    fpzero_p256(point.x);
+    fpzero_p256(point.y);
+    fpzero_p256(negy);
+}
+
+/*
+ * Fixed-base scalar multiplication Q = k.P using a table computed by ec_fixedbase_precomp
+ * Weierstrass a=-3 curve
+ * The fixed window representation of k is evaluated as the sum of one table point per window, so no doublings are needed.
+ */
+QStatus ec_scalarmul_fixedbase(const ec_fixedbase_table_t* table, digit256_t k, ecpoint_t* Q, ec_t* curve)
+{
+    size_t num_digits;
+    int digits[FIXEDBASE_WINDOWS] = { 0 };
+    size_t t;
+    size_t i = 0;
+    size_t j = 0;
+    sdigit_t odd = 0;
+    ecpoint_jacobian_t T;
+    ecpoint_jacobian_t R;
+    digit256_t temp;
+
+    /* SECURITY NOTE: the crypto sensitive part of this function is protected against timing attacks and runs in constant-time on prime-order Weierstrass curves.
+     *                Conditional if-statements evaluate public data only and the number of iterations for all loops is public.
+     * DISCLAIMER:    the caller is responsible for guaranteeing that early termination produced after detecting errors during input validation
+     *                (of scalar k) does not leak any secret information.
+     */
+
+    if (table == NULL || k == NULL || Q == NULL || curve == NULL) {
+        return ER_INVALID_ADDRESS;
+    }
+
+    num_digits = NBITS_TO_NDIGITS(curve->pbits);    /* Number of words to represent field elements and elements in modulo the group order */
+    t = (curve->rbits + (W_FIXEDBASE - 2)) / (W_FIXEDBASE - 1); /* Fixed length of the fixed window representation   */
+    QCC_ASSERT(t < FIXEDBASE_WINDOWS);
+
+    /*  Input validation: */
+    /* Is scalar k in [1,r-1]?  */
+    if ((fpiszero_p256(k) == true) || (validate_256(k, curve->order) == false)) {
+        return ER_INVALID_DATA;
+    }
+    /* end input validation */
+
+    odd = -((sdigit_t)k[0] & 1);
+    fpsub_p256(curve->order, k, temp);                  /* Converting scalar to odd (r-k if even)  */
+    for (j = 0; j < num_digits; j++) {                  /* If (even) then k = k_temp else k = k   */
+        temp[j] = (odd & (k[j] ^ temp[j])) ^ temp[j];
+    }
+
+    fixed_window_recode(temp, (unsigned int)curve->rbits, W_FIXEDBASE, digits);
+
+    lut_fixedbase(table->points[t], &T, digits[t], curve);         /* Initialize T = (X_T:Y_T:Z_T) with the point of the last window */
+    for (i = t; i >= 1; i--) {
+        lut_fixedbase(table->points[i - 1], &R, digits[i - 1], curve);  /* Load R = (X_R:Y_R:1) with the point of the window */
+        ec_add_jacobian(&R, &T, curve);                                 /* Complete addition (X_T:Y_T:Z_T) = (X_T:Y_T:Z_T) + (X_R:Y_R:1)  */
+    }
+
+    fpcopy_p256(T.Y, temp);
+    fpneg_p256(temp);                                       /* Correcting scalar (-Ty if even)  */
+
+    for (j = 0; j < num_digits; j++) {                      /* If (even) then Ty = -Ty   */
+        T.Y[j] = (odd & (T.Y[j] ^ temp[j])) ^ temp[j];
+    }
+
+    ec_toaffine(&T, Q, curve);                              /* Output Q = (x,y)  */
+
+    ClearMemory(digits, sizeof(digits));
+    ecpoint_jacobian_zero(&T);
+    ecpoint_jacobian_zero(&R);
+    fpzero_p256(temp);
+
+    return ER_OK;
+}
+
+const ec_fixedbase_table_t* ec_get_generator_table(ec_t* curve)
+{
+    if ((curve == NULL) || (curve->curveid != NISTP256r1)) {
+        return NULL;
+    }
+    return &P256_GENERATOR_TABLE;
+}
+
+/* Number of points ec_scalarmul_cached keeps tables for.  Each table takes about 33 KB. */
+#define SCALARMUL_CACHE_SIZE 8
+/* Number of points multiplied once that ec_scalarmul_cached remembers.  A point only gets
+ * a cache entry the second time it is seen, so single-use keys never displace a table. */
+#define SCALARMUL_SEEN_SIZE 32
+/* Number of multiplications of a point before ec_scalarmul_cached computes its table.
+ * Computing a table costs about as much as a few variable-base multiplications. */
+#define SCALARMUL_CACHE_THRESHOLD 4
+
+struct ScalarmulCacheEntry {
+    ecpoint_t point;
+    uint32_t uses;              /* Multiplications of point since it was added */
+    uint64_t lastUse;           /* 0 if the entry is free */
+    bool building;              /* A thread is computing the table, the entry must not be replaced */
+    std::shared_ptr<const ec_fixedbase_table_t> table;
+
+    ScalarmulCacheEntry() : uses(0), lastUse(0), building(false) { }
+};
+
+static Mutex* scalarmulCacheLock = NULL;
+static ScalarmulCacheEntry* scalarmulCache = NULL;
+static uint64_t scalarmulCacheClock = 0;
+static ecpoint_t* scalarmulSeen = NULL;
+static size_t scalarmulSeenNext = 0;
+
+void ec_scalarmul_cache_init(void)
+{
+    if (!scalarmulCacheLock) {
+        scalarmulCacheLock = new Mutex();
+        scalarmulCache = new ScalarmulCacheEntry[SCALARMUL_CACHE_SIZE];
+        scalarmulCacheClock = 0;
+        scalarmulSeen = new ecpoint_t[SCALARMUL_SEEN_SIZE];
+        memset(scalarmulSeen, 0, SCALARMUL_SEEN_SIZE * sizeof(ecpoint_t));
+        scalarmulSeenNext = 0;
+    }
+}
+
+void ec_scalarmul_cache_shutdown(void)
+{
+    if (scalarmulCacheLock) {
+        delete [] scalarmulSeen;
+        scalarmulSeen = NULL;
+        delete [] scalarmulCache;
+        scalarmulCache = NULL;
+        delete scalarmulCacheLock;
+        scalarmulCacheLock = NULL;
+    }
+}
+
+/*
+ * Returns true if P was multiplied once before, forgetting it since it is about to get a cache entry.
+ * Otherwise remembers P in place of the oldest point seen.  Forgotten slots hold (0, 0), which is
+ * not on the curve.  Must be called with scalarmulCacheLock held.
+ */
+static bool scalarmul_seen_before(const ecpoint_t* P)
+{
+    for (size_t i = 0; i < SCALARMUL_SEEN_SIZE; i++) {
+        ecpoint_t* seen = &scalarmulSeen[i];
+        if (fpequal_p256(seen->x, P->x) && fpequal_p256(seen->y, P->y)) {
+            fpzero_p256(seen->x);
+            fpzero_p256(seen->y);
+            return true;
+        }
+    }
+    fpcopy_p256(P->x, scalarmulSeen[scalarmulSeenNext].x);
+    fpcopy_p256(P->y, scalarmulSeen[scalarmulSeenNext].y);
+    scalarmulSeenNext = (scalarmulSeenNext + 1) % SCALARMUL_SEEN_SIZE;
+    return false;
+}
+
+/*
+ * Returns the entry of P.  A point without an entry gets the least recently used one the second
+ * time it is seen.  Returns NULL the first time P is seen, or if every entry is having its table
+ * computed.  Must be called with scalarmulCacheLock held.
+ */
+static ScalarmulCacheEntry* scalarmul_cache_lookup(const ecpoint_t* P)
+{
+    ScalarmulCacheEntry* victim = NULL;
+
+    for (size_t i = 0; i < SCALARMUL_CACHE_SIZE; i++) {
+        ScalarmulCacheEntry* entry = &scalarmulCache[i];
+        if ((entry->lastUse != 0) && fpequal_p256(entry->point.x, P->x) && fpequal_p256(entry->point.y, P->y)) {
+            return entry;
+        }
+        if (!entry->building && ((victim == NULL) || (entry->lastUse < victim->lastUse))) {
+            victim = entry;
+        }
+    }
+    if (!scalarmul_seen_before(P)) {
+        return NULL;
+    }
+    if (victim) {
+        fpcopy_p256(P->x, victim->point.x);
+        fpcopy_p256(P->y, victim->point.y);
+        /* Count the multiplication that got P remembered */
+        victim->uses = 1;
+        victim->table.reset();
+    }
+    return victim;
+}
+
+QStatus ec_scalarmul_cached(const ecpoint_t* P, digit256_t k, ecpoint_t* Q, ec_t* curve)
+{
+    std::shared_ptr<const ec_fixedbase_table_t> table;
+    ScalarmulCacheEntry* entry;
+    bool build = false;
+
+    if (P == NULL || k == NULL || Q == NULL || curve == NULL) {
+        return ER_INVALID_ADDRESS;
+    }
+    if (!scalarmulCacheLock) {
+        return ec_scalarmul(P, k, Q, curve);
+    }
+
+    scalarmulCacheLock->Lock(MUTEX_CONTEXT);
+    entry = scalarmul_cache_lookup(P);
+    if (entry) {
+        entry->lastUse = ++scalarmulCacheClock;
+        entry->uses++;
+        table = entry->table;
+        if (!table && !entry->building && (entry->uses >= SCALARMUL_CACHE_THRESHOLD)) {
+            entry->building = true;
+            build = true;
+        }
+    }
+    scalarmulCacheLock->Unlock(MUTEX_CONTEXT);
+
+    if (build) {
+        /* Computed without holding the lock; the entry is not replaced while building is set */
+        ec_fixedbase_table_t* newTable = new ec_fixedbase_table_t;
+        if (ec_fixedbase_precomp(P, newTable, curve) == ER_OK) {
+            table.reset(newTable);
+        } else {
+            delete newTable;
+        }
+        scalarmulCacheLock->Lock(MUTEX_CONTEXT);
+        entry->building = false;
+        entry->table = table;
+        if (!table) {
+            entry->uses = 0;
+        }
+        scalarmulCacheLock->Unlock(MUTEX_CONTEXT);
+    }
+
+    if (table) {
+        return ec_scalarmul_fixedbase(table.get(), k, Q, curve);
+    }
+    return ec_scalarmul(P, k, Q, curve);
+}
+
 }
@@ -22,6 +22,17 @@
 #include <qcc/IODispatch.h>
 #include <qcc/StringUtil.h>
 #include <qcc/LockLevel.h>
+
+#if defined(QCC_IODISPATCH_EPOLL)
+#if !defined(QCC_OS_LINUX)
+#error "QCC_IODISPATCH_EPOLL is only supported on Linux"
+#endif
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#endif
+
 #define QCC_MODULE "IODISPATCH"
 
 using namespace qcc;
@@ -29,14 +40,31 @@ using namespace std;
 
 volatile int32_t IODispatch::iodispatchCnt = 0;
 
+#if defined(QCC_IODISPATCH_EPOLL)
+/* Maximum number of ready streams harvested from the epoll set per wakeup */
+static const int MAX_POLL_EVENTS = 64;
+#endif
+
 IODispatch::IODispatch(const char* name, uint32_t concurrency) :
     timer((String(name) + U32ToString(IncrementAndFetch(&iodispatchCnt))), true, concurrency, false, 96),
     lock(LOCK_LEVEL_IODISPATCH_LOCK),
     reload(false),
     isRunning(false),
     numAlarmsInProgress(0),
-    crit(false)
+    crit(false),
+    epollFd(-1),
+    pollEvent(NULL),
+    readCallbackUsec(Metrics::GetHistogram(String("iodispatch.") + name + ".read.usec")),
+    writeCallbackUsec(Metrics::GetHistogram(String("iodispatch.") + name + ".write.usec"))
 {
+#if defined(QCC_IODISPATCH_EPOLL)
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        QCC_LogError(ER_OS_ERROR, ("epoll_create1 failed with %d (%s), using select", errno, strerror(errno)));
+    } else {
+        pollEvent = new Event(epollFd, Event::IO_READ);
+    }
+#endif
 }
 
 IODispatch::~IODispatch()
@@ -50,6 +78,13 @@ IODispatch::~IODispatch()
      * Just a sanity check.
      */
     QCC_ASSERT(dispatchEntries.size() == 0);
+
+#if defined(QCC_IODISPATCH_EPOLL)
+    delete pollEvent;
+    if (epollFd >= 0) {
+        close(epollFd);
+    }
+#endif
 }
 
 QStatus IODispatch::Start(void* arg, ThreadListener* listener)
@@ -128,6 +163,15 @@ QStatus IODispatch::StartStream(Stream* stream, IOReadListener* readListener, IO
     dispatchEntries[stream].readTimeoutCtxt = new CallbackContext(stream, IO_READ_TIMEOUT);
     dispatchEntries[stream].exitCtxt = new CallbackContext(stream, IO_EXIT);
 
+    IODispatchEntry& entry = dispatchEntries[stream];
+    RegisterPoll(stream, entry);
+    if (entry.pollFd != INVALID_SOCKET_FD) {
+        /* Polled streams are armed directly, the Run thread need not reload. */
+        lock.Unlock();
+        return ER_OK;
+    }
+    selectEntries[stream] = &entry;
+
     /* Set reload to false and alert the IODispatch::Run thread */
     reload = false;
     lock.Unlock();
@@ -158,6 +202,7 @@ QStatus IODispatch::StopStream(Stream* stream)
 
     /* Disable further read and writes on this stream */
     it->second.stopping_state = IO_STOPPING;
+    UnregisterPoll(stream, it->second);
 
     /* Set reload to false and alert the IODispatch::Run thread */
     reload = false;
@@ -272,6 +317,7 @@ void IODispatch::AlarmTriggered(const Alarm& alarm, QStatus reason)
          * of descriptors.
          */
         it->second.readInProgress = true;
+        UpdatePoll(it->second);
         while (!reload && crit && isRunning) {
             lock.Unlock();
             Sleep(1);
@@ -284,6 +330,7 @@ void IODispatch::AlarmTriggered(const Alarm& alarm, QStatus reason)
         lock.Unlock();
         if (dispatchEntry.readEnable) {
             /* Ensure read has not been disabled */
+            ScopedMetricTimer callbackTimer(readCallbackUsec);
             dispatchEntry.readListener->ReadCallback(*stream, ctxt->type == IO_READ_TIMEOUT);
         }
         DecrementAndFetch(&numAlarmsInProgress);
@@ -297,6 +344,7 @@ void IODispatch::AlarmTriggered(const Alarm& alarm, QStatus reason)
          * of descriptors.
          */
         it->second.writeInProgress = true;
+        UpdatePoll(it->second);
         while (!reload && crit && isRunning) {
             lock.Unlock();
             Sleep(1);
@@ -312,6 +360,7 @@ void IODispatch::AlarmTriggered(const Alarm& alarm, QStatus reason)
         /* Make the write callback */
         if (dispatchEntry.writeEnable) {
             /* Ensure write has not been disabled */
+            ScopedMetricTimer callbackTimer(writeCallbackUsec);
             dispatchEntry.writeListener->WriteCallback(*stream, ctxt->type == IO_WRITE_TIMEOUT);
         }
         DecrementAndFetch(&numAlarmsInProgress);
@@ -373,6 +422,8 @@ void IODispatch::AlarmTriggered(const Alarm& alarm, QStatus reason)
             delete it->second.readTimeoutCtxt;
             it->second.readTimeoutCtxt = NULL;
         }
+        UnregisterPoll(stream, it->second);
+        selectEntries.erase(stream);
         dispatchEntries.erase(it);
         lock.Unlock();
         break;
@@ -383,6 +434,232 @@ void IODispatch::AlarmTriggered(const Alarm& alarm, QStatus reason)
     }
 }
 
+void IODispatch::ScheduleReadAlarm(Stream* stream)
+{
+    int32_t when = 0;
+    AlarmListener* listener = this;
+    map<Stream*, IODispatchEntry>::iterator it = dispatchEntries.find(stream);
+
+    /* Add a readAlarm to fire now, and set readInProgress to true. */
+    Alarm prevAlarm = it->second.readAlarm;
+    Alarm readAlarm = Alarm(when, listener, it->second.readCtxt);
+    it->second.readInProgress = true;
+    it->second.mainAddingRead = true;
+    lock.Unlock();
+    /* Remove the read timeout alarm if any first */
+    timer.RemoveAlarm(prevAlarm, true);
+    lock.Lock();
+    it = dispatchEntries.find(stream);
+    if (it != dispatchEntries.end()) {
+        it->second.mainAddingRead = false;
+    }
+
+    QStatus status = ER_TIMER_FULL;
+    while (isRunning && status == ER_TIMER_FULL && it != dispatchEntries.end() && it->second.stopping_state == IO_RUNNING) {
+        /* Call the non-blocking version of AddAlarm, while holding the
+         * locks to ensure that the state of the dispatchEntry is valid.
+         */
+        status = timer.AddAlarmNonBlocking(readAlarm);
+
+        if (status == ER_TIMER_FULL) {
+            lock.Unlock();
+            qcc::Sleep(2);
+            lock.Lock();
+        }
+
+        it = dispatchEntries.find(stream);
+    }
+    if (status == ER_OK && it != dispatchEntries.end()) {
+        it->second.readAlarm = readAlarm;
+    }
+}
+
+void IODispatch::ScheduleWriteAlarm(Stream* stream)
+{
+    int32_t when = 0;
+    AlarmListener* listener = this;
+    map<Stream*, IODispatchEntry>::iterator it = dispatchEntries.find(stream);
+
+    /* Add a writeAlarm to fire now, and set writeInProgress to true. */
+    Alarm prevAlarm = it->second.writeAlarm;
+    Alarm writeAlarm = Alarm(when, listener, it->second.writeCtxt);
+    it->second.writeInProgress = true;
+    it->second.mainAddingWrite = true;
+    lock.Unlock();
+    /* Remove the write timeout alarm if any first */
+    timer.RemoveAlarm(prevAlarm, true);
+    lock.Lock();
+    it = dispatchEntries.find(stream);
+    if (it != dispatchEntries.end()) {
+        it->second.mainAddingWrite = false;
+    }
+
+    QStatus status = ER_TIMER_FULL;
+    while (isRunning && status == ER_TIMER_FULL && it != dispatchEntries.end() && it->second.stopping_state == IO_RUNNING) {
+        /* Call the non-blocking version of AddAlarm, while holding the
+         * locks to ensure that the state of the dispatchEntry is valid.
+         */
+        status = timer.AddAlarmNonBlocking(writeAlarm);
+
+        if (status == ER_TIMER_FULL) {
+            lock.Unlock();
+            qcc::Sleep(2);
+            lock.Lock();
+        }
+
+        it = dispatchEntries.find(stream);
+    }
+    if (status == ER_OK && it != dispatchEntries.end()) {
+        it->second.writeAlarm = writeAlarm;
+    }
+}
+
+void IODispatch::RegisterPoll(Stream* stream, IODispatchEntry& entry)
+{
+#if defined(QCC_IODISPATCH_EPOLL)
+    if (epollFd < 0) {
+        return;
+    }
+    Event& sourceEvent = stream->GetSourceEvent();
+    Event& sinkEvent = stream->GetSinkEvent();
+    if ((sourceEvent.GetEventType() != Event::IO_READ) || !sourceEvent.IsIOOnly() ||
+        (sinkEvent.GetEventType() != Event::IO_WRITE) || !sinkEvent.IsIOOnly() ||
+        (sourceEvent.GetFD() != sinkEvent.GetFD())) {
+        /* Streams with general purpose or timed events stay on the select path */
+        return;
+    }
+
+    SocketFd fd = sourceEvent.GetFD();
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLET | EPOLLONESHOT;
+    ev.data.fd = fd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        QCC_DbgPrintf(("RegisterPoll(): epoll_ctl(ADD, %d) failed with %d (%s), using select", fd, errno, strerror(errno)));
+        return;
+    }
+    /*
+     * If the FD number was previously used by a stream that closed its socket
+     * without being stopped, the kernel has already dropped that registration
+     * so the new stream simply takes over the slot.
+     */
+    polledFds[fd] = stream;
+    entry.pollFd = fd;
+    entry.pollArmed = 0;
+    UpdatePoll(entry);
+#else
+    QCC_UNUSED(stream);
+    QCC_UNUSED(entry);
+#endif
+}
+
+void IODispatch::UnregisterPoll(Stream* stream, IODispatchEntry& entry)
+{
+#if defined(QCC_IODISPATCH_EPOLL)
+    if (entry.pollFd == INVALID_SOCKET_FD) {
+        return;
+    }
+    map<SocketFd, Stream*>::iterator pit = polledFds.find(entry.pollFd);
+    if (pit != polledFds.end() && pit->second == stream) {
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, entry.pollFd, &ev);
+        polledFds.erase(pit);
+    }
+    entry.pollFd = INVALID_SOCKET_FD;
+    entry.pollArmed = 0;
+#else
+    QCC_UNUSED(stream);
+    QCC_UNUSED(entry);
+#endif
+}
+
+void IODispatch::UpdatePoll(IODispatchEntry& entry)
+{
+#if defined(QCC_IODISPATCH_EPOLL)
+    if (entry.pollFd == INVALID_SOCKET_FD) {
+        return;
+    }
+    uint32_t wanted = 0;
+    if (entry.stopping_state == IO_RUNNING) {
+        if (entry.readEnable && !entry.readInProgress) {
+            wanted |= EPOLLIN;
+        }
+        if (entry.writeEnable && !entry.writeInProgress) {
+            wanted |= EPOLLOUT;
+        }
+    }
+    if (wanted == entry.pollArmed) {
+        return;
+    }
+    /*
+     * Re-arming a one-shot registration makes the kernel re-evaluate the FD, so
+     * data that arrived while the callback was in progress is not lost even
+     * though the registration is edge-triggered.
+     */
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = wanted | EPOLLET | EPOLLONESHOT;
+    ev.data.fd = entry.pollFd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_MOD, entry.pollFd, &ev) == 0) {
+        entry.pollArmed = wanted;
+    } else {
+        QCC_LogError(ER_OS_ERROR, ("epoll_ctl(MOD, %d) failed with %d (%s)", entry.pollFd, errno, strerror(errno)));
+    }
+#else
+    QCC_UNUSED(entry);
+#endif
+}
+
+void IODispatch::DispatchPolledEvents()
+{
+#if defined(QCC_IODISPATCH_EPOLL)
+    struct epoll_event events[MAX_POLL_EVENTS];
+    int numEvents = epoll_wait(epollFd, events, MAX_POLL_EVENTS, 0);
+    if (numEvents < 0) {
+        if (errno != EINTR) {
+            QCC_LogError(ER_OS_ERROR, ("epoll_wait failed with %d (%s)", errno, strerror(errno)));
+        }
+        return;
+    }
+
+    for (int i = 0; i < numEvents && isRunning; ++i) {
+        map<SocketFd, Stream*>::iterator pit = polledFds.find(events[i].data.fd);
+        if (pit == polledFds.end()) {
+            continue;
+        }
+        Stream* stream = pit->second;
+        map<Stream*, IODispatchEntry>::iterator it = dispatchEntries.find(stream);
+        if (it == dispatchEntries.end() || it->second.pollFd != events[i].data.fd) {
+            continue;
+        }
+
+        /* The one-shot registration stays disarmed until UpdatePoll re-arms it */
+        uint32_t armed = it->second.pollArmed;
+        it->second.pollArmed = 0;
+        if (it->second.stopping_state != IO_RUNNING) {
+            continue;
+        }
+
+        bool readReady = (armed & EPOLLIN) && (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP));
+        bool writeReady = (armed & EPOLLOUT) && (events[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP));
+
+        if (readReady && it->second.readEnable && !it->second.readInProgress) {
+            ScheduleReadAlarm(stream);
+            it = dispatchEntries.find(stream);
+        }
+        if (writeReady && it != dispatchEntries.end() && it->second.stopping_state == IO_RUNNING &&
+            it->second.writeEnable && !it->second.writeInProgress) {
+            ScheduleWriteAlarm(stream);
+            it = dispatchEntries.find(stream);
+        }
+        if (it != dispatchEntries.end()) {
+            UpdatePoll(it->second);
+        }
+    }
+#endif
+}
+
 ThreadReturn STDCALL IODispatch::Run(void* arg) {
     QCC_UNUSED(arg);
 
@@ -395,30 +672,35 @@ ThreadReturn STDCALL IODispatch::Run(void* arg) {
         signaledEvents.clear();
         /* Add the Thread's stop event to list of events to check for */
         checkEvents.push_back(&stopEvent);
+        if (pollEvent) {
+            /* Streams registered with epoll are reported through a single event */
+            checkEvents.push_back(pollEvent);
+        }
 
         /* Set reload to true to indicate that this thread is not in the Event::Wait and is
          * reloading the set of source and sink events
          */
         lock.Lock();
         reload = true;
-        map<Stream*, IODispatchEntry>::iterator it = dispatchEntries.begin();
-        while (it != dispatchEntries.end() && isRunning) {
-            if (it->second.stopping_state == IO_RUNNING) {
+        map<Stream*, IODispatchEntry*>::iterator sit = selectEntries.begin();
+        while (sit != selectEntries.end() && isRunning) {
+            IODispatchEntry& entry = *sit->second;
+            if (entry.stopping_state == IO_RUNNING) {
                 /* Check this stream only if it has not been stopped */
-                if (it->second.readEnable && !it->second.readInProgress) {
+                if (entry.readEnable && !entry.readInProgress) {
                     /* If read is enabled and not in progress, add the source event for the stream to the
                      * set of check events
                      */
-                    checkEvents.push_back(&it->first->GetSourceEvent());
+                    checkEvents.push_back(&sit->first->GetSourceEvent());
                 }
-                if (it->second.writeEnable && !it->second.writeInProgress) {
+                if (entry.writeEnable && !entry.writeInProgress) {
                     /* If write is enabled and not in progress, add the sink event for the stream to the
                      * set of check events
                      */
-                    checkEvents.push_back(&it->first->GetSinkEvent());
+                    checkEvents.push_back(&sit->first->GetSinkEvent());
                 }
             }
-            it++;
+            sit++;
         }
         crit = true;
         lock.Unlock();
@@ -442,7 +724,7 @@ ThreadReturn STDCALL IODispatch::Run(void* arg) {
                 lock.Lock();
                 stopEvent.ResetEvent();
 
-                it = dispatchEntries.begin();
+                map<Stream*, IODispatchEntry>::iterator it = dispatchEntries.begin();
                 /* Add exit alarms for any streams that are being stopped.
                  * We dont need to keep track of the exit alarm, since we never remove
                  * the exit alarm. Hence it is not a part of IODispatchEntry.
@@ -476,97 +758,34 @@ ThreadReturn STDCALL IODispatch::Run(void* arg) {
                 }
                 lock.Unlock();
                 continue;
+            } else if (*i == pollEvent) {
+                lock.Lock();
+                DispatchPolledEvents();
+                lock.Unlock();
             } else {
                 lock.Lock();
-                it = dispatchEntries.begin();
-                while (it != dispatchEntries.end()) {
+                sit = selectEntries.begin();
+                while (sit != selectEntries.end()) {
 
-                    Stream* stream = it->first;
+                    Stream* stream = sit->first;
+                    IODispatchEntry& entry = *sit->second;
 
-                    if (it->second.stopping_state == IO_RUNNING) {
+                    if (entry.stopping_state == IO_RUNNING) {
                         if (&stream->GetSourceEvent() == *i) {
-
-                            if (it->second.readEnable && !it->second.readInProgress) {
-                                /* If the source event for a particular stream has been signalled,
-                                 * add a readAlarm to fire now, and set readInProgress to true.
-                                 */
-                                Alarm prevAlarm = it->second.readAlarm;
-                                Alarm readAlarm = Alarm(when, listener, it->second.readCtxt);
-                                it->second.readInProgress = true;
-                                it->second.mainAddingRead = true;
-                                lock.Unlock();
-                                /* Remove the read timeout alarm if any first */
-                                timer.RemoveAlarm(prevAlarm, true);
-                                lock.Lock();
-                                it = dispatchEntries.find(stream);
-                                if (it != dispatchEntries.end()) {
-                                    it->second.mainAddingRead = false;
-                                }
-
-                                QStatus status = ER_TIMER_FULL;
-                                while (isRunning && status == ER_TIMER_FULL && it != dispatchEntries.end() && it->second.stopping_state == IO_RUNNING) {
-                                    /* Call the non-blocking version of AddAlarm, while holding the
-                                     * locks to ensure that the state of the dispatchEntry is valid.
-                                     */
-                                    status = timer.AddAlarmNonBlocking(readAlarm);
-
-                                    if (status == ER_TIMER_FULL) {
-                                        lock.Unlock();
-                                        qcc::Sleep(2);
-                                        lock.Lock();
-                                    }
-
-                                    it = dispatchEntries.find(stream);
-                                }
-                                if (status == ER_OK && it != dispatchEntries.end()) {
-                                    it->second.readAlarm = readAlarm;
-                                }
-
+                            if (entry.readEnable && !entry.readInProgress) {
+                                /* The source event for this stream has been signalled */
+                                ScheduleReadAlarm(stream);
                                 break;
                             }
-
                         } else if (&stream->GetSinkEvent() == *i) {
-                            if (it->second.writeEnable && !it->second.writeInProgress) {
-                                /* If the sink event for a particular stream has been signalled,
-                                 * add a writeAlarm to fire now, and set writeInProgress to true.
-                                 */
-                                Alarm prevAlarm = it->second.writeAlarm;
-                                Alarm writeAlarm = Alarm(when, listener, it->second.writeCtxt);
-                                it->second.writeInProgress = true;
-                                it->second.mainAddingWrite = true;
-                                lock.Unlock();
-                                /* Remove the write timeout alarm if any first */
-                                timer.RemoveAlarm(prevAlarm, true);
-                                lock.Lock();
-                                it = dispatchEntries.find(stream);
-                                if (it != dispatchEntries.end()) {
-                                    it->second.mainAddingWrite = false;
-                                }
-
-                                QStatus status = ER_TIMER_FULL;
-                                while (isRunning && status == ER_TIMER_FULL && it != dispatchEntries.end() && it->second.stopping_state == IO_RUNNING) {
-                                    /* Call the non-blocking version of AddAlarm, while holding the
-                                     * locks to ensure that the state of the dispatchEntry is valid.
-                                     */
-                                    status = timer.AddAlarmNonBlocking(writeAlarm);
-
-                                    if (status == ER_TIMER_FULL) {
-                                        lock.Unlock();
-                                        qcc::Sleep(2);
-                                        lock.Lock();
-                                    }
-
-                                    it = dispatchEntries.find(stream);
-                                }
-                                if (status == ER_OK && it != dispatchEntries.end()) {
-                                    it->second.writeAlarm = writeAlarm;
-                                }
-
+                            if (entry.writeEnable && !entry.writeInProgress) {
+                                /* The sink event for this stream has been signalled */
+                                ScheduleWriteAlarm(stream);
                                 break;
                             }
                         }
                     }
-                    ++it;
+                    ++sit;
                 }
                 lock.Unlock();
             }
@@ -638,6 +857,12 @@ QStatus IODispatch::EnableReadCallback(const Source* source, uint32_t timeout)
         /* Timeout = 0 indicates that no timeout alarm is required for this stream */
         it->second.readInProgress = false;
     }
+    if (it != dispatchEntries.end() && it->second.pollFd != INVALID_SOCKET_FD) {
+        /* Polled streams are re-armed here, the Run thread need not be alerted */
+        UpdatePoll(it->second);
+        lock.Unlock();
+        return ER_OK;
+    }
     lock.Unlock();
 
     Thread::Alert();
@@ -727,6 +952,12 @@ QStatus IODispatch::DisableReadCallback(const Source* source)
         return ER_INVALID_STREAM;
     }
     it->second.readEnable = false;
+    if (it->second.pollFd != INVALID_SOCKET_FD) {
+        /* A polled stream that fires after this point is ignored by the Run thread */
+        UpdatePoll(it->second);
+        lock.Unlock();
+        return ER_OK;
+    }
     lock.Unlock();
     Thread::Alert();
     /* Wait until the IODispatch::Run thread reloads the set of check events
@@ -774,7 +1005,11 @@ QStatus IODispatch::EnableWriteCallbackNow(Sink* sink)
          * Do not block here, since it can create deadlocks.
          */
         it->second.writeInProgress = false;
-        Thread::Alert();
+        if (it->second.pollFd != INVALID_SOCKET_FD) {
+            UpdatePoll(it->second);
+        } else {
+            Thread::Alert();
+        }
     }
     lock.Unlock();
     return ER_OK;
@@ -830,9 +1065,16 @@ QStatus IODispatch::EnableWriteCallback(Sink* sink, uint32_t timeout)
             dispatchEntriesIt->second.writeAlarm = writeAlarm;
             dispatchEntriesIt->second.writeInProgress = false;
         }
+        it = dispatchEntriesIt;
     } else {
         it->second.writeInProgress = false;
     }
+    if (it != dispatchEntries.end() && it->second.pollFd != INVALID_SOCKET_FD) {
+        /* Polled streams are re-armed here, the Run thread need not be alerted */
+        UpdatePoll(it->second);
+        lock.Unlock();
+        return ER_OK;
+    }
     lock.Unlock();
     Thread::Alert();
 
@@ -857,6 +1099,12 @@ QStatus IODispatch::DisableWriteCallback(const Sink* sink)
         return ER_INVALID_STREAM;
     }
     it->second.writeEnable = false;
+    if (it->second.pollFd != INVALID_SOCKET_FD) {
+        /* A polled stream that fires after this point is ignored by the Run thread */
+        UpdatePoll(it->second);
+        lock.Unlock();
+        return ER_OK;
+    }
 
     lock.Unlock();
     Thread::Alert();
@@ -0,0 +1,188 @@
+/**
+ * @file
+ *
+ * Named counters and latency histograms cheap enough to update on hot paths.
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+
+#include <qcc/platform.h>
+
+#include <string.h>
+
+#include <qcc/Metrics.h>
+#include <qcc/Mutex.h>
+#include <qcc/Thread.h>
+
+#define QCC_MODULE "METRICS"
+
+using namespace std;
+
+namespace qcc {
+
+size_t GetMetricShard()
+{
+    /* FNV-1a over the bytes of the thread id, pthread_t is opaque on some platforms */
+    ThreadId id = Thread::GetCurrentThreadId();
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&id);
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; i < sizeof(id); ++i) {
+        hash = (hash ^ bytes[i]) * 16777619U;
+    }
+    return (hash ^ (hash >> 16)) & (METRIC_SHARDS - 1);
+}
+
+MetricCounter::MetricCounter()
+{
+    memset(shards, 0, sizeof(shards));
+}
+
+void MetricCounter::Add(uint32_t n)
+{
+    volatile int32_t* value = &shards[GetMetricShard()].value;
+    int32_t current;
+    do {
+        current = *value;
+    } while (!CompareAndExchange(value, current, static_cast<int32_t>(static_cast<uint32_t>(current) + n)));
+}
+
+uint32_t MetricCounter::GetValue() const
+{
+    uint32_t sum = 0;
+    for (size_t i = 0; i < METRIC_SHARDS; ++i) {
+        sum += static_cast<uint32_t>(shards[i].value);
+    }
+    return sum;
+}
+
+uint64_t MetricHistogramSnapshot::GetCount() const
+{
+    uint64_t count = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        count += buckets[i];
+    }
+    return count;
+}
+
+uint32_t MetricHistogramSnapshot::GetPercentile(double percent) const
+{
+    uint64_t count = GetCount();
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>((percent * count) / 100.0);
+    if (rank >= count) {
+        rank = count - 1;
+    }
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen > rank) {
+            return MetricHistogram::GetBucketLowerBound(i);
+        }
+    }
+    return 0;
+}
+
+MetricHistogram::MetricHistogram()
+{
+    memset(const_cast<int32_t*>(&buckets[0][0]), 0, sizeof(buckets));
+}
+
+void MetricHistogram::GetSnapshot(MetricHistogramSnapshot& snapshot) const
+{
+    snapshot.buckets.assign(NUM_BUCKETS, 0);
+    for (size_t s = 0; s < METRIC_SHARDS; ++s) {
+        for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+            snapshot.buckets[i] += static_cast<uint32_t>(buckets[s][i]);
+        }
+    }
+}
+
+static Mutex* metricsLock = NULL;
+static map<String, MetricCounter*>* counters = NULL;
+static map<String, MetricHistogram*>* histograms = NULL;
+
+void Metrics::Init()
+{
+    if (!metricsLock) {
+        metricsLock = new Mutex();
+        counters = new map<String, MetricCounter*>();
+        histograms = new map<String, MetricHistogram*>();
+    }
+}
+
+void Metrics::Shutdown()
+{
+    if (metricsLock) {
+        for (map<String, MetricCounter*>::iterator it = counters->begin(); it != counters->end(); ++it) {
+            delete it->second;
+        }
+        for (map<String, MetricHistogram*>::iterator it = histograms->begin(); it != histograms->end(); ++it) {
+            delete it->second;
+        }
+        delete histograms;
+        histograms = NULL;
+        delete counters;
+        counters = NULL;
+        delete metricsLock;
+        metricsLock = NULL;
+    }
+}
+
+MetricCounter* Metrics::GetCounter(const String& name)
+{
+    QCC_ASSERT(metricsLock);
+    metricsLock->Lock(MUTEX_CONTEXT);
+    MetricCounter*& counter = (*counters)[name];
+    if (!counter) {
+        counter = new MetricCounter();
+    }
+    MetricCounter* ret = counter;
+    metricsLock->Unlock(MUTEX_CONTEXT);
+    return ret;
+}
+
+MetricHistogram* Metrics::GetHistogram(const String& name)
+{
+    QCC_ASSERT(metricsLock);
+    metricsLock->Lock(MUTEX_CONTEXT);
+    MetricHistogram*& histogram = (*histograms)[name];
+    if (!histogram) {
+        histogram = new MetricHistogram();
+    }
+    MetricHistogram* ret = histogram;
+    metricsLock->Unlock(MUTEX_CONTEXT);
+    return ret;
+}
+
+void Metrics::GetSnapshot(MetricsSnapshot& snapshot)
+{
+    QCC_ASSERT(metricsLock);
+    snapshot.counters.clear();
+    snapshot.histograms.clear();
+    metricsLock->Lock(MUTEX_CONTEXT);
+    for (map<String, MetricCounter*>::const_iterator it = counters->begin(); it != counters->end(); ++it) {
+        snapshot.counters[it->first] = it->second->GetValue();
+    }
+    for (map<String, MetricHistogram*>::const_iterator it = histograms->begin(); it != histograms->end(); ++it) {
+        it->second->GetSnapshot(snapshot.histograms[it->first]);
+    }
+    metricsLock->Unlock(MUTEX_CONTEXT);
+}
+
+}
@@ -0,0 +1,118 @@
+/**
+ * @file
+ *
+ * ShardedIODispatch spreads streams over several independent IODispatch loops
+ */
+
+/******************************************************************************
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <qcc/ShardedIODispatch.h>
+#include <qcc/Debug.h>
+
+#define QCC_MODULE "IODISPATCH"
+
+using namespace qcc;
+using namespace std;
+
+/*
+ * Lower bound on the callback concurrency of each shard.  Read and write
+ * callbacks may block, so a shard must not be left with a single worker.
+ */
+static const uint32_t MIN_SHARD_CONCURRENCY = 8;
+
+ShardedIODispatch::ShardedIODispatch(const char* name, uint32_t concurrency, uint32_t numShards)
+{
+    if (numShards == 0) {
+        numShards = 1;
+    }
+    uint32_t shardConcurrency = concurrency;
+    if (numShards > 1) {
+        shardConcurrency = (concurrency + numShards - 1) / numShards;
+        if (shardConcurrency < MIN_SHARD_CONCURRENCY) {
+            shardConcurrency = MIN_SHARD_CONCURRENCY;
+        }
+    }
+    QCC_DbgPrintf(("ShardedIODispatch %s: %u shards with concurrency %u", name, numShards, shardConcurrency));
+    for (uint32_t i = 0; i < numShards; ++i) {
+        shards.push_back(new IODispatch(name, shardConcurrency));
+    }
+}
+
+ShardedIODispatch::~ShardedIODispatch()
+{
+    for (size_t i = 0; i < shards.size(); ++i) {
+        delete shards[i];
+    }
+}
+
+QStatus ShardedIODispatch::Start()
+{
+    QStatus status = ER_OK;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        QStatus s = shards[i]->Start();
+        if (ER_OK == status) {
+            status = s;
+        }
+    }
+    return status;
+}
+
+QStatus ShardedIODispatch::Stop()
+{
+    QStatus status = ER_OK;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        QStatus s = shards[i]->Stop();
+        if (ER_OK == status) {
+            status = s;
+        }
+    }
+    return status;
+}
+
+QStatus ShardedIODispatch::Join()
+{
+    QStatus status = ER_OK;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        QStatus s = shards[i]->Join();
+        if (ER_OK == status) {
+            status = s;
+        }
+    }
+    return status;
+}
+
+bool ShardedIODispatch::IsTimerCallbackThread() const
+{
+    for (size_t i = 0; i < shards.size(); ++i) {
+        if (shards[i]->IsTimerCallbackThread()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+IODispatch& ShardedIODispatch::ShardFor(const Stream* stream) const
+{
+    if (shards.size() == 1) {
+        return *shards[0];
+    }
+    /*
+     * Streams are heap objects whose addresses share their low bits, so use
+     * Fibonacci hashing and take the high bits of the product.
+     */
+    uint64_t hash = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(stream)) * 0x9E3779B97F4A7C15ULL;
+    return *shards[static_cast<size_t>((hash >> 32) % shards.size())];
+}
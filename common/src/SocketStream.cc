@@ -303,6 +303,36 @@ QStatus SocketStream::PushBytes(const void* buf, size_t numBytes, size_t& numSen
     return status;
 }
 
+QStatus SocketStream::PushBytesV(const IOVec* iov, size_t numIov, size_t& numSent, uint32_t ttl)
+{
+    if (numIov == 0) {
+        numSent = 0;
+        return ER_OK;
+    }
+    /* There is no point waiting for room in the socket after the first message has expired */
+    uint32_t timeout = ((ttl != 0) && (ttl < sendTimeout)) ? ttl : sendTimeout;
+    QStatus status;
+    for (;;) {
+        if (!isConnected) {
+            return ER_WRITE_ERROR;
+        }
+        status = qcc::SendV(sock, iov, numIov, numSent);
+        if (ER_WOULDBLOCK == status) {
+            if (timeout == Event::WAIT_FOREVER) {
+                status = Event::Wait(*sinkEvent);
+            } else {
+                status = Event::Wait(*sinkEvent, timeout);
+            }
+            if (ER_OK != status) {
+                break;
+            }
+        } else {
+            break;
+        }
+    }
+    return status;
+}
+
 QStatus SocketStream::PushBytesAndFds(const void* buf, size_t numBytes, size_t& numSent, SocketFd* fdList, size_t numFds, uint32_t pid)
 {
     if (numBytes == 0) {
@@ -23,7 +23,9 @@
 #ifdef CRYPTO_CNG
 #include <qcc/CngCache.h>
 #endif
+#include <qcc/CryptoECCp256.h>
 #include <qcc/Logger.h>
+#include <qcc/Metrics.h>
 #include <qcc/String.h>
 #include <qcc/Thread.h>
 #include <qcc/Util.h>
@@ -62,6 +64,7 @@ class StaticGlobals {
         String::Init();
         DebugControl::Init();
         LoggerSetting::Init();
+        Metrics::Init();
         QStatus status = Thread::StaticInit();
         if (status != ER_OK) {
             Shutdown();
@@ -72,13 +75,16 @@ class StaticGlobals {
             Shutdown();
             return status;
         }
+        ec_scalarmul_cache_init();
         return ER_OK;
     }
 
     static QStatus Shutdown()
     {
+        ec_scalarmul_cache_shutdown();
         Crypto::Shutdown();
         Thread::StaticShutdown();
+        Metrics::Shutdown();
         LoggerSetting::Shutdown();
         DebugControl::Shutdown();
         String::Shutdown();
@@ -1,7 +1,7 @@
 /**
  * @file
  *
- * Simple ThreadPool using Timers and Alarms
+ * Work-stealing ThreadPool
  */
 
 /******************************************************************************
@@ -20,94 +20,189 @@
  *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  ******************************************************************************/
 
+#include <deque>
+
+#include <qcc/Debug.h>
+#include <qcc/StringUtil.h>
+#include <qcc/Thread.h>
 #include <qcc/ThreadPool.h>
 
 #define QCC_MODULE "THREADPOOL"
 
 namespace qcc {
 
-void Runnable::AlarmTriggered(const Alarm& alarm, QStatus reason)
-{
-    QCC_UNUSED(alarm);
-    QCC_UNUSED(reason);
+/*
+ * A thread of a ThreadPool along with its queue of closures.  The owning worker
+ * uses the back of the queue and other workers steal from the front.
+ */
+class ThreadPoolWorker : public Thread {
+  public:
+    ThreadPoolWorker(const String& name, ThreadPool* pool) : Thread(name), threadId(0), pool(pool) { }
 
-    QCC_DbgPrintf(("Runnable::AlarmTriggered()"));
+    /*
+     * Add a closure to the back of the queue.  The queue takes over the
+     * caller's reference to the closure.
+     */
+    void Push(Runnable* runnable)
+    {
+        queueLock.Lock();
+        queue.push_back(runnable);
+        queueLock.Unlock();
+    }
 
     /*
-     * Execute the user's provided run function.  Note that this is done in an
-     * OS-specific context.  For example, on Linux-based systems, this may
-     * happen in the context of a pthread from the Timer; but on Windows systems
-     * it may happen in the context of an asynchronous OS callback.
+     * Take a closure from the back (own == true) or front (own == false) of the
+     * queue, or return NULL if the queue is empty.
      */
-    Run();
+    Runnable* Pop(bool own)
+    {
+        Runnable* runnable = NULL;
+        queueLock.Lock();
+        if (!queue.empty()) {
+            if (own) {
+                runnable = queue.back();
+                queue.pop_back();
+            } else {
+                runnable = queue.front();
+                queue.pop_front();
+            }
+        }
+        queueLock.Unlock();
+        return runnable;
+    }
+
+    bool HasWork()
+    {
+        queueLock.Lock();
+        bool hasWork = !queue.empty();
+        queueLock.Unlock();
+        return hasWork;
+    }
 
     /*
-     * Tell the threadpool that we are done with this runnable object.  This
-     * allows the threadpool to release its reference to the object which may
-     * result in an immediate delete of the object.  So one must never refer to
-     * the underlying runnable after this point.
+     * Drop the closures that never ran.  Only called once the worker has exited.
      */
-    m_threadpool->Release(this);
+    void Clear()
+    {
+        queueLock.Lock();
+        while (!queue.empty()) {
+            queue.front()->DecRef();
+            queue.pop_front();
+        }
+        queueLock.Unlock();
+    }
+
+    /* Set once the thread is running, used to recognize Execute() calls made from a worker */
+    volatile ThreadId threadId;
+
+  protected:
+    ThreadReturn STDCALL Run(void* arg);
+
+  private:
+    ThreadPoolWorker& operator=(const ThreadPoolWorker&);
+
+    ThreadPool* pool;
+    Mutex queueLock;
+    std::deque<Runnable*> queue;
+};
+
+ThreadReturn STDCALL ThreadPoolWorker::Run(void* arg)
+{
+    QCC_UNUSED(arg);
+
+    threadId = GetCurrentThreadId();
+    while (!pool->m_stopping) {
+        Runnable* runnable = pool->TakeWork(this);
+        if (runnable) {
+            /*
+             * Execute the user's provided run function then drop the reference
+             * the queue held, which may delete the closure.
+             */
+            runnable->Run();
+            runnable->DecRef();
+            pool->Release();
+        } else {
+            pool->WaitForWork(this);
+        }
+    }
+    return 0;
 }
 
 ThreadPool::ThreadPool(const char* name, uint32_t poolsize)
-    : m_stopping(false), m_poolsize(poolsize), m_dispatcher(name, false, poolsize)
+    : m_stopping(false), m_poolsize(poolsize), m_pending(0), m_waiters(0), m_nextWorker(0), m_idle(0), m_workers(poolsize)
 {
     QCC_DbgPrintf(("ThreadPool::ThreadPool()"));
 
     QCC_ASSERT(poolsize && "ThreadPool::ThreadPool(): Empty pools are no good for anyone");
 
-    /*
-     * Start the dispatcher Timer.  The Timer is the code that will cause alarms
-     * to be executed.  It is the alarms that provide the callbacks that the
-     * timer will fire.  Our timer will have a concurrency variable that
-     * corresponds to the poolsize provided.  This means that there will be
-     * <poolsize> theads waiting to dispatch expired alarms (either AllJoyn
-     * created in Posix systems or OS dispatched in Windows systems).  The
-     * concurrent threads in the Timer provide us with the thread pool we
-     * actually use.
-     */
-    m_dispatcher.Start();
+    for (uint32_t i = 0; i < poolsize; ++i) {
+        m_workers[i] = new ThreadPoolWorker(String(name) + "_" + U32ToString(i), this);
+    }
+    for (uint32_t i = 0; i < poolsize; ++i) {
+        QStatus status = m_workers[i]->Start();
+        if (status != ER_OK) {
+            QCC_LogError(status, ("ThreadPool::ThreadPool(): Failed to start worker %u", i));
+        }
+    }
 
     /*
      * Set the event that callers will ultimately use to sleep on until a thread
-     * becomes available.  We just created a Timer dispatcher which has
-     * concurrency of at least one, so there is definitely a thread available.
+     * becomes available.  There are no closures yet so there is definitely a
+     * thread available.
      */
     m_event.SetEvent();
 }
 
 ThreadPool::~ThreadPool()
 {
-    QCC_DbgPrintf(("ThreadPool::~ThreadPool(): %d closures remain", m_closures.size()));
+    QCC_DbgPrintf(("ThreadPool::~ThreadPool(): %d closures remain", m_pending));
     Stop();
     Join();
 
     /*
-     * We have joined the underlying timer, so all of its threads must be
-     * stopped.  That doesn't necessarily mean that they have executed the
-     * AlarmTriggered() function that would take the closure off of the
-     * pending closures list.  In this case, we need to make sure we clear
-     * the closures map so we release the underlying Ptr and free the
-     * runnable.
+     * We have joined the workers so none of them is running a closure, but
+     * there may be closures that were queued and never ran.  Release them.
      */
-    m_closures.clear();
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        m_workers[i]->Clear();
+        delete m_workers[i];
+    }
+    m_workers.clear();
 }
 
 QStatus ThreadPool::Stop()
 {
     QCC_DbgPrintf(("ThreadPool::Stop()"));
     m_stopping = true;
-    QStatus status = m_dispatcher.Stop();
-    return status;
 
+    /*
+     * Wake the idle workers so they see m_stopping, and anyone waiting for a
+     * thread to become available.
+     */
+    m_idleLock.Lock();
+    m_idleCondition.Broadcast();
+    m_idleLock.Unlock();
+    m_lock.Lock();
+    m_event.SetEvent();
+    m_lock.Unlock();
+
+    QStatus status = ER_OK;
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        QStatus tStatus = m_workers[i]->Stop();
+        status = (status == ER_OK) ? tStatus : status;
+    }
+    return status;
 }
 
 QStatus ThreadPool::Join()
 {
     QCC_DbgPrintf(("ThreadPool::Join()"));
     QCC_ASSERT(m_stopping && "ThreadPool::Join(): must have previously Stop()ped");
-    QStatus status = m_dispatcher.Join();
+    QStatus status = ER_OK;
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        QStatus tStatus = m_workers[i]->Join();
+        status = (status == ER_OK) ? tStatus : status;
+    }
     return status;
 }
 
@@ -120,29 +215,17 @@ QStatus ThreadPool::Join()
 uint32_t ThreadPool::GetN(void)
 {
     QCC_DbgPrintf(("ThreadPool::GetN()"));
-
-    uint32_t n = 0;
-    QCC_DbgPrintf(("ThreadPool::GetN(): Taking lock"));
-    m_lock.Lock();
-    n = m_closures.size();
-    QCC_DbgPrintf(("ThreadPool::GetN(): Giving lock"));
-    m_lock.Unlock();
-    return n;
+    return static_cast<uint32_t>(m_pending);
 }
 
 QStatus ThreadPool::Execute(Ptr<Runnable> runnable)
 {
     QCC_DbgPrintf(("ThreadPool::Execute()"));
 
-    QCC_DbgPrintf(("ThreadPool::Execute(): Taking lock"));
-    m_lock.Lock();
-
     /*
      * Refuse to add any new closures if we're in the process of closing.
      */
     if (m_stopping) {
-        QCC_DbgPrintf(("ThreadPool::Execute(): Giving lock"));
-        m_lock.Unlock();
         QCC_DbgPrintf(("ThreadPool::Execute(): Stopping"));
         return ER_THREADPOOL_STOPPING;
     }
@@ -154,91 +237,112 @@ QStatus ThreadPool::Execute(Ptr<Runnable> runnable)
      * available resources.  This is enabled by returning an error when all of
      * the threads are in process.  This is a thread pool, not a work queue.
      */
-    if (m_closures.size() == m_poolsize) {
-        QCC_DbgPrintf(("ThreadPool::Execute(): Giving lock"));
-        m_lock.Unlock();
+    if (static_cast<uint32_t>(IncrementAndFetch(&m_pending)) > m_poolsize) {
+        Release();
         QCC_DbgPrintf(("ThreadPool::Execute(): Exhausted"));
         return ER_THREADPOOL_EXHAUSTED;
     }
 
+    runnable->SetThreadPool(this);
+
     /*
-     * We need to make sure that the runnable object is kept alive while it is
-     * waiting to be run (and while it is running) so we keep a reference to it
-     * until we don't need it any more.  This also allows us to keep track of
-     * how many pending operations there are.  Note that the map is keyed on the
-     * underlying runnable object pointer, but the smart pointer is saved in the
-     * map in order to hold a reference to the object.
+     * A closure executed from one of our own workers goes on that worker's
+     * queue; anything else is dealt out to the workers in turn.  Either way an
+     * idle worker will steal it if the owner is busy.
      */
-    QCC_DbgPrintf(("ThreadPool::Execute(): Schedule runnable"));
-    m_closures[runnable.Peek()] = runnable;
-    QCC_DbgPrintf(("ThreadPool::Execute(): %d closures remain", m_closures.size()));
+    ThreadPoolWorker* worker = NULL;
+    ThreadId self = Thread::GetCurrentThreadId();
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        if (m_workers[i]->threadId == self) {
+            worker = m_workers[i];
+            break;
+        }
+    }
+    if (!worker) {
+        uint32_t next = static_cast<uint32_t>(IncrementAndFetch(&m_nextWorker));
+        worker = m_workers[next % m_poolsize];
+    }
 
     /*
-     * Tell the runnable object where to contact us when it is done executing.
-     * Since we're not the one that is actually going to dispatch the thread
-     * we need to have whatever thread that goes in there call us us back so
-     * we can know when to release the object.
+     * The queue holds a reference to the closure until a worker has run it.
      */
-    runnable->SetThreadPool(this);
+    Runnable* closure = runnable.Peek();
+    closure->IncRef();
+    worker->Push(closure);
 
     /*
-     * The trick here is to add an alarm that expires immediately and executes
-     * the AlarmTriggered method of the provided Runnable object.  This will
-     * call the Run() method of the Runnable.  So although we use Timers and
-     * Alarms, we schedule everthing to happen immediately, and the result looks
-     * like a thread pool that we all know and love.
-     *
-     * Since <runnable> is a smart pointer, we need to get the underlying object
-     * pointer using Peek().  This object pointer is automagically cast to an
-     * AlarmListener which defines which actual callback which the alarm will
-     * call.
+     * CompareAndExchange() is a full barrier so m_idle is read after the
+     * closure was queued.  A worker going idle increments m_idle before it
+     * looks at the queues one last time, so either it sees the closure or we
+     * see it and wake it.
      */
-    uint32_t zero = 0;
-    void* voidptr = NULL;
-    AlarmListener* listener = runnable.Peek();
-    Alarm alarm = Alarm(zero, listener, voidptr, zero);
-    QCC_DbgPrintf(("ThreadPool::Execute(): AddAlarm()"));
-    QStatus status = m_dispatcher.AddAlarm(alarm);
-    QCC_DbgPrintf(("ThreadPool::Execute(): Giving lock"));
-    m_lock.Unlock();
-    return status;
+    if (!CompareAndExchange(&m_idle, 0, 0)) {
+        m_idleLock.Lock();
+        m_idleCondition.Signal();
+        m_idleLock.Unlock();
+    }
+    return ER_OK;
 }
 
-void ThreadPool::Release(Runnable* runnable)
+Runnable* ThreadPool::TakeWork(ThreadPoolWorker* worker)
 {
-    QCC_DbgPrintf(("ThreadPool::Release()"));
+    Runnable* runnable = worker->Pop(true);
+    if (runnable) {
+        return runnable;
+    }
 
     /*
-     * After the closure corresponding to the Runnable pointer above has finished
-     * executing, it needs to call us back here and tell us that its heap object is
-     * no longer required; and that we can release our hold on that object.
-     *
-     * We save a smart pointer to the Runnable in our m_closures map, so we need to
-     * erase that entry.  Since the entry is a smart pointer, the act of erasing it
-     * will cause the reference count of the object to be decremented and the
-     * underlying object to be deleted if possible.
+     * Our own queue is empty so steal the oldest closure from another worker,
+     * starting with the next one along so thieves spread over the victims.
      */
-    QCC_DbgPrintf(("ThreadPool::Release(): Taking lock"));
-    m_lock.Lock();
-    QCC_DbgPrintf(("ThreadPool::Release(): Got lock"));
+    size_t numWorkers = m_workers.size();
+    size_t self = 0;
+    while (m_workers[self] != worker) {
+        ++self;
+    }
+    for (size_t i = 1; i < numWorkers; ++i) {
+        runnable = m_workers[(self + i) % numWorkers]->Pop(false);
+        if (runnable) {
+            break;
+        }
+    }
+    return runnable;
+}
+
+void ThreadPool::WaitForWork(ThreadPoolWorker* worker)
+{
+    QCC_UNUSED(worker);
+
+    m_idleLock.Lock();
+    IncrementAndFetch(&m_idle);
+    bool hasWork = false;
+    for (size_t i = 0; !hasWork && (i < m_workers.size()); ++i) {
+        hasWork = m_workers[i]->HasWork();
+    }
+    if (!hasWork && !m_stopping) {
+        m_idleCondition.Wait(m_idleLock);
+    }
+    DecrementAndFetch(&m_idle);
+    m_idleLock.Unlock();
+}
 
-    RunnableEntry::iterator i = m_closures.find(runnable);
-    QCC_ASSERT(i != m_closures.end() && "ThreadPool::Release(): Cannot find closure to release");
-    m_closures.erase(i);
+void ThreadPool::Release(void)
+{
+    QCC_DbgPrintf(("ThreadPool::Release()"));
 
     /*
      * Release needs to work in conjunction with Execute() and
-     * WaitForAvailableThread() to ensure that no than m_poolSize threads are
-     * dispatched at any one time.  We set an event every time a thread
-     * completes its Run() method which can then wake up an external thread
-     * waiting for an available thread to do its work.
+     * WaitForAvailableThread() to ensure that no than m_poolSize closures are
+     * accepted at any one time.  DecrementAndFetch() is a full barrier so
+     * m_waiters is read after the count drops; a waiter increments m_waiters
+     * before it reads the count so either it sees the slot or we wake it.
      */
-    m_event.SetEvent();
-
-    QCC_DbgPrintf(("ThreadPool::Release(): %d closures remain", m_closures.size()));
-
-    QCC_DbgPrintf(("ThreadPool::Release(): Giving lock"));
-    m_lock.Unlock();
+    DecrementAndFetch(&m_pending);
+    if (m_waiters) {
+        m_lock.Lock();
+        m_event.SetEvent();
+        m_lock.Unlock();
+    }
 }
 
 QStatus ThreadPool::WaitForAvailableThread(void)
@@ -248,7 +352,7 @@ QStatus ThreadPool::WaitForAvailableThread(void)
     /*
      * Our job here is loop until a thread is available to execute a closure.
      */
-    QCC_DbgPrintf(("ThreadPool::WaitForAvailableThread(): Taking lock"));
+    IncrementAndFetch(&m_waiters);
     m_lock.Lock();
 
     for (;;) {
@@ -257,56 +361,29 @@ QStatus ThreadPool::WaitForAvailableThread(void)
          * We can't have an available thread if we're stopping.
          */
         if (m_stopping) {
-            QCC_DbgPrintf(("ThreadPool::WaitforAvailableThread(): Giving lock"));
             m_lock.Unlock();
+            DecrementAndFetch(&m_waiters);
             QCC_DbgPrintf(("ThreadPool::WaitForAvailableThread(): Stopping"));
             return ER_THREADPOOL_STOPPING;
         }
 
-        QCC_DbgPrintf(("ThreadPool::WaitForAvailableThread(): m_closures.size() == %d.", m_closures.size()));
-        QCC_DbgPrintf(("ThreadPool::WaitForAvailableThread(): m_poolsize == %d.", m_poolsize));
-
         /*
-         * There are no available threads for us to use doing our work, so we
-         * must block until one of them completes.  When one completes, in its
-         * Release() function, it will do a SetEvent() on our wait event to let
-         * us know that it is done.  We reset this event here, with the shared
-         * lock taken.  This ensures that there can be no Release() in progress
-         * and when the next one happens we will be notified.
-         *
-         * This may seem a peculiar place to put this reset, but there is a
-         * method to my madness.  It turns out that SetEvent() is implemented by
-         * a write to an FD.  ResetEvent reads the file and empties it.  If the
-         * Release() function always does a SetEvent(), it writes characters to
-         * the underlying file.  If that file is never read, it eventually
-         * blocks writes and SetEvent() blocks.  So there must be ResetEvent()
-         * calls made to read this file even though we may not need to block and
-         * wait for threads to finish.  Thus, even though the ResetEvent() should
-         * logically go right before the Event::Wait() we do it here to drain
-         * the event file (on Linux).
+         * Release() sets the event with m_lock held, so resetting it here with
+         * the lock held ensures that any Release() that happens after we look
+         * at the count below will wake us.  Resetting it on every pass also
+         * drains the event (on Linux SetEvent() writes to a descriptor that
+         * ResetEvent() reads).
          */
         m_event.ResetEvent();
 
-        /*
-         * We enter the loop with the mutex that interlocks us with the release
-         * method taken.  Since the lock is taken, the release function must
-         * not change its state so we can look around safely and see whether
-         * or not there is currently an available thread.
-         *
-         * There is a closure on the m_closures map for the duration of time
-         * when a Runnable closure is waiting to be executed and while it is in
-         * process.  So, if the size of the m_closures map is less than the pool
-         * size, it means that not all of our thread pool threads are occupied
-         * and at least one is available, so we return.
-         */
-        if (m_closures.size() < m_poolsize) {
-            QCC_DbgPrintf(("ThreadPool::WaitforAvailableThread(): Giving lock"));
+        if (static_cast<uint32_t>(m_pending) < m_poolsize) {
             m_lock.Unlock();
+            DecrementAndFetch(&m_waiters);
             QCC_DbgPrintf(("ThreadPool::WaitForAvailableThread(): Thread available"));
             return ER_OK;
         }
 
-        QCC_DbgPrintf(("ThreadPool::WaitForAvailableThread(): Waiting on thread completion event.  Giving lock"));
+        QCC_DbgPrintf(("ThreadPool::WaitForAvailableThread(): Waiting on thread completion event"));
         m_lock.Unlock();
 
         /*
@@ -319,11 +396,11 @@ QStatus ThreadPool::WaitForAvailableThread(void)
          */
         QStatus status = Event::Wait(m_event, Event::WAIT_FOREVER);
         if (status != ER_OK) {
+            DecrementAndFetch(&m_waiters);
             QCC_DbgPrintf(("ThreadPool::WaitForAvailableThread(): Event::Wait() error"));
             return status;
         }
 
-        QCC_DbgPrintf(("ThreadPool::WaitForAvailableThread(): Taking lock"));
         m_lock.Lock();
     }
 }
@@ -27,9 +27,11 @@
 #include <qcc/Timer.h>
 #include <qcc/StringUtil.h>
 #include <qcc/LockLevel.h>
+#include <qcc/Metrics.h>
 #include <qcc/PerfCounters.h>
 #include <Status.h>
 #include <algorithm>
+#include <string.h>
 
 #define QCC_MODULE  "TIMER"
 
@@ -84,6 +86,420 @@ class TimerThread : public Thread {
     const Alarm* currentAlarm;
 };
 
+/*
+ * The pending alarms of a timer, ordered by alarm time and then by alarm id.
+ */
+class AlarmQueue {
+  public:
+    virtual ~AlarmQueue() { }
+
+    /**
+     * Return true if there are no pending alarms.
+     */
+    virtual bool Empty() const = 0;
+
+    /**
+     * Return the number of pending alarms.
+     */
+    virtual size_t Size() const = 0;
+
+    /**
+     * Get the earliest pending alarm. The queue must not be empty.
+     */
+    virtual const Alarm& Front() = 0;
+
+    /**
+     * Add an alarm. Adding an alarm that is already pending has no effect.
+     */
+    virtual void Insert(const Alarm& alarm) = 0;
+
+    /**
+     * Remove a pending alarm.
+     *
+     * @param alarm         The alarm to remove.
+     * @param matchId       Match on the alarm id alone, used for periodic alarms whose time changes.
+     * @param[out] removed  The alarm that was removed.
+     * @return  true if an alarm was removed.
+     */
+    virtual bool Remove(const Alarm& alarm, bool matchId, Alarm& removed) = 0;
+
+    /**
+     * Remove a pending alarm for a listener.
+     *
+     * @param listener      The listener.
+     * @param[out] removed  The alarm that was removed.
+     * @return  true if an alarm was removed.
+     */
+    virtual bool Remove(const AlarmListener& listener, Alarm& removed) = 0;
+
+    /**
+     * Return true if the alarm is pending.
+     */
+    virtual bool Contains(const Alarm& alarm) const = 0;
+};
+
+class AlarmSet : public AlarmQueue {
+  public:
+    bool Empty() const { return alarms.empty(); }
+
+    size_t Size() const { return alarms.size(); }
+
+    const Alarm& Front() { return *alarms.begin(); }
+
+    void Insert(const Alarm& alarm) { alarms.insert(alarm); }
+
+    bool Remove(const Alarm& alarm, bool matchId, Alarm& removed)
+    {
+        set<Alarm>::iterator it;
+        if (matchId) {
+            for (it = alarms.begin(); it != alarms.end(); ++it) {
+                if ((*it)->id == alarm->id) {
+                    break;
+                }
+            }
+        } else {
+            it = alarms.find(alarm);
+        }
+        if (it == alarms.end()) {
+            return false;
+        }
+        removed = *it;
+        alarms.erase(it);
+        return true;
+    }
+
+    bool Remove(const AlarmListener& listener, Alarm& removed)
+    {
+        for (set<Alarm>::iterator it = alarms.begin(); it != alarms.end(); ++it) {
+            if ((*it)->listener == &listener) {
+                removed = *it;
+                alarms.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Contains(const Alarm& alarm) const { return alarms.count(alarm) != 0; }
+
+  private:
+    std::set<Alarm, std::less<Alarm> > alarms;
+};
+
+/*
+ * Hierarchical timing wheel with a tick of one millisecond.
+ *
+ * Level 0 has a slot for each tick of the current 256 tick block, kept in alarm order. Each higher
+ * level has a slot for each block of the level below in the current block of its own size, and
+ * anything further out waits on an overflow list. The cursor only moves forward to the earliest
+ * pending alarm or the current time, whichever comes first, and the alarms in the slots it moves
+ * into are redistributed to the lower levels. Alarms that are already due are kept in the cursor's
+ * level 0 slot.
+ *
+ * Each pending alarm points at its wheel entry so adding and removing an alarm are O(1). Finding the
+ * earliest alarm scans forward from the cursor and the result is cached until that alarm is removed.
+ * Entries are recycled rather than freed.
+ */
+class TimingWheel : public AlarmQueue {
+  public:
+    TimingWheel() : cursor(0), count(0), front(NULL), freeEntries(NULL)
+    {
+        memset(slots, 0, sizeof(slots));
+        memset(&overflow, 0, sizeof(overflow));
+        Timespec<MonotonicTime> now;
+        GetTimeNow(&now);
+        cursor = ToTick(now);
+    }
+
+    ~TimingWheel()
+    {
+        for (uint32_t level = 0; level < NUM_LEVELS; ++level) {
+            for (uint32_t i = 0; i < NUM_SLOTS; ++i) {
+                DeleteEntries(slots[level][i]);
+            }
+        }
+        DeleteEntries(overflow);
+        while (freeEntries) {
+            Entry* entry = freeEntries;
+            freeEntries = entry->next;
+            delete entry;
+        }
+    }
+
+    bool Empty() const { return count == 0; }
+
+    size_t Size() const { return count; }
+
+    const Alarm& Front()
+    {
+        QCC_ASSERT(count > 0);
+        if (!front) {
+            front = Earliest();
+            Timespec<MonotonicTime> now;
+            GetTimeNow(&now);
+            Advance((std::min)(front->tick, ToTick(now)));
+        }
+        return front->alarm;
+    }
+
+    void Insert(const Alarm& alarm)
+    {
+        if (Find(alarm)) {
+            return;
+        }
+        QCC_ASSERT(!(alarm->wheelEntry && static_cast<Entry*>(alarm->wheelEntry)->alarm.iden(alarm)) &&
+                   "An alarm can only be pending on one timing wheel");
+        Entry* entry = freeEntries;
+        if (entry) {
+            freeEntries = entry->next;
+        } else {
+            entry = new Entry(idleAlarm);
+        }
+        entry->alarm = alarm;
+        entry->tick = ToTick(alarm->alarmTime);
+        entry->wheel = this;
+        alarm->wheelEntry = entry;
+        Place(entry);
+        if (count++ == 0) {
+            front = entry;
+        } else if (front && (*alarm < *front->alarm)) {
+            front = entry;
+        }
+    }
+
+    bool Remove(const Alarm& alarm, bool matchId, Alarm& removed)
+    {
+        /* A periodic alarm is the same object whatever its time so there is no need to search by id */
+        QCC_UNUSED(matchId);
+        Entry* entry = Find(alarm);
+        if (!entry) {
+            return false;
+        }
+        removed = entry->alarm;
+        Release(entry);
+        return true;
+    }
+
+    bool Remove(const AlarmListener& listener, Alarm& removed)
+    {
+        Entry* entry = NULL;
+        for (uint32_t level = 0; !entry && (level < NUM_LEVELS); ++level) {
+            for (uint32_t i = 0; !entry && (i < NUM_SLOTS); ++i) {
+                entry = FindListener(slots[level][i], listener);
+            }
+        }
+        if (!entry) {
+            entry = FindListener(overflow, listener);
+        }
+        if (!entry) {
+            return false;
+        }
+        removed = entry->alarm;
+        Release(entry);
+        return true;
+    }
+
+    bool Contains(const Alarm& alarm) const { return Find(alarm) != NULL; }
+
+  private:
+
+    static const uint32_t SLOT_BITS = 8;
+    static const uint32_t NUM_SLOTS = 1 << SLOT_BITS;
+    static const uint32_t SLOT_MASK = NUM_SLOTS - 1;
+    static const uint32_t NUM_LEVELS = 4;
+
+    struct Slot;
+
+    struct Entry {
+        Alarm alarm;        /* The pending alarm, or idleAlarm while the entry is free */
+        uint64_t tick;      /* Alarm time in milliseconds */
+        Entry* prev;
+        Entry* next;
+        Slot* slot;         /* Slot holding this entry */
+        TimingWheel* wheel;
+        Entry(const Alarm& idle) : alarm(idle), tick(0), prev(NULL), next(NULL), slot(NULL), wheel(NULL) { }
+    };
+
+    struct Slot {
+        Entry* head;
+        Entry* tail;
+    };
+
+    /* Private assignment operator - does nothing */
+    TimingWheel& operator=(const TimingWheel&);
+
+    /* Alarms that never expire are far enough out for GetMillis() to overflow */
+    static uint64_t ToTick(const Timespec<MonotonicTime>& time)
+    {
+        return (time.seconds >= (END_OF_TIME / 1000)) ? END_OF_TIME : time.GetMillis();
+    }
+
+    Entry* Find(const Alarm& alarm) const
+    {
+        Entry* entry = static_cast<Entry*>(alarm->wheelEntry);
+        return (entry && (entry->wheel == this) && entry->alarm.iden(alarm)) ? entry : NULL;
+    }
+
+    static Entry* FindListener(const Slot& slot, const AlarmListener& listener)
+    {
+        for (Entry* entry = slot.head; entry; entry = entry->next) {
+            if (entry->alarm->listener == &listener) {
+                return entry;
+            }
+        }
+        return NULL;
+    }
+
+    void Place(Entry* entry)
+    {
+        uint64_t tick = (std::max)(entry->tick, cursor);
+        uint64_t diff = tick ^ cursor;
+        if (diff < NUM_SLOTS) {
+            /* Level 0 slots are kept in alarm order, usually by appending */
+            Slot& slot = slots[0][tick & SLOT_MASK];
+            Entry* pos = slot.tail;
+            while (pos && (*entry->alarm < *pos->alarm)) {
+                pos = pos->prev;
+            }
+            Link(slot, pos, entry);
+            return;
+        }
+        for (uint32_t level = 1; level < NUM_LEVELS; ++level) {
+            if ((diff >> (SLOT_BITS * (level + 1))) == 0) {
+                Slot& slot = slots[level][(tick >> (SLOT_BITS * level)) & SLOT_MASK];
+                Link(slot, slot.tail, entry);
+                return;
+            }
+        }
+        Link(overflow, overflow.tail, entry);
+    }
+
+    /* Link entry into slot after pos, or at the head if pos is NULL */
+    static void Link(Slot& slot, Entry* pos, Entry* entry)
+    {
+        entry->slot = &slot;
+        entry->prev = pos;
+        entry->next = pos ? pos->next : slot.head;
+        if (entry->next) {
+            entry->next->prev = entry;
+        } else {
+            slot.tail = entry;
+        }
+        if (pos) {
+            pos->next = entry;
+        } else {
+            slot.head = entry;
+        }
+    }
+
+    static void Unlink(Entry* entry)
+    {
+        Slot& slot = *entry->slot;
+        if (entry->prev) {
+            entry->prev->next = entry->next;
+        } else {
+            slot.head = entry->next;
+        }
+        if (entry->next) {
+            entry->next->prev = entry->prev;
+        } else {
+            slot.tail = entry->prev;
+        }
+        entry->prev = entry->next = NULL;
+        entry->slot = NULL;
+    }
+
+    void Release(Entry* entry)
+    {
+        Unlink(entry);
+        if (front == entry) {
+            front = NULL;
+        }
+        entry->alarm->wheelEntry = NULL;
+        entry->alarm = idleAlarm;
+        entry->wheel = NULL;
+        entry->next = freeEntries;
+        freeEntries = entry;
+        --count;
+    }
+
+    static Entry* Earliest(const Slot& slot)
+    {
+        Entry* earliest = slot.head;
+        for (Entry* entry = slot.head; entry; entry = entry->next) {
+            if (*entry->alarm < *earliest->alarm) {
+                earliest = entry;
+            }
+        }
+        return earliest;
+    }
+
+    Entry* Earliest() const
+    {
+        for (uint32_t i = cursor & SLOT_MASK; i < NUM_SLOTS; ++i) {
+            if (slots[0][i].head) {
+                return slots[0][i].head;
+            }
+        }
+        /* The cursor's own slot is empty on the higher levels */
+        for (uint32_t level = 1; level < NUM_LEVELS; ++level) {
+            for (uint32_t i = ((cursor >> (SLOT_BITS * level)) & SLOT_MASK) + 1; i < NUM_SLOTS; ++i) {
+                if (slots[level][i].head) {
+                    return Earliest(slots[level][i]);
+                }
+            }
+        }
+        return Earliest(overflow);
+    }
+
+    /* Move the cursor forward to tick, which must not be past any pending alarm */
+    void Advance(uint64_t tick)
+    {
+        if (tick <= cursor) {
+            return;
+        }
+        uint64_t prevCursor = cursor;
+        cursor = tick;
+        if ((prevCursor >> (SLOT_BITS * NUM_LEVELS)) != (tick >> (SLOT_BITS * NUM_LEVELS))) {
+            Redistribute(overflow);
+        }
+        for (uint32_t level = NUM_LEVELS - 1; level > 0; --level) {
+            if ((prevCursor >> (SLOT_BITS * level)) != (tick >> (SLOT_BITS * level))) {
+                Redistribute(slots[level][(tick >> (SLOT_BITS * level)) & SLOT_MASK]);
+            }
+        }
+    }
+
+    void Redistribute(Slot& slot)
+    {
+        Entry* entry = slot.head;
+        slot.head = slot.tail = NULL;
+        while (entry) {
+            Entry* next = entry->next;
+            Place(entry);
+            entry = next;
+        }
+    }
+
+    static void DeleteEntries(Slot& slot)
+    {
+        while (slot.head) {
+            Entry* entry = slot.head;
+            slot.head = entry->next;
+            entry->alarm->wheelEntry = NULL;
+            delete entry;
+        }
+    }
+
+    Slot slots[NUM_LEVELS][NUM_SLOTS];
+    Slot overflow;
+    uint64_t cursor;        /* No pending alarm is earlier than the cursor except those already due */
+    size_t count;
+    Entry* front;           /* Cached earliest alarm or NULL if not known */
+    Entry* freeEntries;
+    Alarm idleAlarm;        /* Held by free entries so recycling an entry does not allocate */
+};
+
 class TimerImpl : public ThreadListener {
     friend class TimerThread;
 
@@ -97,8 +513,9 @@ class TimerImpl : public ThreadListener {
      * @param concurrency        Dispatch up to this number of alarms concurrently (using multiple threads).
      * @param prevenReentrancy   Prevent re-entrant call of AlarmTriggered.
      * @param maxAlarms          Maximum number of outstanding alarms allowed before blocking calls to AddAlarm or 0 for infinite.
+     * @param queueType          How the pending alarms are kept.
      */
-    TimerImpl(qcc::String name, bool expireOnExit, uint32_t concurrency, bool preventReentrancy, uint32_t maxAlarms);
+    TimerImpl(qcc::String name, bool expireOnExit, uint32_t concurrency, bool preventReentrancy, uint32_t maxAlarms, Timer::AlarmQueueType queueType);
 
     /**
      * Destructor.
@@ -261,7 +678,7 @@ class TimerImpl : public ThreadListener {
     TimerImpl& operator=(const TimerImpl&);
 
     mutable Mutex lock;
-    std::set<Alarm, std::less<Alarm> >  alarms;
+    AlarmQueue* alarms;
     Alarm* currentAlarm;
     bool expireOnExit;
     std::vector<TimerThread*> timerThreads;
@@ -274,13 +691,16 @@ class TimerImpl : public ThreadListener {
     const uint32_t maxAlarms;
     uint32_t numLimitableAlarms;               /**< Number of alarms currently in the alarm queue that count towards the limit */
     std::deque<qcc::Thread*> addWaitQueue;     /**< Threads waiting for alarms set to become not-full */
+    MetricHistogram* alarmLateMsec;            /**< How long alarms wait past their due time for a timer thread */
+    MetricHistogram* alarmQueueDepth;          /**< Number of alarms still pending each time one is triggered */
 
 };
 
 }
 
-TimerImpl::TimerImpl(String name, bool expireOnExit, uint32_t concurrency, bool preventReentrancy, uint32_t maxAlarms) :
+TimerImpl::TimerImpl(String name, bool expireOnExit, uint32_t concurrency, bool preventReentrancy, uint32_t maxAlarms, Timer::AlarmQueueType queueType) :
     lock(LOCK_LEVEL_TIMERIMPL_LOCK),
+    alarms((queueType == Timer::TIMING_WHEEL) ? static_cast<AlarmQueue*>(new TimingWheel()) : static_cast<AlarmQueue*>(new AlarmSet())),
     currentAlarm(NULL),
     expireOnExit(expireOnExit),
     timerThreads(concurrency),
@@ -290,7 +710,9 @@ TimerImpl::TimerImpl(String name, bool expireOnExit, uint32_t concurrency, bool
     reentrancyLock(LOCK_LEVEL_TIMERIMPL_REENTRANCYLOCK),
     nameStr(name),
     maxAlarms(maxAlarms),
-    numLimitableAlarms(0)
+    numLimitableAlarms(0),
+    alarmLateMsec(Metrics::GetHistogram("timer.alarm.late.msec")),
+    alarmQueueDepth(Metrics::GetHistogram("timer.alarm.queue.depth"))
 {
     /* TimerImpl thread objects will be created when required */
 }
@@ -305,6 +727,7 @@ TimerImpl::~TimerImpl()
             timerThreads[i] = NULL;
         }
     }
+    delete alarms;
 }
 
 QStatus TimerImpl::Start()
@@ -409,8 +832,8 @@ QStatus TimerImpl::AddAlarm(const Alarm& alarm)
         /* Ensure timer is still running */
         if (isRunning) {
             /* Insert the alarm and alert the TimerImpl thread if necessary */
-            bool alertThread = alarms.empty() || (alarm < *alarms.begin());
-            alarms.insert(alarm);
+            bool alertThread = alarms->Empty() || (alarm < alarms->Front());
+            alarms->Insert(alarm);
             if (alarm->limitable) {
                 numLimitableAlarms++;
             }
@@ -444,8 +867,8 @@ QStatus TimerImpl::AddAlarmNonBlocking(const Alarm& alarm)
         }
 
         /* Insert the alarm and alert the TimerImpl thread if necessary */
-        bool alertThread = alarms.empty() || (alarm < *alarms.begin());
-        alarms.insert(alarm);
+        bool alertThread = alarms->Empty() || (alarm < alarms->Front());
+        alarms->Insert(alarm);
         if (alarm->limitable) {
             numLimitableAlarms++;
         }
@@ -468,27 +891,11 @@ bool TimerImpl::RemoveAlarm(const Alarm& alarm, bool blockIfTriggered)
     bool foundAlarm = false;
     lock.Lock(MUTEX_CONTEXT);
     if (isRunning || expireOnExit) {
-        if (alarm->periodMs) {
-            set<Alarm>::iterator it = alarms.begin();
-            while (it != alarms.end()) {
-                if ((*it)->id == alarm->id) {
-                    foundAlarm = true;
-                    if ((*it)->limitable) {
-                        numLimitableAlarms--;
-                    }
-                    alarms.erase(it);
-                    break;
-                }
-                ++it;
-            }
-        } else {
-            set<Alarm>::iterator it = alarms.find(alarm);
-            if (it != alarms.end()) {
-                foundAlarm = true;
-                if ((*it)->limitable) {
-                    numLimitableAlarms--;
-                }
-                alarms.erase(it);
+        Alarm removed;
+        if (alarms->Remove(alarm, alarm->periodMs != 0, removed)) {
+            foundAlarm = true;
+            if (removed->limitable) {
+                numLimitableAlarms--;
             }
         }
         if (blockIfTriggered && !foundAlarm) {
@@ -522,27 +929,11 @@ bool TimerImpl::ForceRemoveAlarm(const Alarm& alarm, bool blockIfTriggered)
     bool foundAlarm = false;
     lock.Lock(MUTEX_CONTEXT);
     if (isRunning || expireOnExit) {
-        if (alarm->periodMs) {
-            set<Alarm>::iterator it = alarms.begin();
-            while (it != alarms.end()) {
-                if ((*it)->id == alarm->id) {
-                    foundAlarm = true;
-                    if ((*it)->limitable) {
-                        numLimitableAlarms--;
-                    }
-                    alarms.erase(it);
-                    break;
-                }
-                ++it;
-            }
-        } else {
-            set<Alarm>::iterator it = alarms.find(alarm);
-            if (it != alarms.end()) {
-                foundAlarm = true;
-                if ((*it)->limitable) {
-                    numLimitableAlarms--;
-                }
-                alarms.erase(it);
+        Alarm removed;
+        if (alarms->Remove(alarm, alarm->periodMs != 0, removed)) {
+            foundAlarm = true;
+            if (removed->limitable) {
+                numLimitableAlarms--;
             }
         }
         if (blockIfTriggered && !foundAlarm) {
@@ -577,12 +968,11 @@ QStatus TimerImpl::ReplaceAlarm(const Alarm& origAlarm, const Alarm& newAlarm, b
     QStatus status = ER_NO_SUCH_ALARM;
     lock.Lock(MUTEX_CONTEXT);
     if (isRunning) {
-        set<Alarm>::iterator it = alarms.find(origAlarm);
-        if (it != alarms.end()) {
-            if ((*it)->limitable) {
+        Alarm removed;
+        if (alarms->Remove(origAlarm, false, removed)) {
+            if (removed->limitable) {
                 numLimitableAlarms--;
             }
-            alarms.erase(it);
             status = AddAlarm(newAlarm);
         } else if (blockIfTriggered) {
             /*
@@ -615,16 +1005,11 @@ bool TimerImpl::RemoveAlarm(const AlarmListener& listener, Alarm& alarm)
     bool removedOne = false;
     lock.Lock(MUTEX_CONTEXT);
     if (isRunning || expireOnExit) {
-        for (set<Alarm>::iterator it = alarms.begin(); it != alarms.end(); ++it) {
-            if ((*it)->listener == &listener) {
-                alarm = *it;
-                if ((*it)->limitable) {
-                    numLimitableAlarms--;
-                }
-                alarms.erase(it);
-                removedOne = true;
-                break;
+        if (alarms->Remove(listener, alarm)) {
+            if (alarm->limitable) {
+                numLimitableAlarms--;
             }
+            removedOne = true;
         }
         /*
          * This function is most likely being called because the listener is about to be freed. If there
@@ -665,7 +1050,7 @@ bool TimerImpl::HasAlarm(const Alarm& alarm) const
     bool ret = false;
     lock.Lock(MUTEX_CONTEXT);
     if (isRunning) {
-        ret = alarms.count(alarm) != 0;
+        ret = alarms->Contains(alarm);
     }
     lock.Unlock(MUTEX_CONTEXT);
     return ret;
@@ -735,9 +1120,9 @@ ThreadReturn STDCALL TimerThread::Run(void* arg)
          * Check for something to do, either now or at some (alarm) time in the
          * future.
          */
-        if (!timer->alarms.empty()) {
+        if (!timer->alarms->Empty()) {
             QCC_DbgPrintf(("TimerThread::Run(): Alarms pending"));
-            const Alarm topAlarm = *(timer->alarms.begin());
+            const Alarm topAlarm = timer->alarms->Front();
             int64_t delay = topAlarm->alarmTime - now;
 
             /*
@@ -949,13 +1334,12 @@ ThreadReturn STDCALL TimerThread::Run(void* arg)
                  * If it has already been serviced by another thread, just ignore
                  * and go back to the top of the loop.
                  */
-                set<Alarm>::iterator it = timer->alarms.find(topAlarm);
-                if (it != timer->alarms.end()) {
-                    Alarm top = *it;
+                Alarm top;
+                if (timer->alarms->Remove(topAlarm, false, top)) {
                     if (top->limitable) {
                         timer->numLimitableAlarms--;
                     }
-                    timer->alarms.erase(it);
+                    timer->alarmQueueDepth->Record(static_cast<uint32_t>(timer->alarms->Size()));
                     currentAlarm = &top;
                     if (0 < timer->addWaitQueue.size()) {
                         Thread* wakeMe = timer->addWaitQueue.back();
@@ -969,6 +1353,8 @@ ThreadReturn STDCALL TimerThread::Run(void* arg)
 
                     QCC_DbgPrintf(("TimerThread::Run(): ******** AlarmTriggered()"));
                     IncrementPerfCounter(PERF_COUNTER_ALARM_TRIGGERED);
+                    int64_t lateMs = now - top->alarmTime;
+                    timer->alarmLateMsec->Record((lateMs > 0) ? static_cast<uint32_t>(lateMs) : 0);
                     (top->listener->AlarmTriggered)(top, ER_OK);
                     if (hasTimerLock) {
                         hasTimerLock = false;
@@ -1093,16 +1479,15 @@ void TimerImpl::ThreadExit(Thread* thread)
     lock.Lock(MUTEX_CONTEXT);
     if ((!isRunning) && expireOnExit) {
         /* Call all alarms */
-        while (!alarms.empty()) {
+        while (!alarms->Empty()) {
             /*
              * Note it is possible that the callback will call RemoveAlarm()
              */
-            set<Alarm>::iterator it = alarms.begin();
-            Alarm alarm = *it;
+            Alarm alarm;
+            alarms->Remove(alarms->Front(), false, alarm);
             if (alarm->limitable) {
                 numLimitableAlarms--;
             }
-            alarms.erase(it);
             tt->SetCurrentAlarm(&alarm);
             lock.Unlock(MUTEX_CONTEXT);
             tt->hasTimerLock = preventReentrancy;
@@ -1181,8 +1566,8 @@ bool TimerImpl::ThreadHoldsLock() const
     return false;
 }
 
-Timer::Timer(String name, bool expireOnExit, uint32_t concurrency, bool preventReentrancy, uint32_t maxAlarms) :
-    timerImpl(new TimerImpl(name, expireOnExit, concurrency, preventReentrancy, maxAlarms))
+Timer::Timer(String name, bool expireOnExit, uint32_t concurrency, bool preventReentrancy, uint32_t maxAlarms, AlarmQueueType queueType) :
+    timerImpl(new TimerImpl(name, expireOnExit, concurrency, preventReentrancy, maxAlarms, queueType))
 {
     /* Timer thread objects will be created when required */
 }
@@ -320,3 +320,125 @@ TEST(AES_CCMTest, AES_CCM_Test_Vecter) {
     }
 }
 
+
+/*
+ * Straightforward RFC 3610 CCM built on single block ECB encryption, used to
+ * check Encrypt_CCM over lengths the test vectors above do not cover.  The
+ * additional data must be shorter than 0xFF00 bytes.
+ */
+static void ReferenceCCM(Crypto_AES& ecb, const uint8_t* nonce, size_t nonceLen, const uint8_t* addData, size_t addLen,
+                         const uint8_t* msg, size_t msgLen, uint8_t authLen, uint8_t* out)
+{
+    const size_t L = 15 - nonceLen;
+    Crypto_AES::Block A;
+    Crypto_AES::Block S;
+    Crypto_AES::Block X;
+    Crypto_AES::Block B;
+
+    /* CBC-MAC over B_0, the encoded additional data and the padded message */
+    memset(B.data, 0, sizeof(B.data));
+    B.data[0] = static_cast<uint8_t>(((addLen > 0) ? 0x40 : 0) | (((authLen - 2) / 2) << 3) | (L - 1));
+    memcpy(&B.data[1], nonce, nonceLen);
+    for (size_t i = 0; i < L; ++i) {
+        B.data[15 - i] = static_cast<uint8_t>(msgLen >> (8 * i));
+    }
+    ecb.Encrypt(&B, &X, 1);
+    vector<uint8_t> macData;
+    if (addLen > 0) {
+        macData.push_back(static_cast<uint8_t>(addLen >> 8));
+        macData.push_back(static_cast<uint8_t>(addLen));
+        macData.insert(macData.end(), addData, addData + addLen);
+        macData.resize(Crypto_AES::NumBlocks(macData.size()) * sizeof(B.data), 0);
+    }
+    macData.insert(macData.end(), msg, msg + msgLen);
+    macData.resize(Crypto_AES::NumBlocks(macData.size()) * sizeof(B.data), 0);
+    for (size_t pos = 0; pos < macData.size(); pos += sizeof(B.data)) {
+        for (size_t i = 0; i < sizeof(B.data); ++i) {
+            B.data[i] = X.data[i] ^ macData[pos + i];
+        }
+        ecb.Encrypt(&B, &X, 1);
+    }
+
+    /* CTR encryption of the message with A_1, A_2, ... and of the MAC with A_0 */
+    memset(A.data, 0, sizeof(A.data));
+    A.data[0] = static_cast<uint8_t>(L - 1);
+    memcpy(&A.data[1], nonce, nonceLen);
+    for (size_t pos = 0; pos < msgLen; pos += sizeof(A.data)) {
+        for (size_t i = 15; ++A.data[i] == 0; --i) {
+        }
+        ecb.Encrypt(&A, &S, 1);
+        for (size_t i = 0; (i < sizeof(S.data)) && (pos + i < msgLen); ++i) {
+            out[pos + i] = msg[pos + i] ^ S.data[i];
+        }
+    }
+    memset(&A.data[16 - L], 0, L);
+    ecb.Encrypt(&A, &S, 1);
+    for (size_t i = 0; i < authLen; ++i) {
+        out[msgLen + i] = X.data[i] ^ S.data[i];
+    }
+}
+
+static void CheckAgainstReference()
+{
+    /* Cover partial blocks on either side of the multi-block paths */
+    const size_t msgLens[] = { 0, 1, 15, 16, 17, 31, 32, 33, 64, 100, 1024, 4099 };
+    const size_t addLens[] = { 0, 1, 14, 16, 31, 90 };
+    const uint8_t authLens[] = { 8, 16 };
+    uint8_t key[Crypto_AES::AES128_SIZE];
+    uint8_t nonce[13];
+    uint8_t addData[90];
+    vector<uint8_t> msg(4099);
+
+    Crypto_GetRandomBytes(key, sizeof(key));
+    Crypto_GetRandomBytes(addData, sizeof(addData));
+    Crypto_GetRandomBytes(&msg[0], msg.size());
+    KeyBlob kb(key, sizeof(key), KeyBlob::AES);
+    Crypto_AES ecb(kb, Crypto_AES::ECB_ENCRYPT);
+
+    for (size_t nonceLen = 11; nonceLen <= sizeof(nonce); ++nonceLen) {
+        Crypto_GetRandomBytes(nonce, nonceLen);
+        KeyBlob nonceBlob(nonce, nonceLen, KeyBlob::GENERIC);
+        for (size_t m = 0; m < ArraySize(msgLens); ++m) {
+            for (size_t a = 0; a < ArraySize(addLens); ++a) {
+                for (size_t t = 0; t < ArraySize(authLens); ++t) {
+                    size_t msgLen = msgLens[m];
+                    size_t addLen = addLens[a];
+                    uint8_t authLen = authLens[t];
+                    vector<uint8_t> expected(msgLen + authLen);
+                    vector<uint8_t> actual(msgLen + authLen);
+                    vector<uint8_t> decrypted(msgLen + authLen);
+                    ReferenceCCM(ecb, nonce, nonceLen, addData, addLen, &msg[0], msgLen, authLen, &expected[0]);
+
+                    Crypto_AES aes(kb, Crypto_AES::CCM);
+                    size_t len = msgLen;
+                    ASSERT_EQ(ER_OK, aes.Encrypt_CCM(&msg[0], &actual[0], len, nonceBlob, addData, addLen, authLen));
+                    ASSERT_EQ(msgLen + authLen, len);
+                    EXPECT_TRUE(memcmp(&expected[0], &actual[0], len) == 0) << "Mismatch for nonce length " << nonceLen
+                                                                          << " message length " << msgLen
+                                                                          << " additional data length " << addLen
+                                                                          << " MAC length " << static_cast<int>(authLen);
+
+                    ASSERT_EQ(ER_OK, aes.Decrypt_CCM(&actual[0], &decrypted[0], len, nonceBlob, addData, addLen, authLen));
+                    ASSERT_EQ(msgLen, len);
+                    EXPECT_TRUE((msgLen == 0) || (memcmp(&msg[0], &decrypted[0], msgLen) == 0));
+
+                    /* Any change to the MAC must be caught */
+                    actual[msgLen + authLen - 1] ^= 0x01;
+                    len = msgLen + authLen;
+                    EXPECT_EQ(ER_AUTH_FAIL, aes.Decrypt_CCM(&actual[0], &decrypted[0], len, nonceBlob, addData, addLen, authLen));
+                }
+            }
+        }
+    }
+}
+
+TEST(AES_CCMTest, AES_CCM_Matches_Reference) {
+    CheckAgainstReference();
+}
+
+/* Where CCM uses CPU instructions, also check the portable implementation */
+TEST(AES_CCMTest, AES_CCM_Portable_Matches_Reference) {
+    bool hardware = Crypto_AES::EnableHardwareCCM(false);
+    CheckAgainstReference();
+    Crypto_AES::EnableHardwareCCM(hardware);
+}
@@ -20,6 +20,7 @@
 #include <qcc/Crypto.h>
 #include <qcc/CryptoECC.h>
 #include <qcc/CryptoECCMath.h>
+#include <qcc/CryptoECCp256.h>
 
 /* For ECCPublicKeyImportInitializeHandles test, which only applies to Windows CNG. */
 #ifdef CRYPTO_CNG
@@ -417,6 +418,130 @@ TEST_F(CryptoECCTest, ECCPublicKeyImportInvalid)
     }
 }
 
+static void RandomScalar(digit256_t k, ec_t* curve)
+{
+    do {
+        ASSERT_EQ(ER_OK, Crypto_GetRandomBytes((uint8_t*)k, sizeof(digit256_t)));
+    } while (fpiszero_p256(k) || !validate_256(k, curve->order));
+}
+
+/**
+ * Test the built-in generator table and fixed-base scalar multiplication against ec_scalarmul.
+ */
+TEST_F(CryptoECCTest, FixedBaseScalarMul)
+{
+    ec_t curve;
+    ecpoint_t g;
+    ecpoint_t expected;
+    ecpoint_t actual;
+    digit256_t k;
+    ec_fixedbase_table_t* table = new ec_fixedbase_table_t;
+
+    ASSERT_EQ(ER_OK, ec_getcurve(&curve, NISTP256r1));
+    ec_get_generator(&g, &curve);
+    ASSERT_NE(nullptr, ec_get_generator_table(&curve));
+    EXPECT_EQ(ER_OK, ec_fixedbase_precomp(&g, table, &curve));
+    EXPECT_EQ(0, memcmp(table, ec_get_generator_table(&curve), sizeof(ec_fixedbase_table_t))) << "Generator table differs from the computed one";
+
+    for (size_t i = 0; i < 100; ++i) {
+        switch (i) {
+        case 0:
+        case 1:
+            /* Smallest odd and even scalars */
+            fpzero_p256(k);
+            k[0] = i + 1;
+            break;
+
+        case 2:
+            /* Largest scalar, r - 1 */
+            fpcopy_p256(curve.order, k);
+            k[0] -= 1;
+            break;
+
+        default:
+            RandomScalar(k, &curve);
+        }
+        EXPECT_EQ(ER_OK, ec_scalarmul(&g, k, &expected, &curve));
+        EXPECT_EQ(ER_OK, ec_scalarmul_fixedbase(ec_get_generator_table(&curve), k, &actual, &curve));
+        EXPECT_EQ(0, memcmp(&expected, &actual, sizeof(ecpoint_t))) << "Fixed-base scalar multiplication failed at iteration " << i;
+    }
+
+    /* Scalars that ec_scalarmul rejects are rejected too */
+    fpzero_p256(k);
+    EXPECT_EQ(ER_INVALID_DATA, ec_scalarmul(&g, k, &expected, &curve));
+    EXPECT_EQ(ER_INVALID_DATA, ec_scalarmul_fixedbase(ec_get_generator_table(&curve), k, &actual, &curve));
+    memset(k, 0xFF, sizeof(digit256_t));
+    EXPECT_EQ(ER_INVALID_DATA, ec_scalarmul(&g, k, &expected, &curve));
+    EXPECT_EQ(ER_INVALID_DATA, ec_scalarmul_fixedbase(ec_get_generator_table(&curve), k, &actual, &curve));
+
+    delete table;
+    ec_freecurve(&curve);
+}
+
+/**
+ * Test that multiplying the same point repeatedly, once it has a cached table, gives the results of ec_scalarmul.
+ */
+TEST_F(CryptoECCTest, CachedScalarMul)
+{
+    ec_t curve;
+    ecpoint_t g;
+    ecpoint_t P;
+    ecpoint_t expected;
+    ecpoint_t actual;
+    digit256_t k;
+
+    ASSERT_EQ(ER_OK, ec_getcurve(&curve, NISTP256r1));
+    ec_get_generator(&g, &curve);
+    RandomScalar(k, &curve);
+    ASSERT_EQ(ER_OK, ec_scalarmul(&g, k, &P, &curve));
+
+    for (size_t i = 0; i < 20; ++i) {
+        RandomScalar(k, &curve);
+        EXPECT_EQ(ER_OK, ec_scalarmul(&P, k, &expected, &curve));
+        EXPECT_EQ(ER_OK, ec_scalarmul_cached(&P, k, &actual, &curve));
+        EXPECT_EQ(0, memcmp(&expected, &actual, sizeof(ecpoint_t))) << "Cached scalar multiplication failed at iteration " << i;
+    }
+
+    ec_freecurve(&curve);
+}
+
+/**
+ * Test that points multiplied once, which are remembered but get no cache entry, and points
+ * admitted on their second use both give the results of ec_scalarmul.
+ */
+TEST_F(CryptoECCTest, CachedScalarMulSingleUsePoints)
+{
+    ec_t curve;
+    ecpoint_t g;
+    ecpoint_t P;
+    ecpoint_t once;
+    ecpoint_t expected;
+    ecpoint_t actual;
+    digit256_t k;
+
+    ASSERT_EQ(ER_OK, ec_getcurve(&curve, NISTP256r1));
+    ec_get_generator(&g, &curve);
+    RandomScalar(k, &curve);
+    ASSERT_EQ(ER_OK, ec_scalarmul(&g, k, &P, &curve));
+
+    for (size_t i = 0; i < 40; ++i) {
+        /* More single-use points than are remembered, interleaved with a point that keeps its table */
+        RandomScalar(k, &curve);
+        ASSERT_EQ(ER_OK, ec_scalarmul(&g, k, &once, &curve));
+        RandomScalar(k, &curve);
+        EXPECT_EQ(ER_OK, ec_scalarmul(&once, k, &expected, &curve));
+        EXPECT_EQ(ER_OK, ec_scalarmul_cached(&once, k, &actual, &curve));
+        EXPECT_EQ(0, memcmp(&expected, &actual, sizeof(ecpoint_t))) << "Single-use multiplication failed at iteration " << i;
+
+        RandomScalar(k, &curve);
+        EXPECT_EQ(ER_OK, ec_scalarmul(&P, k, &expected, &curve));
+        EXPECT_EQ(ER_OK, ec_scalarmul_cached(&P, k, &actual, &curve));
+        EXPECT_EQ(0, memcmp(&expected, &actual, sizeof(ecpoint_t))) << "Cached scalar multiplication failed at iteration " << i;
+    }
+
+    ec_freecurve(&curve);
+}
+
 #ifdef CRYPTO_CNG
 /**
  * Test correct initialization of CNG provider handles without use of a
@@ -183,3 +183,71 @@ TEST(SHA256_Test, SHA256_Test_Vector) {
         EXPECT_STREQ(dig, hex.c_str());
     }
 }
+
+TEST(SHA256_Test, SHA256_Million_a) {
+    /* Exercises the compression function over many blocks fed in odd sized pieces */
+    Crypto_SHA256 hash;
+    uint8_t digest[Crypto_SHA256::DIGEST_SIZE];
+    uint8_t chunk[1000];
+    memset(chunk, 'a', sizeof(chunk));
+    ASSERT_EQ(ER_OK, hash.Init(NULL, 0));
+    size_t remaining = 1000000;
+    for (size_t piece = 1; remaining > 0; piece = ((piece + 6) % sizeof(chunk)) + 1) {
+        size_t len = (std::min)(piece, remaining);
+        ASSERT_EQ(ER_OK, hash.Update(chunk, len));
+        remaining -= len;
+    }
+    ASSERT_EQ(ER_OK, hash.GetDigest(digest));
+    EXPECT_STREQ("CDC76E5C9914FB9281A1C7E284D73E67F1809A48A497200E046D39CCC7112CD0",
+                 BytesToHexString(digest, sizeof(digest), false).c_str());
+}
+
+TEST(SHA256_Test, HMAC_GetMAC_Reuses_Key) {
+    Crypto_SHA256 hash;
+    uint8_t digest[Crypto_SHA256::DIGEST_SIZE];
+    uint8_t key[1024];
+    for (size_t i = 0; i < ArraySize(sha256test); i++) {
+        if (!strlen(sha256test[i].key)) {
+            continue;
+        }
+        size_t len = HexStringToBytes(sha256test[i].key, key, sizeof(key));
+        const char* msg = sha256test[i].msg;
+        ASSERT_EQ(ER_OK, hash.Init(key, len));
+        /* Every message after the first starts from the same key */
+        for (int round = 0; round < 3; ++round) {
+            EXPECT_EQ(ER_OK, hash.Update((const uint8_t*)msg, strlen(msg)));
+            EXPECT_EQ(ER_OK, hash.GetMAC(digest));
+            EXPECT_STREQ(sha256test[i].dig, BytesToHexString(digest, sizeof(digest), false).c_str())
+                << "test #" << (i + 1) << " round " << round;
+        }
+        /* GetDigest() still finishes the MAC after GetMAC() */
+        EXPECT_EQ(ER_OK, hash.Update((const uint8_t*)msg, strlen(msg)));
+        EXPECT_EQ(ER_OK, hash.GetDigest(digest));
+        EXPECT_STREQ(sha256test[i].dig, BytesToHexString(digest, sizeof(digest), false).c_str());
+        EXPECT_EQ(ER_CRYPTO_HASH_UNINITIALIZED, hash.GetMAC(digest));
+    }
+
+    /* A plain hash has no key to reuse */
+    ASSERT_EQ(ER_OK, hash.Init(NULL, 0));
+    EXPECT_EQ(ER_CRYPTO_ERROR, hash.GetMAC(digest));
+}
+
+TEST(SHA1_Test, HMAC_GetMAC_Reuses_Key) {
+    Crypto_SHA1 hash;
+    uint8_t digest[Crypto_SHA1::DIGEST_SIZE];
+    uint8_t key[4096];
+    for (size_t i = 0; i < ArraySize(sha1test); i++) {
+        if (!strlen(sha1test[i].key)) {
+            continue;
+        }
+        size_t len = HexStringToBytes(sha1test[i].key, key, sizeof(key));
+        const char* msg = sha1test[i].msg;
+        ASSERT_EQ(ER_OK, hash.Init(key, len));
+        for (int round = 0; round < 2; ++round) {
+            EXPECT_EQ(ER_OK, hash.Update((const uint8_t*)msg, strlen(msg)));
+            EXPECT_EQ(ER_OK, hash.GetMAC(digest));
+            EXPECT_STREQ(sha1test[i].dig, BytesToHexString(digest, sizeof(digest), false).c_str())
+                << "test #" << (i + 1) << " round " << round;
+        }
+    }
+}
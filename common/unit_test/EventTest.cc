@@ -18,6 +18,13 @@
 #include <qcc/Event.h>
 #include <qcc/time.h>
 
+#if defined(QCC_OS_GROUP_POSIX)
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/select.h>
+#include <unistd.h>
+#endif
+
 using namespace std;
 using namespace qcc;
 
@@ -163,3 +170,154 @@ TEST(EventTest, Above64HandlesTO)
     RunEventTest(1000, 1, T2, T1);
 #endif
 }
+
+TEST(EventTest, RepeatedWaitsAfterEventsAreReplaced)
+{
+    /*
+     * Each round destroys the events of the round before so their file descriptors
+     * get reused by events the waiting thread has not seen yet.
+     */
+    for (uint32_t round = 0; round < 20; ++round) {
+        std::vector<Event*> checkEvents;
+        for (uint32_t i = 0; i < 50; ++i) {
+            checkEvents.push_back(new Event());
+        }
+        uint32_t signalIndex = (round * 7) % checkEvents.size();
+        checkEvents[signalIndex]->SetEvent();
+
+        std::vector<Event*> signalEvents;
+        ASSERT_EQ(ER_OK, Event::Wait(checkEvents, signalEvents, 0));
+        ASSERT_EQ(1U, signalEvents.size());
+        ASSERT_EQ(checkEvents[signalIndex], signalEvents[0]);
+
+        /* Waiting on fewer events afterwards must not report the dropped ones */
+        checkEvents[signalIndex]->ResetEvent();
+        std::vector<Event*> fewerEvents(checkEvents.begin(), checkEvents.begin() + 10);
+        signalEvents.clear();
+        ASSERT_EQ(ER_TIMEOUT, Event::Wait(fewerEvents, signalEvents, 0));
+        ASSERT_EQ(0U, signalEvents.size());
+
+        for (auto event : checkEvents) {
+            delete event;
+        }
+    }
+}
+
+#if defined(QCC_OS_GROUP_POSIX)
+TEST(EventTest, ReadAndWriteEventsOnAPipe)
+{
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    Event readEvent(fds[0], Event::IO_READ);
+    Event writeEvent(fds[1], Event::IO_WRITE);
+
+    std::vector<Event*> checkEvents;
+    checkEvents.push_back(&readEvent);
+    checkEvents.push_back(&writeEvent);
+    std::vector<Event*> signalEvents;
+    ASSERT_EQ(ER_OK, Event::Wait(checkEvents, signalEvents, 0));
+    ASSERT_EQ(1U, signalEvents.size());
+    EXPECT_EQ(&writeEvent, signalEvents[0]);
+    EXPECT_EQ(ER_TIMEOUT, Event::Wait(readEvent, 0));
+
+    char byte = 0;
+    ASSERT_EQ(1, write(fds[1], &byte, 1));
+    signalEvents.clear();
+    ASSERT_EQ(ER_OK, Event::Wait(checkEvents, signalEvents, 0));
+    EXPECT_EQ(2U, signalEvents.size());
+    EXPECT_EQ(ER_OK, Event::Wait(readEvent, 0));
+
+    ASSERT_EQ(1, read(fds[0], &byte, 1));
+    signalEvents.clear();
+    ASSERT_EQ(ER_OK, Event::Wait(checkEvents, signalEvents, 0));
+    ASSERT_EQ(1U, signalEvents.size());
+    EXPECT_EQ(&writeEvent, signalEvents[0]);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+#endif
+
+#if defined(QCC_EVENT_EPOLL)
+TEST(EventTest, DescriptorsAboveFdSetSize)
+{
+    struct rlimit limit;
+    ASSERT_EQ(0, getrlimit(RLIMIT_NOFILE, &limit));
+    if (limit.rlim_cur < (FD_SETSIZE + 64)) {
+        limit.rlim_cur = (limit.rlim_max < (FD_SETSIZE + 64)) ? limit.rlim_max : (FD_SETSIZE + 64);
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+    }
+    if (limit.rlim_cur < (FD_SETSIZE + 64)) {
+        printf("Skipping, descriptors are limited to %u\n", static_cast<uint32_t>(limit.rlim_cur));
+        return;
+    }
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    int highFd = fcntl(fds[0], F_DUPFD, FD_SETSIZE + 8);
+    ASSERT_LE(FD_SETSIZE, highFd);
+
+    Event readEvent(highFd, Event::IO_READ);
+    Event setEvent;
+    std::vector<Event*> checkEvents;
+    checkEvents.push_back(&readEvent);
+    checkEvents.push_back(&setEvent);
+    std::vector<Event*> signalEvents;
+    EXPECT_EQ(ER_TIMEOUT, Event::Wait(checkEvents, signalEvents, 10));
+    EXPECT_EQ(ER_TIMEOUT, Event::Wait(readEvent, 10));
+
+    char byte = 0;
+    ASSERT_EQ(1, write(fds[1], &byte, 1));
+    ASSERT_EQ(ER_OK, Event::Wait(checkEvents, signalEvents, 1000));
+    ASSERT_EQ(1U, signalEvents.size());
+    EXPECT_EQ(&readEvent, signalEvents[0]);
+    EXPECT_EQ(ER_OK, Event::Wait(readEvent, 1000));
+
+    close(highFd);
+    close(fds[0]);
+    close(fds[1]);
+}
+#endif
+
+#if defined(QCC_EVENT_EPOLL)
+TEST(EventTest, ReusedDescriptorWithOtherEvents)
+{
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+
+    /*
+     * Events created back to back get consecutive serials, so the first and last
+     * of these add up to the same as the middle two.  Whatever the thread's epoll
+     * set keeps per descriptor has to tell the two pairs apart.
+     */
+    Event first(fds[0], Event::IO_READ);
+    Event second(fds[0], Event::IO_READ);
+    Event third(fds[0], Event::IO_READ);
+    Event fourth(fds[0], Event::IO_READ);
+
+    std::vector<Event*> checkEvents;
+    checkEvents.push_back(&first);
+    checkEvents.push_back(&fourth);
+    std::vector<Event*> signalEvents;
+    EXPECT_EQ(ER_TIMEOUT, Event::Wait(checkEvents, signalEvents, 10));
+
+    /* Closing the descriptor takes it out of the epoll set, then reuse the number for another pipe */
+    int reused[2];
+    ASSERT_EQ(0, pipe(reused));
+    ASSERT_EQ(fds[0], dup2(reused[0], fds[0]));
+    close(reused[0]);
+
+    char byte = 0;
+    ASSERT_EQ(1, write(reused[1], &byte, 1));
+    checkEvents.clear();
+    checkEvents.push_back(&second);
+    checkEvents.push_back(&third);
+    ASSERT_EQ(ER_OK, Event::Wait(checkEvents, signalEvents, 1000));
+    EXPECT_EQ(2U, signalEvents.size());
+
+    close(fds[0]);
+    close(fds[1]);
+    close(reused[1]);
+}
+#endif
@@ -16,8 +16,14 @@
  ******************************************************************************/
 #include <gtest/gtest.h>
 
+#include <string.h>
+
 #include <qcc/Condition.h>
 #include <qcc/IODispatch.h>
+#include <qcc/ShardedIODispatch.h>
+#include <qcc/Socket.h>
+#include <qcc/SocketStream.h>
+#include <qcc/time.h>
 
 using namespace qcc;
 
@@ -114,3 +120,159 @@ TEST_F(IODispatchStopStreamTest, WhenStreamIsStarted_Stop)
     l.WaitForExitCallback();
     l.ReturnFromExitCallback();
 }
+
+class IODispatchSocketStreamTest : public testing::Test {
+  public:
+    class Listener : public IOReadListener, public IOWriteListener, public IOExitListener {
+      public:
+        Mutex mutex;
+        Condition condition;
+        size_t bytesRead;
+        bool exitCalled;
+
+        Listener() : bytesRead(0), exitCalled(false) { }
+        virtual ~Listener() { }
+        virtual QStatus ReadCallback(Source& source, bool isTimedOut) {
+            if (!isTimedOut) {
+                uint8_t buf[16];
+                size_t actual = 0;
+                source.PullBytes(buf, sizeof(buf), actual, 0);
+                mutex.Lock();
+                bytesRead += actual;
+                condition.Signal();
+                mutex.Unlock();
+            }
+            return ER_OK;
+        }
+        virtual QStatus WriteCallback(Sink&, bool) { return ER_OK; }
+        virtual void ExitCallback() {
+            mutex.Lock();
+            exitCalled = true;
+            condition.Signal();
+            mutex.Unlock();
+        }
+        size_t WaitForBytes(size_t expected, uint32_t ms) {
+            mutex.Lock();
+            uint64_t end = GetTimestamp64() + ms;
+            while (bytesRead < expected && GetTimestamp64() < end) {
+                condition.TimedWait(mutex, 10);
+            }
+            size_t actual = bytesRead;
+            mutex.Unlock();
+            return actual;
+        }
+        void WaitForExitCallback() {
+            mutex.Lock();
+            while (!exitCalled) {
+                condition.Wait(mutex);
+            }
+            mutex.Unlock();
+        }
+    };
+
+    SocketFd fds[2];
+    SocketStream* stream;
+    Listener l;
+    IODispatch io;
+
+    IODispatchSocketStreamTest() : stream(NULL), io("IODispatchSocketStreamTest", 4) { }
+
+    virtual void SetUp() {
+        ASSERT_EQ(ER_OK, SocketPair(fds));
+        stream = new SocketStream(fds[0]);
+        ASSERT_EQ(ER_OK, io.Start());
+        ASSERT_EQ(ER_OK, io.StartStream(stream, &l, &l, &l, true, false));
+    }
+
+    virtual void TearDown() {
+        EXPECT_EQ(ER_OK, io.StopStream(stream));
+        l.WaitForExitCallback();
+        io.JoinStream(stream);
+        io.Stop();
+        io.Join();
+        delete stream;
+        Close(fds[1]);
+    }
+
+    void Send(const char* data) {
+        size_t sent = 0;
+        EXPECT_EQ(ER_OK, qcc::Send(fds[1], data, strlen(data), sent));
+    }
+};
+
+TEST_F(IODispatchSocketStreamTest, ReadCallbackIsRearmedByEnableReadCallback)
+{
+    Send("a");
+    EXPECT_EQ(1U, l.WaitForBytes(1, 2000));
+
+    /* Read stays in progress until the listener re-enables it */
+    Send("bc");
+    EXPECT_EQ(1U, l.WaitForBytes(3, 100));
+
+    /* Data that arrived while the read was in progress must still be reported */
+    EXPECT_EQ(ER_OK, io.EnableReadCallback(stream));
+    EXPECT_EQ(3U, l.WaitForBytes(3, 2000));
+
+    EXPECT_EQ(ER_OK, io.EnableReadCallback(stream));
+    Send("d");
+    EXPECT_EQ(4U, l.WaitForBytes(4, 2000));
+}
+
+TEST_F(IODispatchSocketStreamTest, NoReadCallbackWhenReadDisabled)
+{
+    EXPECT_EQ(ER_OK, io.DisableReadCallback(stream));
+    Send("a");
+    EXPECT_EQ(0U, l.WaitForBytes(1, 100));
+
+    EXPECT_EQ(ER_OK, io.EnableReadCallback(stream));
+    EXPECT_EQ(1U, l.WaitForBytes(1, 2000));
+}
+
+TEST(ShardedIODispatchTest, StreamsOnAllShardsAreDispatched)
+{
+    const size_t numStreams = 16;
+    ShardedIODispatch io("ShardedIODispatchTest", 16, 4);
+    EXPECT_EQ(4U, io.GetNumShards());
+    ASSERT_EQ(ER_OK, io.Start());
+
+    SocketFd peers[numStreams];
+    SocketStream* streams[numStreams];
+    IODispatchSocketStreamTest::Listener listeners[numStreams];
+    for (size_t i = 0; i < numStreams; ++i) {
+        SocketFd fds[2];
+        ASSERT_EQ(ER_OK, SocketPair(fds));
+        peers[i] = fds[1];
+        streams[i] = new SocketStream(fds[0]);
+        ASSERT_EQ(ER_OK, io.StartStream(streams[i], &listeners[i], &listeners[i], &listeners[i], true, false));
+    }
+
+    for (size_t i = 0; i < numStreams; ++i) {
+        size_t sent = 0;
+        EXPECT_EQ(ER_OK, Send(peers[i], "ab", 2, sent));
+    }
+    for (size_t i = 0; i < numStreams; ++i) {
+        EXPECT_EQ(2U, listeners[i].WaitForBytes(2, 2000));
+    }
+
+    /* Read callbacks are re-enabled through the shard that owns the stream */
+    for (size_t i = 0; i < numStreams; ++i) {
+        size_t sent = 0;
+        EXPECT_EQ(ER_OK, io.EnableReadCallback(streams[i]));
+        EXPECT_EQ(ER_OK, Send(peers[i], "c", 1, sent));
+    }
+    for (size_t i = 0; i < numStreams; ++i) {
+        EXPECT_EQ(3U, listeners[i].WaitForBytes(3, 2000));
+    }
+
+    for (size_t i = 0; i < numStreams; ++i) {
+        EXPECT_EQ(ER_OK, io.StopStream(streams[i]));
+    }
+    for (size_t i = 0; i < numStreams; ++i) {
+        listeners[i].WaitForExitCallback();
+        io.JoinStream(streams[i]);
+        delete streams[i];
+        Close(peers[i]);
+    }
+    io.Stop();
+    io.Join();
+}
@@ -0,0 +1,231 @@
+/******************************************************************************
+ *
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <qcc/Event.h>
+#include <qcc/MPSCRing.h>
+#include <qcc/ManagedObj.h>
+#include <qcc/Thread.h>
+#include <qcc/atomic.h>
+
+#include <Status.h>
+
+using namespace qcc;
+
+static volatile int32_t liveCount = 0;
+
+/* Counts its live instances and has no default constructor, like a Message */
+class Counted {
+  public:
+    Counted(uint32_t value) : value(value) { IncrementAndFetch(&liveCount); }
+    Counted(const Counted& other) : value(other.value) { IncrementAndFetch(&liveCount); }
+    ~Counted() { DecrementAndFetch(&liveCount); }
+    Counted& operator=(const Counted& other) { value = other.value; return *this; }
+
+    uint32_t value;
+};
+
+TEST(MPSCRingTest, FifoOrderAndCapacity)
+{
+    MPSCRing<uint32_t> ring(5);
+    uint32_t value;
+
+    EXPECT_FALSE(ring.TryPop(value));
+    /* The capacity is rounded up to 8 */
+    for (uint32_t i = 0; i < 8; ++i) {
+        EXPECT_TRUE(ring.TryPush(i));
+    }
+    EXPECT_FALSE(ring.TryPush(8));
+
+    /* Wrap around a few times to exercise the sequence numbers */
+    for (uint32_t i = 0; i < 100; ++i) {
+        ASSERT_TRUE(ring.TryPop(value));
+        EXPECT_EQ(i, value);
+        EXPECT_TRUE(ring.TryPush(i + 8));
+    }
+    for (uint32_t i = 100; i < 108; ++i) {
+        ASSERT_TRUE(ring.TryPop(value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_FALSE(ring.TryPop(value));
+}
+
+TEST(MPSCRingTest, ElementsAreReleased)
+{
+    liveCount = 0;
+    {
+        MPSCRing<Counted> ring(4);
+        for (uint32_t i = 0; i < 4; ++i) {
+            EXPECT_TRUE(ring.TryPush(Counted(i)));
+        }
+        EXPECT_EQ(4, liveCount);
+
+        Counted* front = ring.Front();
+        ASSERT_TRUE(front != NULL);
+        EXPECT_EQ(0U, front->value);
+        ring.PopFront();
+        EXPECT_EQ(3, liveCount);
+    }
+    /* The destructor releases what was not popped */
+    EXPECT_EQ(0, liveCount);
+
+    {
+        MPSCRing<ManagedObj<uint32_t> > ring(2);
+        uint32_t seven = 7;
+        ManagedObj<uint32_t> obj(seven);
+        EXPECT_TRUE(ring.TryPush(obj));
+        EXPECT_EQ(2, obj.GetRefCount());
+        ManagedObj<uint32_t> popped;
+        EXPECT_TRUE(ring.TryPop(popped));
+        EXPECT_EQ(7U, *popped);
+        EXPECT_EQ(2, obj.GetRefCount());
+    }
+}
+
+static const uint32_t NUM_PRODUCERS = 4;
+static const uint32_t PUSHES_PER_PRODUCER = 20000;
+
+class ProducerThread : public Thread {
+  public:
+    ProducerThread(MPSCRing<uint32_t>& ring, uint32_t id) : Thread("MPSCRingProducer"), ring(ring), id(id) { }
+
+  protected:
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        for (uint32_t i = 0; i < PUSHES_PER_PRODUCER; ++i) {
+            while (!ring.TryPush((id << 24) | i)) {
+                qcc::Sleep(0);
+            }
+        }
+        return 0;
+    }
+
+  private:
+    MPSCRing<uint32_t>& ring;
+    uint32_t id;
+};
+
+TEST(MPSCRingTest, ConcurrentProducersKeepTheirOrder)
+{
+    MPSCRing<uint32_t> ring(16);
+    std::vector<ProducerThread*> producers;
+    for (uint32_t i = 0; i < NUM_PRODUCERS; ++i) {
+        producers.push_back(new ProducerThread(ring, i));
+        ASSERT_EQ(ER_OK, producers.back()->Start());
+    }
+
+    /* Each producer's values must come out in the order it pushed them */
+    std::vector<uint32_t> next(NUM_PRODUCERS, 0);
+    uint32_t popped = 0;
+    while (popped < (NUM_PRODUCERS * PUSHES_PER_PRODUCER)) {
+        uint32_t value;
+        if (!ring.TryPop(value)) {
+            qcc::Sleep(0);
+            continue;
+        }
+        uint32_t id = value >> 24;
+        ++popped;
+        /* Keep popping on failure so the producers can finish */
+        if (id >= NUM_PRODUCERS) {
+            ADD_FAILURE() << "Unexpected value " << value;
+            continue;
+        }
+        EXPECT_EQ(next[id], value & 0xFFFFFF);
+        next[id] = (value & 0xFFFFFF) + 1;
+    }
+
+    for (uint32_t i = 0; i < NUM_PRODUCERS; ++i) {
+        producers[i]->Join();
+        delete producers[i];
+        EXPECT_EQ(PUSHES_PER_PRODUCER, next[i]);
+    }
+    uint32_t value;
+    EXPECT_FALSE(ring.TryPop(value));
+}
+
+/* A value whose copy into the ring blocks until gate is set, leaving its position claimed but unpublished */
+class Gated {
+  public:
+    static Event* claimed;
+    static Event* gate;
+
+    Gated(uint32_t value, bool blocks) : value(value), blocks(blocks) { }
+    Gated(const Gated& other) : value(other.value), blocks(false)
+    {
+        if (other.blocks) {
+            claimed->SetEvent();
+            Event::Wait(*gate);
+        }
+    }
+
+    uint32_t value;
+    bool blocks;
+
+  private:
+    Gated& operator=(const Gated& other);
+};
+
+Event* Gated::claimed = NULL;
+Event* Gated::gate = NULL;
+
+static ThreadReturn STDCALL PushGated(void* arg)
+{
+    reinterpret_cast<MPSCRing<Gated>*>(arg)->TryPush(Gated(0, true));
+    return 0;
+}
+
+static ThreadReturn STDCALL OpenGate(void* arg)
+{
+    QCC_UNUSED(arg);
+    qcc::Sleep(100);
+    Gated::gate->SetEvent();
+    return 0;
+}
+
+TEST(MPSCRingTest, WaitFrontWaitsForClaimedPositions)
+{
+    Event claimed;
+    Event gate;
+    Gated::claimed = &claimed;
+    Gated::gate = &gate;
+    MPSCRing<Gated> ring(4);
+    Thread pusher("PushGated", PushGated);
+    ASSERT_EQ(ER_OK, pusher.Start(&ring));
+    ASSERT_EQ(ER_OK, Event::Wait(claimed, 5000));
+
+    /* The element after the claimed position is published but Front() cannot get past the claim */
+    EXPECT_TRUE(ring.TryPush(Gated(1, false)));
+    EXPECT_TRUE(ring.Front() == NULL);
+
+    Thread opener("OpenGate", OpenGate);
+    ASSERT_EQ(ER_OK, opener.Start());
+    Gated* front = ring.WaitFront();
+    ASSERT_TRUE(front != NULL);
+    EXPECT_EQ(0U, front->value);
+    ring.PopFront();
+    front = ring.WaitFront();
+    ASSERT_TRUE(front != NULL);
+    EXPECT_EQ(1U, front->value);
+    ring.PopFront();
+    EXPECT_TRUE(ring.WaitFront() == NULL);
+
+    opener.Join();
+    pusher.Join();
+}
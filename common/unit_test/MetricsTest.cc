@@ -0,0 +1,136 @@
+/******************************************************************************
+ *
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <qcc/Metrics.h>
+#include <qcc/Thread.h>
+
+#include <Status.h>
+
+using namespace qcc;
+
+TEST(MetricsTest, HistogramBuckets)
+{
+    /* Small values have their own bucket */
+    for (uint32_t v = 0; v < 4; ++v) {
+        EXPECT_EQ(v, MetricHistogram::GetBucket(v));
+        EXPECT_EQ(v, MetricHistogram::GetBucketLowerBound(v));
+    }
+    EXPECT_EQ(4U, MetricHistogram::GetBucket(4));
+    EXPECT_EQ(7U, MetricHistogram::GetBucket(7));
+    EXPECT_EQ(8U, MetricHistogram::GetBucket(8));
+    EXPECT_EQ(8U, MetricHistogram::GetBucket(9));
+    EXPECT_EQ(9U, MetricHistogram::GetBucket(10));
+    EXPECT_EQ(MetricHistogram::NUM_BUCKETS - 1, MetricHistogram::GetBucket(0xFFFFFFFF));
+
+    /* Every bucket starts right after the previous one and its lower bound falls in it */
+    for (size_t b = 1; b < MetricHistogram::NUM_BUCKETS; ++b) {
+        uint32_t lower = MetricHistogram::GetBucketLowerBound(b);
+        EXPECT_EQ(b, MetricHistogram::GetBucket(lower));
+        EXPECT_EQ(b - 1, MetricHistogram::GetBucket(lower - 1));
+    }
+}
+
+TEST(MetricsTest, HistogramPercentiles)
+{
+    MetricHistogram histogram;
+    MetricHistogramSnapshot snapshot;
+    histogram.GetSnapshot(snapshot);
+    EXPECT_EQ(0U, snapshot.GetCount());
+    EXPECT_EQ(0U, snapshot.GetPercentile(50));
+
+    for (uint32_t i = 0; i < 90; ++i) {
+        histogram.Record(2);
+    }
+    for (uint32_t i = 0; i < 10; ++i) {
+        histogram.Record(1000);
+    }
+    histogram.GetSnapshot(snapshot);
+    EXPECT_EQ(100U, snapshot.GetCount());
+    EXPECT_EQ(2U, snapshot.GetPercentile(50));
+    EXPECT_EQ(2U, snapshot.GetPercentile(89));
+    EXPECT_EQ(MetricHistogram::GetBucketLowerBound(MetricHistogram::GetBucket(1000)), snapshot.GetPercentile(99));
+    EXPECT_EQ(MetricHistogram::GetBucketLowerBound(MetricHistogram::GetBucket(1000)), snapshot.GetPercentile(100));
+}
+
+TEST(MetricsTest, RegistryAndSnapshot)
+{
+    MetricCounter* counter = Metrics::GetCounter("metricstest.counter");
+    EXPECT_EQ(counter, Metrics::GetCounter("metricstest.counter"));
+    MetricHistogram* histogram = Metrics::GetHistogram("metricstest.histogram");
+    EXPECT_EQ(histogram, Metrics::GetHistogram("metricstest.histogram"));
+
+    uint32_t before = counter->GetValue();
+    counter->Increment();
+    counter->Add(10);
+    counter->Increment();
+    counter->Decrement();
+    histogram->Record(5);
+
+    MetricsSnapshot snapshot;
+    Metrics::GetSnapshot(snapshot);
+    ASSERT_TRUE(snapshot.counters.find("metricstest.counter") != snapshot.counters.end());
+    EXPECT_EQ(before + 11, snapshot.counters["metricstest.counter"]);
+    ASSERT_TRUE(snapshot.histograms.find("metricstest.histogram") != snapshot.histograms.end());
+    EXPECT_LE(1U, snapshot.histograms["metricstest.histogram"].GetCount());
+}
+
+static const uint32_t NUM_THREADS = 8;
+static const uint32_t INCREMENTS_PER_THREAD = 100000;
+
+class IncrementThread : public Thread {
+  public:
+    IncrementThread(MetricCounter& counter, MetricHistogram& histogram) :
+        Thread("MetricsIncrement"), counter(counter), histogram(histogram) { }
+
+  protected:
+    ThreadReturn STDCALL Run(void* arg)
+    {
+        QCC_UNUSED(arg);
+        for (uint32_t i = 0; i < INCREMENTS_PER_THREAD; ++i) {
+            counter.Increment();
+            histogram.Record(i);
+        }
+        return 0;
+    }
+
+  private:
+    MetricCounter& counter;
+    MetricHistogram& histogram;
+};
+
+TEST(MetricsTest, ConcurrentUpdatesAreNotLost)
+{
+    MetricCounter counter;
+    MetricHistogram histogram;
+    std::vector<IncrementThread*> threads;
+    for (uint32_t i = 0; i < NUM_THREADS; ++i) {
+        threads.push_back(new IncrementThread(counter, histogram));
+        ASSERT_EQ(ER_OK, threads.back()->Start());
+    }
+    for (uint32_t i = 0; i < NUM_THREADS; ++i) {
+        threads[i]->Join();
+        delete threads[i];
+    }
+
+    EXPECT_EQ(NUM_THREADS * INCREMENTS_PER_THREAD, counter.GetValue());
+    MetricHistogramSnapshot snapshot;
+    histogram.GetSnapshot(snapshot);
+    EXPECT_EQ(static_cast<uint64_t>(NUM_THREADS) * INCREMENTS_PER_THREAD, snapshot.GetCount());
+}
@@ -160,6 +160,18 @@ TEST_F(SocketStreamTestErrors, PushBytesTimeout)
     EXPECT_EQ(ER_TIMEOUT, status);
 }
 
+TEST_F(SocketStreamTestErrors, PushBytesVTtlBoundsTheWait)
+{
+    SocketStream connected(acceptedFd); acceptedFd = INVALID_SOCKET_FD;
+    EXPECT_EQ(ER_OK, SetSndBuf(connected.GetSocketFd(), 8192));
+    EXPECT_EQ(ER_OK, SetBlocking(connected.GetSocketFd(), false));
+    /* The send timeout would wait for the peer forever, the ttl does not */
+    IOVec iov[2] = { { buf, ArraySize(buf) / 2 }, { buf + ArraySize(buf) / 2, ArraySize(buf) / 2 } };
+    while ((status = connected.PushBytesV(iov, ArraySize(iov), numBytes, 10)) == ER_OK)
+        ;
+    EXPECT_EQ(ER_TIMEOUT, status);
+}
+
 TEST_F(SocketStreamTestErrors, PushBytesAfterAbortiveRelease)
 {
     SocketStream client(clientFd); clientFd = INVALID_SOCKET_FD;
@@ -353,6 +353,34 @@ TEST_F(SocketTestErrors, SendWouldBlock)
     EXPECT_EQ(ER_WOULDBLOCK, status);
 }
 
+TEST_F(SocketTestErrors, SendVWhenConnected)
+{
+    char part1[] = "scatter";
+    char part2[] = "-";
+    char part3[] = "gather";
+    IOVec iov[3];
+    iov[0].buf = part1;
+    iov[0].len = strlen(part1);
+    iov[1].buf = part2;
+    iov[1].len = 0;
+    iov[2].buf = part3;
+    iov[2].len = strlen(part3);
+    EXPECT_EQ(ER_OK, SendV(acceptedFd, iov, ArraySize(iov), numSent));
+    EXPECT_EQ(strlen(part1) + strlen(part3), numSent);
+
+    size_t total = 0;
+    while ((total < numSent) && (Recv(clientFd, buf + total, numSent - total, numRecvd) == ER_OK) && (numRecvd > 0)) {
+        total += numRecvd;
+    }
+    EXPECT_EQ(numSent, total);
+    EXPECT_EQ(0, memcmp(buf, "scattergather", total));
+}
+
+TEST_F(SocketTestErrors, SendVArgs)
+{
+    EXPECT_EQ(ER_BAD_ARG_3, SendV(acceptedFd, NULL, 0, numSent));
+}
+
 class SocketTestWithFdsErrors : public testing::Test {
   public:
     SocketFd endpoint[2];
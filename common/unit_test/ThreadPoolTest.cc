@@ -0,0 +1,142 @@
+/******************************************************************************
+ *
+ * Copyright AllSeen Alliance. All rights reserved.
+ *
+ *    Permission to use, copy, modify, and/or distribute this software for any
+ *    purpose with or without fee is hereby granted, provided that the above
+ *    copyright notice and this permission notice appear in all copies.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *    WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *    MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *    ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *    WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *    ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ ******************************************************************************/
+#include <gtest/gtest.h>
+
+#include <qcc/Event.h>
+#include <qcc/Thread.h>
+#include <qcc/ThreadPool.h>
+#include <qcc/atomic.h>
+#include <qcc/time.h>
+
+#include <Status.h>
+
+using namespace qcc;
+
+static volatile int32_t runCount = 0;
+static volatile int32_t deleteCount = 0;
+
+class CountingRunnable : public Runnable {
+  public:
+    CountingRunnable(Event* gate = NULL) : gate(gate) { }
+    ~CountingRunnable() { IncrementAndFetch(&deleteCount); }
+
+    virtual void Run(void)
+    {
+        if (gate) {
+            Event::Wait(*gate, 10000);
+        }
+        IncrementAndFetch(&runCount);
+    }
+
+  private:
+    Event* gate;
+};
+
+/* Executes a number of CountingRunnables on its own pool from within Run() */
+class FanOutRunnable : public Runnable {
+  public:
+    FanOutRunnable(ThreadPool* pool, uint32_t children) : pool(pool), children(children) { }
+
+    virtual void Run(void)
+    {
+        for (uint32_t i = 0; i < children; ++i) {
+            EXPECT_EQ(ER_OK, pool->Execute(NewPtr<CountingRunnable>()));
+        }
+        IncrementAndFetch(&runCount);
+    }
+
+  private:
+    ThreadPool* pool;
+    uint32_t children;
+};
+
+static bool WaitForCount(volatile int32_t& count, int32_t expected)
+{
+    uint64_t start = GetTimestamp64();
+    while ((count < expected) && (GetTimestamp64() < (start + 10000))) {
+        qcc::Sleep(1);
+    }
+    return count == expected;
+}
+
+class ThreadPoolTest : public testing::Test {
+  public:
+    virtual void SetUp()
+    {
+        runCount = 0;
+        deleteCount = 0;
+    }
+};
+
+TEST_F(ThreadPoolTest, RunsEveryClosureOnce)
+{
+    const int32_t numClosures = 2000;
+    {
+        ThreadPool pool("ThreadPoolTest", 4);
+        EXPECT_EQ(4U, pool.GetConcurrency());
+        for (int32_t i = 0; i < numClosures; ++i) {
+            ASSERT_EQ(ER_OK, pool.WaitForAvailableThread());
+            Ptr<Runnable> runnable = NewPtr<CountingRunnable>();
+            ASSERT_EQ(ER_OK, pool.Execute(runnable));
+        }
+        ASSERT_TRUE(WaitForCount(runCount, numClosures));
+        ASSERT_TRUE(WaitForCount(deleteCount, numClosures));
+        EXPECT_EQ(0U, pool.GetN());
+    }
+    EXPECT_EQ(numClosures, runCount);
+    EXPECT_EQ(numClosures, deleteCount);
+}
+
+TEST_F(ThreadPoolTest, ExhaustedWhenEveryThreadIsBusy)
+{
+    Event gate;
+    ThreadPool pool("ThreadPoolTest", 2);
+    ASSERT_EQ(ER_OK, pool.Execute(NewPtr<CountingRunnable>(&gate)));
+    ASSERT_EQ(ER_OK, pool.Execute(NewPtr<CountingRunnable>(&gate)));
+    EXPECT_EQ(2U, pool.GetN());
+    EXPECT_EQ(ER_THREADPOOL_EXHAUSTED, pool.Execute(NewPtr<CountingRunnable>()));
+    EXPECT_EQ(2U, pool.GetN());
+
+    gate.SetEvent();
+    ASSERT_EQ(ER_OK, pool.WaitForAvailableThread());
+    ASSERT_TRUE(WaitForCount(runCount, 2));
+    ASSERT_TRUE(WaitForCount(deleteCount, 3));
+}
+
+TEST_F(ThreadPoolTest, ClosuresExecutedFromAWorkerAreStolen)
+{
+    ThreadPool pool("ThreadPoolTest", 4);
+    ASSERT_EQ(ER_OK, pool.Execute(NewPtr<FanOutRunnable>(&pool, 3U)));
+    ASSERT_TRUE(WaitForCount(runCount, 4));
+    ASSERT_TRUE(WaitForCount(deleteCount, 3));
+}
+
+TEST_F(ThreadPoolTest, StopRefusesNewClosures)
+{
+    Event gate;
+    {
+        ThreadPool pool("ThreadPoolTest", 1);
+        ASSERT_EQ(ER_OK, pool.Execute(NewPtr<CountingRunnable>(&gate)));
+        EXPECT_EQ(ER_OK, pool.Stop());
+        EXPECT_EQ(ER_THREADPOOL_STOPPING, pool.Execute(NewPtr<CountingRunnable>()));
+        EXPECT_EQ(ER_THREADPOOL_STOPPING, pool.WaitForAvailableThread());
+        gate.SetEvent();
+        EXPECT_EQ(ER_OK, pool.Join());
+    }
+    /* Both closures are gone once the pool is destroyed */
+    EXPECT_EQ(2, deleteCount);
+}
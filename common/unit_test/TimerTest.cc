@@ -15,10 +15,14 @@
  ******************************************************************************/
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <deque>
+#include <vector>
 
+#include <qcc/Metrics.h>
 #include <qcc/Thread.h>
 #include <qcc/Timer.h>
+#include <qcc/Util.h>
 #include <Status.h>
 
 using namespace std;
@@ -488,3 +492,158 @@ TEST(TimerTest, TestMaxAlarms) {
     ASSERT_EQ(triggeredAlarms.size(), (size_t)3);
     triggeredAlarmsLock.Unlock();
 }
+
+/*
+ * Alarms on a timing wheel are added in no particular order with delays that span the first two
+ * levels of the wheel and must fire in time order.
+ */
+TEST(TimerTest, TimingWheelOrdering) {
+    triggeredAlarmsLock.Lock();
+    triggeredAlarms.clear();
+    triggeredAlarmsLock.Unlock();
+
+    MyAlarmListener alarmListener(0);
+    AlarmListener* al = &alarmListener;
+    Timer timer("testTimer", false, 1, false, 0, Timer::TIMING_WHEEL);
+    ASSERT_EQ(ER_OK, timer.Start());
+
+    const uint32_t delays[] = { 300, 5, 260, 40, 255, 120, 1, 512 };
+    const size_t numDelays = ArraySize(delays);
+    Timespec<MonotonicTime> ts;
+    GetTimeNow(&ts);
+    for (size_t i = 0; i < numDelays; ++i) {
+        uint32_t delay = delays[i];
+        uint32_t zero = 0;
+        void* context = (void*)(uintptr_t)delay;
+        Alarm alarm(delay, al, context, zero);
+        ASSERT_EQ(ER_OK, timer.AddAlarm(alarm));
+    }
+
+    /* Alarms far enough out to sit on the upper levels and the overflow list are only removed */
+    uint32_t farDelay = 90 * 1000;
+    Alarm far(farDelay, al);
+    ASSERT_EQ(ER_OK, timer.AddAlarm(far));
+    Timespec<MonotonicTime> months = ts;
+    months.seconds += 100 * 24 * 60 * 60;
+    Alarm never(months, al);
+    ASSERT_EQ(ER_OK, timer.AddAlarm(never));
+
+    std::vector<uint32_t> sorted(delays, delays + numDelays);
+    std::sort(sorted.begin(), sorted.end());
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        ASSERT_TRUE(testNextAlarm(ts + sorted[i], (void*)(uintptr_t)sorted[i])) << "Delay " << sorted[i];
+    }
+
+    EXPECT_TRUE(timer.HasAlarm(far));
+    EXPECT_TRUE(timer.HasAlarm(never));
+    EXPECT_TRUE(timer.RemoveAlarm(far));
+    EXPECT_FALSE(timer.HasAlarm(far));
+    EXPECT_FALSE(timer.RemoveAlarm(far));
+    EXPECT_TRUE(timer.RemoveAlarm(never));
+
+    ASSERT_EQ(ER_OK, timer.Stop());
+    ASSERT_EQ(ER_OK, timer.Join());
+}
+
+TEST(TimerTest, TimingWheelRemoveAndReplace) {
+    triggeredAlarmsLock.Lock();
+    triggeredAlarms.clear();
+    triggeredAlarmsLock.Unlock();
+
+    MyAlarmListener alarmListener(0);
+    MyAlarmListener otherListener(0);
+    AlarmListener* al = &alarmListener;
+    AlarmListener* other = &otherListener;
+    Timer timer("testTimer", false, 1, false, 0, Timer::TIMING_WHEEL);
+    ASSERT_EQ(ER_OK, timer.Start());
+
+    std::vector<Alarm> alarms;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        uint32_t delay = 10000 + i * 97;
+        Alarm alarm(delay, (i & 1) ? other : al);
+        ASSERT_EQ(ER_OK, timer.AddAlarm(alarm));
+        alarms.push_back(alarm);
+    }
+    /* Adding an alarm that is already pending has no effect */
+    ASSERT_EQ(ER_OK, timer.AddAlarm(alarms[0]));
+    EXPECT_TRUE(timer.RemoveAlarm(alarms[0]));
+    EXPECT_FALSE(timer.HasAlarm(alarms[0]));
+
+    timer.RemoveAlarmsWithListener(otherListener);
+    for (size_t i = 1; i < alarms.size(); ++i) {
+        EXPECT_EQ((i & 1) == 0, timer.HasAlarm(alarms[i]));
+    }
+
+    /* Replace a pending alarm with one that fires right away */
+    Timespec<MonotonicTime> ts;
+    GetTimeNow(&ts);
+    uint32_t delay = 20;
+    void* context = (void*)0x1234;
+    uint32_t zero = 0;
+    Alarm soon(delay, al, context, zero);
+    ASSERT_EQ(ER_OK, timer.ReplaceAlarm(alarms[2], soon));
+    EXPECT_FALSE(timer.HasAlarm(alarms[2]));
+    ASSERT_TRUE(testNextAlarm(ts + delay, context));
+
+    /* A recurring alarm keeps its place on the wheel */
+    GetTimeNow(&ts);
+    uint32_t period = 50;
+    void* none = NULL;
+    Alarm recurring(period, al, none, period);
+    ASSERT_EQ(ER_OK, timer.AddAlarm(recurring));
+    ASSERT_TRUE(testNextAlarm(ts + period, 0));
+    ASSERT_TRUE(testNextAlarm(ts + 2 * period, 0));
+    ASSERT_TRUE(testNextAlarm(ts + 3 * period, 0));
+    EXPECT_TRUE(timer.RemoveAlarm(recurring));
+
+    ASSERT_EQ(ER_OK, timer.Stop());
+    ASSERT_EQ(ER_OK, timer.Join());
+}
+
+TEST(TimerTest, QueueDepthIsRecorded) {
+    const Timer::AlarmQueueType queueTypes[] = { Timer::ALARM_SET, Timer::TIMING_WHEEL };
+    MetricHistogram* depth = Metrics::GetHistogram("timer.alarm.queue.depth");
+
+    for (size_t t = 0; t < ArraySize(queueTypes); ++t) {
+        triggeredAlarmsLock.Lock();
+        triggeredAlarms.clear();
+        triggeredAlarmsLock.Unlock();
+
+        MyAlarmListener alarmListener(0);
+        AlarmListener* al = &alarmListener;
+        Timer timer("testTimer", false, 1, false, 0, queueTypes[t]);
+        ASSERT_EQ(ER_OK, timer.Start());
+
+        MetricHistogramSnapshot before;
+        depth->GetSnapshot(before);
+
+        /* Each alarm that fires leaves the later ones and the far alarm pending */
+        const uint32_t delays[] = { 20, 40, 60 };
+        const size_t numDelays = ArraySize(delays);
+        Timespec<MonotonicTime> ts;
+        GetTimeNow(&ts);
+        for (size_t i = 0; i < numDelays; ++i) {
+            uint32_t zero = 0;
+            void* context = (void*)(uintptr_t)delays[i];
+            Alarm alarm(delays[i], al, context, zero);
+            ASSERT_EQ(ER_OK, timer.AddAlarm(alarm));
+        }
+        uint32_t farDelay = 60 * 1000;
+        Alarm far(farDelay, al);
+        ASSERT_EQ(ER_OK, timer.AddAlarm(far));
+        for (size_t i = 0; i < numDelays; ++i) {
+            ASSERT_TRUE(testNextAlarm(ts + delays[i], (void*)(uintptr_t)delays[i]));
+        }
+
+        MetricHistogramSnapshot after;
+        depth->GetSnapshot(after);
+        for (uint32_t pending = 1; pending <= numDelays; ++pending) {
+            size_t bucket = MetricHistogram::GetBucket(pending);
+            EXPECT_EQ(before.buckets[bucket] + 1, after.buckets[bucket]) << "Pending " << pending;
+        }
+
+        EXPECT_TRUE(timer.RemoveAlarm(far));
+        ASSERT_EQ(ER_OK, timer.Stop());
+        ASSERT_EQ(ER_OK, timer.Join());
+    }
+}
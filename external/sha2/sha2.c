@@ -379,6 +379,15 @@ void SHA256_Init(SHA256_CTX* context) {
 	context->bitcount = 0;
 }
 
+/*
+ * A file that includes this one and provides its own SHA256_Transform()
+ * defines SHA256_PORTABLE_TRANSFORM, the transform below is then named
+ * SHA256_Transform_Portable() for it to fall back on.
+ */
+#ifdef SHA256_PORTABLE_TRANSFORM
+#define SHA256_Transform SHA256_Transform_Portable
+#endif
+
 #ifdef SHA2_UNROLL_TRANSFORM
 
 /* Unrolled SHA-256 round macros: */
@@ -554,6 +563,10 @@ void SHA256_Transform(SHA256_CTX* context, const sha2_word32* data) {
 
 #endif /* SHA2_UNROLL_TRANSFORM */
 
+#ifdef SHA256_PORTABLE_TRANSFORM
+#undef SHA256_Transform
+#endif
+
 void SHA256_Update(SHA256_CTX* context, const sha2_byte *data, size_t len) {
 	unsigned int	freespace, usedspace;
 